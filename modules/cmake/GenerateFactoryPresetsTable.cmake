@@ -0,0 +1,131 @@
+# Generates a header containing the metadata for the factory presets, so that the
+# plugin doesn't need to parse every preset to list them.
+#
+# Usage: cmake -DPRESET_FILES="<file1>|<file2>|..." -DOUTPUT_FILE=<header> -P GenerateFactoryPresetsTable.cmake
+
+function(xml_unescape var)
+    set(text "${${var}}")
+    string(REPLACE "&lt;" "<" text "${text}")
+    string(REPLACE "&gt;" ">" text "${text}")
+    string(REPLACE "&quot;" "\"" text "${text}")
+    string(REPLACE "&apos;" "'" text "${text}")
+    string(REPLACE "&amp;" "&" text "${text}")
+    set(${var} "${text}" PARENT_SCOPE)
+endfunction()
+
+function(cpp_string_literal var)
+    set(text "${${var}}")
+    string(REPLACE "\\" "\\\\" text "${text}")
+    string(REPLACE "\"" "\\\"" text "${text}")
+    set(${var} "\"${text}\"" PARENT_SCOPE)
+endfunction()
+
+function(get_preset_attribute preset_tag attribute var)
+    set(value "")
+    if("${preset_tag}" MATCHES "[ \t\r\n]${attribute}=\"([^\"]*)\"")
+        set(value "${CMAKE_MATCH_1}")
+    endif()
+    xml_unescape(value)
+    cpp_string_literal(value)
+    set(${var} "${value}" PARENT_SCOPE)
+endfunction()
+
+string(REPLACE "|" ";" preset_files "${PRESET_FILES}")
+
+set(module_arrays "")
+set(table_entries "")
+set(preset_index 0)
+foreach(preset_file IN LISTS preset_files)
+    get_filename_component(file_name "${preset_file}" NAME)
+    file(READ "${preset_file}" preset_xml)
+
+    string(REGEX MATCH "<Preset[^>]*>" preset_tag "${preset_xml}")
+    if(NOT preset_tag)
+        message(FATAL_ERROR "Unable to read preset: ${preset_file}")
+    endif()
+
+    get_preset_attribute("${preset_tag}" name preset_name)
+    get_preset_attribute("${preset_tag}" vendor preset_vendor)
+    get_preset_attribute("${preset_tag}" category preset_category)
+
+    # the processors are the top-level elements in the processor chain state
+    # (Input and Output are in every preset, so they don't need to be listed)
+    string(FIND "${preset_xml}" "<proc_chain" chain_start)
+    string(FIND "${preset_xml}" "</proc_chain>" chain_end)
+    set(modules "")
+    set(parameter_ids "")
+    if(chain_start GREATER -1 AND chain_end GREATER chain_start)
+        math(EXPR chain_length "${chain_end} - ${chain_start}")
+        string(SUBSTRING "${preset_xml}" ${chain_start} ${chain_length} chain_xml)
+        string(REPLACE ";" "" chain_xml "${chain_xml}") # so that each module block stays in one list element
+
+        # each module block is the module tag, followed by the (further indented) module contents
+        string(REGEX MATCHALL "\n    <[^ \t\r\n/>]+[^\n]*(\n      [^\n]*)*" module_blocks "${chain_xml}")
+        foreach(module_block IN LISTS module_blocks)
+            string(REGEX MATCH "^\n    <([^ \t\r\n/>]+)" module_tag "${module_block}")
+            string(REPLACE "_" " " module_name "${CMAKE_MATCH_1}")
+            if(module_name STREQUAL "Input" OR module_name STREQUAL "Output")
+                continue()
+            endif()
+            list(APPEND modules "${module_name}")
+
+            # the parameters are only searchable for modules that are turned on
+            if("${module_block}" MATCHES "<PARAM id=\"on_off\" value=\"([^\"]*)\"" AND CMAKE_MATCH_1 LESS 0.5)
+                continue()
+            endif()
+
+            string(REGEX MATCHALL "<PARAM id=\"[^\"]*\"" param_tags "${module_block}")
+            foreach(param_tag IN LISTS param_tags)
+                string(REGEX REPLACE "^<PARAM id=\"([^\"]*)\"$" "\\1" param_id "${param_tag}")
+                if(NOT param_id STREQUAL "on_off")
+                    list(APPEND parameter_ids "${param_id}")
+                endif()
+            endforeach()
+        endforeach()
+        list(REMOVE_DUPLICATES modules)
+        list(REMOVE_DUPLICATES parameter_ids)
+        list(SORT parameter_ids)
+    endif()
+
+    list(LENGTH modules num_modules)
+    set(module_literals "")
+    foreach(module_name IN LISTS modules)
+        cpp_string_literal(module_name)
+        string(APPEND module_literals " ${module_name},")
+    endforeach()
+    string(APPEND module_arrays "    static constexpr std::array<const char*, ${num_modules}> preset${preset_index}Modules {${module_literals} };\n")
+
+    list(LENGTH parameter_ids num_parameter_ids)
+    set(parameter_id_literals "")
+    foreach(parameter_id IN LISTS parameter_ids)
+        cpp_string_literal(parameter_id)
+        string(APPEND parameter_id_literals " ${parameter_id},")
+    endforeach()
+    string(APPEND module_arrays "    static constexpr std::array<const char*, ${num_parameter_ids}> preset${preset_index}ParameterIDs {${parameter_id_literals} };\n")
+
+    set(file_name_literal "${file_name}")
+    cpp_string_literal(file_name_literal)
+    string(APPEND table_entries "        FactoryPresetInfo { ${preset_name}, ${preset_vendor}, ${preset_category}, ${file_name_literal}, preset${preset_index}Modules, preset${preset_index}ParameterIDs },\n")
+
+    math(EXPR preset_index "${preset_index} + 1")
+endforeach()
+
+set(header_contents "// This file was generated by GenerateFactoryPresetsTable.cmake, don't edit it!
+#pragma once
+
+namespace factory_presets_table
+{
+${module_arrays}
+    static constexpr std::array<FactoryPresetInfo, ${preset_index}> presets {
+${table_entries}    };
+} // namespace factory_presets_table
+")
+
+# only write the file if it has changed, to avoid unnecessary re-builds
+if(EXISTS "${OUTPUT_FILE}")
+    file(READ "${OUTPUT_FILE}" old_header_contents)
+    if(old_header_contents STREQUAL header_contents)
+        return()
+    endif()
+endif()
+file(WRITE "${OUTPUT_FILE}" "${header_contents}")
@@ -128,12 +128,13 @@ AudioProcessorEditor* BYOD::createEditor()
 
 void BYOD::getStateInformation (MemoryBlock& destData)
 {
-    copyXmlToBinary (*stateManager->saveState(), destData);
+    MemoryOutputStream stream { destData, false };
+    stateManager->saveState (stream);
 }
 
 void BYOD::setStateInformation (const void* data, int sizeInBytes)
 {
-    stateManager->loadState (getXmlFromBinary (data, sizeInBytes).get(), *paramForwarder);
+    stateManager->loadState (data, (size_t) sizeInBytes, *paramForwarder);
 
     if (wrapperType == WrapperType::wrapperType_AudioUnitv3)
     {
@@ -105,12 +105,7 @@ void Cable::repaintIfNeeded (bool force)
         cablePath = std::move (createdPath);
 
         const auto cableBounds = cablePath.getBounds().expanded (std::ceil (minCableThickness), std::ceil (2.0f * minCableThickness)).toNearestInt();
-        MessageManager::callAsync (
-            [safeComp = Component::SafePointer (this), cableBounds]
-            {
-                if (auto* comp = safeComp.getComponent())
-                    comp->repaint (cableBounds);
-            });
+        frameScheduler->markDirty (*this, cableBounds);
     };
 
     if (force || connectionInfo.endProc == nullptr)
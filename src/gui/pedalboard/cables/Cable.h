@@ -3,6 +3,7 @@
 #include "../editors/ProcessorEditor.h"
 #include "CableDrawingHelpers.h"
 #include "CubicBezier.h"
+#include "gui/utils/FrameScheduler.h"
 #include "processors/BaseProcessor.h"
 #include <pch.h>
 
@@ -36,6 +37,7 @@ private:
     const BoardComponent* board = nullptr;
 
     chowdsp::PopupMenuHelper popupMenu;
+    SharedResourcePointer<FrameScheduler> frameScheduler;
 
     Path cablePath {};
     int numPointsInPath = 0;
@@ -4,10 +4,10 @@
 #include "CableViewConnectionHelper.h"
 #include "CableViewPortLocationHelper.h"
 
-CableView::CableView (BoardComponent& comp) : board (comp), pathTask (*this)
+CableView::CableView (BoardComponent& comp) : board (comp)
 {
     setInterceptsMouseClicks (false, true);
-    startTimerHz (36);
+    startFrameCallbacks (FrameScheduler::frameRateHz);
 
     connectionHelper = std::make_unique<CableViewConnectionHelper> (*this, comp);
     portLocationHelper = std::make_unique<CableViewPortLocationHelper> (*this);
@@ -152,26 +152,35 @@ void CableView::mouseUp (const MouseEvent& e)
     }
 }
 
-void CableView::timerCallback()
+void CableView::frameCallback()
 {
     TRACE_COMPONENT();
 
     using namespace CableDrawingHelpers;
 
-    // repaint port glow
-    if (mouseDraggingOverOutputPort() || mouseOverClickablePort())
+    // repaint port glow (only if the mouse has moved, or a cable is being dragged)
+    if (isDraggingCable || mousePosition != lastFrameMousePosition)
     {
-        portGlow = true;
-        repaint (getPortGlowBounds (portToPaint, scaleFactor).toNearestInt());
-    }
-    else if (portGlow)
-    {
-        portGlow = false;
-        repaint (getPortGlowBounds (portToPaint, scaleFactor).toNearestInt());
+        lastFrameMousePosition = mousePosition;
+
+        const auto prevPortToPaint = portToPaint;
+        const auto prevPortGlow = std::exchange (portGlow, mouseDraggingOverOutputPort() || mouseOverClickablePort());
+        if (prevPortGlow && (! portGlow || portToPaint != prevPortToPaint))
+            frameScheduler->markDirty (*this, getPortGlowBounds (prevPortToPaint, scaleFactor).toNearestInt());
+        if (portGlow && (! prevPortGlow || portToPaint != prevPortToPaint))
+            frameScheduler->markDirty (*this, getPortGlowBounds (portToPaint, scaleFactor).toNearestInt());
     }
 
+    ScopedLock sl (cableMutex);
     if (isDraggingCable)
+    {
         updateCablePositions();
+        if (! cables.isEmpty())
+            frameScheduler->markDirty (*cables.getLast());
+    }
+
+    for (auto* cable : cables)
+        cable->repaintIfNeeded();
 }
 
 void CableView::processorBeingAdded (BaseProcessor* newProc)
@@ -184,20 +193,6 @@ void CableView::processorBeingRemoved (const BaseProcessor* proc)
     connectionHelper->processorBeingRemoved (proc);
 }
 
-//================================================================
-CableView::PathGeneratorTask::PathGeneratorTask (CableView& cv) : cableView (cv)
-{
-    sharedTimeSliceThread->addTimeSliceClient (this);
-
-    if (! sharedTimeSliceThread->isThreadRunning())
-        sharedTimeSliceThread->startThread();
-}
-
-CableView::PathGeneratorTask::~PathGeneratorTask()
-{
-    sharedTimeSliceThread->removeTimeSliceClient (this);
-}
-
 void CableView::updateCablePositions()
 {
     for (auto* cable : cables)
@@ -206,26 +201,3 @@ void CableView::updateCablePositions()
         cable->updateEndPoint();
     }
 }
-
-int CableView::PathGeneratorTask::useTimeSlice()
-{
-    if (cableView.cableBeingDragged())
-    {
-        MessageManager::callAsync (
-            [safeCableView = Component::SafePointer (&cableView)]
-            {
-                if (auto* cv = safeCableView.getComponent())
-                {
-                    ScopedLock sl (cv->cableMutex);
-                    if (! cv->cables.isEmpty())
-                        cv->cables.getLast()->repaint();
-                }
-            });
-    }
-
-    ScopedLock sl (cableView.cableMutex);
-    for (auto* cable : cableView.cables)
-        cable->repaintIfNeeded();
-
-    return 18; // a little less than 60 frames / second
-}
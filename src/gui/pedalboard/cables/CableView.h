@@ -2,12 +2,13 @@
 
 #include "../editors/ProcessorEditor.h"
 #include "Cable.h"
+#include "gui/utils/FrameScheduler.h"
 
 class BoardComponent;
 class CableViewConnectionHelper;
 class CableViewPortLocationHelper;
 class CableView : public Component,
-                  private Timer
+                  private FrameScheduler::Client
 {
 public:
     explicit CableView (BoardComponent& comp);
@@ -39,7 +40,7 @@ public:
     };
 
 private:
-    void timerCallback() override;
+    void frameCallback() override;
 
     const BoardComponent& board;
     OwnedArray<Cable> cables;
@@ -47,6 +48,7 @@ private:
     float scaleFactor = 1.0f;
     bool isDraggingCable = false;
     std::optional<juce::Point<int>> mousePosition;
+    std::optional<juce::Point<int>> lastFrameMousePosition;
 
     friend class CableViewConnectionHelper;
     std::unique_ptr<CableViewConnectionHelper> connectionHelper;
@@ -63,24 +65,5 @@ private:
 
     bool portGlow = false;
 
-    struct PathGeneratorTask : juce::TimeSliceClient
-    {
-    public:
-        explicit PathGeneratorTask (CableView& cv);
-        ~PathGeneratorTask() override;
-
-        int useTimeSlice() override;
-
-    private:
-        struct TimeSliceThread : juce::TimeSliceThread
-        {
-            TimeSliceThread() : juce::TimeSliceThread ("Cable Drawing Background Thread") {}
-        };
-
-        juce::SharedResourcePointer<TimeSliceThread> sharedTimeSliceThread;
-
-        CableView& cableView;
-    } pathTask;
-
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CableView)
 };
@@ -0,0 +1,95 @@
+#include "ProcessorCPUOverlay.h"
+
+namespace CPUOverlayConstants
+{
+constexpr int refreshRateHz = 4;
+const int numTicksPerLoadWindow = FrameScheduler::getCallbackRateHz (refreshRateHz); // ~1 second
+} // namespace CPUOverlayConstants
+
+ProcessorCPUOverlay::ProcessorCPUOverlay (BaseProcessor& processor) : proc (processor)
+{
+    setInterceptsMouseClicks (false, false);
+
+    pluginSettings->addProperties<&ProcessorCPUOverlay::globalSettingChanged> ({ { showModuleCPUUsageID, false } }, *this);
+    globalSettingChanged (showModuleCPUUsageID);
+}
+
+ProcessorCPUOverlay::~ProcessorCPUOverlay()
+{
+    pluginSettings->removePropertyListener (*this);
+}
+
+void ProcessorCPUOverlay::globalSettingChanged (SettingID settingID)
+{
+    if (settingID != showModuleCPUUsageID)
+        return;
+
+    const auto shouldShow = pluginSettings->getProperty<bool> (showModuleCPUUsageID);
+    setVisible (shouldShow);
+
+    if (shouldShow)
+    {
+        frameCallback();
+        startFrameCallbacks (CPUOverlayConstants::refreshRateHz);
+    }
+    else
+    {
+        stopFrameCallbacks();
+    }
+}
+
+void ProcessorCPUOverlay::resetStats()
+{
+    proc.getTimingStats().requestReset();
+    prevProcessingNanos = 0;
+    prevRealTimeNanos = 0;
+}
+
+void ProcessorCPUOverlay::frameCallback()
+{
+    const auto stats = proc.getTimingStats().getSnapshot();
+    isSleeping = proc.isSleeping();
+
+    // measure the load over a short window, so that the overlay reacts to changes quickly
+    const auto deltaProcessingNanos = stats.totalProcessingNanoseconds - prevProcessingNanos;
+    const auto deltaRealTimeNanos = stats.totalRealTimeNanoseconds - prevRealTimeNanos;
+    if (deltaRealTimeNanos > 0 && deltaProcessingNanos >= 0)
+    {
+        const auto newLoad = (double) deltaProcessingNanos / (double) deltaRealTimeNanos;
+        windowLoad += (newLoad - windowLoad) / (double) CPUOverlayConstants::numTicksPerLoadWindow;
+    }
+    else if (deltaRealTimeNanos < 0) // the stats have been reset
+    {
+        windowLoad = stats.load;
+    }
+    prevProcessingNanos = stats.totalProcessingNanoseconds;
+    prevRealTimeNanos = stats.totalRealTimeNanoseconds;
+
+    // only repaint if the text we're showing (including the sleeping state) has actually changed
+    auto newLoadText = isSleeping ? String ("CPU: sleeping") : "CPU: " + String (windowLoad * 100.0, 2) + "%";
+    auto newTimesText = "avg " + String (stats.meanMicroseconds, 1)
+                        + " | p99 " + String (stats.p99Microseconds, 1)
+                        + " | max " + String (stats.maxMicroseconds, 1) + " us";
+    if (newLoadText == loadText && newTimesText == timesText)
+        return;
+
+    loadText = std::move (newLoadText);
+    timesText = std::move (newTimesText);
+    frameScheduler->markDirty (*this);
+}
+
+void ProcessorCPUOverlay::paint (Graphics& g)
+{
+    g.setColour (Colours::black.withAlpha (0.65f));
+    g.fillRoundedRectangle (getLocalBounds().toFloat(), 4.0f);
+
+    auto bounds = getLocalBounds().reduced (4, 2);
+    const auto lineHeight = bounds.getHeight() / 2;
+    g.setFont ((float) lineHeight * 0.85f);
+
+    g.setColour (isSleeping ? Colours::lightgrey : Colours::white);
+    g.drawFittedText (loadText, bounds.removeFromTop (lineHeight), Justification::centredLeft, 1);
+
+    g.setColour (Colours::white);
+    g.drawFittedText (timesText, bounds, Justification::centredLeft, 1);
+}
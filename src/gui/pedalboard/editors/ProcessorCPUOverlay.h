@@ -0,0 +1,43 @@
+#pragma once
+
+#include "gui/utils/FrameScheduler.h"
+#include "processors/BaseProcessor.h"
+
+/**
+ * Overlay for a processor editor, showing how much CPU the processor is using.
+ *
+ * The load is measured over the last second or so, while the average, 99th
+ * percentile, and max processing times are measured since the stats were last reset.
+ */
+class ProcessorCPUOverlay : public Component,
+                            private FrameScheduler::Client
+{
+public:
+    explicit ProcessorCPUOverlay (BaseProcessor& processor);
+    ~ProcessorCPUOverlay() override;
+
+    void paint (Graphics& g) override;
+    void frameCallback() final;
+
+    void resetStats();
+
+    using SettingID = chowdsp::GlobalPluginSettings::SettingID;
+    static constexpr SettingID showModuleCPUUsageID = "show_module_cpu_usage";
+
+private:
+    void globalSettingChanged (SettingID settingID);
+
+    BaseProcessor& proc;
+
+    double windowLoad = 0.0;
+    int64_t prevProcessingNanos = 0;
+    int64_t prevRealTimeNanos = 0;
+    bool isSleeping = false;
+
+    String loadText;
+    String timesText;
+
+    chowdsp::SharedPluginSettings pluginSettings;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ProcessorCPUOverlay)
+};
@@ -19,7 +19,8 @@ ProcessorEditor::ProcessorEditor (BaseProcessor& baseProc,
                                                                                               contrastColour,
                                                                                               procUI.powerColour,
                                                                                               hostContextProvider),
-                                                                                       powerButton (procUI.powerColour)
+                                                                                       powerButton (procUI.powerColour),
+                                                                                       cpuOverlay (baseProc)
 {
     addAndMakeVisible (knobs);
     setBroughtToFrontOnMouseClick (true);
@@ -72,6 +73,8 @@ ProcessorEditor::ProcessorEditor (BaseProcessor& baseProc,
         addAndMakeVisible (newPort);
     }
 
+    addChildComponent (cpuOverlay);
+
     for (int i = 0; i < proc.getNumInputs(); ++i)
         toggleParamsEnabledOnInputConnectionChange (i, false);
 
@@ -118,6 +121,10 @@ void ProcessorEditor::processorSettingsCallback (PopupMenu& menu, PopupMenu::Opt
     menu.addItem ("Info", [this]
                   { showInfoCompBroadcaster (proc); });
 
+    if (cpuOverlay.isVisible())
+        menu.addItem ("Reset CPU Stats", [this]
+                      { cpuOverlay.resetStats(); });
+
     menu.setLookAndFeel (lnfAllocator->getLookAndFeel<ProcessorLNF>());
     options = options
                   .withParentComponent (getParentComponent())
@@ -196,6 +203,7 @@ void ProcessorEditor::resized()
     const auto knobsPad = proportionOfWidth (0.015f);
     auto nameHeight = proportionOfHeight (0.167f);
     knobs.setBounds (knobsPad, nameHeight, width - 2 * knobsPad, height - (nameHeight + knobsPad));
+    cpuOverlay.setBounds (getLocalBounds().reduced (knobsPad).removeFromBottom (proportionOfHeight (0.22f)));
 
     bool isIOProcessor = typeid (proc) == typeid (InputProcessor) || typeid (proc) == typeid (OutputProcessor);
     if (! isIOProcessor)
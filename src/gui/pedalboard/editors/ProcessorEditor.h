@@ -3,6 +3,7 @@
 #include "KnobsComponent.h"
 #include "Port.h"
 #include "PowerButton.h"
+#include "ProcessorCPUOverlay.h"
 #include "processors/chain/ProcessorChain.h"
 
 class ProcessorEditor : public Component
@@ -58,6 +59,8 @@ private:
 
     DrawableButton settingsButton { "Settings", DrawableButton::ImageFitted };
 
+    ProcessorCPUOverlay cpuOverlay;
+
     chowdsp::ScopedCallback uiOptionsChangedCallback;
 
     chowdsp::SharedLNFAllocator lnfAllocator;
@@ -1,6 +1,7 @@
 #include "SettingsButton.h"
 #include "BYOD.h"
 #include "gui/pedalboard/BoardViewport.h"
+#include "gui/pedalboard/editors/ProcessorCPUOverlay.h"
 #include "processors/chain/ProcessorChainPortMagnitudesHelper.h"
 #include "state/ParamForwardManager.h"
 
@@ -63,6 +64,11 @@ void SettingsButton::showSettingsMenu()
 
     defaultZoomMenu (menu, 400);
     addPluginSettingMenuOption ("Show Port Tooltips", BoardViewport::portTooltipsSettingID, menu, 500);
+    addPluginSettingMenuOption ("Multi-Core Processing", ProcessorChain::parallelProcessingID, menu, 600);
+    mathsQualityMenu (menu, 800);
+
+    if (pluginSettings->hasProperty (ProcessorCPUOverlay::showModuleCPUUsageID))
+        addPluginSettingMenuOption ("Show Module CPU Usage", ProcessorCPUOverlay::showModuleCPUUsageID, menu, 700);
 
     menu.addSeparator();
     menu.addItem ("User Manual", []
@@ -109,6 +115,28 @@ void SettingsButton::defaultZoomMenu (PopupMenu& menu, int itemID)
     menu.addSubMenu ("Default Zoom", defaultZoomMenu);
 }
 
+void SettingsButton::mathsQualityMenu (PopupMenu& menu, int itemID)
+{
+    PopupMenu mathsQualityMenu;
+
+    const auto curMathsQuality = pluginSettings->getProperty<int> (ProcessorChain::mathsQualityID);
+    for (const auto& [quality, name] : { std::make_pair (MathsQuality::Eco, "Eco (Less CPU)"),
+                                         std::make_pair (MathsQuality::Normal, "Normal"),
+                                         std::make_pair (MathsQuality::High, "High (More Accurate)") })
+    {
+        PopupMenu::Item item;
+        item.itemID = ++itemID;
+        item.text = name;
+        item.action = [this, quality = quality]
+        { pluginSettings->setProperty (ProcessorChain::mathsQualityID, (int) quality); };
+        item.colour = curMathsQuality == (int) quality ? SettingsColours::onColour : SettingsColours::offColour;
+
+        mathsQualityMenu.addItem (item);
+    }
+
+    menu.addSubMenu ("Drive Model Quality", mathsQualityMenu);
+}
+
 void SettingsButton::copyDiagnosticInfo()
 {
     Logger::writeToLog ("Copying diagnostic info...");
@@ -19,6 +19,7 @@ public:
 private:
     void showSettingsMenu();
     void defaultZoomMenu (PopupMenu& menu, int itemID);
+    void mathsQualityMenu (PopupMenu& menu, int itemID);
     void copyDiagnosticInfo();
     void addPluginSettingMenuOption (const String& name, const SettingID& id, PopupMenu& menu, int itemID);
 
@@ -1,55 +1,355 @@
 #include "PresetSearchHelpers.h"
+#include "processors/utility/InputProcessor.h"
+#include "processors/utility/OutputProcessor.h"
+#include "state/presets/FactoryPresets.h"
 
 namespace preset_search
 {
-static std::string_view to_string_view (const juce::String& str) noexcept
+namespace
 {
-    return { str.toRawUTF8(), str.getNumBytesAsUTF8() };
+    const juce::Identifier tagsTag { "tags" };
+    const juce::String paramType { "PARAM" };
+    const juce::String onOffParamID { "on_off" };
+
+    constexpr std::array<float, numPresetSearchFields> fieldWeights {
+        1.0f, // Name
+        0.9f, // Vendor
+        1.0f, // Category
+        0.8f, // Modules
+        0.5f, // Parameters
+        0.9f, // Tags
+    };
+
+    // word matches are scored by how closely they match
+    constexpr float exactMatchScore = 1.0f;
+    constexpr float prefixMatchScore = 0.9f;
+    constexpr float substringMatchScore = 0.75f;
+    constexpr float fuzzyMatchScore = 0.6f;
+    constexpr float fuzzyMatchThreshold = 0.5f;
+
+    std::string_view to_string_view (const juce::String& str) noexcept
+    {
+        return { str.toRawUTF8(), str.getNumBytesAsUTF8() };
+    }
+
+    bool isWordChar (char c) noexcept
+    {
+        // treat any non-ASCII (UTF-8) bytes as part of a word
+        return (static_cast<unsigned char> (c) & 0x80) != 0 || std::isalnum (static_cast<unsigned char> (c));
+    }
+
+    void splitWords (std::string_view text, std::vector<std::string>& words)
+    {
+        size_t wordStart = 0;
+        while (wordStart < text.size())
+        {
+            while (wordStart < text.size() && ! isWordChar (text[wordStart]))
+                ++wordStart;
+
+            auto wordEnd = wordStart;
+            while (wordEnd < text.size() && isWordChar (text[wordEnd]))
+                ++wordEnd;
+
+            if (wordEnd > wordStart)
+            {
+                auto& word = words.emplace_back (text.substr (wordStart, wordEnd - wordStart));
+                for (auto& c : word)
+                    c = (char) std::tolower (static_cast<unsigned char> (c));
+            }
+
+            wordStart = wordEnd;
+        }
+    }
+
+    /** Used to check if a preset state has changed since it was indexed. */
+    juce::int64 getStateHash (const juce::XmlElement* state)
+    {
+        if (state == nullptr)
+            return 0;
+
+        return state->toString (juce::XmlElement::TextFormat().singleLine().withoutHeader()).hashCode64();
+    }
+
+    std::vector<uint32_t> getTrigrams (std::string_view word)
+    {
+        std::vector<uint32_t> wordTrigrams;
+        for (size_t i = 0; i + 3 <= word.size(); ++i)
+        {
+            wordTrigrams.push_back (((uint32_t) (uint8_t) word[i] << 16)
+                                    | ((uint32_t) (uint8_t) word[i + 1] << 8)
+                                    | (uint32_t) (uint8_t) word[i + 2]);
+        }
+
+        std::sort (wordTrigrams.begin(), wordTrigrams.end());
+        wordTrigrams.erase (std::unique (wordTrigrams.begin(), wordTrigrams.end()), wordTrigrams.end());
+        return wordTrigrams;
+    }
+} // namespace
+
+Index::Words Index::getPresetWords (const chowdsp::Preset& preset)
+{
+    Words words;
+    splitWords (to_string_view (preset.getName()), words[Name]);
+    splitWords (to_string_view (preset.getVendor()), words[Vendor]);
+    splitWords (to_string_view (preset.getCategory()), words[Category]);
+    splitWords (to_string_view (preset.extraInfo.getStringAttribute (tagsTag)), words[Tags]);
+
+    if (const auto* state = preset.getState())
+    {
+        for (const auto* procXml : state->getChildIterator())
+        {
+            const auto procName = procXml->getTagName().replaceCharacter ('_', ' ');
+            if (procName == chowdsp::toString (InputProcessor::name) || procName == chowdsp::toString (OutputProcessor::name))
+                continue;
+
+            splitWords (to_string_view (procName), words[Modules]);
+
+            const auto* paramsXml = procXml->getChildByName ("Parameters");
+            if (paramsXml == nullptr)
+                continue;
+
+            if (const auto* onOffXml = paramsXml->getChildByAttribute ("id", onOffParamID); onOffXml != nullptr && onOffXml->getDoubleAttribute ("value") < 0.5)
+                continue;
+
+            for (const auto* paramXml : paramsXml->getChildWithTagNameIterator (paramType))
+            {
+                const auto paramID = paramXml->getStringAttribute ("id");
+                if (paramID != onOffParamID)
+                    splitWords (to_string_view (paramID.replaceCharacter ('_', ' ')), words[Parameters]);
+            }
+        }
+    }
+
+    // the factory presets are listed with placeholder states that don't have any parameters,
+    // so their parameters come from the factory presets table instead
+    if (const auto* factoryPresetInfo = FactoryPresets::getFactoryPresetInfo (preset.getState()))
+    {
+        for (const auto* paramID : factoryPresetInfo->parameterIDs)
+            splitWords (paramID, words[Parameters]);
+    }
+
+    // each word only needs to be indexed once per field
+    for (auto& fieldWords : words)
+    {
+        std::sort (fieldWords.begin(), fieldWords.end());
+        fieldWords.erase (std::unique (fieldWords.begin(), fieldWords.end()), fieldWords.end());
+    }
+
+    return words;
 }
 
-void initialiseDatabase (const chowdsp::PresetManager& presetManager, Database& database)
+void Index::addWord (const std::string& word, Posting posting)
 {
-    enum SearchFields
+    auto [wordIter, isNewWord] = vocabulary.try_emplace (word);
+    wordIter->second.push_back (posting);
+
+    if (isNewWord)
     {
-        Name = 0,
-        Vendor,
-        Category,
-        // TODO: maybe add a field for the processors present in the preset?
-    };
+        for (auto trigram : getTrigrams (word))
+            trigrams[trigram].push_back (wordIter->first);
+    }
+}
 
-    juce::Logger::writeToLog ("Initializing preset search database...");
+void Index::removeWord (const std::string& word, Posting posting)
+{
+    const auto wordIter = vocabulary.find (word);
+    if (wordIter == vocabulary.end())
+    {
+        jassertfalse;
+        return;
+    }
 
-    database.resetEntries (presetManager.getNumPresets());
-    database.setWeights ({
-        1.0f, // Name
-        0.9f, // Vendor
-        1.0f, // Category
-    });
-    database.setThreshold (0.5f);
+    auto& postings = wordIter->second;
+    std::erase_if (postings, [posting] (const Posting& p)
+                   { return p.key == posting.key && p.field == posting.field; });
+    if (! postings.empty())
+        return;
+
+    for (auto trigram : getTrigrams (word))
+    {
+        if (auto trigramIter = trigrams.find (trigram); trigramIter != trigrams.end())
+        {
+            std::erase (trigramIter->second, std::string_view { wordIter->first });
+            if (trigramIter->second.empty())
+                trigrams.erase (trigramIter);
+        }
+    }
+    vocabulary.erase (wordIter);
+}
+
+void Index::addPreset (int key, const chowdsp::Preset& preset)
+{
+    removePreset (key);
+
+    auto& indexedPreset = presets[key];
+    indexedPreset.words = getPresetWords (preset);
+    indexedPreset.name = preset.getName();
+    indexedPreset.vendor = preset.getVendor();
+    indexedPreset.category = preset.getCategory();
+    indexedPreset.tags = preset.extraInfo.getStringAttribute (tagsTag);
+    indexedPreset.stateHash = getStateHash (preset.getState());
 
+    for (size_t field = 0; field < numPresetSearchFields; ++field)
+    {
+        for (const auto& word : indexedPreset.words[field])
+            addWord (word, { key, (Field) field });
+    }
+}
+
+void Index::removePreset (int key)
+{
+    const auto presetIter = presets.find (key);
+    if (presetIter == presets.end())
+        return;
+
+    for (size_t field = 0; field < numPresetSearchFields; ++field)
+    {
+        for (const auto& word : presetIter->second.words[field])
+            removeWord (word, { key, (Field) field });
+    }
+    presets.erase (presetIter);
+}
+
+void Index::update (const chowdsp::PresetManager& presetManager)
+{
     const auto t1 = std::chrono::steady_clock::now();
-    std::array<std::string_view, numPresetSearchFields> fields {};
 
-    for (const auto& [presetID, preset] : presetManager.getPresetMap())
+    const auto& presetMap = presetManager.getPresetMap();
+    for (auto iter = presets.begin(); iter != presets.end();)
+    {
+        const auto key = (iter++)->first;
+        if (! presetMap.contains (key))
+            removePreset (key);
+    }
+
+    int numPresetsIndexed = 0;
+    for (const auto& [key, preset] : presetMap)
     {
-        fields[Name] = to_string_view (preset.getName());
-        fields[Vendor] = to_string_view (preset.getVendor());
-        fields[Category] = to_string_view (preset.getCategory());
-        database.addEntry (presetID, fields);
+        if (const auto indexedIter = presets.find (key); indexedIter != presets.end())
+        {
+            const auto& indexedPreset = indexedIter->second;
+            if (indexedPreset.name == preset.getName()
+                && indexedPreset.vendor == preset.getVendor()
+                && indexedPreset.category == preset.getCategory()
+                && indexedPreset.tags == preset.extraInfo.getStringAttribute (tagsTag)
+                && indexedPreset.stateHash == getStateHash (preset.getState()))
+                continue;
+        }
+
+        addPreset (key, preset);
+        numPresetsIndexed++;
     }
 
     const auto t2 = std::chrono::steady_clock::now();
     std::chrono::duration<double, std::milli> fp_ms = t2 - t1;
-    juce::Logger::writeToLog ("Finished scanning preset database in "
+    juce::Logger::writeToLog ("Updated preset search index (" + juce::String { numPresetsIndexed } + " presets re-indexed) in "
                               + juce::String { fp_ms.count() }
                               + " milliseconds");
+}
+
+void Index::clear()
+{
+    presets.clear();
+    vocabulary.clear();
+    trigrams.clear();
+}
+
+std::vector<Result> Index::search (std::string_view query) const
+{
+    std::vector<std::string> queryWords;
+    splitWords (query, queryWords);
+    if (queryWords.empty())
+        return {};
+
+    std::unordered_map<int, float> totalScores;
+    std::unordered_map<int, float> queryWordScores;
+    std::unordered_map<const std::string*, float> wordScores;
+    std::unordered_map<std::string_view, int> sharedTrigramCounts;
+    for (size_t queryWordIndex = 0; queryWordIndex < queryWords.size(); ++queryWordIndex)
+    {
+        const auto& queryWord = queryWords[queryWordIndex];
+
+        // find the words in the vocabulary that match this query word
+        wordScores.clear();
+        for (auto iter = vocabulary.lower_bound (queryWord); iter != vocabulary.end() && iter->first.starts_with (queryWord); ++iter)
+            wordScores[&iter->first] = iter->first.size() == queryWord.size() ? exactMatchScore : prefixMatchScore;
+
+        if (const auto queryTrigrams = getTrigrams (queryWord); ! queryTrigrams.empty())
+        {
+            sharedTrigramCounts.clear();
+            for (auto trigram : queryTrigrams)
+            {
+                if (const auto trigramIter = trigrams.find (trigram); trigramIter != trigrams.end())
+                {
+                    for (const auto& word : trigramIter->second)
+                        sharedTrigramCounts[word]++;
+                }
+            }
+
+            for (const auto& [word, numSharedTrigrams] : sharedTrigramCounts)
+            {
+                const auto& vocabularyWord = vocabulary.find (word)->first;
+                if (wordScores.contains (&vocabularyWord))
+                    continue;
+
+                if (vocabularyWord.find (queryWord) != std::string::npos)
+                {
+                    wordScores[&vocabularyWord] = substringMatchScore;
+                    continue;
+                }
+
+                const auto numWordTrigrams = (int) vocabularyWord.size() - 2;
+                const auto similarity = 2.0f * (float) numSharedTrigrams / (float) (numWordTrigrams + (int) queryTrigrams.size());
+                if (similarity >= fuzzyMatchThreshold)
+                    wordScores[&vocabularyWord] = fuzzyMatchScore * similarity;
+            }
+        }
+
+        // score each preset by its best match for this query word
+        queryWordScores.clear();
+        for (const auto& [word, wordScore] : wordScores)
+        {
+            for (const auto& posting : vocabulary.find (*word)->second)
+            {
+                auto& presetScore = queryWordScores[posting.key];
+                presetScore = std::max (presetScore, wordScore * fieldWeights[posting.field]);
+            }
+        }
+
+        // a preset needs to match every word in the query
+        if (queryWordIndex == 0)
+        {
+            totalScores = queryWordScores;
+            continue;
+        }
+
+        for (auto iter = totalScores.begin(); iter != totalScores.end();)
+        {
+            if (const auto scoreIter = queryWordScores.find (iter->first); scoreIter != queryWordScores.end())
+            {
+                iter->second += scoreIter->second;
+                ++iter;
+            }
+            else
+            {
+                iter = totalScores.erase (iter);
+            }
+        }
+    }
+
+    std::vector<Result> results;
+    results.reserve (totalScores.size());
+    for (const auto& [key, score] : totalScores)
+        results.push_back ({ key, score / (float) queryWords.size() });
 
-    database.prepareForSearch();
+    std::sort (results.begin(), results.end(), [] (const Result& r1, const Result& r2)
+               { return r1.score != r2.score ? r1.score > r2.score : r1.key < r2.key; });
+    return results;
 }
 
-Results getSearchResults (const chowdsp::PresetManager& presetManager, const Database& database, const juce::String& query)
+Results getSearchResults (const chowdsp::PresetManager& presetManager, const Index& index, const juce::String& query)
 {
-    const auto searchResults = database.search (to_string_view (query));
+    const auto searchResults = index.search (to_string_view (query));
 
     Results resultsVector;
     resultsVector.reserve (searchResults.size());
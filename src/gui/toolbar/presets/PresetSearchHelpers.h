@@ -4,10 +4,83 @@
 
 namespace preset_search
 {
-static constexpr size_t numPresetSearchFields = 3;
-using Database = chowdsp::SearchDatabase<int, numPresetSearchFields>;
-using Results = std::vector<const chowdsp::Preset*>;
+enum Field : uint8_t
+{
+    Name = 0,
+    Vendor,
+    Category,
+    Modules, // the modules used in the preset
+    Parameters, // the parameters of the (enabled) modules in the preset
+    Tags, // from the "tags" attribute in the preset's extra info
+};
+static constexpr size_t numPresetSearchFields = 6;
+
+struct Result
+{
+    int key;
+    float score;
+};
+
+/**
+ * A search index for the presets, which supports prefix lookup, as well as
+ * substring and fuzzy matching using trigrams.
+ *
+ * Each field of a preset is split into lower-case words. The index keeps a
+ * sorted vocabulary of every word (for prefix lookup), along with the trigrams
+ * of each word, so a search only needs to look at the words in the vocabulary,
+ * rather than every preset. Every word in the query must match a word in the
+ * preset for the preset to be included in the results.
+ *
+ * Presets can be added, removed, or re-indexed one at a time, so the index only
+ * needs to be built once.
+ */
+class Index
+{
+public:
+    Index() = default;
+
+    /** Adds a preset to the index, replacing any preset that was previously indexed with this key. */
+    void addPreset (int key, const chowdsp::Preset& preset);
+
+    /** Removes a preset from the index. */
+    void removePreset (int key);
+
+    /** Re-indexes any presets that have been added, removed, or changed in the preset manager since the last update. */
+    void update (const chowdsp::PresetManager& presetManager);
 
-void initialiseDatabase (const chowdsp::PresetManager& presetManager, Database& database);
-Results getSearchResults (const chowdsp::PresetManager& presetManager, const Database& database, const juce::String& query);
+    void clear();
+    size_t getNumPresets() const noexcept { return presets.size(); }
+
+    /** Returns the matching presets, sorted by score. */
+    std::vector<Result> search (std::string_view query) const;
+
+private:
+    using Words = std::array<std::vector<std::string>, numPresetSearchFields>;
+    static Words getPresetWords (const chowdsp::Preset& preset);
+
+    struct Posting
+    {
+        int key;
+        Field field;
+    };
+
+    struct IndexedPreset
+    {
+        Words words;
+        juce::String name, vendor, category, tags;
+        juce::int64 stateHash = 0; // the preset state can be changed in place, so we compare the contents
+    };
+
+    void addWord (const std::string& word, Posting posting);
+    void removeWord (const std::string& word, Posting posting);
+
+    std::map<int, IndexedPreset> presets;
+    std::map<std::string, std::vector<Posting>, std::less<>> vocabulary;
+    std::unordered_map<uint32_t, std::vector<std::string_view>> trigrams;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Index)
+};
+
+using Results = std::vector<const chowdsp::Preset*>;
+Results getSearchResults (const chowdsp::PresetManager& presetManager, const Index& index, const juce::String& query);
 } // namespace preset_search
@@ -136,16 +136,16 @@ void PresetSearchWindow::resized()
     numResultsLabel.setBounds (footer.reduced (10, 1));
 }
 
-void PresetSearchWindow::updatePresetSearchDatabase()
+void PresetSearchWindow::updatePresetSearchIndex()
 {
-    preset_search::initialiseDatabase (presetManager, searchDatabase);
+    searchIndex.update (presetManager);
     searchEntryBox->setText ({}, juce::sendNotification);
     updateSearchResults ({});
 }
 
 void PresetSearchWindow::updateSearchResults (const String& searchQuery)
 {
-    resultsBoxModel = std::make_unique<ResultsListModel> (preset_search::getSearchResults (presetManager, searchDatabase, searchQuery));
+    resultsBoxModel = std::make_unique<ResultsListModel> (preset_search::getSearchResults (presetManager, searchIndex, searchQuery));
     resultsBox.setModel (resultsBoxModel.get());
     numResultsLabel.setText ("Found: " + String (resultsBoxModel->getNumRows()) + " presets", sendNotificationSync);
 
@@ -12,13 +12,13 @@ public:
     void paint (Graphics& g) override;
     void resized() override;
 
-    void updatePresetSearchDatabase();
+    void updatePresetSearchIndex();
 
 private:
     void updateSearchResults (const String& searchQuery);
 
     chowdsp::PresetManager& presetManager;
-    preset_search::Database searchDatabase;
+    preset_search::Index searchIndex;
 
     struct SearchLabel;
     std::unique_ptr<SearchLabel> searchEntryBox;
@@ -1,5 +1,6 @@
 #include "PresetsComp.h"
 #include "gui/utils/ErrorMessageView.h"
+#include "state/presets/FactoryPresets.h"
 
 PresetsComp::PresetsComp (PresetManager& presetMgr) : chowdsp::PresetsComp (presetMgr),
                                                       presetManager (presetMgr),
@@ -227,7 +228,7 @@ int PresetsComp::addBasicPresetOptions (PopupMenu* menu, int optionID)
                               "Search",
                               [this]
                               {
-                                  searchWindow.getViewComponent().updatePresetSearchDatabase();
+                                  searchWindow.getViewComponent().updatePresetSearchIndex();
                                   searchWindow.show();
                               });
 }
@@ -240,7 +241,11 @@ int PresetsComp::addPresetShareOptions (PopupMenu* menu, int optionID)
                                   [&]
                                   {
                                       if (auto* currentPreset = manager.getCurrentPreset())
-                                          SystemClipboard::copyTextToClipboard (currentPreset->toXml()->toString());
+                                      {
+                                          const auto fullFactoryPreset = FactoryPresets::loadFullPreset (currentPreset->getState());
+                                          const auto& presetToCopy = fullFactoryPreset.has_value() ? *fullFactoryPreset : *currentPreset;
+                                          SystemClipboard::copyTextToClipboard (presetToCopy.toXml()->toString());
+                                      }
                                   });
 
     optionID = addPresetMenuItem (menu,
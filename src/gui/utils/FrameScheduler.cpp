@@ -0,0 +1,148 @@
+#include "FrameScheduler.h"
+
+namespace
+{
+// if a component has lots of small dirty regions, it's cheaper to repaint them all at once
+constexpr int maxRectanglesPerRepaint = 8;
+} // namespace
+
+FrameScheduler::~FrameScheduler()
+{
+    // all the clients hold a reference to the scheduler, so they should be gone by now!
+    jassert (std::all_of (clients.begin(), clients.end(), [] (const ClientInfo& info)
+                          { return info.client == nullptr; }));
+}
+
+int FrameScheduler::getCallbackRateHz (int refreshRateHz) noexcept
+{
+    const auto framesPerCallback = jmax (1, roundToInt ((double) frameRateHz / (double) refreshRateHz));
+    return frameRateHz / framesPerCallback;
+}
+
+void FrameScheduler::addClient (Client* client, int refreshRateHz)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+    jassert (refreshRateHz > 0);
+
+    ClientInfo info;
+    info.client = client;
+    info.framesPerCallback = jmax (1, roundToInt ((double) frameRateHz / (double) refreshRateHz));
+
+    // spread the clients out over different frames, so they don't all do their work at once
+    info.framesUntilCallback = (int) clients.size() % info.framesPerCallback;
+
+    clients.push_back (info);
+
+    if (! isTimerRunning())
+        startTimerHz (frameRateHz);
+}
+
+void FrameScheduler::removeClient (Client* client)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    // Clients can be removed during the frame callbacks, in which case we just clear them
+    // here, and leave the actual removal until after the callbacks have finished.
+    if (! isCallingClients)
+    {
+        std::erase_if (clients, [client] (const ClientInfo& info)
+                       { return info.client == client; });
+        return;
+    }
+
+    for (auto& info : clients)
+    {
+        if (info.client == client)
+            info.client = nullptr;
+    }
+}
+
+void FrameScheduler::markDirty (Component& comp, juce::Rectangle<int> area)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    area = area.getIntersection (comp.getLocalBounds());
+    if (area.isEmpty() || ! comp.isVisible())
+        return;
+
+    auto regionIter = std::find_if (dirtyRegions.begin(), dirtyRegions.end(), [&comp] (const auto& region)
+                                    { return region.first.getComponent() == &comp; });
+    if (regionIter == dirtyRegions.end())
+    {
+        dirtyRegions.emplace_back (&comp, RectangleList<int> {});
+        regionIter = std::prev (dirtyRegions.end());
+    }
+
+    regionIter->second.addWithoutMerging (area);
+
+    if (! isTimerRunning())
+        startTimerHz (frameRateHz);
+}
+
+void FrameScheduler::timerCallback()
+{
+    // new clients might be added during the callbacks, but they won't get called until the next frame
+    const auto numClients = clients.size();
+    isCallingClients = true;
+    for (size_t i = 0; i < numClients; ++i)
+    {
+        if (clients[i].client == nullptr || --clients[i].framesUntilCallback > 0)
+            continue;
+
+        clients[i].framesUntilCallback = clients[i].framesPerCallback;
+        clients[i].client->frameCallback();
+    }
+    isCallingClients = false;
+
+    std::erase_if (clients, [] (const ClientInfo& info)
+                   { return info.client == nullptr; });
+
+    repaintDirtyRegions();
+
+    if (clients.empty())
+        stopTimer();
+}
+
+void FrameScheduler::repaintDirtyRegions()
+{
+    for (auto& [component, region] : dirtyRegions)
+    {
+        auto* comp = component.getComponent();
+        if (comp == nullptr)
+            continue;
+
+        region.consolidate();
+        if (region.getNumRectangles() > maxRectanglesPerRepaint)
+        {
+            comp->repaint (region.getBounds());
+            continue;
+        }
+
+        for (const auto& rect : region)
+            comp->repaint (rect);
+    }
+
+    dirtyRegions.clear();
+}
+
+//===================================================================
+FrameScheduler::Client::~Client()
+{
+    stopFrameCallbacks();
+}
+
+void FrameScheduler::Client::startFrameCallbacks (int refreshRateHz)
+{
+    stopFrameCallbacks();
+    frameScheduler->addClient (this, refreshRateHz);
+    isRegistered = true;
+}
+
+void FrameScheduler::Client::stopFrameCallbacks()
+{
+    if (! isRegistered)
+        return;
+
+    frameScheduler->removeClient (this);
+    isRegistered = false;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <pch.h>
+
+/**
+ * Drives all of the periodic GUI updates (modulated sliders, level meters,
+ * cables, scopes, etc.) from a single shared timer, rather than having every
+ * component wake up the message thread with its own timer.
+ *
+ * Clients are called back at (roughly) their requested refresh rate, with
+ * clients at the same rate spread out over different frames. Clients should
+ * only mark a region as dirty when something has actually changed. The dirty
+ * regions for each component are merged, and repainted together at the end
+ * of the frame.
+ *
+ * The timer only runs while there are clients, or regions to repaint.
+ */
+class FrameScheduler : private Timer
+{
+public:
+    FrameScheduler() = default;
+    ~FrameScheduler() override;
+
+    static constexpr int frameRateHz = 60;
+
+    /** Returns the rate that a client requesting the given refresh rate will actually be called back at. */
+    static int getCallbackRateHz (int refreshRateHz) noexcept;
+
+    class Client;
+
+    /** Marks a region of a component as needing to be repainted at the end of the frame. */
+    void markDirty (Component& comp, juce::Rectangle<int> area);
+
+    /** Marks a whole component as needing to be repainted at the end of the frame. */
+    void markDirty (Component& comp) { markDirty (comp, comp.getLocalBounds()); }
+
+private:
+    void addClient (Client* client, int refreshRateHz);
+    void removeClient (Client* client);
+
+    void timerCallback() override;
+    void repaintDirtyRegions();
+
+    struct ClientInfo
+    {
+        Client* client = nullptr;
+        int framesPerCallback = 1;
+        int framesUntilCallback = 0;
+    };
+    std::vector<ClientInfo> clients;
+    bool isCallingClients = false;
+
+    std::vector<std::pair<Component::SafePointer<Component>, RectangleList<int>>> dirtyRegions;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FrameScheduler)
+};
+
+/**
+ * Base class for anything that needs to be updated periodically by the
+ * FrameScheduler. This works a lot like juce::Timer, but all of the clients
+ * share the same timer.
+ */
+class FrameScheduler::Client
+{
+public:
+    Client() = default;
+    virtual ~Client();
+
+    /** Called on the message thread, once per frame at the requested refresh rate. */
+    virtual void frameCallback() = 0;
+
+    void startFrameCallbacks (int refreshRateHz);
+    void stopFrameCallbacks();
+    bool isReceivingFrameCallbacks() const noexcept { return isRegistered; }
+
+protected:
+    SharedResourcePointer<FrameScheduler> frameScheduler;
+
+private:
+    bool isRegistered = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Client)
+};
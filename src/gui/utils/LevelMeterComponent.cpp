@@ -11,16 +11,18 @@ LevelMeterComponent::LevelMeterComponent (const LevelDataType& levelData) : rmsL
                                                                             dbLevels ({ LevelMeterConstants::minDB, LevelMeterConstants::minDB }),
                                                                             dbLevelsPrev ({ 0.0f, 0.0f })
 {
-    constexpr int timerHz = 24;
+    constexpr int refreshRateHz = 24;
 
+    // the level detectors run once per frame callback, so they need to know the actual callback rate
+    const auto callbackRateHz = FrameScheduler::getCallbackRateHz (refreshRateHz);
     for (int ch = 0; ch < 2; ++ch)
     {
-        levelDetector[ch].prepare ({ (double) timerHz, 128, 2 });
+        levelDetector[ch].prepare ({ (double) callbackRateHz, 128, 2 });
         levelDetector[ch].setParameters (80.0f, 300.0f);
     }
 
-    timerCallback();
-    startTimerHz (timerHz);
+    frameCallback();
+    startFrameCallbacks (refreshRateHz);
 }
 
 juce::Rectangle<int> LevelMeterComponent::getMeterBounds() const
@@ -55,7 +57,7 @@ void LevelMeterComponent::paint (Graphics& g)
     g.fillRect (rightChBounds.withTop (getYForDB (dbLevels[1]) + yPad));
 }
 
-void LevelMeterComponent::timerCallback()
+void LevelMeterComponent::frameCallback()
 {
     bool needsRepaint = false;
     for (size_t ch = 0; ch < 2; ++ch)
@@ -70,5 +72,5 @@ void LevelMeterComponent::timerCallback()
     }
 
     if (needsRepaint)
-        repaint (getMeterBounds());
+        frameScheduler->markDirty (*this, getMeterBounds());
 }
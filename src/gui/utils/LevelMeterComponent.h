@@ -1,9 +1,9 @@
 #pragma once
 
-#include <pch.h>
+#include "FrameScheduler.h"
 
 class LevelMeterComponent : public Component,
-                            private Timer
+                            private FrameScheduler::Client
 {
 public:
     using LevelDataType = std::array<std::atomic<float>, 2>;
@@ -11,7 +11,7 @@ public:
     explicit LevelMeterComponent (const LevelDataType& levelData);
 
     void paint (Graphics& g) override;
-    void timerCallback() final;
+    void frameCallback() final;
 
 private:
     juce::Rectangle<int> getMeterBounds() const;
@@ -5,7 +5,7 @@ ModulatableSlider::ModulatableSlider (const chowdsp::FloatParameter& p, const ch
                                                                                                                    hostContextProvider (hcp)
 {
     if (hostContextProvider.supportsParameterModulation())
-        startTimerHz (32);
+        startFrameCallbacks (30);
 }
 
 void ModulatableSlider::drawRotarySlider (juce::Graphics& g, int x, int y, int width, int height, float sliderPos, float modSliderPos)
@@ -141,11 +141,11 @@ void ModulatableSlider::mouseDown (const MouseEvent& e)
     Slider::mouseDown (e);
 }
 
-void ModulatableSlider::timerCallback()
+void ModulatableSlider::frameCallback()
 {
     const auto newModulatedValue = param.getCurrentValue();
     if (std::abs (modulatedValue - newModulatedValue) < 0.01)
         return;
 
-    repaint();
+    frameScheduler->markDirty (*this);
 }
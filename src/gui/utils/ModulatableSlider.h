@@ -1,9 +1,9 @@
 #pragma once
 
-#include <pch.h>
+#include "FrameScheduler.h"
 
 class ModulatableSlider : public Slider,
-                          private Timer
+                          private FrameScheduler::Client
 {
 public:
     ModulatableSlider (const chowdsp::FloatParameter& param, const chowdsp::HostContextProvider& hostContextProvider);
@@ -16,7 +16,7 @@ public:
     std::unique_ptr<SliderAttachment> attachment;
 
 protected:
-    void timerCallback() override;
+    void frameCallback() override;
     void drawRotarySlider (juce::Graphics& g, int x, int y, int width, int height, float sliderPos, float modSliderPos);
     void drawLinearSlider (juce::Graphics& g, int x, int y, int width, int height, float sliderPos, float modSliderPos);
 
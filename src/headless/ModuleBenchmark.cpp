@@ -0,0 +1,278 @@
+#include "ModuleBenchmark.h"
+#include "tests/UnitTests.h"
+
+namespace
+{
+constexpr double warmUpSeconds = 0.25;
+constexpr double paramSweepFreqHz = 0.2;
+
+/**
+ * Generates a guitar-like test signal, using Karplus-Strong plucked strings,
+ * with a new note (at a random pitch between E2 and E5) every half-second.
+ */
+struct GuitarSignalGenerator
+{
+    explicit GuitarSignalGenerator (double sampleRate) : fs (sampleRate),
+                                                         delayLine ((size_t) (sampleRate / 70.0) + 1, 0.0f)
+    {
+    }
+
+    void process (float* data, int numSamples)
+    {
+        for (int n = 0; n < numSamples; ++n)
+        {
+            if (samplesUntilNextNote-- <= 0)
+                pluckNewNote();
+
+            const auto readIndex = (writeIndex + 1) % delayLength;
+            const auto y = delayLine[(size_t) writeIndex];
+            delayLine[(size_t) writeIndex] = decay * 0.5f * (y + delayLine[(size_t) readIndex]);
+            writeIndex = readIndex;
+
+            data[n] = y;
+        }
+    }
+
+    void pluckNewNote()
+    {
+        const auto noteNumber = 40 + rand.nextInt (37); // E2 to E5
+        delayLength = jlimit (2, (int) delayLine.size(), (int) std::round (fs / MidiMessage::getMidiNoteInHertz (noteNumber)));
+        writeIndex = 0;
+
+        const auto amplitude = 0.25f + 0.5f * rand.nextFloat();
+        for (int i = 0; i < delayLength; ++i)
+            delayLine[(size_t) i] = amplitude * (2.0f * rand.nextFloat() - 1.0f);
+
+        samplesUntilNextNote = (int) (fs * 0.5);
+    }
+
+    const double fs;
+    std::vector<float> delayLine;
+    int delayLength = 2;
+    int writeIndex = 0;
+    int samplesUntilNextNote = 0;
+    float decay = 0.996f;
+    Random rand { 0x1234 };
+};
+
+struct BenchmarkConfig
+{
+    double sampleRate;
+    int blockSize;
+    int osFactor;
+    int numChannels;
+    MathsQuality mathsQuality;
+};
+
+struct BenchmarkResult
+{
+    String moduleName;
+    BenchmarkConfig config;
+    double nsPerSample;
+    double realTimeFactor;
+    ProcessorTimingStats::Snapshot blockStats;
+};
+
+std::vector<double> parseList (const ArgumentList& args, const String& option, std::vector<double> defaultValues)
+{
+    if (! args.containsOption (option))
+        return defaultValues;
+
+    std::vector<double> values;
+    for (const auto& token : StringArray::fromTokens (args.getValueForOption (option), ",", ""))
+        values.push_back (token.getDoubleValue());
+    return values;
+}
+
+BenchmarkResult benchmarkProcessor (BaseProcessor& proc, const BenchmarkConfig& config, double numSeconds)
+{
+    const auto osSampleRate = config.sampleRate * config.osFactor;
+    const auto osBlockSize = config.blockSize * config.osFactor;
+
+    auto floatParams = std::vector<AudioParameterFloat*> {};
+    for (auto* param : proc.getParameters())
+    {
+        param->setValueNotifyingHost (param->getDefaultValue());
+        if (auto* floatParam = dynamic_cast<AudioParameterFloat*> (param))
+            floatParams.push_back (floatParam);
+    }
+
+    DSPArena arena {};
+    arena.get_memory_resource() = ProcessorChain::allocArena ((size_t) jmax (1 << 18, 16 * osBlockSize * (int) sizeof (float)));
+    MidiBuffer midi;
+    proc.arena = &arena;
+    proc.midiBuffer = &midi;
+
+    proc.prepareProcessing (osSampleRate, osBlockSize, config.osFactor, config.mathsQuality);
+
+    GuitarSignalGenerator signalGenerator { osSampleRate };
+    AudioBuffer<float> buffer { config.numChannels, osBlockSize };
+
+    const auto numWarmUpBlocks = (int) (warmUpSeconds * config.sampleRate) / config.blockSize;
+    const auto numBlocks = jmax (1, (int) (numSeconds * config.sampleRate) / config.blockSize);
+    int64_t totalNanoseconds = 0;
+    for (int i = 0; i < numWarmUpBlocks + numBlocks; ++i)
+    {
+        if (i == numWarmUpBlocks)
+        {
+            proc.getTimingStats().requestReset();
+            totalNanoseconds = 0;
+        }
+
+        // sweep the parameters slowly, with a different phase for each parameter
+        const auto time = (double) i * config.blockSize / config.sampleRate;
+        for (size_t paramIndex = 0; paramIndex < floatParams.size(); ++paramIndex)
+        {
+            const auto phase = MathConstants<double>::twoPi * (paramSweepFreqHz * time + (double) paramIndex / (double) floatParams.size());
+            floatParams[paramIndex]->setValueNotifyingHost ((float) (0.5 + 0.5 * std::sin (phase)));
+        }
+
+        // the same signal goes to every channel
+        buffer.setSize (config.numChannels, osBlockSize, false, false, true);
+        signalGenerator.process (buffer.getWritePointer (0), osBlockSize);
+        for (int ch = 1; ch < config.numChannels; ++ch)
+            buffer.copyFrom (ch, 0, buffer, 0, 0, osBlockSize);
+
+        const auto startTime = std::chrono::steady_clock::now();
+        proc.processAudioBlock (buffer);
+        totalNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now() - startTime).count();
+
+        arena.clear();
+    }
+
+    proc.midiBuffer = nullptr;
+    proc.arena = nullptr;
+    ProcessorChain::deallocArena (arena.get_memory_resource());
+
+    const auto numBaseRateSamples = (double) numBlocks * (double) config.blockSize;
+    const auto audioSeconds = numBaseRateSamples / config.sampleRate;
+    return {
+        proc.getName(),
+        config,
+        (double) totalNanoseconds / numBaseRateSamples,
+        (double) totalNanoseconds * 1.0e-9 / audioSeconds,
+        proc.getTimingStats().getSnapshot(),
+    };
+}
+
+String resultsToCSV (const std::vector<BenchmarkResult>& results)
+{
+    String csv = "module,sample_rate,block_size,os_factor,num_channels,maths_quality,ns_per_sample,real_time_factor,mean_block_us,p99_block_us,max_block_us\n";
+    for (const auto& result : results)
+    {
+        csv << result.moduleName.quoted() << ","
+            << String (result.config.sampleRate) << ","
+            << String (result.config.blockSize) << ","
+            << String (result.config.osFactor) << ","
+            << String (result.config.numChannels) << ","
+            << String ((int) result.config.mathsQuality) << ","
+            << String (result.nsPerSample, 3) << ","
+            << String (result.realTimeFactor, 6) << ","
+            << String (result.blockStats.meanMicroseconds, 3) << ","
+            << String (result.blockStats.p99Microseconds, 3) << ","
+            << String (result.blockStats.maxMicroseconds, 3) << "\n";
+    }
+    return csv;
+}
+
+String resultsToJSON (const std::vector<BenchmarkResult>& results)
+{
+    Array<var> resultsArray;
+    for (const auto& result : results)
+    {
+        auto resultObject = std::make_unique<DynamicObject>();
+        resultObject->setProperty ("module", result.moduleName);
+        resultObject->setProperty ("sample_rate", result.config.sampleRate);
+        resultObject->setProperty ("block_size", result.config.blockSize);
+        resultObject->setProperty ("os_factor", result.config.osFactor);
+        resultObject->setProperty ("num_channels", result.config.numChannels);
+        resultObject->setProperty ("maths_quality", (int) result.config.mathsQuality);
+        resultObject->setProperty ("ns_per_sample", result.nsPerSample);
+        resultObject->setProperty ("real_time_factor", result.realTimeFactor);
+        resultObject->setProperty ("mean_block_us", result.blockStats.meanMicroseconds);
+        resultObject->setProperty ("p99_block_us", result.blockStats.p99Microseconds);
+        resultObject->setProperty ("max_block_us", result.blockStats.maxMicroseconds);
+        resultsArray.add (var { resultObject.release() });
+    }
+
+    auto root = std::make_unique<DynamicObject>();
+    root->setProperty ("version", ProjectInfo::versionString);
+    root->setProperty ("results", resultsArray);
+    return JSON::toString (var { root.release() });
+}
+} // namespace
+
+ModuleBenchmark::ModuleBenchmark()
+{
+    this->commandOption = "--benchmark";
+    this->argumentDescription = "--benchmark --sample-rates=[48000,96000] --block-sizes=[64,512] --os-factors=[1,2,4] --channels=[1,2] --maths-quality=[eco|normal|high] --seconds=[SECONDS] --modules=[MODULE1,MODULE2] --format=[json|csv] --out=[FILE]";
+    this->shortDescription = "Measures the real-time factor of every module";
+    this->longDescription = "Processes a guitar-like signal through each module (while sweeping the module parameters), "
+                            "at every combination of the given sample rates, block sizes, oversampling factors, and channel counts (stereo by default). "
+                            "The results are written as JSON or CSV, to a file or to the console.";
+    this->command = [=] (const ArgumentList& args)
+    { runBenchmarks (args); };
+}
+
+void ModuleBenchmark::runBenchmarks (const ArgumentList& args)
+{
+    const auto sampleRates = parseList (args, "--sample-rates", { 48000.0, 96000.0 });
+    const auto blockSizes = parseList (args, "--block-sizes", { 64.0, 512.0 });
+    const auto osFactors = parseList (args, "--os-factors", { 1.0, 2.0, 4.0 });
+    const auto channelCounts = parseList (args, "--channels", { 2.0 });
+    for (auto numChannels : channelCounts)
+        if (numChannels != 1.0 && numChannels != 2.0)
+            ConsoleApplication::fail ("Unsupported channel count: " + String (numChannels));
+    const auto mathsQualityName = args.containsOption ("--maths-quality") ? args.getValueForOption ("--maths-quality").toLowerCase() : String { "normal" };
+    if (mathsQualityName != "eco" && mathsQualityName != "normal" && mathsQualityName != "high")
+        ConsoleApplication::fail ("Unknown maths quality: " + mathsQualityName);
+    const auto mathsQuality = mathsQualityName == "eco" ? MathsQuality::Eco : (mathsQualityName == "high" ? MathsQuality::High : MathsQuality::Normal);
+    const auto numSeconds = args.containsOption ("--seconds") ? args.getValueForOption ("--seconds").getDoubleValue() : 2.0;
+    const auto format = args.containsOption ("--format") ? args.getValueForOption ("--format").toLowerCase() : String { "json" };
+    if (format != "json" && format != "csv")
+        ConsoleApplication::fail ("Unknown output format: " + format);
+
+    StringArray modulesToSkip;
+    if (args.containsOption ("--modules"))
+    {
+        const auto modulesToRun = StringArray::fromTokens (args.getValueForOption ("--modules"), ",", "\"");
+        for (const auto& [name, storeEntry] : ProcessorStore::getStoreMap())
+            if (! modulesToRun.contains (name))
+                modulesToSkip.add (name);
+    }
+
+    std::vector<BenchmarkConfig> configs;
+    for (auto sampleRate : sampleRates)
+        for (auto blockSize : blockSizes)
+            for (auto osFactor : osFactors)
+                for (auto numChannels : channelCounts)
+                    configs.push_back ({ sampleRate, (int) blockSize, (int) osFactor, (int) numChannels, mathsQuality });
+
+    std::vector<BenchmarkResult> results;
+    runTestForAllProcessors (
+        nullptr,
+        [&] (BaseProcessor* proc)
+        {
+            for (const auto& config : configs)
+            {
+                const auto& result = results.emplace_back (benchmarkProcessor (*proc, config, numSeconds));
+                std::cerr << proc->getName() << " @ " << config.sampleRate << " Hz, " << config.blockSize << " samples, "
+                          << config.osFactor << "x OS, " << config.numChannels << " ch: " << result.nsPerSample << " ns/sample" << std::endl;
+            }
+        },
+        modulesToSkip,
+        false);
+
+    const auto resultsString = format == "csv" ? resultsToCSV (results) : resultsToJSON (results);
+    if (args.containsOption ("--out"))
+    {
+        const auto outFile = args.getFileForOption ("--out");
+        if (! outFile.replaceWithText (resultsString))
+            ConsoleApplication::fail ("Unable to write results to file: " + outFile.getFullPathName());
+        std::cerr << "Results written to " << outFile.getFullPathName() << std::endl;
+    }
+    else
+    {
+        std::cout << resultsString << std::endl;
+    }
+}
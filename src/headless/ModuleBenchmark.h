@@ -0,0 +1,15 @@
+#pragma once
+
+#include "../pch.h"
+
+class ModuleBenchmark : public ConsoleApplication::Command
+{
+public:
+    ModuleBenchmark();
+
+private:
+    /** Benchmarks every module in the processor store, at a range of sample rates, block sizes, and oversampling factors */
+    static void runBenchmarks (const ArgumentList& args);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ModuleBenchmark)
+};
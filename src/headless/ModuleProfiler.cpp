@@ -0,0 +1,68 @@
+#include "ModuleProfiler.h"
+#include "BYOD.h"
+
+ModuleProfiler::ModuleProfiler()
+{
+    this->commandOption = "--profile-modules";
+    this->argumentDescription = "--profile-modules --preset=[PRESET FILE] --seconds=[SECONDS] --block-size=[BLOCK SIZE] --sample-rate=[SAMPLE RATE]";
+    this->shortDescription = "Measures the CPU usage of each module in a preset";
+    this->longDescription = "Processes some noise through the preset (or the default preset), and prints the processing time statistics for each module";
+    this->command = [=] (const ArgumentList& args)
+    { profileModules (args); };
+}
+
+void ModuleProfiler::profileModules (const ArgumentList& args)
+{
+    const auto getOptionOrDefault = [&args] (const String& option, auto defaultValue)
+    {
+        if (! args.containsOption (option))
+            return defaultValue;
+        return (decltype (defaultValue)) args.getValueForOption (option).getDoubleValue();
+    };
+
+    const auto sampleRate = getOptionOrDefault ("--sample-rate", 48000.0);
+    const auto blockSize = getOptionOrDefault ("--block-size", 512);
+    const auto numSeconds = getOptionOrDefault ("--seconds", 10.0);
+
+    BYOD plugin;
+    if (args.containsOption ("--preset"))
+    {
+        const auto presetFile = args.getExistingFileForOption ("--preset");
+        std::cout << "Loading preset: " << presetFile.getFullPathName() << std::endl;
+        plugin.getPresetManager().loadPreset (chowdsp::Preset { presetFile });
+    }
+
+    std::cout << "Profiling modules at sample rate " << sampleRate << " Hz, with block size " << blockSize
+              << ", for " << numSeconds << " seconds of audio..." << std::endl;
+
+    plugin.prepareToPlay (sampleRate, blockSize);
+
+    chowdsp::Noise<float> noiseGenerator;
+    noiseGenerator.setGainDecibels (-12.0f);
+    noiseGenerator.setSeed (123);
+    noiseGenerator.prepare ({ sampleRate, (uint32_t) blockSize, 2 });
+
+    AudioBuffer<float> buffer { 2, blockSize };
+    MidiBuffer midi;
+    const auto numBlocks = (int) (numSeconds * sampleRate) / blockSize;
+    for (int i = 0; i < numBlocks; ++i)
+    {
+        buffer.clear();
+        auto&& block = dsp::AudioBlock<float> { buffer };
+        noiseGenerator.process (dsp::ProcessContextReplacing<float> { block });
+        plugin.processBlock (buffer, midi);
+    }
+
+    auto& procChain = plugin.getProcChain();
+    std::vector<std::pair<String, ProcessorTimingStats::Snapshot>> moduleStats;
+    moduleStats.emplace_back (procChain.getInputProcessor().getName(), procChain.getInputProcessor().getTimingStats().getSnapshot());
+    for (auto* proc : procChain.getProcessors())
+        moduleStats.emplace_back (proc->getName(), proc->getTimingStats().getSnapshot());
+    moduleStats.emplace_back (procChain.getOutputProcessor().getName(), procChain.getOutputProcessor().getTimingStats().getSnapshot());
+
+    std::sort (moduleStats.begin(), moduleStats.end(), [] (const auto& a, const auto& b)
+               { return a.second.load > b.second.load; });
+
+    for (const auto& [name, stats] : moduleStats)
+        std::cout << name << ": " << ProcessorTimingStats::toString (stats) << std::endl;
+}
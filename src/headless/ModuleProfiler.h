@@ -0,0 +1,14 @@
+#pragma once
+
+#include "../pch.h"
+
+class ModuleProfiler : public ConsoleApplication::Command
+{
+public:
+    ModuleProfiler();
+
+private:
+    static void profileModules (const ArgumentList& args);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ModuleProfiler)
+};
@@ -0,0 +1,53 @@
+#include "NeuralModelConverter.h"
+#include "processors/drive/neural_utils/ModelWeights.h"
+
+NeuralModelConverter::NeuralModelConverter()
+{
+    this->commandOption = "--convert-model";
+    this->argumentDescription = "--convert-model --in=[JSON FILE OR DIR] --out=[DIR]";
+    this->shortDescription = "Converts neural model JSON files to the binary weights format";
+    this->longDescription = "Converts each JSON model file to a .bnnw file, which can be loaded without any parsing. "
+                            "If no output directory is given, the converted files are written next to the JSON files.";
+    this->command = [=] (const ArgumentList& args)
+    { convertModels (args); };
+}
+
+void NeuralModelConverter::convertModels (const ArgumentList& args)
+{
+    if (! args.containsOption ("--in"))
+        ConsoleApplication::fail ("Please specify the model(s) to convert with --in");
+
+    const auto inputFile = args.getFileForOption ("--in");
+    auto modelFiles = inputFile.existsAsFile() ? Array<File> { inputFile } : inputFile.findChildFiles (File::findFiles, true, "*.json");
+    modelFiles.sort();
+    if (modelFiles.isEmpty())
+        ConsoleApplication::fail ("No model files found!");
+
+    const auto outputDir = args.containsOption ("--out") ? args.getFileForOption ("--out") : File {};
+    for (const auto& modelFile : modelFiles)
+    {
+        const auto outputFile = (outputDir == File {} ? modelFile.getParentDirectory() : outputDir).getChildFile (modelFile.getFileNameWithoutExtension() + ".bnnw");
+        std::cout << "Converting " << modelFile.getFullPathName() << " to " << outputFile.getFullPathName() << std::endl;
+
+        std::vector<std::byte> weightsData;
+        try
+        {
+            weightsData = ModelWeights::fromJson (chowdsp::json::parse (modelFile.loadFileAsString().toStdString()));
+        }
+        catch (const std::exception& e)
+        {
+            ConsoleApplication::fail ("Unable to convert model: " + String { e.what() });
+        }
+
+        // make sure that the converted model can actually be loaded
+        const auto weights = ModelWeights::fromData (weightsData.data(), weightsData.size());
+        if (! weights.has_value())
+            ConsoleApplication::fail ("Converted model is invalid!");
+
+        outputFile.getParentDirectory().createDirectory();
+        if (! outputFile.replaceWithData (weightsData.data(), weightsData.size()))
+            ConsoleApplication::fail ("Unable to write file: " + outputFile.getFullPathName());
+
+        std::cout << "    " << weights->getNumTensors() << " tensors, " << modelFile.getSize() << " bytes -> " << weightsData.size() << " bytes" << std::endl;
+    }
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "../pch.h"
+
+class NeuralModelConverter : public ConsoleApplication::Command
+{
+public:
+    NeuralModelConverter();
+
+private:
+    /** Converts neural model JSON files to the binary weights format */
+    static void convertModels (const ArgumentList& args);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (NeuralModelConverter)
+};
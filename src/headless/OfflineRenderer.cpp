@@ -0,0 +1,199 @@
+#include "OfflineRenderer.h"
+#include "BYOD.h"
+
+namespace
+{
+struct RenderJob
+{
+    File presetFile;
+    String presetName;
+    std::unique_ptr<BYOD> plugin;
+
+    double processingSeconds = 0.0;
+    double audioSeconds = 0.0;
+    int numFilesRendered = 0;
+    StringArray errors;
+};
+
+Array<File> findFiles (const File& fileOrDirectory, const String& wildcard)
+{
+    if (fileOrDirectory.existsAsFile())
+        return { fileOrDirectory };
+
+    auto files = fileOrDirectory.findChildFiles (File::findFiles, true, wildcard);
+    files.sort();
+    return files;
+}
+
+void setOversamplingFactor (BYOD& plugin, int osFactor)
+{
+    auto* osFactorParam = dynamic_cast<AudioParameterChoice*> (plugin.getVTS().getParameter ("os_factor"));
+    if (osFactorParam == nullptr)
+        ConsoleApplication::fail ("Unable to find oversampling parameter!");
+
+    const auto osFactorIndex = osFactorParam->choices.indexOf (String (osFactor) + "x");
+    if (osFactorIndex < 0)
+        ConsoleApplication::fail ("Invalid oversampling factor: " + String (osFactor) + ", options are: " + osFactorParam->choices.joinIntoString (", "));
+
+    osFactorParam->setValueNotifyingHost (osFactorParam->convertTo0to1 ((float) osFactorIndex));
+}
+
+void renderFile (RenderJob& job, const File& inputFile, const File& outputFile, int blockSize)
+{
+    AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::unique_ptr<AudioFormatReader> reader (formatManager.createReaderFor (inputFile));
+    if (reader == nullptr)
+    {
+        job.errors.add ("Unable to read audio file: " + inputFile.getFullPathName());
+        return;
+    }
+
+    const auto sampleRate = reader->sampleRate;
+    const auto numInputSamples = reader->lengthInSamples;
+
+    auto& plugin = *job.plugin;
+    plugin.prepareToPlay (sampleRate, blockSize);
+
+    // render the extra samples needed for latency compensation, and trim them from the start of the output
+    const auto latencySamples = (int64) plugin.getLatencySamples();
+    const auto numRenderSamples = numInputSamples + latencySamples;
+    auto numSamplesToTrim = latencySamples;
+
+    outputFile.getParentDirectory().createDirectory();
+    outputFile.deleteFile();
+    auto outputStream = outputFile.createOutputStream();
+    std::unique_ptr<AudioFormatWriter> writer;
+    if (outputStream != nullptr)
+        writer.reset (WavAudioFormat().createWriterFor (outputStream.get(), sampleRate, 2, 24, {}, 0));
+
+    if (writer == nullptr)
+    {
+        job.errors.add ("Unable to write audio file: " + outputFile.getFullPathName());
+        return;
+    }
+    outputStream.release(); // the writer owns the stream now
+
+    AudioBuffer<float> buffer { 2, blockSize };
+    MidiBuffer midi;
+    for (int64 samplePos = 0; samplePos < numRenderSamples; samplePos += blockSize)
+    {
+        const auto numSamples = (int) jmin ((int64) blockSize, numRenderSamples - samplePos);
+        buffer.setSize (2, numSamples, false, false, true);
+        buffer.clear();
+        reader->read (&buffer, 0, numSamples, samplePos, true, true); // reading past the end of the file gives us silence
+
+        const auto startTime = Time::getMillisecondCounterHiRes();
+        plugin.processBlock (buffer, midi);
+        job.processingSeconds += (Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+
+        const auto numSamplesTrimmed = (int) jmin ((int64) numSamples, numSamplesToTrim);
+        numSamplesToTrim -= numSamplesTrimmed;
+        writer->writeFromAudioSampleBuffer (buffer, numSamplesTrimmed, numSamples - numSamplesTrimmed);
+    }
+
+    job.audioSeconds += (double) numInputSamples / sampleRate;
+    job.numFilesRendered++;
+}
+
+void renderJob (RenderJob& job, const Array<File>& inputFiles, const File& outputDir, int blockSize)
+{
+    for (const auto& inputFile : inputFiles)
+        renderFile (job, inputFile, outputDir.getChildFile (job.presetName).getChildFile (inputFile.getFileNameWithoutExtension() + ".wav"), blockSize);
+}
+} // namespace
+
+OfflineRenderer::OfflineRenderer()
+{
+    this->commandOption = "--render";
+    this->argumentDescription = "--render --in=[WAV FILE OR DIR] --out=[DIR] --preset=[PRESET FILE OR DIR] --block-size=[BLOCK SIZE] --os-factor=[OS FACTOR] --jobs=[NUM JOBS]";
+    this->shortDescription = "Renders audio files through one or more presets";
+    this->longDescription = "Renders each input file through each preset (or the default preset), and reports the real-time factor for each preset. "
+                            "Presets are rendered in parallel, with one plugin instance per job.";
+    this->command = [=] (const ArgumentList& args)
+    { render (args); };
+}
+
+void OfflineRenderer::render (const ArgumentList& args)
+{
+    if (! args.containsOption ("--in"))
+        ConsoleApplication::fail ("Please provide some input files to render! (--in=[WAV FILE OR DIR])");
+
+    const auto inputFiles = findFiles (args.getFileForOption ("--in"), "*.wav");
+    if (inputFiles.isEmpty())
+        ConsoleApplication::fail ("No input files found!");
+
+    File outputDir = File::getCurrentWorkingDirectory().getChildFile ("renders");
+    if (args.containsOption ("--out"))
+        outputDir = args.getFileForOption ("--out");
+
+    Array<File> presetFiles;
+    if (args.containsOption ("--preset"))
+    {
+        presetFiles = findFiles (args.getFileForOption ("--preset"), "*.chowpreset");
+        if (presetFiles.isEmpty())
+            ConsoleApplication::fail ("No preset files found!");
+    }
+
+    const auto blockSize = args.containsOption ("--block-size") ? args.getValueForOption ("--block-size").getIntValue() : 512;
+    const auto osFactor = args.containsOption ("--os-factor") ? args.getValueForOption ("--os-factor").getIntValue() : 2;
+    const auto numJobs = args.containsOption ("--jobs") ? jmax (1, args.getValueForOption ("--jobs").getIntValue()) : SystemStats::getNumPhysicalCpus();
+    if (blockSize <= 0)
+        ConsoleApplication::fail ("Invalid block size!");
+
+    const auto numPresets = jmax (1, presetFiles.size()); // if no presets are provided, we render the default preset
+    std::cout << "Rendering " << inputFiles.size() << " files through " << numPresets << " presets, with block size "
+              << blockSize << ", " << osFactor << "x oversampling, and " << numJobs << " jobs..." << std::endl;
+    std::cout << "Saving renders to " << outputDir.getFullPathName() << std::endl;
+
+    const auto renderStartTime = Time::getMillisecondCounterHiRes();
+    double totalAudioSeconds = 0.0;
+    for (int batchStart = 0; batchStart < numPresets; batchStart += numJobs)
+    {
+        // the plugin instances and presets need to be set up on the main thread
+        std::vector<std::unique_ptr<RenderJob>> jobs;
+        for (int presetIndex = batchStart; presetIndex < jmin (batchStart + numJobs, numPresets); ++presetIndex)
+        {
+            auto& job = *jobs.emplace_back (std::make_unique<RenderJob>());
+            job.plugin = std::make_unique<BYOD>();
+
+            if (presetFiles.isEmpty())
+            {
+                job.presetName = "Default";
+            }
+            else
+            {
+                job.presetFile = presetFiles[presetIndex];
+                job.presetName = job.presetFile.getFileNameWithoutExtension();
+                job.plugin->getPresetManager().loadPreset (chowdsp::Preset { job.presetFile });
+            }
+
+            setOversamplingFactor (*job.plugin, osFactor);
+        }
+
+        std::vector<std::thread> threads;
+        for (auto& job : jobs)
+            threads.emplace_back ([&job = *job, &inputFiles, &outputDir, blockSize]
+                                  { renderJob (job, inputFiles, outputDir, blockSize); });
+
+        for (auto& thread : threads)
+            thread.join();
+
+        for (auto& job : jobs)
+        {
+            for (const auto& error : job->errors)
+                std::cout << "ERROR: " << job->presetName << ": " << error << std::endl;
+
+            const auto realTimeFactor = job->audioSeconds > 0.0 ? job->processingSeconds / job->audioSeconds : 0.0;
+            std::cout << job->presetName << ": rendered " << job->numFilesRendered << " files (" << job->audioSeconds
+                      << " seconds of audio) in " << job->processingSeconds << " seconds, real-time factor: " << realTimeFactor
+                      << " (" << (realTimeFactor > 0.0 ? 1.0 / realTimeFactor : 0.0) << "x faster than real-time)" << std::endl;
+
+            totalAudioSeconds += job->audioSeconds;
+        }
+    }
+
+    const auto totalSeconds = (Time::getMillisecondCounterHiRes() - renderStartTime) * 0.001;
+    std::cout << "Rendered " << totalAudioSeconds << " seconds of audio in " << totalSeconds << " seconds" << std::endl;
+}
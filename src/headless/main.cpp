@@ -1,4 +1,8 @@
 #include "GuitarMLFilterDesigner.h"
+#include "ModuleBenchmark.h"
+#include "ModuleProfiler.h"
+#include "NeuralModelConverter.h"
+#include "OfflineRenderer.h"
 #include "PresetResaver.h"
 #include "PresetSaveLoadTime.h"
 #include "ScreenshotGenerator.h"
@@ -31,6 +35,10 @@ int main (int argc, char* argv[])
     app.addCommand (PresetResaver());
     app.addCommand (PresetSaveLoadTime());
     app.addCommand (GuitarMLFilterDesigner());
+    app.addCommand (NeuralModelConverter());
+    app.addCommand (ModuleProfiler());
+    app.addCommand (ModuleBenchmark());
+    app.addCommand (OfflineRenderer());
     app.addCommand (UnitTests());
 
     // ArgumentList args { "--unit-tests", "--all" };
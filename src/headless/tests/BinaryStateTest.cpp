@@ -0,0 +1,165 @@
+#include "UnitTests.h"
+
+class BinaryStateTest : public UnitTest
+{
+public:
+    BinaryStateTest() : UnitTest ("Binary State Test")
+    {
+    }
+
+    static MemoryBlock writeState (const BinaryStateWriter& writer)
+    {
+        MemoryBlock data;
+        MemoryOutputStream stream { data, false };
+        writer.writeTo (stream, JucePlugin_VersionString);
+        stream.flush();
+        return data;
+    }
+
+    void processorRoundTripTest (BaseProcessor* proc, Random& rand)
+    {
+        for (auto* param : proc->getParameters())
+        {
+            if (auto* rangedParam = dynamic_cast<RangedAudioParameter*> (param))
+                rangedParam->setValueNotifyingHost (rand.nextFloat());
+        }
+
+        if (auto* quantities = proc->getNetlistCircuitQuantities())
+        {
+            for (auto& quantity : *quantities)
+                quantity.value = jmap (rand.nextFloat(), quantity.minValue, quantity.maxValue);
+        }
+
+        BinaryStateWriter writer;
+        writer.writeRecord ([proc] (BinaryStateWriter& procWriter)
+                            { proc->toBinary (procWriter); });
+        writer.writeInt (1234);
+        const auto data = writeState (writer);
+
+        auto reader = BinaryStateReader::fromData (data.getData(), data.getSize());
+        expect (reader.has_value(), "Binary state could not be read!");
+        if (! reader.has_value())
+            return;
+
+        auto newProc = ProcessorStore::getStoreMap().at (proc->getName()).factory (nullptr);
+        auto procReader = reader->readRecord();
+        newProc->fromBinary (procReader, reader->getPluginVersion());
+        expect (! procReader.hasFailed(), "Processor state could not be read!");
+        expectEquals (reader->readInt(), 1234, "Reader did not skip over the processor state correctly!");
+
+        for (auto* param : proc->getParameters())
+        {
+            auto* rangedParam = dynamic_cast<RangedAudioParameter*> (param);
+            if (rangedParam == nullptr)
+                continue;
+
+            const auto* newParam = newProc->getVTS().getParameter (rangedParam->getParameterID());
+            expect (newParam != nullptr, "Parameter is missing: " + rangedParam->getParameterID());
+            if (newParam != nullptr)
+                expectWithinAbsoluteError (newParam->getValue(), rangedParam->getValue(), 1.0e-4f, "Parameter value is incorrect: " + rangedParam->getParameterID());
+        }
+
+        if (auto* quantities = proc->getNetlistCircuitQuantities())
+        {
+            for (const auto& quantity : *quantities)
+            {
+                const auto* newQuantity = newProc->getNetlistCircuitQuantities()->findQuantity (quantity.name);
+                expectEquals (newQuantity->value.load(), quantity.value.load(), "Circuit quantity value is incorrect: " + String { quantity.name });
+            }
+
+            circuitQuantityNamesTest (proc);
+        }
+
+        newProc->freeInternalMemory();
+    }
+
+    void circuitQuantityNamesTest (BaseProcessor* proc)
+    {
+        // write the circuit quantities in reverse order, with a quantity that the processor doesn't have,
+        // and without the first quantity, as if the processor's netlist had changed since the state was saved
+        const auto& quantities = proc->getNetlistCircuitQuantities()->quantities;
+        StringArray savedNames { "Not A Quantity" };
+        std::vector<float> savedValues { 1.0f };
+        for (auto iter = quantities.rbegin(); iter != std::prev (quantities.rend()); ++iter)
+        {
+            savedNames.add (String { iter->name });
+            savedValues.push_back (iter->minValue);
+        }
+
+        BinaryStateWriter writer;
+        writer.writeRecord ([&] (BinaryStateWriter& procWriter)
+                            {
+                                procWriter.writeFloat (0.0f);
+                                procWriter.writeFloat (0.0f);
+                                procWriter.writeInt (-1);
+                                procWriter.writeParameterState (proc->getVTS().copyState());
+                                procWriter.writeIDTable (savedNames);
+                                for (auto value : savedValues)
+                                    procWriter.writeFloat (value); });
+        const auto data = writeState (writer);
+
+        auto reader = BinaryStateReader::fromData (data.getData(), data.getSize());
+        expect (reader.has_value(), "Binary state could not be read!");
+        if (! reader.has_value())
+            return;
+
+        auto newProc = ProcessorStore::getStoreMap().at (proc->getName()).factory (nullptr);
+        auto procReader = reader->readRecord();
+        newProc->fromBinary (procReader, reader->getPluginVersion());
+        expect (! procReader.hasFailed(), "Processor state could not be read!");
+
+        for (auto [idx, quantity] : chowdsp::enumerate (newProc->getNetlistCircuitQuantities()->quantities))
+        {
+            const auto expectedValue = idx == 0 ? quantity.defaultValue : quantity.minValue;
+            expectEquals (quantity.value.load(), expectedValue, "Circuit quantity was not matched by name: " + String { quantity.name });
+        }
+
+        newProc->freeInternalMemory();
+    }
+
+    void parameterStateTest()
+    {
+        ValueTree state { "Parameters", { { "extra_property", 1 } } };
+        for (int i = 0; i < 10; ++i)
+            state.appendChild (ValueTree { "PARAM", { { "id", "param_" + String (i) }, { "value", (float) i } } }, nullptr);
+
+        BinaryStateWriter writer;
+        writer.writeParameterState (state);
+        writer.writeParameterState (state);
+        const auto data = writeState (writer);
+
+        {
+            auto reader = BinaryStateReader::fromData (data.getData(), data.getSize());
+            expect (reader.has_value(), "Binary state could not be read!");
+            expect (reader->readParameterState().isEquivalentTo (state), "First parameter state is incorrect!");
+            expect (reader->readParameterState().isEquivalentTo (state), "Second parameter state is incorrect!");
+            expect (! reader->hasFailed() && reader->isExhausted(), "Reader should be at the end of the state!");
+        }
+
+        const auto xmlData = state.toXmlString();
+        expect (! BinaryStateReader::fromData (xmlData.toRawUTF8(), xmlData.getNumBytesAsUTF8()).has_value(), "XML data should not be read as a binary state!");
+
+        for (size_t truncatedSize = 0; truncatedSize < data.getSize(); ++truncatedSize)
+        {
+            auto reader = BinaryStateReader::fromData (data.getData(), truncatedSize);
+            if (! reader.has_value())
+                continue;
+
+            reader->readParameterState();
+            reader->readParameterState();
+            expect (reader->hasFailed(), "Truncated state should not be read!");
+        }
+    }
+
+    void runTest() override
+    {
+        auto rand = getRandom();
+        runTestForAllProcessors (this, [&] (BaseProcessor* proc)
+                                 { processorRoundTripTest (proc, rand); });
+
+        beginTest ("Parameter State Test");
+        parameterStateTest();
+    }
+};
+
+static BinaryStateTest binaryStateTest;
@@ -0,0 +1,279 @@
+#include "UnitTests.h"
+#include "processors/drive/GuitarMLAmp.h"
+#include "processors/drive/neural_utils/GuitarMLModel.h"
+
+namespace
+{
+constexpr int numTestSamples = 2000;
+} // namespace
+
+class GuitarMLModelTest : public UnitTest
+{
+public:
+    GuitarMLModelTest() : UnitTest ("GuitarML Model Test")
+    {
+    }
+
+    static int getNumGates (const GuitarMLModelArch& arch)
+    {
+        return arch.recurrentLayerType == RecurrentLayerType::LSTMLayer ? 4 : 3;
+    }
+
+    /** Makes some random weights, in the same format as the GuitarML (PyTorch) models */
+    static chowdsp::json makeWeightsJson (const GuitarMLModelArch& arch, Random& rand)
+    {
+        const auto numGates = getNumGates (arch);
+        const auto randomMatrix = [&rand] (int rows, int cols)
+        {
+            std::vector<std::vector<float>> matrix ((size_t) rows, std::vector<float> ((size_t) cols));
+            for (auto& row : matrix)
+                for (auto& x : row)
+                    x = 0.5f * (rand.nextFloat() * 2.0f - 1.0f);
+            return matrix;
+        };
+
+        chowdsp::json modelJson;
+        modelJson["model_data"]["input_size"] = arch.numInputs;
+        modelJson["model_data"]["hidden_size"] = arch.hiddenSize;
+        modelJson["model_data"]["skip"] = 1;
+        modelJson["state_dict"]["rec.weight_ih_l0"] = randomMatrix (numGates * arch.hiddenSize, arch.numInputs);
+        modelJson["state_dict"]["rec.weight_hh_l0"] = randomMatrix (numGates * arch.hiddenSize, arch.hiddenSize);
+        modelJson["state_dict"]["rec.bias_ih_l0"] = randomMatrix (1, numGates * arch.hiddenSize)[0];
+        modelJson["state_dict"]["rec.bias_hh_l0"] = randomMatrix (1, numGates * arch.hiddenSize)[0];
+        modelJson["state_dict"]["lin.weight"] = randomMatrix (1, arch.hiddenSize);
+        modelJson["state_dict"]["lin.bias"] = randomMatrix (1, 1)[0];
+        return modelJson;
+    }
+
+    /**
+     * Pads the model out to a larger hidden size, with zeros for all the extra weights and biases.
+     * The extra hidden units then always stay at zero, and don't change the output at all, so the
+     * padded model gives the same output as the original model.
+     */
+    static chowdsp::json padWeightsJson (const chowdsp::json& modelJson, const GuitarMLModelArch& arch, int paddedHiddenSize)
+    {
+        const auto numGates = getNumGates (arch);
+        const auto hiddenSize = (size_t) arch.hiddenSize;
+        const auto padGateRows = [numGates, hiddenSize, paddedHiddenSize] (const std::vector<std::vector<float>>& rows, size_t numCols)
+        {
+            std::vector<std::vector<float>> padded ((size_t) (numGates * paddedHiddenSize), std::vector<float> (numCols));
+            for (size_t gate = 0; gate < (size_t) numGates; ++gate)
+                for (size_t i = 0; i < hiddenSize; ++i)
+                    std::copy (rows[gate * hiddenSize + i].begin(), rows[gate * hiddenSize + i].end(), padded[gate * (size_t) paddedHiddenSize + i].begin());
+            return padded;
+        };
+        const auto padColumns = [paddedHiddenSize] (std::vector<std::vector<float>> rows)
+        {
+            for (auto& row : rows)
+                row.resize ((size_t) paddedHiddenSize);
+            return rows;
+        };
+        const auto padGateVector = [&padGateRows] (const std::vector<float>& values)
+        {
+            std::vector<std::vector<float>> rows;
+            for (auto x : values)
+                rows.push_back ({ x });
+
+            std::vector<float> padded;
+            for (const auto& row : padGateRows (rows, 1))
+                padded.push_back (row[0]);
+            return padded;
+        };
+
+        const auto& stateDict = modelJson["state_dict"];
+        auto paddedJson = modelJson;
+        paddedJson["model_data"]["hidden_size"] = paddedHiddenSize;
+        paddedJson["state_dict"]["rec.weight_ih_l0"] = padGateRows (stateDict["rec.weight_ih_l0"].get<std::vector<std::vector<float>>>(), (size_t) arch.numInputs);
+        paddedJson["state_dict"]["rec.weight_hh_l0"] = padGateRows (padColumns (stateDict["rec.weight_hh_l0"].get<std::vector<std::vector<float>>>()), (size_t) paddedHiddenSize);
+        paddedJson["state_dict"]["rec.bias_ih_l0"] = padGateVector (stateDict["rec.bias_ih_l0"].get<std::vector<float>>());
+        paddedJson["state_dict"]["rec.bias_hh_l0"] = padGateVector (stateDict["rec.bias_hh_l0"].get<std::vector<float>>());
+        paddedJson["state_dict"]["lin.weight"] = padColumns (stateDict["lin.weight"].get<std::vector<std::vector<float>>>());
+        return paddedJson;
+    }
+
+    static std::unique_ptr<GuitarMLModel> createModel (const chowdsp::json& modelJson, bool precompiled)
+    {
+        const auto weightsData = ModelWeights::fromJson (modelJson);
+        const auto weights = *ModelWeights::fromData (weightsData.data(), weightsData.size());
+        const auto arch = GuitarMLModelArch::fromWeights (weights);
+
+        auto model = precompiled ? GuitarMLModelRegistry::createModel (arch) : GuitarMLModelRegistry::createDynamicModel (arch);
+        model->initialise (weights);
+        return model;
+    }
+
+    void expectModelsMatch (GuitarMLModel& model, GuitarMLModel& refModel, Random& rand, float rnnDelaySamples, MathsQuality mathsQuality, float tolerance)
+    {
+        for (auto* m : { &model, &refModel })
+            m->prepare (rnnDelaySamples, mathsQuality);
+
+        AudioBuffer<float> buffer { 2, numTestSamples };
+        std::vector<float> condition ((size_t) numTestSamples);
+        for (int n = 0; n < numTestSamples; ++n)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                buffer.setSample (ch, n, rand.nextFloat() - 0.5f);
+            condition[(size_t) n] = (float) n / (float) numTestSamples;
+        }
+        auto refBuffer = buffer;
+
+        model.process ({ buffer.getArrayOfWritePointers(), 2 }, (size_t) numTestSamples, condition.data(), true);
+        refModel.process ({ refBuffer.getArrayOfWritePointers(), 2 }, (size_t) numTestSamples, condition.data(), true);
+
+        for (int ch = 0; ch < 2; ++ch)
+            for (int n = 0; n < numTestSamples; ++n)
+                expectWithinAbsoluteError (buffer.getSample (ch, n), refBuffer.getSample (ch, n), tolerance, "Model output is incorrect!");
+    }
+
+    /** Checks a pre-compiled model against the dynamic model. */
+    void modelTest (const GuitarMLModelArch& arch, MathsQuality mathsQuality = MathsQuality::Normal, float tolerance = 1.0e-3f, float rnnDelaySamples = 1.0f)
+    {
+        Random rand { 0x4321 };
+        const auto modelJson = makeWeightsJson (arch, rand);
+        const auto weightsData = ModelWeights::fromJson (modelJson);
+        expect (GuitarMLModelArch::fromWeights (*ModelWeights::fromData (weightsData.data(), weightsData.size())) == arch, "Model architecture was not read correctly!");
+        expect (GuitarMLModelRegistry::isPrecompiled (arch), "This model size should be pre-compiled!");
+
+        auto model = createModel (modelJson, true);
+        auto refModel = createModel (modelJson, false);
+        expectModelsMatch (*model, *refModel, rand, rnnDelaySamples, mathsQuality, tolerance);
+    }
+
+    /**
+     * Checks the dynamic model for a size that isn't pre-compiled, against a
+     * pre-compiled model with the same weights, padded out to a larger size.
+     */
+    void dynamicModelTest (const GuitarMLModelArch& arch, int paddedHiddenSize, float rnnDelaySamples = 1.0f)
+    {
+        Random rand { 0x1234 };
+        const auto modelJson = makeWeightsJson (arch, rand);
+        const auto paddedArch = GuitarMLModelArch { arch.recurrentLayerType, arch.numInputs, paddedHiddenSize };
+        expect (! GuitarMLModelRegistry::isPrecompiled (arch), "This model size should not be pre-compiled!");
+        expect (GuitarMLModelRegistry::isPrecompiled (paddedArch), "The padded model size should be pre-compiled!");
+
+        auto model = createModel (modelJson, true);
+        auto refModel = createModel (padWeightsJson (modelJson, arch, paddedHiddenSize), true);
+        expectModelsMatch (*model, *refModel, rand, rnnDelaySamples, MathsQuality::Normal, 1.0e-3f);
+    }
+
+    void builtInModelsTest()
+    {
+        for (const auto* resourceName : { "BluesJrAmp_VolKnob_bnnw", "TS9_DriveKnob_bnnw", "MesaRecMini_ModernChannel_GainKnob_bnnw" })
+        {
+            int dataSize;
+            const auto* data = BinaryData::getNamedResource (resourceName, dataSize);
+            const auto arch = GuitarMLModelArch::fromWeights (*ModelWeights::fromData (data, (size_t) dataSize));
+            expect (arch == GuitarMLModelArch { RecurrentLayerType::LSTMLayer, 2, 40 }, "Built-in model architecture is incorrect!");
+            expect (GuitarMLModelRegistry::isPrecompiled (arch), "Built-in models should be pre-compiled!");
+        }
+    }
+
+    void waitForModelLoading()
+    {
+        static constexpr uint32 timeoutMs = 5000;
+        const auto startTime = Time::getMillisecondCounter();
+        while (! GuitarMLAmp::isBackgroundLoadingIdle())
+        {
+            if (Time::getMillisecondCounter() - startTime > timeoutMs)
+            {
+                expect (false, "Timed out waiting for the model to load!");
+                return;
+            }
+
+            Thread::sleep (1);
+        }
+    }
+
+    void modelSwitchingTest()
+    {
+        static constexpr double sampleRate = 48000.0;
+        static constexpr int blockSize = 512;
+        static constexpr int numSilentBlocks = 400;
+        static constexpr int numSineBlocks = 20;
+
+        // the reference amp uses the last model the whole time
+        GuitarMLAmp amp, refAmp;
+        refAmp.loadModel (2);
+        waitForModelLoading();
+        amp.prepareProcessing (sampleRate, blockSize);
+        refAmp.prepareProcessing (sampleRate, blockSize);
+
+        AudioBuffer<float> buffer { 2, blockSize }, refBuffer { 2, blockSize };
+        const auto processBlock = [&] (int blockIndex)
+        {
+            buffer.clear();
+            if (blockIndex >= numSilentBlocks)
+            {
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int n = 0; n < blockSize; ++n)
+                        buffer.setSample (ch, n, 0.1f * std::sin (MathConstants<float>::twoPi * 100.0f * float (blockIndex * blockSize + n) / (float) sampleRate));
+            }
+            refBuffer.makeCopyOf (buffer, true);
+
+            amp.processAudio (buffer);
+            refAmp.processAudio (refBuffer);
+        };
+
+        // start crossfading to the second model...
+        amp.loadModel (1);
+        waitForModelLoading();
+        processBlock (0);
+
+        // ... and then switch to the third model before the crossfade has finished
+        amp.loadModel (2);
+        waitForModelLoading();
+
+        // after a while of silence, both amps should have settled into the same state
+        for (int blockIndex = 1; blockIndex < numSilentBlocks + numSineBlocks; ++blockIndex)
+            processBlock (blockIndex);
+
+        for (int ch = 0; ch < 2; ++ch)
+            for (int n = 0; n < blockSize; ++n)
+                expectWithinAbsoluteError (buffer.getSample (ch, n), refBuffer.getSample (ch, n), 1.0e-3f, "The last model is not the one playing!");
+        expectEquals (amp.getCurrentModelName(), refAmp.getCurrentModelName(), "Incorrect model name!");
+    }
+
+    void runTest() override
+    {
+        beginTest ("Built-In Models Test");
+        builtInModelsTest();
+
+        beginTest ("LSTM Model Test");
+        modelTest ({ RecurrentLayerType::LSTMLayer, 1, 16 });
+
+        beginTest ("Conditioned LSTM Model Test");
+        modelTest ({ RecurrentLayerType::LSTMLayer, 2, 12 });
+
+        beginTest ("GRU Model Test");
+        modelTest ({ RecurrentLayerType::GRULayer, 1, 20 });
+
+        beginTest ("Conditioned GRU Model Test");
+        modelTest ({ RecurrentLayerType::GRULayer, 2, 8 });
+
+        beginTest ("Eco Maths Quality LSTM Model Test");
+        modelTest ({ RecurrentLayerType::LSTMLayer, 1, 16 }, MathsQuality::Eco, 2.0e-2f);
+
+        beginTest ("High Maths Quality LSTM Model Test");
+        modelTest ({ RecurrentLayerType::LSTMLayer, 2, 12 }, MathsQuality::High);
+
+        beginTest ("Sample Rate Corrected LSTM Model Test");
+        modelTest ({ RecurrentLayerType::LSTMLayer, 2, 12 }, MathsQuality::Normal, 1.0e-3f, 2.5f);
+
+        beginTest ("Sample Rate Corrected GRU Model Test");
+        modelTest ({ RecurrentLayerType::GRULayer, 1, 20 }, MathsQuality::Normal, 1.0e-3f, 2.5f);
+
+        beginTest ("Dynamic LSTM Model Test");
+        dynamicModelTest ({ RecurrentLayerType::LSTMLayer, 2, 24 }, 32);
+
+        beginTest ("Dynamic GRU Model Test");
+        dynamicModelTest ({ RecurrentLayerType::GRULayer, 1, 10 }, 12);
+
+        beginTest ("Sample Rate Corrected Dynamic Model Test");
+        dynamicModelTest ({ RecurrentLayerType::LSTMLayer, 1, 24 }, 32, 1.5f);
+
+        beginTest ("Model Switching Test");
+        modelSwitchingTest();
+    }
+};
+
+static GuitarMLModelTest guitarMLModelTest;
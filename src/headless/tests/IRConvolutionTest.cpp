@@ -0,0 +1,240 @@
+#include "UnitTests.h"
+#include "processors/tone/IRConvolution.h"
+
+namespace
+{
+constexpr double sampleRate = 48000.0;
+constexpr int irLength = 1500;
+constexpr int partitionSize = 128;
+constexpr int numTestSamples = 4000;
+} // namespace
+
+class IRConvolutionTest : public UnitTest
+{
+public:
+    IRConvolutionTest() : UnitTest ("IR Convolution Test")
+    {
+    }
+
+    static AudioBuffer<float> makeNoise (int numChannels, int numSamples, Random& rand)
+    {
+        AudioBuffer<float> buffer { numChannels, numSamples };
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int n = 0; n < numSamples; ++n)
+                buffer.setSample (ch, n, rand.nextFloat() * 2.0f - 1.0f);
+        return buffer;
+    }
+
+    void waitForBackgroundLoading()
+    {
+        static constexpr uint32 timeoutMs = 5000;
+        const auto startTime = Time::getMillisecondCounter();
+        while (! IRConvolution::isBackgroundLoadingIdle())
+        {
+            if (Time::getMillisecondCounter() - startTime > timeoutMs)
+            {
+                expect (false, "Timed out waiting for the IR to load!");
+                return;
+            }
+
+            Thread::sleep (1);
+        }
+    }
+
+    void partitionedConvolutionTest (const std::vector<int>& blockSizes)
+    {
+        Random rand { 0x1234 };
+        const auto ir = makeNoise (2, irLength, rand);
+        const auto input = makeNoise (2, numTestSamples, rand);
+
+        PartitionedConvolutionEngine engine { std::make_shared<const PartitionedIR> (ir, sampleRate, partitionSize), 2 };
+
+        auto output = input;
+        for (int sampleIndex = 0, blockIndex = 0; sampleIndex < numTestSamples; ++blockIndex)
+        {
+            const auto numSamples = jmin (blockSizes[(size_t) blockIndex % blockSizes.size()], numTestSamples - sampleIndex);
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                auto* data = output.getWritePointer (ch, sampleIndex);
+                engine.process (data, data, ch, numSamples);
+            }
+            sampleIndex += numSamples;
+        }
+
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            for (int n = 0; n < numTestSamples; n += 7)
+            {
+                auto expected = 0.0f;
+                for (int k = 0; k <= jmin (n, irLength - 1); ++k)
+                    expected += ir.getSample (ch, k) * input.getSample (ch, n - k);
+
+                expectWithinAbsoluteError (output.getSample (ch, n), expected, 5.0e-3f, "Convolution output is incorrect!");
+            }
+        }
+    }
+
+    void sharedCacheTest()
+    {
+        int irDataSize;
+        const auto* irData = BinaryData::getNamedResource ("Marshall_wav", irDataSize);
+
+        SharedResourcePointer<IRCache> cache1;
+        SharedResourcePointer<IRCache> cache2;
+        expect (&cache1.get() == &cache2.get(), "IR cache should be shared!");
+
+        const IRCache::Settings settings { sampleRate, partitionSize };
+        auto ir1 = cache1->getImpulseResponse (irData, (size_t) irDataSize, settings);
+        auto ir2 = cache2->getImpulseResponse (irData, (size_t) irDataSize, settings);
+        expect (ir1 != nullptr, "IR was not loaded!");
+        expect (ir1 == ir2, "Instances with the same IR should share the same data!");
+
+        auto otherSettings = settings;
+        otherSettings.sampleRate = 2.0 * sampleRate;
+        auto ir3 = cache1->getImpulseResponse (irData, (size_t) irDataSize, otherSettings);
+        expect (ir1 != ir3, "IRs prepared with different settings should not be shared!");
+
+        ir1.reset();
+        ir2.reset();
+        ir3.reset();
+        expectEquals (cache1->getNumCachedImpulseResponses(), (size_t) 0, "IRs should be freed when they are no longer used!");
+    }
+
+    void reprepareKeepsCachedIRTest()
+    {
+        int irDataSize;
+        const auto* irData = BinaryData::getNamedResource ("Marshall_wav", irDataSize);
+
+        IRConvolution convolution;
+        convolution.addImpulseResponse (irData, (size_t) irDataSize);
+        convolution.loadImpulseResponse (0);
+        convolution.prepare (sampleRate, 512, 1);
+
+        // only the convolution holds on to the IR, so it should stay in the cache while re-preparing with the same settings
+        SharedResourcePointer<IRCache> cache;
+        std::weak_ptr<const PartitionedIR> weakIR = cache->getImpulseResponse (irData, (size_t) irDataSize, { sampleRate, 512 });
+        expect (! weakIR.expired(), "IR was not loaded!");
+
+        convolution.prepare (sampleRate, 512, 1);
+        expect (! weakIR.expired(), "IR was dropped from the cache while re-preparing!");
+    }
+
+    void switchingTest()
+    {
+        static constexpr int blockSize = 512;
+        static constexpr int numBlocks = 200;
+
+        int marshallSize, fenderSize;
+        const auto* marshallData = BinaryData::getNamedResource ("Marshall_wav", marshallSize);
+        const auto* fenderData = BinaryData::getNamedResource ("Fender_wav", fenderSize);
+
+        // the reference convolution uses the second IR the whole time
+        IRConvolution convolution, refConvolution;
+        for (auto* conv : { &convolution, &refConvolution })
+        {
+            conv->addImpulseResponse (marshallData, (size_t) marshallSize);
+            conv->addImpulseResponse (fenderData, (size_t) fenderSize);
+        }
+        refConvolution.loadImpulseResponse (1);
+        convolution.prepare (sampleRate, blockSize, 1);
+        refConvolution.prepare (sampleRate, blockSize, 1);
+
+        // the new IR is loaded in the background, so we should keep on processing in the meantime
+        convolution.loadImpulseResponse (1);
+
+        AudioBuffer<float> buffer { 2, blockSize }, refBuffer { 2, blockSize };
+        for (int blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                for (int n = 0; n < blockSize; ++n)
+                    buffer.setSample (ch, n, std::sin (MathConstants<float>::twoPi * 100.0f * float (blockIndex * blockSize + n) / (float) sampleRate));
+            refBuffer.makeCopyOf (buffer, true);
+
+            auto&& block = dsp::AudioBlock<float> { buffer };
+            auto&& refBlock = dsp::AudioBlock<float> { refBuffer };
+            convolution.process (dsp::ProcessContextReplacing<float> { block });
+            refConvolution.process (dsp::ProcessContextReplacing<float> { refBlock });
+            Thread::sleep (2);
+        }
+
+        for (int ch = 0; ch < 2; ++ch)
+            for (int n = 0; n < blockSize; ++n)
+                expectWithinAbsoluteError (buffer.getSample (ch, n), refBuffer.getSample (ch, n), 1.0e-4f, "IR was not switched!");
+    }
+
+    void rapidSwitchingTest()
+    {
+        static constexpr int blockSize = 512;
+        static constexpr int numBlocks = 200;
+
+        int marshallSize, fenderSize, bognerSize;
+        const auto* marshallData = BinaryData::getNamedResource ("Marshall_wav", marshallSize);
+        const auto* fenderData = BinaryData::getNamedResource ("Fender_wav", fenderSize);
+        const auto* bognerData = BinaryData::getNamedResource ("Bogner_wav", bognerSize);
+
+        // the reference convolution uses the last IR the whole time
+        IRConvolution convolution, refConvolution;
+        for (auto* conv : { &convolution, &refConvolution })
+        {
+            conv->addImpulseResponse (marshallData, (size_t) marshallSize);
+            conv->addImpulseResponse (fenderData, (size_t) fenderSize);
+            conv->addImpulseResponse (bognerData, (size_t) bognerSize);
+        }
+        refConvolution.loadImpulseResponse (2);
+        convolution.prepare (sampleRate, blockSize, 1);
+        refConvolution.prepare (sampleRate, blockSize, 1);
+
+        AudioBuffer<float> buffer { 2, blockSize }, refBuffer { 2, blockSize };
+        const auto processBlock = [&] (int blockIndex)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                for (int n = 0; n < blockSize; ++n)
+                    buffer.setSample (ch, n, std::sin (MathConstants<float>::twoPi * 100.0f * float (blockIndex * blockSize + n) / (float) sampleRate));
+            refBuffer.makeCopyOf (buffer, true);
+
+            auto&& block = dsp::AudioBlock<float> { buffer };
+            auto&& refBlock = dsp::AudioBlock<float> { refBuffer };
+            convolution.process (dsp::ProcessContextReplacing<float> { block });
+            refConvolution.process (dsp::ProcessContextReplacing<float> { refBlock });
+        };
+
+        // start crossfading to the second IR...
+        convolution.loadImpulseResponse (1);
+        waitForBackgroundLoading();
+        processBlock (0);
+
+        // ... and then switch to the third IR before the crossfade has finished
+        convolution.loadImpulseResponse (2);
+        waitForBackgroundLoading();
+
+        for (int blockIndex = 1; blockIndex < numBlocks; ++blockIndex)
+            processBlock (blockIndex);
+
+        for (int ch = 0; ch < 2; ++ch)
+            for (int n = 0; n < blockSize; ++n)
+                expectWithinAbsoluteError (buffer.getSample (ch, n), refBuffer.getSample (ch, n), 1.0e-4f, "The last IR is not the one playing!");
+    }
+
+    void runTest() override
+    {
+        beginTest ("Partitioned Convolution Test");
+        partitionedConvolutionTest ({ partitionSize });
+
+        beginTest ("Partitioned Convolution Variable Block Size Test");
+        partitionedConvolutionTest ({ 1, 17, 64, 128, 100, 3 });
+
+        beginTest ("Shared IR Cache Test");
+        sharedCacheTest();
+
+        beginTest ("IR Re-prepare Keeps Cached IR Test");
+        reprepareKeepsCachedIRTest();
+
+        beginTest ("IR Switching Test");
+        switchingTest();
+
+        beginTest ("IR Rapid Switching Test");
+        rapidSwitchingTest();
+    }
+};
+
+static IRConvolutionTest irConvolutionTest;
@@ -0,0 +1,75 @@
+#include "UnitTests.h"
+#include "processors/drive/neural_utils/ModelWeights.h"
+
+class ModelWeightsTest : public UnitTest
+{
+public:
+    ModelWeightsTest() : UnitTest ("Model Weights Test")
+    {
+    }
+
+    void roundTripTest (const char* resourceName)
+    {
+        int dataSize;
+        const auto* data = BinaryData::getNamedResource (resourceName, dataSize);
+        const auto weights = ModelWeights::fromData (data, (size_t) dataSize);
+        expect (weights.has_value(), "Model weights could not be loaded!");
+        if (! weights.has_value())
+            return;
+
+        // converting back to JSON and then to binary again should give exactly the same data
+        const auto roundTripData = ModelWeights::fromJson (weights->toJson());
+        expectEquals ((int) roundTripData.size(), dataSize, "Round-trip weights size is incorrect!");
+        expect (std::memcmp (roundTripData.data(), data, roundTripData.size()) == 0, "Round-trip weights are incorrect!");
+    }
+
+    /** The .bnnw files are committed alongside their JSON sources, so make sure they haven't gone out of sync. */
+    void sourceModelsTest (const File& weightsFile)
+    {
+        const auto jsonFile = weightsFile.withFileExtension ("json");
+        expect (jsonFile.existsAsFile(), "Model weights have no JSON source: " + weightsFile.getFileName());
+        if (! jsonFile.existsAsFile())
+            return;
+
+        MemoryBlock weightsData;
+        weightsFile.loadFileAsData (weightsData);
+
+        const auto convertedData = ModelWeights::fromJson (chowdsp::json::parse (jsonFile.loadFileAsString().toStdString()));
+        expectEquals ((int) weightsData.getSize(), (int) convertedData.size(), "Model weights size doesn't match the JSON source: " + weightsFile.getFileName());
+        expect (weightsData.getSize() == convertedData.size() && std::memcmp (weightsData.getData(), convertedData.data(), convertedData.size()) == 0,
+                "Model weights don't match the JSON source (re-convert the model with --convert-model): " + weightsFile.getFileName());
+    }
+
+    void invalidDataTest()
+    {
+        const std::string modelJson = R"({"model_data": {"hidden_size": 40}})";
+        expect (! ModelWeights::fromData (modelJson.data(), modelJson.size()).has_value(), "JSON data should not be loaded as binary weights!");
+
+        const auto weightsData = ModelWeights::fromJson (chowdsp::json::parse (modelJson));
+        expect (ModelWeights::fromData (weightsData.data(), weightsData.size()).has_value(), "Weights should be valid!");
+        expect (! ModelWeights::fromData (weightsData.data(), sizeof (ModelWeights::Header)).has_value(), "Truncated weights should not be loaded!");
+    }
+
+    void runTest() override
+    {
+        for (int i = 0; i < BinaryData::namedResourceListSize; ++i)
+        {
+            if (! String { BinaryData::originalFilenames[i] }.endsWith (".bnnw"))
+                continue;
+
+            beginTest ("Round-Trip Test: " + String { BinaryData::originalFilenames[i] });
+            roundTripTest (BinaryData::namedResourceList[i]);
+        }
+
+        beginTest ("Source Models Test");
+        auto weightsFiles = File { BYOD_ROOT_DIR }.getChildFile ("res/guitar_ml_models").findChildFiles (File::findFiles, true, "*.bnnw");
+        expect (! weightsFiles.isEmpty(), "No model weights found!");
+        for (const auto& weightsFile : weightsFiles)
+            sourceModelsTest (weightsFile);
+
+        beginTest ("Invalid Data Test");
+        invalidDataTest();
+    }
+};
+
+static ModelWeightsTest modelWeightsTest;
@@ -8,12 +8,12 @@ public:
     {
     }
 
-    static void query (const chowdsp::PresetManager& presetManager, const preset_search::Database& searchDatabase, const std::string& query)
+    static std::vector<preset_search::Result> query (const chowdsp::PresetManager& presetManager, const preset_search::Index& searchIndex, const std::string& query)
     {
         std::cout << " --- \n";
 
         auto t1 = std::chrono::steady_clock::now();
-        auto res = searchDatabase.search (query);
+        auto res = searchIndex.search (query);
         auto t2 = std::chrono::steady_clock::now();
         std::chrono::duration<double, std::milli> fp_ms = t2 - t1;
 
@@ -28,24 +28,98 @@ public:
             if (i > 22)
                 break;
         }
+
+        return res;
+    }
+
+    static bool containsPreset (const std::vector<preset_search::Result>& results, int key)
+    {
+        return std::any_of (results.begin(), results.end(), [key] (const preset_search::Result& r)
+                            { return r.key == key; });
+    }
+
+    void incrementalUpdateTest (const chowdsp::PresetManager& presetMgr)
+    {
+        preset_search::Index searchIndex;
+        searchIndex.update (presetMgr);
+
+        // add lots of copies of the factory presets, to make sure the search is fast enough for large collections
+        static constexpr int numCopies = 20;
+        std::vector<std::pair<int, chowdsp::Preset>> extraPresets;
+        auto nextKey = presetMgr.getPresetMap().rbegin()->first + 1;
+        for (int copy = 0; copy < numCopies; ++copy)
+        {
+            for (const auto& [_, preset] : presetMgr.getPresetMap())
+            {
+                chowdsp::Preset extraPreset { preset.getName() + " Copy " + String (copy), "User", *preset.getState(), preset.getCategory() };
+                extraPresets.emplace_back (nextKey++, std::move (extraPreset));
+            }
+        }
+
+        for (const auto& [key, preset] : extraPresets)
+            searchIndex.addPreset (key, preset);
+        expectEquals (searchIndex.getNumPresets(), (size_t) presetMgr.getNumPresets() * (numCopies + 1), "Incorrect number of presets in the index!");
+
+        for (const auto* queryString : { "j", "jim", "hendrix", "muff ram", "fuzz copy 1", "tremolo", "bass" })
+        {
+            const auto t1 = std::chrono::steady_clock::now();
+            const auto results = searchIndex.search (queryString);
+            const auto t2 = std::chrono::steady_clock::now();
+            std::chrono::duration<double, std::milli> fp_ms = t2 - t1;
+            std::cout << "Query: \"" << queryString << "\" over " << searchIndex.getNumPresets() << " presets, Time: " << fp_ms.count() << "ms #Results: " << results.size() << "\n";
+        }
+
+        // rename a preset
+        const auto& [renamedKey, renamedPreset] = extraPresets.front();
+        expect (containsPreset (searchIndex.search ("copy 0"), renamedKey), "Preset not found before renaming!");
+        searchIndex.addPreset (renamedKey, chowdsp::Preset { "Renamed Preset", "User", *renamedPreset.getState(), renamedPreset.getCategory() });
+        expect (! containsPreset (searchIndex.search ("copy 0"), renamedKey), "Preset found with old name!");
+        expect (containsPreset (searchIndex.search ("renamed"), renamedKey), "Preset not found with new name!");
+
+        // remove the extra presets
+        for (const auto& [key, preset] : extraPresets)
+            searchIndex.removePreset (key);
+        expectEquals (searchIndex.getNumPresets(), (size_t) presetMgr.getNumPresets(), "Incorrect number of presets in the index!");
+        expect (searchIndex.search ("renamed").empty(), "Removed preset found in search results!");
+        expect (searchIndex.search ("copy").empty(), "Removed presets found in search results!");
+
+        // updating from the preset manager shouldn't need to change anything
+        searchIndex.update (presetMgr);
+        expectEquals (searchIndex.getNumPresets(), (size_t) presetMgr.getNumPresets(), "Incorrect number of presets in the index!");
     }
 
     void runTest() override
     {
         BYOD plugin;
         const auto& presetMgr = plugin.getPresetManager();
-        preset_search::Database searchDatabase;
+        preset_search::Index searchIndex;
 
-        beginTest ("Initialise Database");
-        preset_search::initialiseDatabase (presetMgr, searchDatabase);
+        beginTest ("Initialise Index");
+        searchIndex.update (presetMgr);
+        expectEquals (searchIndex.getNumPresets(), (size_t) presetMgr.getNumPresets(), "Incorrect number of presets in the index!");
 
         beginTest ("Search");
-        query (presetMgr, searchDatabase, "");
-        query (presetMgr, searchDatabase, "CHOW");
-        query (presetMgr, searchDatabase, "J");
-        query (presetMgr, searchDatabase, "Jim");
-        query (presetMgr, searchDatabase, "Jimi");
-        query (presetMgr, searchDatabase, "JIMI");
+        query (presetMgr, searchIndex, "");
+        query (presetMgr, searchIndex, "CHOW");
+        query (presetMgr, searchIndex, "J");
+        query (presetMgr, searchIndex, "Jim");
+        query (presetMgr, searchIndex, "Jimi");
+        query (presetMgr, searchIndex, "JIMI");
+        expectEquals (query (presetMgr, searchIndex, "Jimi").size(), query (presetMgr, searchIndex, "JIMI").size(), "Search should not be case-sensitive!");
+        expect (! query (presetMgr, searchIndex, "Muff").empty(), "Prefix search should find results!");
+        expect (! query (presetMgr, searchIndex, "Muf Trangle").empty(), "Fuzzy search should find results!");
+
+        for (const auto& [key, preset] : presetMgr.getPresetMap())
+        {
+            if (preset.getName() == "American Sound")
+            {
+                expect (containsPreset (query (presetMgr, searchIndex, "Blonde Drive"), key), "Module search should find presets containing the module!");
+                expect (containsPreset (query (presetMgr, searchIndex, "bias"), key), "Parameter search should find factory presets containing the parameter!");
+            }
+        }
+
+        beginTest ("Incremental Update");
+        incrementalUpdateTest (presetMgr);
     }
 };
 
@@ -0,0 +1,183 @@
+#include "UnitTests.h"
+
+#if BYOD_BUILD_PRESET_SERVER
+
+#include "state/presets/PresetInfoHelpers.h"
+#include "state/presets/PresetsServerCommunication.h"
+#include "state/presets/PresetsServerSyncProtocol.h"
+
+class PresetsServerSyncTest : public UnitTest
+{
+public:
+    PresetsServerSyncTest() : UnitTest ("Presets Server Sync Test")
+    {
+    }
+
+    static std::vector<chowdsp::Preset> createPresets (int numPresets, Random& rand)
+    {
+        std::vector<chowdsp::Preset> presets;
+        for (int i = 0; i < numPresets; ++i)
+        {
+            XmlElement state { "state" };
+            state.setAttribute ("value", rand.nextFloat());
+            state.setAttribute ("padding", String::repeatedString ("x", rand.nextInt (4096)));
+
+            presets.emplace_back ("Preset " + String (i), "User", state, "Test");
+            PresetInfoHelpers::setIsPublic (presets.back(), rand.nextBool());
+        }
+
+        return presets;
+    }
+
+    static std::vector<const chowdsp::Preset*> getPresetPointers (const std::vector<chowdsp::Preset>& presets)
+    {
+        std::vector<const chowdsp::Preset*> presetPointers;
+        for (auto& preset : presets)
+            presetPointers.push_back (&preset);
+        return presetPointers;
+    }
+
+    void contentHashTest()
+    {
+        const auto hash = PresetsServerSyncProtocol::getContentHash ("preset data");
+        expectEquals (hash.length(), 16, "Hash has the wrong length!");
+        expectEquals (PresetsServerSyncProtocol::getContentHash ("preset data"), hash, "Hash is not deterministic!");
+        expect (PresetsServerSyncProtocol::getContentHash ("preset data!") != hash, "Different data has the same hash!");
+        expectEquals (PresetsServerSyncProtocol::getContentHash ({}), String { "cbf29ce484222325" }, "Empty hash is incorrect!");
+    }
+
+    void changedPresetsTest (Random& rand)
+    {
+        auto presets = createPresets (100, rand);
+
+        // the first 80 presets are on the server, and 10 of those have changed locally
+        std::map<String, String> serverHashes;
+        for (int i = 0; i < 80; ++i)
+        {
+            PresetInfoHelpers::setPresetID (presets[(size_t) i], String (i));
+            serverHashes[String (i)] = PresetsServerSyncProtocol::getContentHash (presets[(size_t) i].toXml()->toString());
+        }
+        for (int i = 0; i < 10; ++i)
+            serverHashes[String (i * 8)] = "0000000000000000";
+
+        const auto changedPresets = PresetsServerSyncProtocol::getChangedPresets (getPresetPointers (presets), serverHashes);
+        expectEquals ((int) changedPresets.size(), 30, "Incorrect number of changed presets!");
+        for (const auto& upload : changedPresets)
+        {
+            const auto presetID = PresetInfoHelpers::getPresetID (*upload.preset);
+            expect (presetID.isEmpty() || presetID.getIntValue() % 8 == 0, "Unchanged preset is being uploaded: " + upload.preset->getName());
+        }
+    }
+
+    void batchesTest (Random& rand)
+    {
+        const auto presets = createPresets (200, rand);
+        auto uploads = PresetsServerSyncProtocol::getChangedPresets (getPresetPointers (presets), {});
+        expectEquals (uploads.size(), presets.size(), "All presets should be uploaded!");
+
+        const auto batches = PresetsServerSyncProtocol::splitIntoBatches (std::move (uploads));
+        size_t numPresetsInBatches = 0;
+        for (const auto& batch : batches)
+        {
+            size_t batchSizeBytes = 0;
+            for (const auto& upload : batch)
+                batchSizeBytes += upload.data.getNumBytesAsUTF8();
+
+            expect (! batch.empty(), "Batch is empty!");
+            expect (batch.size() <= PresetsServerSyncProtocol::maxPresetsPerBatch, "Batch has too many presets!");
+            expect (batch.size() == 1 || batchSizeBytes <= PresetsServerSyncProtocol::maxBatchSizeBytes, "Batch is too large!");
+
+            const auto batchData = PresetsServerSyncProtocol::createBatchRequestData (batch);
+            MemoryInputStream compressedStream { batchData, false };
+            GZIPDecompressorInputStream decompressedStream { compressedStream };
+            const auto batchJson = chowdsp::json::parse (decompressedStream.readEntireStreamAsString().toStdString());
+            expect (batchJson.is_array() && batchJson.size() == batch.size(), "Batch JSON has the wrong number of presets!");
+            expect (batchData.getSize() < batchSizeBytes, "Batch data is not compressed!");
+
+            for (size_t i = 0; i < batch.size(); ++i)
+            {
+                expectEquals (batchJson[i]["name"].get<String>(), batch[i].preset->getName(), "Preset name is incorrect!");
+                expectEquals (batchJson[i]["data"].get<String>(), batch[i].data, "Preset data is incorrect!");
+            }
+
+            numPresetsInBatches += batch.size();
+        }
+
+        expectEquals (numPresetsInBatches, presets.size(), "Batches are missing presets!");
+    }
+
+    void responseStatusTest()
+    {
+        using PresetsServerCommunication::ServerResponse;
+        expect (ServerResponse { 404, {} }.isUnsupported(), "404 should fall back to individual uploads!");
+        expect (ServerResponse { 405, {} }.isUnsupported(), "405 should fall back to individual uploads!");
+
+        for (auto statusCode : { 0, 200, 401, 403, 500, 503 })
+            expect (! ServerResponse { statusCode, {} }.isUnsupported(), "Status code should not fall back to individual uploads: " + String (statusCode));
+    }
+
+#if BYOD_USE_LOCAL_PRESET_SERVER
+    void localServerSyncTest (Random& rand)
+    {
+        using namespace PresetsServerCommunication;
+        const String user = "sync_test_user";
+        const String pass = "sync_test_pass";
+        sendServerRequest (CommType::register_user, user, pass);
+
+        auto presets = createPresets (50, rand);
+        const auto getServerHashes = [&]
+        {
+            const auto response = sendGetPresetHashesRequest (user, pass);
+            expect (response.isOK(), "Unable to get preset hashes from local server!");
+            return PresetsServerSyncProtocol::parseHashesResponse (response.body).value_or (std::map<String, String> {});
+        };
+
+        auto batches = PresetsServerSyncProtocol::splitIntoBatches (PresetsServerSyncProtocol::getChangedPresets (getPresetPointers (presets), getServerHashes()));
+        for (auto& batch : batches)
+        {
+            const auto response = sendSyncPresetsRequest (user, pass, PresetsServerSyncProtocol::createBatchRequestData (batch));
+            const auto presetIDs = PresetsServerSyncProtocol::parseBatchResponse (response.body, batch.size());
+            expect (presetIDs.has_value(), "Unable to sync presets to local server!");
+            if (! presetIDs.has_value())
+                return;
+
+            for (size_t i = 0; i < batch.size(); ++i)
+                PresetInfoHelpers::setPresetID (presets[(size_t) (batch[i].preset - presets.data())], (*presetIDs)[(int) i]);
+        }
+
+        // the server now has the presets, but without their IDs...
+        expectEquals ((int) PresetsServerSyncProtocol::getChangedPresets (getPresetPointers (presets), getServerHashes()).size(), 50);
+
+        // ... so after one more sync, there should be nothing left to upload
+        for (auto& batch : PresetsServerSyncProtocol::splitIntoBatches (PresetsServerSyncProtocol::getChangedPresets (getPresetPointers (presets), getServerHashes())))
+            expect (sendSyncPresetsRequest (user, pass, PresetsServerSyncProtocol::createBatchRequestData (batch)).isOK(), "Unable to sync presets to local server!");
+        expect (PresetsServerSyncProtocol::getChangedPresets (getPresetPointers (presets), getServerHashes()).empty(), "Presets should be up to date!");
+    }
+#endif
+
+    void runTest() override
+    {
+        auto rand = getRandom();
+
+        beginTest ("Content Hash Test");
+        contentHashTest();
+
+        beginTest ("Changed Presets Test");
+        changedPresetsTest (rand);
+
+        beginTest ("Batches Test");
+        batchesTest (rand);
+
+        beginTest ("Response Status Test");
+        responseStatusTest();
+
+#if BYOD_USE_LOCAL_PRESET_SERVER
+        beginTest ("Local Server Sync Test");
+        localServerSyncTest (rand);
+#endif
+    }
+};
+
+static PresetsServerSyncTest presetsServerSyncTest;
+
+#endif // BYOD_BUILD_PRESET_SERVER
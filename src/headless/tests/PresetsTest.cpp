@@ -1,4 +1,5 @@
 #include "UnitTests.h"
+#include "state/presets/FactoryPresets.h"
 
 namespace
 {
@@ -54,10 +55,112 @@ public:
         std::cout << "Processed " << bufferCount << " buffers while loading presets" << std::endl;
     }
 
+    static int getNumConnections (ProcessorChain& procChain)
+    {
+        int numConnections = 0;
+        const auto countConnections = [&numConnections] (const BaseProcessor* proc)
+        {
+            for (int portIdx = 0; portIdx < proc->getNumOutputs(); ++portIdx)
+                numConnections += proc->getNumOutputConnections (portIdx);
+        };
+
+        for (auto* proc : procChain.getProcessors())
+            countConnections (proc);
+        countConnections (&procChain.getInputProcessor());
+        return numConnections;
+    }
+
+    void presetReuseTest()
+    {
+        BYOD plugin;
+        plugin.prepareToPlay (sampleRateToUse, blockSize);
+        plugin.setCurrentProgram (0);
+        MessageManager::getInstance()->runDispatchLoopUntil (50);
+
+        auto& procChain = plugin.getProcChain();
+        Array<BaseProcessor*> procsBefore;
+        for (auto* proc : procChain.getProcessors())
+            procsBefore.add (proc);
+        const auto numConnectionsBefore = getNumConnections (procChain);
+        expect (! procsBefore.isEmpty(), "Preset should contain some processors!");
+
+        // re-loading the same preset should re-use every processor, and keep every connection
+        const auto presetState = procChain.getStateHelper().saveProcChain (true);
+        procChain.getStateHelper().loadProcChain (presetState.get(), chowdsp::Version { std::string_view { JucePlugin_VersionString } }, true);
+        MessageManager::getInstance()->runDispatchLoopUntil (50);
+
+        expectEquals (procChain.getProcessors().size(), procsBefore.size(), "Number of processors is incorrect!");
+        for (auto* proc : procChain.getProcessors())
+            expect (procsBefore.contains (proc), "Processor should have been re-used: " + proc->getName());
+        expectEquals (getNumConnections (procChain), numConnectionsBefore, "Number of connections is incorrect!");
+    }
+
+    void factoryPresetMetadataTest()
+    {
+        for (const auto& presetInfo : FactoryPresets::getFactoryPresetInfo())
+        {
+            const auto placeholderPreset = FactoryPresets::createPlaceholderPreset (presetInfo);
+            const auto fullPreset = FactoryPresets::loadFullPreset (placeholderPreset.getState());
+            expect (fullPreset.has_value(), "Unable to load factory preset: " + String { presetInfo.fileName });
+            if (! fullPreset.has_value())
+                continue;
+
+            expectEquals (placeholderPreset.getName(), fullPreset->getName(), "Preset name is incorrect!");
+            expectEquals (placeholderPreset.getVendor(), fullPreset->getVendor(), "Preset vendor is incorrect!");
+            expectEquals (placeholderPreset.getCategory(), fullPreset->getCategory(), "Preset category is incorrect!");
+
+            // the placeholder should contain every module in the preset
+            StringArray fullPresetModules;
+            for (const auto* procXml : fullPreset->getState()->getChildIterator())
+                fullPresetModules.addIfNotAlreadyThere (procXml->getTagName());
+            fullPresetModules.removeString ("Input");
+            fullPresetModules.removeString ("Output");
+
+            StringArray placeholderModules;
+            for (const auto* procXml : placeholderPreset.getState()->getChildIterator())
+                placeholderModules.add (procXml->getTagName());
+
+            fullPresetModules.sort (false);
+            placeholderModules.sort (false);
+            expect (placeholderModules == fullPresetModules, "Preset modules are incorrect: " + placeholderPreset.getName());
+
+            // the parameter IDs should include every parameter of the enabled modules (apart from on/off)
+            StringArray fullPresetParamIDs;
+            for (const auto* procXml : fullPreset->getState()->getChildIterator())
+            {
+                const auto* paramsXml = procXml->getChildByName ("Parameters");
+                if (procXml->hasTagName ("Input") || procXml->hasTagName ("Output") || paramsXml == nullptr)
+                    continue;
+
+                if (const auto* onOffXml = paramsXml->getChildByAttribute ("id", "on_off"); onOffXml != nullptr && onOffXml->getDoubleAttribute ("value") < 0.5)
+                    continue;
+
+                for (const auto* paramXml : paramsXml->getChildWithTagNameIterator ("PARAM"))
+                    fullPresetParamIDs.addIfNotAlreadyThere (paramXml->getStringAttribute ("id"));
+            }
+            fullPresetParamIDs.removeString ("on_off");
+
+            StringArray tableParamIDs;
+            for (const auto* paramID : presetInfo.parameterIDs)
+                tableParamIDs.add (paramID);
+
+            fullPresetParamIDs.sort (false);
+            tableParamIDs.sort (false);
+            expect (tableParamIDs == fullPresetParamIDs, "Preset parameter IDs are incorrect: " + placeholderPreset.getName());
+            expect (FactoryPresets::getFactoryPresetInfo (placeholderPreset.getState()) == &presetInfo, "Factory preset info not found: " + placeholderPreset.getName());
+        }
+    }
+
     void runTest() override
     {
+        beginTest ("Factory Preset Metadata Test");
+        factoryPresetMetadataTest();
+
         beginTest ("Presets Test");
         presetsTest();
+
+        beginTest ("Preset Re-Use Test");
+        presetReuseTest();
     }
 };
 
@@ -0,0 +1,507 @@
+#include "UnitTests.h"
+#include "processors/ParameterHelpers.h"
+#include "processors/chain/ModuleOversampling.h"
+#include "processors/chain/ProcessorChainActionHelper.h"
+#include "processors/modulation/Tremolo.h"
+
+namespace
+{
+constexpr double sampleRate = 48000.0;
+constexpr int blockSize = 2048;
+constexpr int numBlocks = 4;
+
+/** A lowpass filter with a DC bias on its output, so its output isn't silent when its input is. */
+class BiasedLowpass : public BaseProcessor
+{
+public:
+    BiasedLowpass() : BaseProcessor ("Biased Lowpass", createParameterLayout(), nullptr) {}
+
+    ProcessorType getProcessorType() const override { return Tone; }
+    static ParamLayout createParameterLayout()
+    {
+        auto params = ParameterHelpers::createBaseParams();
+        return { params.begin(), params.end() };
+    }
+
+    void prepare (double sampleRate, int /*samplesPerBlock*/) override
+    {
+        filter.prepare (2);
+        filter.calcCoefs (cutoffFreqHz, (float) sampleRate);
+    }
+
+    void processAudio (AudioBuffer<float>& buffer) override
+    {
+        filter.processBlock (buffer);
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            FloatVectorOperations::add (buffer.getWritePointer (ch), bias, buffer.getNumSamples());
+    }
+
+    double getTailLengthSeconds() const override { return getFilterTailLengthSeconds ((double) cutoffFreqHz); }
+
+    static constexpr float bias = 0.1f;
+
+private:
+    static constexpr float cutoffFreqHz = 1000.0f;
+    chowdsp::FirstOrderLPF<float> filter;
+};
+} // namespace
+
+class ProcessorGraphTest : public UnitTest
+{
+public:
+    ProcessorGraphTest() : UnitTest ("Processor Graph Test")
+    {
+    }
+
+    static void processDCBlocks (ProcessorChain& chain, AudioBuffer<float>& buffer, float dcValue)
+    {
+        MidiBuffer midi;
+        for (int i = 0; i < numBlocks; ++i)
+        {
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                FloatVectorOperations::fill (buffer.getWritePointer (ch), dcValue, blockSize);
+            chain.processAudio (buffer, midi);
+        }
+    }
+
+    void checkOutputLevel (const AudioBuffer<float>& buffer, float expectedLevel)
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            auto minMax = FloatVectorOperations::findMinAndMax (buffer.getReadPointer (ch) + blockSize / 2, blockSize / 2);
+            expectWithinAbsoluteError (minMax.getStart(), expectedLevel, 0.05f, "Output level is incorrect!");
+            expectWithinAbsoluteError (minMax.getEnd(), expectedLevel, 0.05f, "Output level is incorrect!");
+        }
+    }
+
+    void fanOutFanInTest()
+    {
+        BYOD plugin;
+        auto* undoManager = plugin.getVTS().undoManager;
+        auto& chain = plugin.getProcChain();
+        auto& actionHelper = chain.getActionHelper();
+
+        plugin.prepareToPlay (sampleRate, blockSize);
+
+        auto& gainFactory = ProcessorStore::getStoreMap().at ("Clean Gain").factory;
+        auto& mixerFactory = ProcessorStore::getStoreMap().at ("Mixer").factory;
+
+        actionHelper.addProcessor (gainFactory (undoManager));
+        actionHelper.addProcessor (gainFactory (undoManager));
+        actionHelper.addProcessor (gainFactory (undoManager));
+        actionHelper.addProcessor (mixerFactory (undoManager));
+
+        auto* input = &chain.getInputProcessor();
+        auto* gain1 = chain.getProcessors()[0];
+        auto* gain2 = chain.getProcessors()[1];
+        auto* gain3 = chain.getProcessors()[2];
+        auto* mixer = chain.getProcessors()[3];
+        auto* output = &chain.getOutputProcessor();
+
+        actionHelper.removeConnection ({ input, 0, output, 0 });
+        actionHelper.addConnection ({ input, 0, gain1, 0 });
+        actionHelper.addConnection ({ input, 0, gain2, 0 });
+        actionHelper.addConnection ({ gain1, 0, mixer, 0 });
+        actionHelper.addConnection ({ gain2, 0, mixer, 1 });
+        actionHelper.addConnection ({ gain2, 0, gain3, 0 });
+        actionHelper.addConnection ({ gain3, 0, mixer, 2 });
+        actionHelper.addConnection ({ mixer, 0, output, 0 });
+
+        AudioBuffer<float> buffer (2, blockSize);
+        processDCBlocks (chain, buffer, 0.25f);
+        checkOutputLevel (buffer, 0.75f);
+    }
+
+    void wideFanOutTest (bool parallel)
+    {
+        BYOD plugin;
+        auto* undoManager = plugin.getVTS().undoManager;
+        auto& chain = plugin.getProcChain();
+        auto& actionHelper = chain.getActionHelper();
+
+        chain.setParallelProcessingEnabled (parallel);
+        plugin.prepareToPlay (sampleRate, blockSize);
+
+        auto& gainFactory = ProcessorStore::getStoreMap().at ("Clean Gain").factory;
+        auto& mixerFactory = ProcessorStore::getStoreMap().at ("Mixer").factory;
+
+        static constexpr int numBranches = 4;
+        for (int i = 0; i < numBranches; ++i)
+            actionHelper.addProcessor (gainFactory (undoManager));
+        actionHelper.addProcessor (mixerFactory (undoManager));
+
+        auto* input = &chain.getInputProcessor();
+        auto* mixer = chain.getProcessors()[numBranches];
+        auto* output = &chain.getOutputProcessor();
+
+        // the last branch can use the input buffer in-place, the others need copies
+        actionHelper.removeConnection ({ input, 0, output, 0 });
+        for (int i = 0; i < numBranches; ++i)
+        {
+            auto* gain = chain.getProcessors()[i];
+            actionHelper.addConnection ({ input, 0, gain, 0 });
+            actionHelper.addConnection ({ gain, 0, mixer, i });
+        }
+        actionHelper.addConnection ({ mixer, 0, output, 0 });
+
+        AudioBuffer<float> buffer (2, blockSize);
+        processDCBlocks (chain, buffer, 0.25f);
+        checkOutputLevel (buffer, 1.0f);
+
+        chain.setParallelProcessingEnabled (false);
+    }
+
+    void perModuleOversamplingTest()
+    {
+        BYOD plugin;
+        auto* undoManager = plugin.getVTS().undoManager;
+        auto& chain = plugin.getProcChain();
+        auto& actionHelper = chain.getActionHelper();
+
+        plugin.getVTS().getParameter (GlobalParamTags::osScopeTag)->setValueNotifyingHost (1.0f);
+        plugin.prepareToPlay (sampleRate, blockSize);
+
+        auto& gainFactory = ProcessorStore::getStoreMap().at ("Clean Gain").factory;
+        auto& clipperFactory = ProcessorStore::getStoreMap().at ("Diode Clipper").factory;
+        actionHelper.addProcessor (gainFactory (undoManager));
+        actionHelper.addProcessor (clipperFactory (undoManager));
+        actionHelper.addProcessor (clipperFactory (undoManager));
+
+        auto* input = &chain.getInputProcessor();
+        auto* gain = chain.getProcessors()[0];
+        auto* clipper1 = chain.getProcessors()[1];
+        auto* clipper2 = chain.getProcessors()[2];
+        auto* output = &chain.getOutputProcessor();
+
+        // linear modules are processed at the base rate
+        actionHelper.removeConnection ({ input, 0, output, 0 });
+        actionHelper.addConnection ({ input, 0, gain, 0 });
+        actionHelper.addConnection ({ gain, 0, output, 0 });
+
+        AudioBuffer<float> buffer (2, blockSize);
+        processDCBlocks (chain, buffer, 0.25f);
+        checkOutputLevel (buffer, 0.25f);
+        expectEquals (plugin.getLatencySamples(), 0, "Linear modules should not add any latency!");
+
+        // the clippers are oversampled together
+        actionHelper.removeConnection ({ gain, 0, output, 0 });
+        actionHelper.addConnection ({ gain, 0, clipper1, 0 });
+        actionHelper.addConnection ({ clipper1, 0, clipper2, 0 });
+        actionHelper.addConnection ({ clipper2, 0, output, 0 });
+        expectEquals (plugin.getLatencySamples(), roundToInt (ModuleOversampling::getLatencySamples (2)), "Latency should include one oversampling group!");
+
+        MidiBuffer midi;
+        for (int i = 0; i < numBlocks; ++i)
+        {
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                for (int n = 0; n < blockSize; ++n)
+                    buffer.setSample (ch, n, 0.5f * std::sin (MathConstants<float>::twoPi * 100.0f * float (i * blockSize + n) / (float) sampleRate));
+            chain.processAudio (buffer, midi);
+        }
+
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            const auto* data = buffer.getReadPointer (ch);
+            expect (std::all_of (data, data + blockSize, [] (float x) { return std::isfinite (x); }), "Output contains NaNs or Infs!");
+            expectGreaterThan (buffer.getRMSLevel (ch, 0, blockSize), 0.01f, "Output is silent!");
+        }
+    }
+
+    void oversamplingChangeTest()
+    {
+        BYOD plugin;
+        auto* undoManager = plugin.getVTS().undoManager;
+        auto& chain = plugin.getProcChain();
+        auto& actionHelper = chain.getActionHelper();
+
+        plugin.prepareToPlay (sampleRate, blockSize);
+
+        auto& gainFactory = ProcessorStore::getStoreMap().at ("Clean Gain").factory;
+        actionHelper.addProcessor (gainFactory (undoManager));
+
+        auto* input = &chain.getInputProcessor();
+        auto* gain = chain.getProcessors()[0];
+        auto* output = &chain.getOutputProcessor();
+        actionHelper.removeConnection ({ input, 0, output, 0 });
+        actionHelper.addConnection ({ input, 0, gain, 0 });
+        actionHelper.addConnection ({ gain, 0, output, 0 });
+
+        AudioBuffer<float> buffer (2, blockSize);
+        processDCBlocks (chain, buffer, 0.25f);
+        checkOutputLevel (buffer, 0.25f);
+
+        // the arena needs to grow for the higher oversampling factor, which is done by the message thread
+        auto* osFactorParam = dynamic_cast<AudioParameterChoice*> (plugin.getVTS().getParameter ("os_factor"));
+        expect (osFactorParam != nullptr, "Oversampling factor parameter not found!");
+        osFactorParam->setValueNotifyingHost (osFactorParam->convertTo0to1 ((float) osFactorParam->choices.indexOf ("16x")));
+        processDCBlocks (chain, buffer, 0.25f);
+        checkOutputLevel (buffer, 0.25f);
+    }
+
+    void sleepingTest()
+    {
+        BYOD plugin;
+        auto* undoManager = plugin.getVTS().undoManager;
+        auto& chain = plugin.getProcChain();
+        auto& actionHelper = chain.getActionHelper();
+
+        plugin.prepareToPlay (sampleRate, blockSize);
+
+        auto& clipperFactory = ProcessorStore::getStoreMap().at ("Diode Clipper").factory;
+        auto& reverbFactory = ProcessorStore::getStoreMap().at ("Smooth Reverb").factory;
+        actionHelper.addProcessor (clipperFactory (undoManager));
+        actionHelper.addProcessor (reverbFactory (undoManager));
+
+        auto* input = &chain.getInputProcessor();
+        auto* clipper = chain.getProcessors()[0];
+        auto* reverb = chain.getProcessors()[1];
+        auto* output = &chain.getOutputProcessor();
+
+        actionHelper.removeConnection ({ input, 0, output, 0 });
+        actionHelper.addConnection ({ input, 0, clipper, 0 });
+        actionHelper.addConnection ({ clipper, 0, reverb, 0 });
+        actionHelper.addConnection ({ reverb, 0, output, 0 });
+
+        AudioBuffer<float> buffer (2, blockSize);
+        processDCBlocks (chain, buffer, 0.25f);
+        expect (! clipper->isSleeping(), "Processor should not be asleep while processing a signal!");
+        expect (! reverb->isSleeping(), "Processor should not be asleep while processing a signal!");
+
+        // the clipper has a short tail, but the reverb should still be ringing out
+        processDCBlocks (chain, buffer, 0.0f);
+        expect (clipper->isSleeping(), "Processor should be asleep once its tail has finished!");
+        expect (! reverb->isSleeping(), "Processor should not be asleep before its tail has finished!");
+        expectGreaterThan (buffer.getMagnitude (0, blockSize), 0.0f, "Reverb tail was cut off!");
+
+        processDCBlocks (chain, buffer, 0.25f);
+        expect (! clipper->isSleeping(), "Processor should wake up when its input is no longer silent!");
+        expectGreaterThan (buffer.getMagnitude (0, blockSize), 0.01f, "Output is silent!");
+    }
+
+    void sleepContinuityTest()
+    {
+        // the first chain can go to sleep during the silence, but the second chain gets
+        // a tiny (inaudible) signal, which keeps all of its processors awake
+        struct TestChain
+        {
+            BYOD plugin;
+            BaseProcessor* clipper = nullptr;
+            BaseProcessor* biased = nullptr;
+        };
+        TestChain sleepingChain, continuousChain;
+        for (auto* testChain : { &sleepingChain, &continuousChain })
+        {
+            auto& chain = testChain->plugin.getProcChain();
+            auto& actionHelper = chain.getActionHelper();
+            testChain->plugin.prepareToPlay (sampleRate, blockSize);
+
+            actionHelper.addProcessor (ProcessorStore::getStoreMap().at ("Diode Clipper").factory (testChain->plugin.getVTS().undoManager));
+            actionHelper.addProcessor (std::make_unique<BiasedLowpass>());
+
+            auto* input = &chain.getInputProcessor();
+            testChain->clipper = chain.getProcessors()[0];
+            testChain->biased = chain.getProcessors()[1];
+            auto* output = &chain.getOutputProcessor();
+
+            actionHelper.removeConnection ({ input, 0, output, 0 });
+            actionHelper.addConnection ({ input, 0, testChain->clipper, 0 });
+            actionHelper.addConnection ({ testChain->clipper, 0, testChain->biased, 0 });
+            actionHelper.addConnection ({ testChain->biased, 0, output, 0 });
+        }
+
+        AudioBuffer<float> sleepingBuffer (2, blockSize);
+        AudioBuffer<float> continuousBuffer (2, blockSize);
+        MidiBuffer midi;
+        int sampleCount = 0;
+        const auto processBlocks = [&] (bool silent)
+        {
+            for (int i = 0; i < numBlocks; ++i)
+            {
+                for (int ch = 0; ch < sleepingBuffer.getNumChannels(); ++ch)
+                {
+                    for (int n = 0; n < blockSize; ++n)
+                    {
+                        const auto x = 0.5f * std::sin (MathConstants<float>::twoPi * 100.0f * float (sampleCount + n) / (float) sampleRate);
+                        sleepingBuffer.setSample (ch, n, silent ? 0.0f : x);
+                        continuousBuffer.setSample (ch, n, silent ? (n % 2 == 0 ? 1.0e-5f : -1.0e-5f) : x);
+                    }
+                }
+                sampleCount += blockSize;
+
+                sleepingChain.plugin.getProcChain().processAudio (sleepingBuffer, midi);
+                continuousChain.plugin.getProcChain().processAudio (continuousBuffer, midi);
+
+                float maxError = 0.0f;
+                for (int ch = 0; ch < sleepingBuffer.getNumChannels(); ++ch)
+                    for (int n = 0; n < blockSize; ++n)
+                        maxError = jmax (maxError, std::abs (sleepingBuffer.getSample (ch, n) - continuousBuffer.getSample (ch, n)));
+                expectLessThan (maxError, 1.0e-3f, "Output doesn't match continuous processing!");
+            }
+        };
+
+        processBlocks (false);
+        expect (! continuousChain.clipper->isSleeping() && ! continuousChain.biased->isSleeping(), "Processors should not go to sleep while processing a signal!");
+
+        processBlocks (true);
+        expect (sleepingChain.clipper->isSleeping(), "Processor should be asleep once its tail has finished!");
+        expect (! sleepingChain.biased->isSleeping(), "Processor should not go to sleep while its output has a DC bias!");
+        expect (! continuousChain.clipper->isSleeping(), "Processor should not go to sleep while its input is not silent!");
+        expectGreaterThan (std::abs (sleepingBuffer.getSample (0, blockSize - 1)), 0.5f * BiasedLowpass::bias, "DC bias was cut off!");
+
+        processBlocks (false);
+        expect (! sleepingChain.clipper->isSleeping(), "Processor should wake up when its input is no longer silent!");
+    }
+
+    void topologyChangeTest()
+    {
+        BYOD plugin;
+        auto* undoManager = plugin.getVTS().undoManager;
+        auto& chain = plugin.getProcChain();
+        auto& actionHelper = chain.getActionHelper();
+
+        plugin.prepareToPlay (sampleRate, blockSize);
+
+        AudioBuffer<float> buffer (2, blockSize);
+        processDCBlocks (chain, buffer, 0.25f);
+        checkOutputLevel (buffer, 0.25f);
+
+        auto& gainFactory = ProcessorStore::getStoreMap().at ("Clean Gain").factory;
+        auto& mixerFactory = ProcessorStore::getStoreMap().at ("Mixer").factory;
+        actionHelper.addProcessor (gainFactory (undoManager));
+        actionHelper.addProcessor (gainFactory (undoManager));
+        actionHelper.addProcessor (mixerFactory (undoManager));
+
+        auto* input = &chain.getInputProcessor();
+        auto* gain1 = chain.getProcessors()[0];
+        auto* gain2 = chain.getProcessors()[1];
+        auto* mixer = chain.getProcessors()[2];
+        auto* output = &chain.getOutputProcessor();
+
+        // each change should be picked up by the next block
+        actionHelper.removeConnection ({ input, 0, output, 0 });
+        actionHelper.addConnection ({ input, 0, gain1, 0 });
+        actionHelper.addConnection ({ gain1, 0, output, 0 });
+        processDCBlocks (chain, buffer, 0.25f);
+        checkOutputLevel (buffer, 0.25f);
+
+        actionHelper.removeConnection ({ gain1, 0, output, 0 });
+        actionHelper.addConnection ({ gain1, 0, mixer, 0 });
+        actionHelper.addConnection ({ input, 0, gain2, 0 });
+        actionHelper.addConnection ({ gain2, 0, mixer, 1 });
+        actionHelper.addConnection ({ mixer, 0, output, 0 });
+        processDCBlocks (chain, buffer, 0.25f);
+        checkOutputLevel (buffer, 0.5f);
+
+        actionHelper.removeProcessor (gain2);
+        processDCBlocks (chain, buffer, 0.25f);
+        checkOutputLevel (buffer, 0.25f);
+    }
+
+    void mathsQualityChangeTest()
+    {
+        BYOD plugin;
+        auto* undoManager = plugin.getVTS().undoManager;
+        auto& chain = plugin.getProcChain();
+        auto& actionHelper = chain.getActionHelper();
+
+        plugin.prepareToPlay (sampleRate, blockSize);
+
+        auto& gainFactory = ProcessorStore::getStoreMap().at ("Clean Gain").factory;
+        actionHelper.addProcessor (gainFactory (undoManager));
+
+        auto* input = &chain.getInputProcessor();
+        auto* gain = chain.getProcessors()[0];
+        auto* output = &chain.getOutputProcessor();
+        actionHelper.removeConnection ({ input, 0, output, 0 });
+        actionHelper.addConnection ({ input, 0, gain, 0 });
+        actionHelper.addConnection ({ gain, 0, output, 0 });
+
+        // the processors are re-prepared while the audio thread uses a schedule that doesn't touch them
+        const auto silentSchedule = ProcessorChainSchedule::createSilent();
+        expect (silentSchedule->steps.empty(), "Silent schedule should not process anything!");
+        expect (! silentSchedule->reachesOutput, "Silent schedule should not reach the output!");
+
+        AudioBuffer<float> buffer (2, blockSize);
+        processDCBlocks (chain, buffer, 0.25f);
+        checkOutputLevel (buffer, 0.25f);
+
+        const auto originalQuality = chain.getMathsQuality();
+        chain.setMathsQuality (originalQuality == MathsQuality::High ? MathsQuality::Eco : MathsQuality::High);
+        processDCBlocks (chain, buffer, 0.25f);
+        checkOutputLevel (buffer, 0.25f);
+        chain.setMathsQuality (originalQuality);
+    }
+
+    void controlRateModulationTest()
+    {
+        BYOD plugin;
+        auto* undoManager = plugin.getVTS().undoManager;
+        auto& chain = plugin.getProcChain();
+        auto& actionHelper = chain.getActionHelper();
+
+        plugin.prepareToPlay (sampleRate, blockSize);
+
+        auto& modulatorFactory = ProcessorStore::getStoreMap().at ("Param Modulator").factory;
+        auto& tremoloFactory = ProcessorStore::getStoreMap().at ("Tremolo").factory;
+        auto& mixerFactory = ProcessorStore::getStoreMap().at ("Mixer").factory;
+        actionHelper.addProcessor (modulatorFactory (undoManager));
+        actionHelper.addProcessor (tremoloFactory (undoManager));
+        actionHelper.addProcessor (mixerFactory (undoManager));
+
+        auto* input = &chain.getInputProcessor();
+        auto* modulator = chain.getProcessors()[0];
+        auto* tremolo = chain.getProcessors()[1];
+        auto* mixer = chain.getProcessors()[2];
+        auto* output = &chain.getOutputProcessor();
+
+        auto* modParam = modulator->getVTS().getParameter ("bipolar_mod");
+        modParam->setValueNotifyingHost (modParam->convertTo0to1 (0.25f));
+
+        // the control-rate signal gets passed along as it is to the tremolo's modulation input,
+        // and gets upsampled for the mixer's audio inputs
+        actionHelper.removeConnection ({ input, 0, output, 0 });
+        actionHelper.addConnection ({ modulator, 0, mixer, 0 });
+        actionHelper.addConnection ({ modulator, 0, tremolo, Tremolo::ModulationInput });
+        actionHelper.addConnection ({ tremolo, Tremolo::ModulationOutput, mixer, 1 });
+        actionHelper.addConnection ({ mixer, 0, output, 0 });
+
+        AudioBuffer<float> buffer (2, blockSize);
+        processDCBlocks (chain, buffer, 0.0f);
+        checkOutputLevel (buffer, 0.5f);
+    }
+
+    void runTest() override
+    {
+        beginTest ("Fan-Out/Fan-In Test");
+        fanOutFanInTest();
+
+        beginTest ("Wide Fan-Out Test");
+        wideFanOutTest (false);
+
+        beginTest ("Parallel Fan-Out Test");
+        wideFanOutTest (true);
+
+        beginTest ("Per-Module Oversampling Test");
+        perModuleOversamplingTest();
+
+        beginTest ("Oversampling Change Test");
+        oversamplingChangeTest();
+
+        beginTest ("Sleeping Test");
+        sleepingTest();
+
+        beginTest ("Sleep Continuity Test");
+        sleepContinuityTest();
+
+        beginTest ("Topology Change Test");
+        topologyChangeTest();
+
+        beginTest ("Maths Quality Change Test");
+        mathsQualityChangeTest();
+
+        beginTest ("Control-Rate Modulation Test");
+        controlRateModulationTest();
+    }
+};
+
+static ProcessorGraphTest processorGraphTest;
@@ -1,21 +1,84 @@
 #include "UnitTests.h"
+#include "processors/drive/GuitarMLAmp.h"
+#include "processors/tone/IRConvolution.h"
 
+#if JUCE_LINUX
+#include <malloc.h>
+#endif
+
+#if JUCE_MAC || JUCE_LINUX
+namespace
+{
 #if JUCE_MAC
 // borrowed from: https://developer.apple.com/forums/thread/105088?answerId=357415022#357415022
-static float getCurrentMemoryUsageGB()
+int64_t getCurrentMemoryUsageBytes()
 {
     auto info = task_vm_info_data_t {};
     auto info_count = TASK_VM_INFO_COUNT;
 
     if (task_info (mach_task_self(), task_flavor_t (TASK_VM_INFO), reinterpret_cast<task_info_t> (&info), &info_count) == KERN_SUCCESS)
+        return (int64_t) info.phys_footprint;
+
+    // unable to get virtual memory info on this platform!
+    return 0;
+}
+#elif JUCE_LINUX
+/** Returns the proportional set size of this process, (used if the allocator statistics aren't available). */
+int64_t getProportionalSetSizeBytes()
+{
+    const auto smapsRollup = File { "/proc/self/smaps_rollup" }.loadFileAsString();
+    for (const auto& line : StringArray::fromLines (smapsRollup))
     {
-        return float (info.phys_footprint) * 1.0e-9f; // phys_footprint is in bytes, so let's convert to GigaBytes
+        if (line.startsWith ("Pss:"))
+            return line.fromFirstOccurrenceOf ("Pss:", false, false).trim().getLargeIntValue() * 1024; // value is in kB
     }
 
-    // unable to get virtual memory info on this platform!
-    return 0.0f;
+    return 0;
 }
 
+int64_t getCurrentMemoryUsageBytes()
+{
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+    // The heap statistics count every allocation (including memory that hasn't
+    // been touched yet), which is what we want when budgeting for many instances.
+    const auto info = mallinfo2();
+    return (int64_t) (info.uordblks + info.hblkhd);
+#else
+    return getProportionalSetSizeBytes();
+#endif
+}
+#endif
+
+/**
+ * The memory usage is measured for the whole process, so we need to make sure
+ * the IR and neural model loaders aren't allocating anything in the background,
+ * (e.g. a model that was requested when the previous module was created).
+ */
+bool waitForBackgroundLoading()
+{
+    static constexpr uint32 timeoutMs = 10000;
+    const auto startTime = Time::getMillisecondCounter();
+    while (! IRConvolution::isBackgroundLoadingIdle() || ! GuitarMLAmp::isBackgroundLoadingIdle())
+    {
+        if (Time::getMillisecondCounter() - startTime > timeoutMs)
+            return false;
+
+        Thread::sleep (1);
+    }
+
+    return true;
+}
+
+constexpr double sampleRate = 48000.0;
+constexpr int blockSize = 1024;
+constexpr int osFactors[] = { 1, 2, 4, 8, 16 };
+constexpr auto numOSFactors = std::size (osFactors);
+
+// modules whose footprint grows by more than this (and at least 64 kB) at the highest OS factor are flagged
+constexpr double osScalingThreshold = 1.5;
+constexpr int64_t osScalingMinBytes = 1 << 16;
+} // namespace
+
 class RAMUSageTest : public UnitTest
 {
 public:
@@ -27,26 +90,55 @@ public:
     {
         struct UsageInfo
         {
-            std::string name;
-            float usageGB = 0.0f;
+            String name;
+            std::array<int64_t, numOSFactors> usageBytes {};
         };
         std::vector<UsageInfo> usageInfo;
         usageInfo.reserve (ProcessorStore::getStoreMap().size());
 
-        const auto baseMemoryUsage = getCurrentMemoryUsageGB();
-        runTestForAllProcessors (
-            this,
-            [baseMemoryUsage, &usageInfo] (BaseProcessor* proc)
-            {
-                proc->prepareProcessing (48000.0, 1024);
-                const auto memoryUsage = getCurrentMemoryUsageGB() - baseMemoryUsage;
-                usageInfo.push_back ({ proc->getName().toStdString(), memoryUsage });
-            });
+        // each OS factor gets a fresh set of processors, so we only measure the memory allocated while preparing
+        for (size_t osIndex = 0; osIndex < numOSFactors; ++osIndex)
+        {
+            size_t procIndex = 0;
+            runTestForAllProcessors (
+                this,
+                [this, osIndex, &procIndex, &usageInfo] (BaseProcessor* proc)
+                {
+                    if (osIndex == 0)
+                        usageInfo.push_back ({ proc->getName() });
+
+                    const auto osFactor = osFactors[osIndex];
+                    expect (waitForBackgroundLoading(), "Background loading did not finish before preparing " + proc->getName());
+                    const auto baseMemoryUsage = getCurrentMemoryUsageBytes();
+                    proc->prepareProcessing (sampleRate * osFactor, blockSize * osFactor, osFactor);
+                    expect (waitForBackgroundLoading(), "Background loading did not finish after preparing " + proc->getName());
+                    usageInfo[procIndex++].usageBytes[osIndex] = getCurrentMemoryUsageBytes() - baseMemoryUsage;
+                },
+                {},
+                osIndex == 0);
+        }
 
         std::sort (usageInfo.begin(), usageInfo.end(), [] (const auto& u1, const auto& u2)
-                   { return u1.usageGB < u2.usageGB; });
+                   { return u1.usageBytes[0] < u2.usageBytes[0]; });
+
+        String header = "Module";
+        for (auto osFactor : osFactors)
+            header << ", " << String (osFactor) << "x (kB)";
+        std::cout << header << std::endl;
+
         for (const auto& uInfo : usageInfo)
-            std::cout << uInfo.name << ": " << uInfo.usageGB << std::endl;
+        {
+            String line = uInfo.name;
+            for (auto usageBytes : uInfo.usageBytes)
+                line << ", " << String ((double) usageBytes / 1024.0, 1);
+
+            const auto baseUsage = uInfo.usageBytes.front();
+            const auto maxOSUsage = uInfo.usageBytes.back();
+            if (maxOSUsage - baseUsage > osScalingMinBytes && (double) maxOSUsage > osScalingThreshold * (double) baseUsage)
+                line << " <-- scales with OS factor";
+
+            std::cout << line << std::endl;
+        }
     }
 };
 
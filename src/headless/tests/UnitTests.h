@@ -1,5 +1,9 @@
 #include "../../BYOD.h"
 
+/**
+ * Runs a test function for every processor in the store.
+ * The UnitTest may be null, (e.g. when running benchmarks outside of a unit test).
+ */
 static inline void runTestForAllProcessors (UnitTest* ut,
                                             const std::function<void (BaseProcessor*)>& testFunc,
                                             const StringArray& procsToSkip = {},
@@ -10,13 +14,13 @@ static inline void runTestForAllProcessors (UnitTest* ut,
     {
         if (procsToSkip.contains (name))
         {
-            std::cout << "Skipping " << ut->getName() << " for processor: " << name << std::endl;
+            std::cout << "Skipping " << (ut != nullptr ? ut->getName() : String { "test" }) << " for processor: " << name << std::endl;
             continue;
         }
 
         auto proc = storeEntry.factory (nullptr);
         proc->playheadHelpers = &playheadHelper;
-        if (startNewTest)
+        if (startNewTest && ut != nullptr)
             ut->beginTest (proc->getName() + " Test");
         testFunc (proc.get());
         proc->freeInternalMemory();
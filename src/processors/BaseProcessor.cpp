@@ -1,8 +1,23 @@
 #include "BaseProcessor.h"
+#include "BufferHelpers.h"
+#include "chain/ModuleOversampling.h"
 #include "gui/pedalboard/editors/ProcessorEditor.h"
 #include "netlist_helpers/NetlistViewer.h"
 #include "state/ParamForwardManager.h"
 
+namespace
+{
+/**
+ * The processor might already be running (e.g. if a preset has re-used it),
+ * so the new circuit values get applied on the audio thread, before the next block.
+ */
+void requestCircuitQuantitiesUpdate (netlist::CircuitQuantityList& quantities)
+{
+    for (auto& quantity : quantities)
+        quantity.needsUpdate = true;
+}
+} // namespace
+
 BaseProcessor::BaseProcessor (const String& name,
                               ParamLayout params,
                               UndoManager* um) : BaseProcessor (
@@ -37,14 +52,34 @@ BaseProcessor::BaseProcessor (const String& name,
     outputConnections.resize ((size_t) numOutputs);
 
     inputBuffers.resize (numInputs);
-    inputsConnected.resize (0);
+    inputsConnected.ensureStorageAllocated (numInputs);
     portMagnitudes.resize ((size_t) numInputs);
+
+    inputControlRates.resize ((size_t) numInputs);
+    outputControlRates.resize ((size_t) numOutputs);
 }
 
 BaseProcessor::~BaseProcessor() = default;
 
-void BaseProcessor::prepareProcessing (double sampleRate, int numSamples)
+double BaseProcessor::getTailLengthSeconds() const
 {
+    return std::numeric_limits<double>::infinity();
+}
+
+double BaseProcessor::getFilterTailLengthSeconds (double freqHz, double q)
+{
+    const auto decayTimeConstant = q / (MathConstants<double>::pi * freqHz);
+    return std::log (1.0e4) * decayTimeConstant;
+}
+
+void BaseProcessor::prepareProcessing (double sampleRate, int numSamples, int oversamplingFactor, MathsQuality mathsQuality)
+{
+    processingSampleRate = sampleRate;
+    processingOversamplingFactor = oversamplingFactor;
+    processingMathsQuality = mathsQuality;
+    numSilentSamples = 0;
+    sleeping.store (false);
+
     prepare (sampleRate, numSamples);
 
     for (auto& mag : portMagnitudes)
@@ -62,10 +97,12 @@ void BaseProcessor::freeInternalMemory()
 
 void BaseProcessor::processAudioBlock (AudioBuffer<float>& buffer)
 {
+    const auto startTime = std::chrono::steady_clock::now();
+    const auto numSamples = buffer.getNumSamples();
+
     auto updateBufferMag = [&] (const chowdsp::BufferView<const float>& inBuffer, int inputIndex)
     {
         const auto inBufferNumChannels = inBuffer.getNumChannels();
-        const auto inBufferNumSamples = inBuffer.getNumSamples();
 
         auto rmsAvg = 0.0f;
         for (int ch = 0; ch < inBufferNumChannels; ++ch)
@@ -73,8 +110,9 @@ void BaseProcessor::processAudioBlock (AudioBuffer<float>& buffer)
         rmsAvg /= (float) inBufferNumChannels;
 
         auto& portMag = portMagnitudes[(size_t) inputIndex];
+        // control-rate inputs have fewer samples than the block, so the smoother runs for the whole block
         float curMag = 0.0f;
-        for (int n = 0; n < inBufferNumSamples; ++n)
+        for (int n = 0; n < numSamples; ++n)
             curMag = portMag.smoother.processSample (rmsAvg);
         portMag.currentMagnitudeDB.set (curMag);
     };
@@ -110,6 +148,42 @@ void BaseProcessor::processAudioBlock (AudioBuffer<float>& buffer)
         processAudioBypassed (buffer);
     else
         processAudio (buffer);
+
+    const auto processingTime = std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now() - startTime);
+    timingStats.addBlock (processingTime.count(), (int64_t) ((double) numSamples * 1.0e9 / processingSampleRate));
+}
+
+bool BaseProcessor::updateSleepState (bool inputsAreSilent, int numSamples) noexcept
+{
+    if (! inputsAreSilent)
+    {
+        numSilentSamples = 0;
+        sleeping.store (false, std::memory_order_relaxed);
+        return false;
+    }
+
+    if (sleeping.load (std::memory_order_relaxed))
+        return true;
+
+    numSilentSamples += numSamples;
+    const auto tailLengthSamples = getTailLengthSeconds() * processingSampleRate;
+    const auto shouldSleep = (double) numSilentSamples > tailLengthSamples;
+    sleeping.store (shouldSleep, std::memory_order_relaxed);
+    return shouldSleep;
+}
+
+void BaseProcessor::processSilentBlock (AudioBuffer<float>& buffer)
+{
+    buffer.clear();
+
+    if (portMagnitudesOn)
+    {
+        for (auto& mag : portMagnitudes)
+        {
+            mag.smoother.reset();
+            mag.currentMagnitudeDB = -100.0f;
+        }
+    }
 }
 
 float BaseProcessor::getInputLevelDB (int portIndex) const noexcept
@@ -185,11 +259,19 @@ void BaseProcessor::fromXML (XmlElement* xml, const chowdsp::Version&, bool load
                 quantity.value = quantity.defaultValue;
         }
 
-        for (auto& quantity : *netlistCircuitQuantities)
-        {
-            quantity.setter (quantity);
-            quantity.needsUpdate = false;
-        }
+        requestCircuitQuantitiesUpdate (*netlistCircuitQuantities);
+    }
+}
+
+void BaseProcessor::applyNetlistCircuitQuantities()
+{
+    if (netlistCircuitQuantities == nullptr)
+        return;
+
+    for (auto& quantity : *netlistCircuitQuantities)
+    {
+        quantity.setter (quantity);
+        quantity.needsUpdate = false;
     }
 }
 
@@ -206,18 +288,89 @@ void BaseProcessor::loadPositionInfoFromXML (XmlElement* xml)
     editorPosition = juce::Point { xPos, yPos };
 }
 
-void BaseProcessor::addConnection (ConnectionInfo&& info)
+void BaseProcessor::toBinary (BinaryStateWriter& writer)
+{
+    writer.writeFloat (editorPosition.x);
+    writer.writeFloat (editorPosition.y);
+    writer.writeInt (forwardingParamsSlotIndex);
+    writer.writeParameterState (vts.copyState());
+
+    // the circuit quantity names are stored in an ID table, so the values can be matched up by name when loading
+    StringArray quantityNames;
+    if (netlistCircuitQuantities != nullptr)
+    {
+        for (const auto& quantity : *netlistCircuitQuantities)
+            quantityNames.add (juce::String { quantity.name });
+    }
+
+    writer.writeIDTable (quantityNames);
+    if (netlistCircuitQuantities != nullptr)
+    {
+        for (const auto& quantity : *netlistCircuitQuantities)
+            writer.writeFloat (quantity.value);
+    }
+}
+
+void BaseProcessor::fromBinary (BinaryStateReader& reader, const chowdsp::Version&, bool loadPosition)
+{
+    const auto xPos = reader.readFloat();
+    const auto yPos = reader.readFloat();
+    const auto slotIndex = reader.readInt();
+    auto state = reader.readParameterState();
+    if (reader.hasFailed() || ! state.hasType (vts.state.getType()))
+        return;
+
+    vts.state = state; // don't use `replaceState()` otherwise UndoManager will clear
+    forwardingParamsSlotIndex = slotIndex;
+
+    if (loadPosition)
+        editorPosition = juce::Point { xPos, yPos };
+
+    // (the first version of the format didn't store the circuit quantity names)
+    const auto hasQuantityNames = reader.getFormatVersion() >= 2;
+    const auto quantityNames = hasQuantityNames ? reader.readIDTable() : StringArray {};
+    std::vector<float> quantityValues ((size_t) (hasQuantityNames ? quantityNames.size() : reader.readCount (sizeof (float))));
+    for (auto& value : quantityValues)
+        value = reader.readFloat();
+
+    if (netlistCircuitQuantities != nullptr)
+    {
+        // Any quantities that aren't in the saved state go back to their defaults. Older states only
+        // stored the quantities in order, so those can only be loaded if the netlist hasn't changed.
+        const auto quantitiesMatch = quantityValues.size() == netlistCircuitQuantities->size();
+        for (auto [idx, quantity] : chowdsp::enumerate (*netlistCircuitQuantities))
+        {
+            const auto savedIndex = hasQuantityNames ? quantityNames.indexOf (juce::String { quantity.name })
+                                                     : (quantitiesMatch ? (int) idx : -1);
+            quantity.value = isPositiveAndBelow (savedIndex, quantityValues.size()) ? quantityValues[(size_t) savedIndex] : quantity.defaultValue;
+        }
+
+        requestCircuitQuantitiesUpdate (*netlistCircuitQuantities);
+    }
+}
+
+void BaseProcessor::loadPositionInfoFromBinary (BinaryStateReader reader)
+{
+    const auto xPos = reader.readFloat();
+    const auto yPos = reader.readFloat();
+    if (! reader.hasFailed())
+        editorPosition = juce::Point { xPos, yPos };
+}
+
+void BaseProcessor::addConnection (ConnectionInfo&& info, bool updateProcessingInputs)
 {
     jassert (info.startProc == this);
     outputConnections[(size_t) info.startPort].add (info);
 
     // make sure the end processor actually has an input port available that we can connect to!
-    jassert (info.endProc->inputsConnected.size() + 1 <= info.endProc->numInputs);
-    info.endProc->inputsConnected.addUsingDefaultSort (info.endPort);
+    jassert (info.endProc->connectedInputPorts.size() + 1 <= info.endProc->numInputs);
+    info.endProc->connectedInputPorts.addUsingDefaultSort (info.endPort);
+    if (updateProcessingInputs)
+        info.endProc->updateInputsConnected (info.endProc->connectedInputPorts);
     info.endProc->inputConnectionChanged (info.endPort, true);
 }
 
-void BaseProcessor::removeConnection (const ConnectionInfo& info)
+void BaseProcessor::removeConnection (const ConnectionInfo& info, bool updateProcessingInputs)
 {
     jassert (info.startProc == this);
 
@@ -227,13 +380,23 @@ void BaseProcessor::removeConnection (const ConnectionInfo& info)
         if (connections[cIdx].endProc == info.endProc && connections[cIdx].endPort == info.endPort)
         {
             connections.remove (cIdx);
-            info.endProc->inputsConnected.removeFirstMatchingValue (info.endPort);
+            info.endProc->connectedInputPorts.removeFirstMatchingValue (info.endPort);
+            if (updateProcessingInputs)
+                info.endProc->updateInputsConnected (info.endProc->connectedInputPorts);
             info.endProc->inputConnectionChanged (info.endPort, false);
             break;
         }
     }
 }
 
+void BaseProcessor::updateInputsConnected (const Array<int>& newInputsConnected) noexcept
+{
+    // storage for all the input ports is allocated up front, so this should never allocate
+    jassert (newInputsConnected.size() <= numInputs);
+    inputsConnected.clearQuick();
+    inputsConnected.addArray (newInputsConnected);
+}
+
 const std::vector<String>* BaseProcessor::getParametersToDisableWhenInputIsConnected (int portIndex) const noexcept
 {
     if (auto iter = paramsToDisableWhenInputConnected.find (portIndex); iter != paramsToDisableWhenInputConnected.end())
@@ -315,7 +478,7 @@ void BaseProcessor::addToPopupMenu (PopupMenu& menu)
         bool isEnabled = true;
         for (int i = 0; i < getNumInputs(); ++i)
         {
-            if (! inputsConnected.contains (i))
+            if (! connectedInputPorts.contains (i))
                 continue;
 
             if (auto* paramIDsToDisable = getParametersToDisableWhenInputIsConnected (i);
@@ -358,6 +521,50 @@ PortType BaseProcessor::getOutputPortType (int portIndex) const
     return outputPortTypes[(size_t) portIndex];
 }
 
+std::optional<ControlRate::Smoothing> BaseProcessor::getOutputControlRate (int portIndex) const
+{
+    return outputControlRates[(size_t) portIndex];
+}
+
+void BaseProcessor::setInputControlRate (int portIndex, std::optional<ControlRate::Smoothing> smoothing) noexcept
+{
+    inputControlRates[(size_t) portIndex] = smoothing;
+}
+
+std::optional<ControlRate::Smoothing> BaseProcessor::getInputControlRate (int portIndex) const noexcept
+{
+    return inputControlRates[(size_t) portIndex];
+}
+
+void BaseProcessor::setControlRateOutput (int outputPortIndex, ControlRate::Smoothing smoothing)
+{
+    jassert (getOutputPortType (outputPortIndex) == PortType::modulation); // only modulation outputs can be control-rate!
+    outputControlRates[(size_t) outputPortIndex] = smoothing;
+}
+
+void BaseProcessor::getModulationInput (int inputPortIndex, ControlRate::Signal& signal, int numSamples) const
+{
+    const auto modInputBuffer = getInputBuffer (inputPortIndex);
+    if (getInputControlRate (inputPortIndex).has_value())
+        signal.copyFrom (modInputBuffer, numSamples);
+    else
+        signal.decimateFrom (modInputBuffer);
+}
+
+void BaseProcessor::getModulationInput (int inputPortIndex, AudioBuffer<float>& buffer) const
+{
+    const auto modInputBuffer = getInputBuffer (inputPortIndex);
+    if (const auto smoothing = getInputControlRate (inputPortIndex); smoothing.has_value())
+    {
+        // control-rate signals are always mono
+        jassert (modInputBuffer.getNumSamples() == ControlRate::getNumValues (buffer.getNumSamples()));
+        ControlRate::upsample (modInputBuffer.getReadPointer (0), buffer.getWritePointer (0), buffer.getNumSamples(), *smoothing);
+        return;
+    }
+
+    BufferHelpers::collapseToMonoBuffer (modInputBuffer, buffer);
+}
+
 void BaseProcessor::setPosition (juce::Point<int> pos, juce::Rectangle<int> parentBounds)
 {
     if (parentBounds.getWidth() <= 0 || parentBounds.getHeight() <= 0)
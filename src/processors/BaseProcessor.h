@@ -1,6 +1,10 @@
 #pragma once
 
+#include "ControlRate.h"
 #include "JuceProcWrapper.h"
+#include "ProcessorTimingStats.h"
+#include "drive/MathsQuality.h"
+#include "state/BinaryState.h"
 
 enum ProcessorType
 {
@@ -35,6 +39,7 @@ struct ProcessorUIOptions
 
 class BaseProcessor;
 class ProcessorEditor;
+class ModuleOversampling;
 struct PlayheadHelpers;
 namespace netlist
 {
@@ -117,14 +122,64 @@ public:
 
     // metadata
     virtual ProcessorType getProcessorType() const = 0;
+
+    /**
+     * Returns true if the processor is nonlinear, and should be oversampled
+     * even when the processor chain is only oversampling the nonlinear modules.
+     */
+    virtual bool isNonlinear() const { return getProcessorType() == Drive; }
+
+    /**
+     * Returns the length of time (in seconds) that the processor keeps producing
+     * output after its inputs have gone silent. Once the inputs have been silent
+     * for longer than the tail, the processor chain can put the processor to sleep.
+     *
+     * By default, modules have an infinite tail (i.e. they are never put to sleep),
+     * since they might have long decays, or produce a signal without any input.
+     * Modules that can be put to sleep should override this with their actual tail.
+     */
+    double getTailLengthSeconds() const override;
     const String getName() const override { return JuceProcWrapper::getName(); }
 
     // audio processing methods
     bool isBypassed() const { return ! static_cast<bool> (onOffParam->load()); }
-    void prepareProcessing (double sampleRate, int numSamples);
+
+    /**
+     * Prepares the processor to process audio at the given sample rate.
+     *
+     * If the processor chain is oversampled, the sample rate and block size
+     * will already include the oversampling factor, but the factor is passed
+     * along as well, so that modules which don't need the extra bandwidth
+     * can do their processing at the host sample rate.
+     *
+     * The maths quality sets the accuracy of the approximate maths used
+     * by modules with expensive non-linearities (e.g. WDF diodes or RNNs).
+     */
+    void prepareProcessing (double sampleRate, int numSamples, int oversamplingFactor = 1, MathsQuality mathsQuality = MathsQuality::Normal);
     void freeInternalMemory();
     void processAudioBlock (AudioBuffer<float>& buffer);
 
+    /**
+     * Updates the processor's sleep state, and returns true if the processor
+     * is asleep, (i.e. its inputs have been silent for longer than its tail).
+     */
+    bool updateSleepState (bool inputsAreSilent, int numSamples) noexcept;
+    bool isSleeping() const noexcept { return sleeping.load(); }
+
+    /**
+     * Called by the processor chain when the processor's inputs are silent, but its output
+     * isn't (e.g. a module with a DC offset). The processor then stays awake until its output
+     * is silent as well, so that the output doesn't jump to silence when it goes to sleep.
+     */
+    void outputIsNotSilent() noexcept { numSilentSamples = 0; }
+
+    /** Used by the processor chain instead of processAudioBlock() while the processor is asleep. */
+    void processSilentBlock (AudioBuffer<float>& buffer);
+
+    /** Returns the processing time statistics for this processor. */
+    ProcessorTimingStats& getTimingStats() noexcept { return timingStats; }
+    const ProcessorTimingStats& getTimingStats() const noexcept { return timingStats; }
+
     // methods for working with port input levels
     float getInputLevelDB (int portIndex) const noexcept;
     void resetPortMagnitudes (bool shouldPortMagsBeOn);
@@ -134,6 +189,14 @@ public:
     virtual void fromXML (XmlElement* xml, const chowdsp::Version& version, bool loadPosition = true);
     void loadPositionInfoFromXML (XmlElement* xml);
 
+    /**
+     * Binary versions of the state save/load methods, used for the plugin state.
+     * Processors that save extra state in toXML() should save it here as well!
+     */
+    virtual void toBinary (BinaryStateWriter& writer);
+    virtual void fromBinary (BinaryStateReader& reader, const chowdsp::Version& version, bool loadPosition = true);
+    void loadPositionInfoFromBinary (BinaryStateReader reader);
+
     // interface for processor editors
     AudioProcessorValueTreeState& getVTS() { return vts; }
     ProcessorUIOptions& getUIOptions() { return uiOptions; }
@@ -180,14 +243,22 @@ public:
     const ConnectionInfo& getOutputConnection (int portIdx, int connectionIdx) const { return outputConnections[(size_t) portIdx].getReference (connectionIdx); }
 
     int getNumOutputConnections (int portIdx) const { return outputConnections[(size_t) portIdx].size(); }
-    int getNumInputConnections() const { return inputsConnected.size(); }
+    int getNumInputConnections() const { return connectedInputPorts.size(); }
+    const Array<int>& getConnectedInputPorts() const noexcept { return connectedInputPorts; }
 
-    int incrementNumInputsReady() { return numInputsReady++; }
-    int getNumInputsReady() const { return numInputsReady; }
-    void clearNumInputsReady() { numInputsReady = 0; }
+    /**
+     * Adds or removes a connection from one of this processor's outputs.
+     *
+     * When the processors are part of a processor chain, the chain will update
+     * the connected inputs seen by the end processor while processing, so that
+     * the audio thread never sees a connection before the processing schedule
+     * knows about it.
+     */
+    void addConnection (ConnectionInfo&& info, bool updateProcessingInputs = true);
+    void removeConnection (const ConnectionInfo& info, bool updateProcessingInputs = true);
 
-    void addConnection (ConnectionInfo&& info);
-    void removeConnection (const ConnectionInfo& info);
+    /** Updates the input ports that the processor sees as connected while processing. */
+    void updateInputsConnected (const Array<int>& newInputsConnected) noexcept;
     virtual void inputConnectionChanged (int /*portIndex*/, bool /*wasConnected*/) {}
 
     int getNumInputs() const noexcept { return numInputs; }
@@ -195,6 +266,20 @@ public:
     PortType getInputPortType (int portIndex) const;
     PortType getOutputPortType (int portIndex) const;
 
+    /**
+     * Returns the smoothing policy if the output port produces a control-rate
+     * signal (see ControlRate.h), or nullopt if it produces an audio-rate signal.
+     */
+    std::optional<ControlRate::Smoothing> getOutputControlRate (int portIndex) const;
+
+    /**
+     * Used by the processor chain to tell the processor whether an input is
+     * receiving a control-rate signal (and how it should be smoothed), or an
+     * audio-rate signal. Only modulation inputs ever receive control-rate signals.
+     */
+    void setInputControlRate (int portIndex, std::optional<ControlRate::Smoothing> smoothing) noexcept;
+    std::optional<ControlRate::Smoothing> getInputControlRate (int portIndex) const noexcept;
+
     void setPosition (juce::Point<int> pos, juce::Rectangle<int> parentBounds);
     void setPosition (const BaseProcessor& other) { editorPosition = other.editorPosition; }
     juce::Point<int> getPosition (juce::Rectangle<int> parentBounds);
@@ -220,11 +305,37 @@ public:
     /** Provided by the processor chain */
     const PlayheadHelpers* playheadHelpers = nullptr;
 
+    /** Used by the processor chain when this processor is oversampled on its own. */
+    std::unique_ptr<ModuleOversampling> moduleOversampling;
+
     /** Returns a tooltip string for a given port. */
     virtual String getTooltipForPort (int portIndex, bool isInput);
 
 protected:
     virtual void prepare (double sampleRate, int samplesPerBlock) = 0;
+
+    /** Returns the factor by which the processing sample rate is above the host sample rate. */
+    int getOversamplingFactor() const noexcept { return processingOversamplingFactor; }
+
+    /** Returns the quality tier that the processor should use for its approximate maths. */
+    MathsQuality getMathsQuality() const noexcept { return processingMathsQuality; }
+
+    /**
+     * Returns the time (in seconds) for a filter's impulse response to decay by 80 dB,
+     * which modules can use to work out their tail from their lowest filter frequency.
+     * The decay time constant is Q / (pi * freq), and a first-order filter acts like Q = 0.5.
+     */
+    static double getFilterTailLengthSeconds (double freqHz, double q = 0.5);
+
+    /** A tail for modules with a nonlinear circuit model or an RNN, which has some state that needs to settle. */
+    static constexpr double stateSettleTimeSeconds = 0.1;
+
+    /** The lowest pole frequency of the tone stack circuit models (depending on their controls), used to work out their tail. */
+    static constexpr double toneStackLowestFreqHz = 10.0;
+
+    /** Sets every netlist circuit quantity, e.g. after a processor's circuit models have been re-created. */
+    void applyNetlistCircuitQuantities();
+
     virtual void releaseMemory() {}
     virtual void processAudio (AudioBuffer<float>& buffer) = 0;
 
@@ -250,6 +361,19 @@ protected:
      */
     void enableWhenInputConnected (const std::initializer_list<String>& paramIDs, int inputPortIndex);
 
+    /**
+     * If a modulation output should produce a control-rate signal, then call this
+     * method in the module's constructor. The module should then always set the
+     * output buffer to a ControlRate::Signal buffer, (even when it's bypassed).
+     */
+    void setControlRateOutput (int outputPortIndex, ControlRate::Smoothing smoothing = ControlRate::Smoothing::Linear);
+
+    /** Reads a modulation input into a control-rate signal, (decimating the input if it's an audio-rate signal). */
+    void getModulationInput (int inputPortIndex, ControlRate::Signal& signal, int numSamples) const;
+
+    /** Reads a modulation input into the first channel of an audio-rate buffer, (upsampling the input if it's a control-rate signal). */
+    void getModulationInput (int inputPortIndex, AudioBuffer<float>& buffer) const;
+
     /** 
      * All modulation signals should be in the range of [-1,1],
      * they can then be modified as needed by the individual module.
@@ -259,6 +383,8 @@ protected:
     ProcessorUIOptions uiOptions;
 
     Array<chowdsp::BufferView<float>> outputBuffers;
+
+    /** The input ports that are connected, (only valid while processing). */
     Array<int> inputsConnected;
 
     chowdsp::SharedLNFAllocator lnfAllocator;
@@ -267,13 +393,6 @@ protected:
     std::unique_ptr<Component> netlistWindow {};
     std::unique_ptr<netlist::CircuitQuantityList> netlistCircuitQuantities {};
 
-    /**
-     * If your processor uses convolution, you can use this shared
-     * messaging queue to avoid creating a new background thread
-     * for each instance.
-     */
-    auto& getSharedConvolutionMessageQueue() { return convolutionMessageQueue.get(); }
-
     enum class BasicInputPort
     {
         AudioInput,
@@ -299,17 +418,11 @@ private:
     const int numOutputs {};
 
     std::vector<Array<ConnectionInfo>> outputConnections;
+    Array<int> connectedInputPorts;
     Array<chowdsp::BufferView<float>> inputBuffers;
-    int numInputsReady = 0;
 
     juce::Point<float> editorPosition;
 
-    struct ConvolutionMessageQueue : public dsp::ConvolutionMessageQueue
-    {
-        ConvolutionMessageQueue() : dsp::ConvolutionMessageQueue (2048) {}
-    };
-    SharedResourcePointer<ConvolutionMessageQueue> convolutionMessageQueue;
-
     struct PortMagnitude
     {
         PortMagnitude() = default;
@@ -322,12 +435,23 @@ private:
     bool portMagnitudesOn = false;
     std::vector<PortMagnitude> portMagnitudes;
 
+    ProcessorTimingStats timingStats;
+
+    double processingSampleRate = 48000.0;
+    int processingOversamplingFactor = 1;
+    MathsQuality processingMathsQuality = MathsQuality::Normal;
+    int64_t numSilentSamples = 0;
+    std::atomic_bool sleeping { false }; // written by the audio thread, read by the GUI
+
     StringArray popupMenuParameterIDs;
     OwnedArray<ParameterAttachment> popupMenuParameterAttachments;
 
     const base_processor_detail::PortTypesVector inputPortTypes;
     const base_processor_detail::PortTypesVector outputPortTypes;
 
+    std::vector<std::optional<ControlRate::Smoothing>> inputControlRates;
+    std::vector<std::optional<ControlRate::Smoothing>> outputControlRates;
+
     std::unordered_map<int, std::vector<String>> paramsToDisableWhenInputConnected {};
     std::unordered_map<int, std::vector<String>> paramsToEnableWhenInputConnected {};
 
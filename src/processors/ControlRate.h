@@ -0,0 +1,169 @@
+#pragma once
+
+#include <pch.h>
+
+/**
+ * Helpers for control-rate modulation signals.
+ *
+ * Modulation signals are much slower than audio, so there's no need to
+ * compute them at the audio rate (let alone the oversampled rate). Instead,
+ * a modulation output can produce one value for every ControlRate::interval
+ * samples. The processor chain passes these signals between modulation ports
+ * as they are, and the modules that need an audio-rate signal upsample them
+ * with a cheap ramp.
+ *
+ * A block of N samples is split into K = ceil (N / interval) equal segments,
+ * and a control-rate buffer holds K + 1 values: the last value from the
+ * previous block, followed by the value at the end of each segment. That way
+ * a control-rate buffer can be upsampled without any extra state.
+ */
+namespace ControlRate
+{
+/** The maximum number of audio-rate samples for each control-rate value. */
+static constexpr int interval = 32;
+
+/** How a control-rate signal should be upsampled to audio rate. */
+enum class Smoothing
+{
+    Linear, // ramp from one value to the next over each segment
+    Hold, // jump to the next value at the start of each segment
+};
+
+/** Returns the number of control-rate segments in a block of audio-rate samples. */
+constexpr int getNumSegments (int numSamples) noexcept { return (numSamples + interval - 1) / interval; }
+
+/** Returns the number of values in a control-rate buffer, for a block of audio-rate samples. */
+constexpr int getNumValues (int numSamples) noexcept { return getNumSegments (numSamples) + 1; }
+
+/** Returns the (average) number of audio-rate samples in each segment. */
+inline float getSegmentLength (int numSamples) noexcept
+{
+    return (float) numSamples / (float) jmax (1, getNumSegments (numSamples));
+}
+
+/** Returns the first audio-rate sample in a segment. */
+inline int getSegmentStart (int segmentIndex, int numSamples) noexcept
+{
+    return (int) ((int64) segmentIndex * numSamples / jmax (1, getNumSegments (numSamples)));
+}
+
+/** Upsamples a control-rate buffer (with getNumValues (numSamples) values) to audio rate. */
+inline void upsample (const float* controlData, float* audioData, int numSamples, Smoothing smoothing) noexcept
+{
+    const auto numSegments = getNumSegments (numSamples);
+    for (int k = 0; k < numSegments; ++k)
+    {
+        const auto start = getSegmentStart (k, numSamples);
+        const auto end = getSegmentStart (k + 1, numSamples);
+
+        if (smoothing == Smoothing::Hold)
+        {
+            std::fill (audioData + start, audioData + end, controlData[k + 1]);
+            continue;
+        }
+
+        const auto increment = (controlData[k + 1] - controlData[k]) / (float) (end - start);
+        auto value = controlData[k];
+        for (int n = start; n < end; ++n)
+        {
+            value += increment;
+            audioData[n] = value;
+        }
+    }
+}
+
+/**
+ * A mono control-rate signal, for modules with control-rate modulation outputs.
+ * The signal remembers its last value, so that each block carries on smoothly
+ * from the previous one.
+ */
+class Signal
+{
+public:
+    Signal() { buffer.clear(); }
+
+    void prepare (int maxNumSamples)
+    {
+        buffer.setSize (1, getNumValues (maxNumSamples));
+        buffer.clear();
+        numValues = 1;
+    }
+
+    /**
+     * Starts a new block, and returns a pointer to the values for each
+     * segment of the block, (i.e. getNumSegments (numSamples) values),
+     * which should be filled in by the caller.
+     */
+    float* startBlock (int numSamples)
+    {
+        const auto lastValue = buffer.getSample (0, numValues - 1);
+        numValues = getNumValues (numSamples);
+        buffer.setSize (1, numValues, false, false, true);
+
+        auto* data = buffer.getWritePointer (0);
+        data[0] = lastValue;
+        return data + 1;
+    }
+
+    /** Fills a new block with a constant value. */
+    void fill (int numSamples, float value)
+    {
+        auto* data = startBlock (numSamples);
+        std::fill (data, data + getNumSegments (numSamples), value);
+    }
+
+    /** Fills a new block from a control-rate buffer, mixing multi-channel buffers down to mono. */
+    void copyFrom (const AudioBuffer<float>& controlRateBuffer, int numSamples)
+    {
+        jassert (controlRateBuffer.getNumSamples() == getNumValues (numSamples));
+
+        auto* data = startBlock (numSamples);
+        const auto numSegments = getNumSegments (numSamples);
+        const auto numChannels = controlRateBuffer.getNumChannels();
+        if (numSegments == 0)
+            return;
+
+        FloatVectorOperations::copy (data, controlRateBuffer.getReadPointer (0, 1), numSegments);
+        if (numChannels > 1)
+        {
+            for (int ch = 1; ch < numChannels; ++ch)
+                FloatVectorOperations::add (data, controlRateBuffer.getReadPointer (ch, 1), numSegments);
+            FloatVectorOperations::multiply (data, 1.0f / (float) numChannels, numSegments);
+        }
+    }
+
+    /** Fills a new block by taking the last sample from each segment of an audio-rate buffer, mixed down to mono. */
+    void decimateFrom (const AudioBuffer<float>& audioRateBuffer)
+    {
+        const auto numSamples = audioRateBuffer.getNumSamples();
+        const auto numChannels = audioRateBuffer.getNumChannels();
+
+        auto* data = startBlock (numSamples);
+        for (int k = 0; k < getNumSegments (numSamples); ++k)
+        {
+            const auto sampleIndex = getSegmentStart (k + 1, numSamples) - 1;
+
+            data[k] = 0.0f;
+            for (int ch = 0; ch < numChannels; ++ch)
+                data[k] += audioRateBuffer.getSample (ch, sampleIndex);
+            data[k] /= (float) numChannels;
+        }
+    }
+
+    /** Upsamples the current block to audio rate. */
+    void upsample (float* audioData, int numSamples, Smoothing smoothing) const noexcept
+    {
+        jassert (numValues == getNumValues (numSamples));
+        ControlRate::upsample (buffer.getReadPointer (0), audioData, numSamples, smoothing);
+    }
+
+    /** Returns the control-rate buffer for the current block, e.g. to use as a processor output. */
+    AudioBuffer<float>& getBuffer() noexcept { return buffer; }
+
+private:
+    AudioBuffer<float> buffer { 1, 1 };
+    int numValues = 1;
+
+    JUCE_DECLARE_NON_COPYABLE (Signal)
+};
+} // namespace ControlRate
@@ -0,0 +1,99 @@
+#include "ProcessorTimingStats.h"
+#include <bit>
+
+void ProcessorTimingStats::addBlock (int64_t processingNanoseconds, int64_t realTimeNanoseconds) noexcept
+{
+    if (resetRequested.exchange (false, std::memory_order_relaxed))
+        reset();
+
+    // the audio thread is the only writer, so we don't need any read-modify-write operations here
+    const auto relaxedIncrement = [] (std::atomic<int64_t>& value, int64_t increment)
+    {
+        value.store (value.load (std::memory_order_relaxed) + increment, std::memory_order_relaxed);
+    };
+
+    relaxedIncrement (numBlocks, 1);
+    relaxedIncrement (totalProcessingNanos, processingNanoseconds);
+    relaxedIncrement (totalRealTimeNanos, realTimeNanoseconds);
+    relaxedIncrement (histogram[(size_t) getBinIndex (processingNanoseconds)], 1);
+
+    if (processingNanoseconds > maxProcessingNanos.load (std::memory_order_relaxed))
+        maxProcessingNanos.store (processingNanoseconds, std::memory_order_relaxed);
+}
+
+void ProcessorTimingStats::reset() noexcept
+{
+    numBlocks.store (0, std::memory_order_relaxed);
+    totalProcessingNanos.store (0, std::memory_order_relaxed);
+    totalRealTimeNanos.store (0, std::memory_order_relaxed);
+    maxProcessingNanos.store (0, std::memory_order_relaxed);
+    for (auto& bin : histogram)
+        bin.store (0, std::memory_order_relaxed);
+}
+
+ProcessorTimingStats::Snapshot ProcessorTimingStats::getSnapshot() const noexcept
+{
+    Snapshot snapshot;
+    snapshot.numBlocks = numBlocks.load (std::memory_order_relaxed);
+    snapshot.totalProcessingNanoseconds = totalProcessingNanos.load (std::memory_order_relaxed);
+    snapshot.totalRealTimeNanoseconds = totalRealTimeNanos.load (std::memory_order_relaxed);
+    snapshot.maxMicroseconds = (double) maxProcessingNanos.load (std::memory_order_relaxed) * 1.0e-3;
+
+    if (snapshot.numBlocks == 0)
+        return snapshot;
+
+    snapshot.meanMicroseconds = (double) snapshot.totalProcessingNanoseconds * 1.0e-3 / (double) snapshot.numBlocks;
+    if (snapshot.totalRealTimeNanoseconds > 0)
+        snapshot.load = (double) snapshot.totalProcessingNanoseconds / (double) snapshot.totalRealTimeNanoseconds;
+
+    // The histogram might be slightly out of sync with the block count,
+    // if the audio thread is recording a block right now, so let's count it up again.
+    int64_t histogramCount = 0;
+    for (const auto& bin : histogram)
+        histogramCount += bin.load (std::memory_order_relaxed);
+
+    const auto p99Count = (int64_t) std::ceil ((double) histogramCount * 0.99);
+    int64_t cumulativeCount = 0;
+    for (int binIndex = 0; binIndex < numBins; ++binIndex)
+    {
+        cumulativeCount += histogram[(size_t) binIndex].load (std::memory_order_relaxed);
+        if (cumulativeCount >= p99Count)
+        {
+            snapshot.p99Microseconds = getBinUpperEdgeNanoseconds (binIndex) * 1.0e-3;
+            break;
+        }
+    }
+
+    // the bins are coarse, so make sure the estimate doesn't exceed the actual max
+    snapshot.p99Microseconds = jmin (snapshot.p99Microseconds, snapshot.maxMicroseconds);
+
+    return snapshot;
+}
+
+int ProcessorTimingStats::getBinIndex (int64_t nanoseconds) noexcept
+{
+    if (nanoseconds < binsPerOctave)
+        return (int) jmax (nanoseconds, (int64_t) 0);
+
+    // the first bins are linear, then each octave is split into binsPerOctave bins
+    const auto octave = (int) std::bit_width ((uint64_t) nanoseconds) - 1;
+    const auto subBin = (int) (nanoseconds >> (octave - binsPerOctaveLog2)) & (binsPerOctave - 1);
+    return jmin ((octave - binsPerOctaveLog2 + 1) * binsPerOctave + subBin, numBins - 1);
+}
+
+double ProcessorTimingStats::getBinUpperEdgeNanoseconds (int binIndex) noexcept
+{
+    if (binIndex < binsPerOctave)
+        return (double) (binIndex + 1);
+
+    const auto octave = binIndex / binsPerOctave + binsPerOctaveLog2 - 1;
+    const auto subBin = binIndex % binsPerOctave;
+    return std::ldexp ((double) (binsPerOctave + subBin + 1), octave - binsPerOctaveLog2);
+}
+
+String ProcessorTimingStats::toString (const Snapshot& snapshot)
+{
+    return String (snapshot.load * 100.0, 2) + "% (avg " + String (snapshot.meanMicroseconds, 1)
+           + " us, p99 " + String (snapshot.p99Microseconds, 1)
+           + " us, max " + String (snapshot.maxMicroseconds, 1) + " us)";
+}
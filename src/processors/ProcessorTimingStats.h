@@ -0,0 +1,69 @@
+#pragma once
+
+#include <pch.h>
+
+/**
+ * Lock-free processing time statistics for a single processor.
+ *
+ * The audio thread records the time taken to process each block, and any
+ * other thread can take a snapshot of the statistics (mean, 99th percentile,
+ * and max time per block, along with the processor's share of the real-time
+ * budget). The 99th percentile is estimated from a histogram with four
+ * bins per octave, so it's accurate to within ~20%.
+ *
+ * Since the audio thread is the only writer, resetting the statistics
+ * from another thread is done by requesting a reset, which the audio
+ * thread carries out before recording the next block.
+ */
+class ProcessorTimingStats
+{
+public:
+    ProcessorTimingStats() = default;
+
+    struct Snapshot
+    {
+        int64_t numBlocks = 0;
+        double meanMicroseconds = 0.0;
+        double p99Microseconds = 0.0;
+        double maxMicroseconds = 0.0;
+
+        /** Processing time as a fraction of the real-time duration of the processed audio. */
+        double load = 0.0;
+
+        /** Totals, which can be used to compute the load over a shorter window. */
+        int64_t totalProcessingNanoseconds = 0;
+        int64_t totalRealTimeNanoseconds = 0;
+    };
+
+    /** Records the time taken to process a block (audio thread only). */
+    void addBlock (int64_t processingNanoseconds, int64_t realTimeNanoseconds) noexcept;
+
+    /** Returns the current statistics (any thread). */
+    Snapshot getSnapshot() const noexcept;
+
+    /** Requests that the statistics are reset before the next block is recorded (any thread). */
+    void requestReset() noexcept { resetRequested.store (true, std::memory_order_relaxed); }
+
+    /** Returns a summary string like: "1.2% (avg 10.5 us, p99 15.2 us, max 40.0 us)". */
+    static String toString (const Snapshot& snapshot);
+
+private:
+    void reset() noexcept;
+    static int getBinIndex (int64_t nanoseconds) noexcept;
+    static double getBinUpperEdgeNanoseconds (int binIndex) noexcept;
+
+    static constexpr int binsPerOctaveLog2 = 2;
+    static constexpr int binsPerOctave = 1 << binsPerOctaveLog2;
+    static constexpr int numOctaves = 40; // up to ~18 minutes per block, which should be plenty!
+    static constexpr int numBins = numOctaves * binsPerOctave;
+
+    std::atomic<int64_t> numBlocks { 0 };
+    std::atomic<int64_t> totalProcessingNanos { 0 };
+    std::atomic<int64_t> totalRealTimeNanos { 0 };
+    std::atomic<int64_t> maxProcessingNanos { 0 };
+    std::array<std::atomic<int64_t>, (size_t) numBins> histogram {};
+
+    std::atomic_bool resetRequested { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ProcessorTimingStats)
+};
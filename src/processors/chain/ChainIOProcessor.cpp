@@ -1,4 +1,5 @@
 #include "ChainIOProcessor.h"
+#include "ModuleOversampling.h"
 #include "../ParameterHelpers.h"
 
 using namespace GlobalParamTags;
@@ -8,6 +9,7 @@ ChainIOProcessor::ChainIOProcessor (AudioProcessorValueTreeState& vts, std::func
 {
     using namespace ParameterHelpers;
     monoModeParam = vts.getRawParameterValue (monoModeTag);
+    osScopeParam = vts.getRawParameterValue (osScopeTag);
     loadParameterPointer (inGainParam, vts, inGainTag);
     loadParameterPointer (outGainParam, vts, outGainTag);
     loadParameterPointer (dryWetParam, vts, dryWetTag);
@@ -30,6 +32,14 @@ void ChainIOProcessor::createParameters (Parameters& params)
                                                               "Mode",
                                                               StringArray { "Mono", "Stereo", "Left", "Right" },
                                                               0));
+    // In "Nonlinear Only" mode, each group of nonlinear modules has its own (minimum-phase) oversampling,
+    // so the reported latency is the IIR filter delay for the longest path through those groups,
+    // rounded to whole samples. Since the filter delay depends on the frequency, and different paths
+    // can go through different numbers of groups, parallel branches might not line up exactly.
+    params.push_back (std::make_unique<AudioParameterChoice> (juce::ParameterID { osScopeTag, 211 },
+                                                              "Oversampling Scope",
+                                                              StringArray { "Whole Chain", "Nonlinear Only" },
+                                                              0));
     createGainDBParameter (params, { inGainTag, 100 }, "In Gain", -72.0f, 18.0f, 0.0f, 0.0f);
     createGainDBParameter (params, { outGainTag, 100 }, "Out Gain", -72.0f, 18.0f, 0.0f, 0.0f);
     createPercentParameter (params, { dryWetTag, 100 }, "Dry/Wet", 1.0f);
@@ -38,6 +48,7 @@ void ChainIOProcessor::createParameters (Parameters& params)
 void ChainIOProcessor::prepare (double sampleRate, int samplesPerBlock)
 {
     oversampling.prepareToPlay (sampleRate, samplesPerBlock, 2);
+    perModuleOversampling.store (osScopeParam->load() == 1.0f);
 
     dsp::ProcessSpec spec { sampleRate, (uint32) samplesPerBlock, 2 };
     inGain.setGainDecibels (inGainParam->getCurrentValue());
@@ -50,9 +61,9 @@ void ChainIOProcessor::prepare (double sampleRate, int samplesPerBlock)
 
     ioBuffer.setSize (2, samplesPerBlock);
     dryWetMixer.prepare (spec);
-    latencyChangedCallbackFunc ((int) oversampling.getLatencySamples());
 
     isPrepared = true;
+    updateLatency();
 }
 
 void ChainIOProcessor::reset() noexcept
@@ -74,6 +85,38 @@ int ChainIOProcessor::getOversamplingFactor() const
     return oversampling.getOSFactor();
 }
 
+int ChainIOProcessor::getChainOversamplingFactor() const
+{
+    if (isOversamplingPerModule())
+        return 1;
+
+    return getOversamplingFactor();
+}
+
+void ChainIOProcessor::setNumModuleOversamplingGroups (int numGroups)
+{
+    if (numGroups == numModuleOversamplingGroups)
+        return;
+
+    numModuleOversamplingGroups = numGroups;
+    updateLatency();
+}
+
+void ChainIOProcessor::updateLatency()
+{
+    const auto groupLatencySamples = ModuleOversampling::getLatencySamples (getOversamplingFactor());
+    moduleOversamplingLatencySamples.store (roundToInt ((float) numModuleOversamplingGroups * groupLatencySamples));
+    latencyChangedCallbackFunc (getLatencySamples());
+}
+
+int ChainIOProcessor::getLatencySamples() const
+{
+    if (isOversamplingPerModule())
+        return moduleOversamplingLatencySamples.load();
+
+    return (int) oversampling.getLatencySamples();
+}
+
 bool ChainIOProcessor::processChannelInputs (const AudioBuffer<float>& buffer)
 {
     const auto numChannels = buffer.getNumChannels();
@@ -120,11 +163,20 @@ bool ChainIOProcessor::processChannelInputs (const AudioBuffer<float>& buffer)
 
 dsp::AudioBlock<float> ChainIOProcessor::processAudioInput (const AudioBuffer<float>& buffer, bool& sampleRateChanged)
 {
-    if (oversampling.updateOSFactor())
+    const auto osFactorChanged = oversampling.updateOSFactor();
+    const auto shouldOversamplePerModule = osScopeParam->load() == 1.0f;
+    const auto osScopeChanged = shouldOversamplePerModule != perModuleOversampling.load();
+    if (osScopeChanged)
+    {
+        perModuleOversampling.store (shouldOversamplePerModule);
+        oversampling.reset();
+    }
+
+    if (osFactorChanged || osScopeChanged)
     {
         sampleRateChanged = true;
         mainThreadAction.call ([this]
-                               { latencyChangedCallbackFunc ((int) oversampling.getLatencySamples()); },
+                               { updateLatency(); },
                                true);
     }
 
@@ -139,7 +191,10 @@ dsp::AudioBlock<float> ChainIOProcessor::processAudioInput (const AudioBuffer<fl
     dryWetMixer.setDryWet (dryWetParam->getCurrentValue());
     dryWetMixer.copyDryBuffer (ioBuffer);
 
-    processBlock = oversampling.processSamplesUp (block);
+    if (isOversamplingPerModule())
+        processBlock = block; // the chain is processed at the base sample rate
+    else
+        processBlock = oversampling.processSamplesUp (block);
 
     if (useStereo)
         return processBlock; // return stereo block
@@ -161,10 +216,10 @@ void ChainIOProcessor::processAudioOutput (const AudioBuffer<float>& processedBu
         processBlock.getSingleChannelBlock (ch).copyFrom (processedBlock.getSingleChannelBlock (ch % (size_t) numProcessedChannels));
 
     auto&& outputBlock = dsp::AudioBlock<float> { ioBuffer };
-    oversampling.processSamplesDown (outputBlock);
+    if (! isOversamplingPerModule())
+        oversampling.processSamplesDown (outputBlock);
 
-    const auto latencySamples = (int) oversampling.getLatencySamples();
-    dryWetMixer.processBlock (ioBuffer, latencySamples);
+    dryWetMixer.processBlock (ioBuffer, getLatencySamples());
 
     outGain.setGainDecibels (outGainParam->getCurrentValue());
     outGain.process (dsp::ProcessContextReplacing<float> { outputBlock });
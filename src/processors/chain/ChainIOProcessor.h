@@ -8,6 +8,7 @@ const String monoModeTag = "mono_mode";
 const String inGainTag = "in_gain";
 const String outGainTag = "out_gain";
 const String dryWetTag = "dry_wet";
+const String osScopeTag = "os_scope";
 } // namespace GlobalParamTags
 
 class ChainIOProcessor
@@ -19,7 +20,24 @@ public:
     void prepare (double sampleRate, int samplesPerBlock);
     void reset() noexcept;
 
+    /** Returns the oversampling factor selected by the user. */
     int getOversamplingFactor() const;
+
+    /**
+     * Returns true if only the nonlinear modules should be oversampled,
+     * in which case the rest of the chain is processed at the base sample rate.
+     */
+    bool isOversamplingPerModule() const noexcept { return perModuleOversampling.load(); }
+
+    /** Returns the oversampling factor that the chain as a whole is processed at. */
+    int getChainOversamplingFactor() const;
+
+    /**
+     * Sets the largest number of oversampling groups in series between the chain input and output,
+     * which is used to work out the chain latency when only the nonlinear modules are oversampled.
+     */
+    void setNumModuleOversamplingGroups (int numGroups);
+
     dsp::AudioBlock<float> processAudioInput (const AudioBuffer<float>& buffer, bool& sampleRateChanged);
     void processAudioOutput (const AudioBuffer<float>& processedBuffer, AudioBuffer<float>& outputBuffer);
 
@@ -28,10 +46,16 @@ public:
 private:
     bool processChannelInputs (const AudioBuffer<float>& buffer);
     void processChannelOutputs (AudioBuffer<float>& buffer, int numChannelsProcessed) const;
+    int getLatencySamples() const;
+    void updateLatency();
 
     const std::function<void (int)> latencyChangedCallbackFunc;
 
     chowdsp::VariableOversampling<float> oversampling;
+    std::atomic<float>* osScopeParam = nullptr;
+    std::atomic_bool perModuleOversampling { false };
+    int numModuleOversamplingGroups = 0;
+    std::atomic_int moduleOversamplingLatencySamples { 0 };
 
     std::atomic<float>* monoModeParam = nullptr;
     AudioBuffer<float> ioBuffer;
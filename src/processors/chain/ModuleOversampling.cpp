@@ -0,0 +1,70 @@
+#include "ModuleOversampling.h"
+
+static auto createOversampling (int numChannels, int osFactor)
+{
+    return std::make_unique<dsp::Oversampling<float>> ((size_t) numChannels,
+                                                       (size_t) std::log2 (osFactor),
+                                                       dsp::Oversampling<float>::filterHalfBandPolyphaseIIR,
+                                                       true,
+                                                       false);
+}
+
+void ModuleOversampling::prepare (int osFactor, int samplesPerBlock)
+{
+    factor = osFactor;
+    oversampling = createOversampling (2, osFactor);
+    oversampling->initProcessing ((size_t) samplesPerBlock);
+    outputBuffer.setSize (2, samplesPerBlock);
+}
+
+float ModuleOversampling::getLatencySamples (int osFactor)
+{
+    if (osFactor <= 1)
+        return 0.0f;
+
+    // the IIR filters have a fractional group delay (measured at low frequencies)
+    return createOversampling (1, osFactor)->getLatencyInSamples();
+}
+
+void ModuleOversampling::reset()
+{
+    if (oversampling != nullptr)
+        oversampling->reset();
+}
+
+AudioBuffer<float>& ModuleOversampling::processSamplesUp (const AudioBuffer<float>& buffer)
+{
+    const auto numChannels = buffer.getNumChannels();
+    jassert (numChannels <= 2);
+
+    osBlock = oversampling->processSamplesUp (dsp::AudioBlock<const float> { buffer });
+
+    float* osChannels[2] {};
+    for (int ch = 0; ch < numChannels; ++ch)
+        osChannels[ch] = osBlock.getChannelPointer ((size_t) ch);
+    osBuffer = AudioBuffer<float> { osChannels, numChannels, (int) osBlock.getNumSamples() };
+
+    return osBuffer;
+}
+
+AudioBuffer<float>& ModuleOversampling::processSamplesDown (const AudioBuffer<float>& processedBuffer)
+{
+    const auto numChannels = processedBuffer.getNumChannels();
+    const auto osNumSamples = (int) osBlock.getNumSamples();
+    jassert (numChannels <= 2);
+    jassert (processedBuffer.getNumSamples() == osNumSamples);
+
+    // the module might not have processed in-place, so make sure the processed signal is in the oversampler's buffer
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto* osData = osBlock.getChannelPointer ((size_t) ch);
+        if (processedBuffer.getReadPointer (ch) != osData)
+            FloatVectorOperations::copy (osData, processedBuffer.getReadPointer (ch), osNumSamples);
+    }
+
+    outputBuffer.setSize (numChannels, osNumSamples / factor, false, false, true);
+    auto&& outputBlock = dsp::AudioBlock<float> { outputBuffer };
+    oversampling->processSamplesDown (outputBlock);
+
+    return outputBuffer;
+}
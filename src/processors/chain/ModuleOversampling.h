@@ -0,0 +1,38 @@
+#pragma once
+
+#include <pch.h>
+
+/**
+ * Oversampling for a single module (or a group of connected modules),
+ * used when the processor chain only oversamples the nonlinear modules.
+ *
+ * Always uses minimum-phase filters, so that the latency of the oversampled
+ * branches stays close to the branches that are processed at the base rate.
+ */
+class ModuleOversampling
+{
+public:
+    ModuleOversampling() = default;
+
+    void prepare (int osFactor, int samplesPerBlock);
+    void reset();
+
+    /** Returns the latency (in samples at the base rate) of upsampling and downsampling with the given oversampling factor. */
+    static float getLatencySamples (int osFactor);
+
+    /** Upsamples the buffer, and returns a buffer at the oversampled rate, for the module to process. */
+    AudioBuffer<float>& processSamplesUp (const AudioBuffer<float>& buffer);
+
+    /** Downsamples the module output, and returns a buffer at the base rate. */
+    AudioBuffer<float>& processSamplesDown (const AudioBuffer<float>& processedBuffer);
+
+private:
+    std::unique_ptr<dsp::Oversampling<float>> oversampling;
+    int factor = 1;
+
+    dsp::AudioBlock<float> osBlock;
+    AudioBuffer<float> osBuffer; // refers to the memory in osBlock
+    AudioBuffer<float> outputBuffer;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ModuleOversampling)
+};
@@ -1,4 +1,5 @@
 #include "ProcessorChain.h"
+#include "ModuleOversampling.h"
 #include "ProcessorChainActionHelper.h"
 #include "ProcessorChainPortMagnitudesHelper.h"
 #include "ProcessorChainStateHelper.h"
@@ -48,32 +49,65 @@ ProcessorChain::ProcessorChain (ProcessorStore& store,
     portMagsHelper = std::make_unique<ProcessorChainPortMagnitudesHelper> (*this);
 
     procs.ensureStorageAllocated (100);
+    updateSchedule();
+
+    pluginSettings->addProperties<&ProcessorChain::globalSettingChanged> ({ { parallelProcessingID, false },
+                                                                            { mathsQualityID, (int) MathsQuality::Normal } },
+                                                                          *this);
+    globalSettingChanged (parallelProcessingID);
+    globalSettingChanged (mathsQualityID);
 }
 
-ProcessorChain::~ProcessorChain() = default;
+ProcessorChain::~ProcessorChain()
+{
+    pluginSettings->removePropertyListener (*this);
+    threadPool.reset();
+
+    for (auto& retired : retiredSchedules)
+        deallocScheduleArenas (*retired.schedule);
+    deallocScheduleArenas (*schedule);
+    deallocArena (arena.get_memory_resource());
+}
 
 void ProcessorChain::createParameters (Parameters& params)
 {
     ChainIOProcessor::createParameters (params);
 }
 
+bool ProcessorChain::isOversamplingNonlinearModulesOnly() const
+{
+    return ioProcessor.isOversamplingPerModule() && ioProcessor.getOversamplingFactor() > 1;
+}
+
+void ProcessorChain::prepareProcessor (BaseProcessor& proc)
+{
+    if (isOversamplingNonlinearModulesOnly() && ProcessorChainSchedule::canOversampleIndividually (proc))
+    {
+        const auto osFactor = ioProcessor.getOversamplingFactor();
+        proc.prepareProcessing (mySampleRate * osFactor, mySamplesPerBlock * osFactor, osFactor, mathsQuality.load());
+
+        if (proc.moduleOversampling == nullptr)
+            proc.moduleOversampling = std::make_unique<ModuleOversampling>();
+        proc.moduleOversampling->prepare (osFactor, mySamplesPerBlock);
+        return;
+    }
+
+    const auto osFactor = ioProcessor.getChainOversamplingFactor();
+    proc.prepareProcessing (mySampleRate * osFactor, mySamplesPerBlock * osFactor, osFactor, mathsQuality.load());
+}
+
 void ProcessorChain::initializeProcessors()
 {
-    const auto osFactor = ioProcessor.getOversamplingFactor();
+    const auto osFactor = ioProcessor.getChainOversamplingFactor();
     const double osSampleRate = mySampleRate * osFactor;
     const int osSamplesPerBlock = mySamplesPerBlock * osFactor;
 
-    inputProcessor.prepareProcessing (osSampleRate, osSamplesPerBlock);
-    outputProcessor.prepareProcessing (osSampleRate, osSamplesPerBlock);
-
-    for (int i = procs.size() - 1; i >= 0; --i)
-    {
-        if (auto* proc = procs[i])
-            proc->prepareProcessing (osSampleRate, osSamplesPerBlock);
-    }
+    inputProcessor.prepareProcessing (osSampleRate, osSamplesPerBlock, osFactor);
+    outputProcessor.prepareProcessing (osSampleRate, osSamplesPerBlock, osFactor);
 
-    deallocArena (arena.get_memory_resource());
-    arena.get_memory_resource() = allocArena (getRequiredArenaSizeBytes());
+    const auto& scheduleProcs = audioThreadSchedule->processors;
+    for (auto procIter = scheduleProcs.rbegin(); procIter != scheduleProcs.rend(); ++procIter)
+        prepareProcessor (*procIter->proc);
 }
 
 void ProcessorChain::prepare (double sampleRate, int samplesPerBlock)
@@ -88,8 +122,22 @@ void ProcessorChain::prepare (double sampleRate, int samplesPerBlock)
     internalMidiBuffer.clear();
     internalMidiBuffer.ensureSize (256);
 
-    SpinLock::ScopedLockType scopedProcessingLock (processingLock);
+    // the audio thread is not running right now, so we can pick up the latest schedule here
+    adoptSchedule (*schedule);
     initializeProcessors();
+
+    // ... and make sure the arena is the right size for the current oversampling factor
+    if (const auto arenaBytes = getRequiredArenaSizeBytes (audioThreadSchedule->numArenaBuffers, audioThreadSchedule->numControlRateRegisters); needsNewArena (arenaBytes))
+    {
+        deallocArena (arena.get_memory_resource());
+        arena.get_memory_resource() = allocArena (arenaBytes);
+        arenaSizeBytes.store (arenaBytes);
+    }
+
+    if (const auto scratchBytes = getRequiredArenaSizeBytes (numScratchArenaBuffers); threadPool != nullptr && threadPool->getArenaSizeBytes() < scratchBytes)
+        threadPool->prepareArenas (scratchBytes);
+
+    isPrepared = true;
 }
 
 void ProcessorChain::reset() noexcept
@@ -97,107 +145,182 @@ void ProcessorChain::reset() noexcept
     ioProcessor.reset();
 }
 
-void ProcessorChain::runProcessor (BaseProcessor* proc, AudioBuffer<float>& buffer, bool& outProcessed)
+void ProcessorChain::globalSettingChanged (SettingID settingID)
 {
-    TRACE_DSP();
+    if (settingID == parallelProcessingID)
+        setParallelProcessingEnabled (pluginSettings->getProperty<bool> (parallelProcessingID));
+    else if (settingID == mathsQualityID)
+        setMathsQuality ((MathsQuality) jlimit ((int) MathsQuality::Eco, (int) MathsQuality::High, pluginSettings->getProperty<int> (mathsQualityID)));
+}
 
-    int nextNumProcs = 0;
-    const int numOutputs = proc->getNumOutputs();
-    int numAudioOutputs = 0;
-    for (int i = 0; i < numOutputs; ++i)
-    {
-        const int numOutProcs = proc->getNumOutputConnections (i);
-        for (int j = 0; j < numOutProcs; ++j)
-            nextNumProcs += 1;
+void ProcessorChain::setMathsQuality (MathsQuality newQuality)
+{
+    if (mathsQuality.exchange (newQuality) == newQuality)
+        return;
 
-        numAudioOutputs += proc->getOutputPortType (i) == PortType::audio ? 1 : 0;
-    }
+    Logger::writeToLog ("Setting maths quality: " + String ((int) newQuality));
 
-    if (proc == &outputProcessor) // we've reached the output processor, so we're done!
-    {
-        proc->processAudioBlock (buffer);
-        outProcessed = true;
+    // if the chain hasn't been prepared yet, then the processors will get the new quality when it is
+    if (isPrepared)
+        reprepareProcessors();
+}
+
+void ProcessorChain::reprepareProcessors()
+{
+    // Preparing the processors can take a lot of work (allocating memory, loading models
+    // and IRs, etc.), so it shouldn't be done on the audio thread. Instead, we publish a
+    // schedule that doesn't process anything, and once the audio thread has picked it up
+    // (i.e. once any block that might be using the old schedule has finished), nothing else
+    // is touching the processors, so we can prepare them here. The output is silent in the meantime.
+    publishSchedule (ProcessorChainSchedule::createSilent());
+    waitForAudioThread();
+
+    for (auto* proc : procs)
+        prepareProcessor (*proc);
+
+    updateSchedule();
+}
+
+void ProcessorChain::setParallelProcessingEnabled (bool shouldEnable)
+{
+    if (shouldEnable == isParallelProcessingEnabled())
         return;
-    }
 
-    if (numOutputs == 0) // this processor has no outputs, so after we process, we're done!
+    Logger::writeToLog ("Turning parallel processing: " + String (shouldEnable ? "ON" : "OFF"));
+    if (shouldEnable)
     {
-        proc->processAudioBlock (buffer);
-        return;
+        threadPool = std::make_unique<ProcessorChainThreadPool> (ProcessorChainThreadPool::getDefaultNumWorkers(),
+                                                                 getRequiredArenaSizeBytes (numScratchArenaBuffers));
+        publishedThreadPool.store (threadPool.get());
     }
-
-    if (nextNumProcs == 0 && numAudioOutputs > 0) // the output of this processor is connected to nothing, so let's not waste our processing...
+    else
     {
-        if (proc == &inputProcessor)
-            inputProcessor.resetLevels();
-
-        return;
+        publishedThreadPool.store (nullptr);
+        waitForAudioThread();
+        threadPool.reset();
     }
 
-    proc->processAudioBlock (buffer);
+    updateSchedule();
+}
 
-    auto processBuffer = [&] (BaseProcessor* nextProc, int inputIndex, AudioBuffer<float>& nextBuffer)
-    {
-        int nextNumInputs = nextProc->getNumInputs();
-        if (nextNumProcs == 1 && nextNumInputs == 1)
-        {
-            runProcessor (nextProc, nextBuffer, outProcessed);
-        }
-        else if (nextNumProcs > 1 && nextNumInputs == 1)
-        {
-            auto bufferView = arena.alloc_buffer (nextBuffer);
-            chowdsp::BufferMath::copyBufferData (nextBuffer, bufferView);
-            nextProc->getInputBufferView() = bufferView;
-            auto copyNextBuffer = bufferView.toAudioBuffer();
-            runProcessor (nextProc, copyNextBuffer, outProcessed);
-        }
-        else
-        {
-            auto bufferView = arena.alloc_buffer (nextBuffer);
-            chowdsp::BufferMath::copyBufferData (nextBuffer, bufferView);
-            nextProc->getInputBufferView (inputIndex) = bufferView;
-            auto copyNextBuffer = bufferView.toAudioBuffer();
+void ProcessorChain::updateSchedule()
+{
+    auto newSchedule = ProcessorChainSchedule::compile (procs, inputProcessor, outputProcessor, isParallelProcessingEnabled());
+    ioProcessor.setNumModuleOversamplingGroups (newSchedule->numOversamplingGroupsInSeries);
+    publishSchedule (std::move (newSchedule));
+}
 
-            nextProc->incrementNumInputsReady();
-            if (nextProc->getNumInputsReady() < nextProc->getNumInputConnections())
-                return; // not all the inputs are ready yet...
+void ProcessorChain::publishSchedule (std::unique_ptr<ProcessorChainSchedule>&& newSchedule)
+{
+    newSchedule->id = ++nextScheduleID;
+    newSchedule->numArenaBuffers = newSchedule->numRegisters + numScratchArenaBuffers;
 
-            runProcessor (nextProc, copyNextBuffer, outProcessed);
-        }
-    };
+    // allocate new arena memory here, so that the audio thread doesn't have to,
+    // (a schedule without any steps doesn't use the arena, so we can keep the current one)
+    if (const auto arenaBytes = getRequiredArenaSizeBytes (newSchedule->numArenaBuffers, newSchedule->numControlRateRegisters); ! newSchedule->steps.empty() && needsNewArena (arenaBytes))
+        newSchedule->arenaMemory = allocArena (arenaBytes);
 
-    for (int i = 0; i < numOutputs; ++i)
+    // the same goes for the worker arenas, if the schedule is going to be processed in parallel
+    if (const auto scratchBytes = getRequiredArenaSizeBytes (numScratchArenaBuffers); threadPool != nullptr && ! newSchedule->tasks.empty() && threadPool->getArenaSizeBytes() < scratchBytes)
     {
-        auto outBufferView = proc->getOutputBuffer (i);
-        if (outBufferView.getNumSamples() == 0)
-            outBufferView = buffer;
-        auto outBuffer = outBufferView.toAudioBuffer();
+        for (int i = 0; i < threadPool->getNumWorkers(); ++i)
+            newSchedule->workerArenaMemory.push_back (allocArena (scratchBytes));
+    }
 
-        const int numOutProcs = proc->getNumOutputConnections (i);
-        for (int j = numOutProcs - 1; j >= 0; --j)
-        {
-            const auto& connectionInfo = proc->getOutputConnection (i, j);
-            processBuffer (connectionInfo.endProc, connectionInfo.endPort, outBuffer);
+    auto oldSchedule = std::exchange (schedule, std::move (newSchedule));
+    publishedSchedule.store (schedule.get());
 
-            nextNumProcs -= 1;
-        }
+    if (oldSchedule != nullptr)
+        retiredSchedules.push_back ({ std::move (oldSchedule), audioThreadBlockCounter.load() });
+    reclaimRetiredSchedules();
+}
+
+void ProcessorChain::adoptSchedule (ProcessorChainSchedule& newSchedule)
+{
+    for (const auto& [proc, inputsConnected] : newSchedule.processors)
+        proc->updateInputsConnected (inputsConnected);
+
+    auto& arenaMemory = arena.get_memory_resource();
+    if (! newSchedule.arenaMemory.empty())
+    {
+        mainThreadAction.call ([oldArenaMemory = arenaMemory]
+                               { deallocArena (oldArenaMemory); },
+                               true);
+        arenaMemory = std::exchange (newSchedule.arenaMemory, {});
+        arenaSizeBytes.store (arenaMemory.size());
     }
+
+    // the old worker arena memory gets swapped into the schedule, and is freed along with it
+    if (auto* pool = publishedThreadPool.load(); pool != nullptr && ! newSchedule.workerArenaMemory.empty())
+        pool->swapArenas (newSchedule.workerArenaMemory);
+
+    audioThreadSchedule = &newSchedule;
+    audioThreadScheduleID = newSchedule.id;
+}
+
+void ProcessorChain::reclaimRetiredSchedules()
+{
+    const auto blockCounter = audioThreadBlockCounter.load();
+    std::erase_if (retiredSchedules,
+                   [blockCounter] (RetiredSchedule& retired)
+                   {
+                       // If the audio thread was in the middle of a block when the schedule was retired,
+                       // then the schedule might still be in use until that block has finished.
+                       const auto wasProcessing = (retired.blockCounter & 1) == 1;
+                       if (wasProcessing && blockCounter == retired.blockCounter)
+                           return false;
+
+                       deallocScheduleArenas (*retired.schedule);
+                       return true;
+                   });
+}
+
+void ProcessorChain::deallocScheduleArenas (ProcessorChainSchedule& oldSchedule)
+{
+    deallocArena (std::exchange (oldSchedule.arenaMemory, {}));
+    for (auto& workerArenaMemory : oldSchedule.workerArenaMemory)
+        deallocArena (std::exchange (workerArenaMemory, {}));
+}
+
+void ProcessorChain::waitForAudioThread() const
+{
+    const auto blockCounter = audioThreadBlockCounter.load();
+    if ((blockCounter & 1) == 0)
+        return; // not processing right now
+
+    while (audioThreadBlockCounter.load() == blockCounter)
+        std::this_thread::yield();
 }
 
 void ProcessorChain::processAudio (AudioBuffer<float>& buffer, const MidiBuffer& hostMidiBuffer)
 {
-    SpinLock::ScopedTryLockType tryProcessingLock (processingLock);
-    if (! tryProcessingLock.isLocked())
-        return;
+    // let the message thread know that we're processing, so it won't reclaim a schedule that we're still using
+    audioThreadBlockCounter.fetch_add (1);
+
+    // pick up the latest schedule from the message thread
+    if (auto* latestSchedule = publishedSchedule.load(); latestSchedule->id != audioThreadScheduleID)
+        adoptSchedule (*latestSchedule);
+    auto& processSchedule = *audioThreadSchedule;
 
     // process input (oversampling, input gain, etc)
     bool sampleRateChange = false;
     auto osBlock = ioProcessor.processAudioInput (buffer, sampleRateChange);
     if (sampleRateChange)
+    {
         initializeProcessors();
 
+        // the arena might need to be resized for the new oversampling factor, so we ask the message thread for a new schedule
+        mainThreadAction.call ([this]
+                               { updateSchedule(); },
+                               true);
+    }
+
+    // If the oversampling factor has gone up since the arena was allocated, then the arena won't
+    // be big enough until the new schedule arrives, so the chain output is silent in the meantime.
+    const auto arenaIsBigEnough = arena.get_memory_resource().size() >= getRequiredArenaSizeBytes (processSchedule.numArenaBuffers, processSchedule.numControlRateRegisters);
+
     // prepare port magnitudes
-    portMagsHelper->preparePortMagnitudes();
+    portMagsHelper->preparePortMagnitudes (processSchedule);
 
     const auto osNumSamples = (int) osBlock.getNumSamples();
     const auto inputNumChannels = (int) osBlock.getNumChannels();
@@ -211,33 +334,47 @@ void ProcessorChain::processAudio (AudioBuffer<float>& buffer, const MidiBuffer&
             inputBuffer.copyFrom (ch, 0, osBlock.getChannelPointer ((size_t) ch), osNumSamples);
     }
 
-    bool outProcessed = false;
-    const auto& processMidiBuffer = ChainHelperFuncs::getMidiBufferToUse (hostMidiBuffer, internalMidiBuffer, ioProcessor.getOversamplingFactor());
+    oversampleNonlinearModules = isOversamplingNonlinearModulesOnly();
 
-    for (auto* processor : procs)
+    const auto& processMidiBuffer = ChainHelperFuncs::getMidiBufferToUse (hostMidiBuffer, internalMidiBuffer, ioProcessor.getChainOversamplingFactor());
+    for (auto& procInfo : processSchedule.processors)
     {
         // set up MIDI buffer and arena
-        processor->midiBuffer = &processMidiBuffer;
-        processor->arena = &arena;
-
-        // process standalone modulation ports
-        auto noInputsConnected = processor->getNumInputConnections() == 0;
-        auto modOutputConnected = processor->isOutputModulationPortConnected();
-        auto onlyModOut = processor->onlyHasModulationOutput();
-        if (noInputsConnected && (modOutputConnected || onlyModOut))
-            runProcessor (processor, inputBuffer, outProcessed);
+        procInfo.proc->midiBuffer = &processMidiBuffer;
+        procInfo.proc->arena = &arena;
     }
 
-    // run processing chain
-    runProcessor (&inputProcessor, inputBuffer, outProcessed);
-
-    for (auto* processor : procs)
+    if (arenaIsBigEnough)
     {
-        processor->midiBuffer = nullptr;
-        processor->clearNumInputsReady();
+        // allocate registers for the processing schedule
+        auto& registerBuffers = processSchedule.registerBuffers;
+        for (auto& registerBuffer : registerBuffers)
+            registerBuffer = arena.alloc_buffer (2, osNumSamples);
+        for (auto& registerBuffer : processSchedule.controlRateRegisterBuffers)
+            registerBuffer = arena.alloc_buffer (1, ControlRate::getNumValues (osNumSamples));
+
+        // run processing schedule, (serially if the worker arenas haven't caught up with the oversampling factor yet)
+        auto* pool = publishedThreadPool.load();
+        if (pool != nullptr && ! processSchedule.tasks.empty() && pool->getArenaSizeBytes() >= getRequiredArenaSizeBytes (numScratchArenaBuffers))
+        {
+            for (int stepIndex = 0; stepIndex < processSchedule.firstParallelStep; ++stepIndex)
+                processStep (processSchedule, processSchedule.steps[(size_t) stepIndex]);
+            pool->processTasks (processSchedule, &processTask, this, arena);
+        }
+        else
+        {
+            for (const auto& step : processSchedule.steps)
+                processStep (processSchedule, step);
+        }
     }
 
-    if (! outProcessed)
+    if (! arenaIsBigEnough || ! processSchedule.isInputConnected)
+        inputProcessor.resetLevels();
+
+    for (auto& procInfo : processSchedule.processors)
+        procInfo.proc->midiBuffer = nullptr;
+
+    if (! arenaIsBigEnough || ! processSchedule.reachesOutput)
     {
         outputProcessor.resetLevels();
         inputBuffer.clear();
@@ -257,6 +394,145 @@ void ProcessorChain::processAudio (AudioBuffer<float>& buffer, const MidiBuffer&
     }
 
     arena.clear();
+
+    audioThreadBlockCounter.fetch_add (1);
+}
+
+void ProcessorChain::processStep (ProcessorChainSchedule& processSchedule, const ProcessorChainSchedule::Step& step)
+{
+    TRACE_DSP();
+
+    auto& slotBuffers = processSchedule.slotBuffers;
+    auto& registerBuffers = processSchedule.registerBuffers;
+
+    auto* buffer = step.bufferSlot == 0 ? &inputBuffer : &slotBuffers[(size_t) step.bufferSlot];
+
+    auto* moduleOversampling = oversampleNonlinearModules && step.oversamplingGroupHead != nullptr
+                                   ? step.oversamplingGroupHead->moduleOversampling.get()
+                                   : nullptr;
+    // check the inputs before upsampling, since the upsampled buffer won't be exactly silent
+    const auto inputsAreSilent = areStepInputsSilent (processSchedule, step);
+
+    if (moduleOversampling != nullptr && step.upsampleInput)
+        buffer = &moduleOversampling->processSamplesUp (*buffer);
+
+    // if the processor is asleep, then its output is silent, and can be passed along in-place
+    const auto isAsleep = step.proc->updateSleepState (inputsAreSilent, buffer->getNumSamples());
+    if (isAsleep)
+        step.proc->processSilentBlock (*buffer);
+    else
+        step.proc->processAudioBlock (*buffer);
+
+    if (inputsAreSilent && ! isAsleep && ! isStepOutputSilent (step, *buffer))
+        step.proc->outputIsNotSilent();
+
+    // oversampled modules only have one output, so we can downsample the output before routing it
+    bool outputIsDownsampled = false;
+    if (moduleOversampling != nullptr && step.downsampleOutput)
+    {
+        jassert (step.proc->getNumOutputs() == 1);
+        if (auto outBufferView = step.proc->getOutputBuffer (0); ! isAsleep && outBufferView.getNumSamples() > 0)
+            buffer = &moduleOversampling->processSamplesDown (outBufferView.toAudioBuffer());
+        else
+            buffer = &moduleOversampling->processSamplesDown (*buffer);
+        outputIsDownsampled = true;
+    }
+
+    const auto numSamples = buffer->getNumSamples();
+    for (const auto& route : step.routes)
+    {
+        chowdsp::BufferView<float> outBufferView = *buffer;
+        if (route.controlRate.has_value())
+        {
+            // control-rate outputs are always set by the processor (and modulation sources never go to sleep)
+            outBufferView = step.proc->getOutputBuffer (route.outputPort);
+            jassert (outBufferView.getNumSamples() == ControlRate::getNumValues (numSamples));
+        }
+        else if (! outputIsDownsampled && ! isAsleep)
+        {
+            outBufferView = step.proc->getOutputBuffer (route.outputPort);
+            if (outBufferView.getNumSamples() == 0)
+                outBufferView = *buffer;
+        }
+        auto outBuffer = outBufferView.toAudioBuffer();
+
+        auto& destBuffer = slotBuffers[(size_t) route.destSlot];
+        if (route.upsample)
+        {
+            // the destination input needs an audio-rate signal
+            auto& registerBuffer = registerBuffers[(size_t) route.destRegister];
+            destBuffer = AudioBuffer<float> { registerBuffer.getArrayOfWritePointers(), 1, numSamples };
+            ControlRate::upsample (outBuffer.getReadPointer (0), destBuffer.getWritePointer (0), numSamples, *route.controlRate);
+        }
+        else if (route.copy)
+        {
+            auto& registerBuffer = route.isControlRateCopy() ? processSchedule.controlRateRegisterBuffers[(size_t) route.destRegister]
+                                                             : registerBuffers[(size_t) route.destRegister];
+            jassert (outBuffer.getNumChannels() <= registerBuffer.getNumChannels());
+            jassert (outBuffer.getNumSamples() <= registerBuffer.getNumSamples());
+
+            destBuffer = AudioBuffer<float> { registerBuffer.getArrayOfWritePointers(), outBuffer.getNumChannels(), outBuffer.getNumSamples() };
+            chowdsp::BufferMath::copyBufferData (outBuffer, destBuffer);
+        }
+        else
+        {
+            destBuffer = std::move (outBuffer);
+        }
+
+        route.destProc->getInputBufferView (route.destInputPort) = destBuffer;
+        route.destProc->setInputControlRate (route.destInputPort, route.upsample ? std::nullopt : route.controlRate);
+        processSchedule.slotIsSilent[(size_t) route.destSlot] = isAsleep ? 1 : 0;
+    }
+}
+
+bool ProcessorChain::areStepInputsSilent (const ProcessorChainSchedule& processSchedule, const ProcessorChainSchedule::Step& step) const
+{
+    // processors with no inputs, or an infinite tail, can never go to sleep, so there's no need to check
+    if (step.inputSlots.empty() || ! std::isfinite (step.proc->getTailLengthSeconds()))
+        return false;
+
+    for (auto slot : step.inputSlots)
+    {
+        if (processSchedule.slotIsSilent[(size_t) slot] != 0)
+            continue;
+
+        const auto& slotBuffer = slot == 0 ? inputBuffer : processSchedule.slotBuffers[(size_t) slot];
+        if (slotBuffer.getMagnitude (0, slotBuffer.getNumSamples()) > silenceThreshold)
+            return false;
+    }
+
+    return true;
+}
+
+bool ProcessorChain::isStepOutputSilent (const ProcessorChainSchedule::Step& step, const AudioBuffer<float>& buffer) const
+{
+    for (const auto& route : step.routes)
+    {
+        // control-rate outputs are modulation signals, which never go to sleep
+        if (route.controlRate.has_value())
+            continue;
+
+        const auto outBufferView = step.proc->getOutputBuffer (route.outputPort);
+        const auto outMagnitude = outBufferView.getNumSamples() > 0
+                                      ? chowdsp::BufferMath::getMagnitude (outBufferView)
+                                      : buffer.getMagnitude (0, buffer.getNumSamples());
+        if (outMagnitude > silenceThreshold)
+            return false;
+    }
+
+    return true;
+}
+
+void ProcessorChain::processTask (void* chainContext, const ProcessorChainSchedule::Task& task, DSPArena& taskArena)
+{
+    auto& chain = *static_cast<ProcessorChain*> (chainContext);
+    auto& processSchedule = *chain.audioThreadSchedule;
+    for (auto stepIndex : task.steps)
+    {
+        const auto& step = processSchedule.steps[(size_t) stepIndex];
+        step.proc->arena = &taskArena; // each thread needs its own arena for scratch memory
+        chain.processStep (processSchedule, step);
+    }
 }
 
 void ProcessorChain::parameterChanged (const juce::String& /*parameterID*/, float /*newValue*/)
@@ -270,25 +546,29 @@ void ProcessorChain::parameterChanged (const juce::String& /*parameterID*/, floa
                            true);
 }
 
-size_t ProcessorChain::getRequiredArenaSizeBytes()
+size_t ProcessorChain::getRequiredArenaSizeBytes (int numArenaBuffers, int numControlRateBuffers) const
 {
-    const auto osFactor = ioProcessor.getOversamplingFactor();
+    const auto osFactor = ioProcessor.getChainOversamplingFactor();
     const int osSamplesPerBlock = mySamplesPerBlock * osFactor;
     const auto osSamplesPerBlockPadded = chowdsp::Math::round_to_next_multiple (osSamplesPerBlock, 4);
     const auto bufferSizeBytes = osSamplesPerBlockPadded * 2 * sizeof (float);
 
-    const auto numIOBuffers = chowdsp::Math::round_to_next_multiple (2 * connectionsCount + 1, 10);
+    const auto numIOBuffers = chowdsp::Math::round_to_next_multiple (numArenaBuffers, 4);
     const auto ioBufferBytes = numIOBuffers * bufferSizeBytes;
 
+    // control-rate buffers are mono, (padded to leave room for alignment)
+    const auto controlRateBufferBytes = (size_t) chowdsp::Math::round_to_next_multiple (ControlRate::getNumValues (osSamplesPerBlock), 16) * sizeof (float);
+    const auto controlRateBytes = (size_t) numControlRateBuffers * controlRateBufferBytes;
+
     static constexpr size_t blockSize = 8192;
-    const auto totalNumBytes = chowdsp::Math::round_to_next_multiple (ioBufferBytes, blockSize);
+    const auto totalNumBytes = chowdsp::Math::round_to_next_multiple (ioBufferBytes + controlRateBytes, blockSize);
 
     return totalNumBytes;
 }
 
 bool ProcessorChain::needsNewArena (size_t requiredBytes) const
 {
-    const auto currentArenaBytes = arena.get_memory_resource().size();
+    const auto currentArenaBytes = arenaSizeBytes.load();
 
     // If the current arena is too small then we need a new one
     if (currentArenaBytes < requiredBytes)
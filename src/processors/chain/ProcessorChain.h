@@ -2,6 +2,8 @@
 
 #include "../ProcessorStore.h"
 #include "ChainIOProcessor.h"
+#include "ProcessorChainSchedule.h"
+#include "ProcessorChainThreadPool.h"
 
 #include "../utility/InputProcessor.h"
 #include "../utility/OutputProcessor.h"
@@ -14,6 +16,8 @@ class ParamForwardManager;
 class ProcessorChain : private AudioProcessorValueTreeState::Listener
 {
 public:
+    using SettingID = chowdsp::GlobalPluginSettings::SettingID;
+
     ProcessorChain (ProcessorStore& store,
                     AudioProcessorValueTreeState& vts,
                     std::unique_ptr<chowdsp::PresetManager>& presetMgr,
@@ -26,6 +30,10 @@ public:
     void processAudio (AudioBuffer<float>& buffer, const MidiBuffer& hostMidiBuffer);
     void reset() noexcept;
 
+    /** Enables or disables processing independent branches of the chain on multiple threads. */
+    void setParallelProcessingEnabled (bool shouldEnable);
+    bool isParallelProcessingEnabled() const noexcept { return threadPool != nullptr; }
+
     auto& getProcessors() { return procs; }
     const auto& getProcessors() const { return procs; }
     ProcessorStore& getProcStore() { return procStore; }
@@ -44,14 +52,34 @@ public:
     chowdsp::Broadcaster<void (const ConnectionInfo&)> connectionAddedBroadcaster;
     chowdsp::Broadcaster<void (const ConnectionInfo&)> connectionRemovedBroadcaster;
 
-    size_t getRequiredArenaSizeBytes();
+    size_t getRequiredArenaSizeBytes (int numArenaBuffers, int numControlRateBuffers = 0) const;
     bool needsNewArena (size_t requiredBytes) const;
     static std::span<std::byte> allocArena (size_t bytes);
     static void deallocArena (std::span<std::byte> bytes);
 
+    /** Sets the accuracy of the approximate maths used by the processors (they'll be re-prepared on the message thread). */
+    void setMathsQuality (MathsQuality newQuality);
+    MathsQuality getMathsQuality() const noexcept { return mathsQuality.load(); }
+
+    static constexpr SettingID parallelProcessingID = "parallel_processing";
+    static constexpr SettingID mathsQualityID = "maths_quality";
+
 private:
     void initializeProcessors();
-    void runProcessor (BaseProcessor* proc, AudioBuffer<float>& buffer, bool& outProcessed);
+    void prepareProcessor (BaseProcessor& proc);
+    bool isOversamplingNonlinearModulesOnly() const;
+    void updateSchedule();
+    void publishSchedule (std::unique_ptr<ProcessorChainSchedule>&& newSchedule);
+    void reprepareProcessors();
+    void adoptSchedule (ProcessorChainSchedule& newSchedule);
+    void reclaimRetiredSchedules();
+    static void deallocScheduleArenas (ProcessorChainSchedule& oldSchedule);
+    void waitForAudioThread() const;
+    void processStep (ProcessorChainSchedule& processSchedule, const ProcessorChainSchedule::Step& step);
+    bool areStepInputsSilent (const ProcessorChainSchedule& processSchedule, const ProcessorChainSchedule::Step& step) const;
+    bool isStepOutputSilent (const ProcessorChainSchedule::Step& step, const AudioBuffer<float>& buffer) const;
+    static void processTask (void* chainContext, const ProcessorChainSchedule::Task& task, DSPArena& taskArena);
+    void globalSettingChanged (SettingID settingID);
     void parameterChanged (const juce::String& parameterID, float newValue) override;
 
     double mySampleRate = 48000.0;
@@ -59,7 +87,6 @@ private:
 
     OwnedArray<BaseProcessor> procs;
     ProcessorStore& procStore;
-    SpinLock processingLock;
     UndoManager* um;
 
     InputProcessor inputProcessor;
@@ -88,8 +115,37 @@ private:
     MidiBuffer internalMidiBuffer;
     PlayheadHelpers playheadHelper;
 
-    int connectionsCount {};
+    // processor inputs quieter than this (-120 dB) are considered to be silent
+    static constexpr float silenceThreshold = 1.0e-6f;
+
+    // extra space in the arena for processors that allocate their own scratch buffers (e.g. Panner)
+    static constexpr int numScratchArenaBuffers = 2;
     DSPArena arena {};
+    std::atomic<size_t> arenaSizeBytes { 0 };
+
+    std::unique_ptr<ProcessorChainSchedule> schedule; // the most recently published schedule (message thread only)
+    std::atomic<ProcessorChainSchedule*> publishedSchedule { nullptr };
+    uint64_t nextScheduleID = 0;
+
+    struct RetiredSchedule
+    {
+        std::unique_ptr<ProcessorChainSchedule> schedule;
+        uint32_t blockCounter;
+    };
+    std::vector<RetiredSchedule> retiredSchedules;
+
+    ProcessorChainSchedule* audioThreadSchedule = nullptr; // the schedule currently in use (audio thread only)
+    uint64_t audioThreadScheduleID = 0;
+    std::atomic<uint32_t> audioThreadBlockCounter { 0 }; // odd while the audio thread is processing a block
+
+    std::unique_ptr<ProcessorChainThreadPool> threadPool; // (message thread only)
+    std::atomic<ProcessorChainThreadPool*> publishedThreadPool { nullptr };
+    chowdsp::SharedPluginSettings pluginSettings;
+
+    bool oversampleNonlinearModules = false; // (audio thread only)
+
+    std::atomic<MathsQuality> mathsQuality { MathsQuality::Normal };
+    bool isPrepared = false;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ProcessorChain)
 };
@@ -26,14 +26,10 @@ public:
         Logger::writeToLog (String ("Creating processor: ") + newProc->getName());
 
         newProc->playheadHelpers = &chain.playheadHelper;
-        auto osFactor = chain.ioProcessor.getOversamplingFactor();
-        newProc->prepareProcessing (osFactor * chain.mySampleRate, osFactor * chain.mySamplesPerBlock);
+        chain.prepareProcessor (*newProc);
 
-        BaseProcessor* newProcPtr = nullptr;
-        {
-            SpinLock::ScopedLockType scopedProcessingLock { chain.processingLock };
-            newProcPtr = chain.procs.add (std::move (newProc));
-        }
+        auto* newProcPtr = chain.procs.add (std::move (newProc));
+        chain.updateSchedule();
 
         for (auto* param : newProcPtr->getParameters())
         {
@@ -58,10 +54,11 @@ public:
                 procToRemove->getVTS().removeParameterListener (paramCast->paramID, &chain);
         }
 
-        {
-            SpinLock::ScopedLockType scopedProcessingLock { chain.processingLock };
-            saveProc.reset (chain.procs.removeAndReturn (chain.procs.indexOf (procToRemove)));
-        }
+        saveProc.reset (chain.procs.removeAndReturn (chain.procs.indexOf (procToRemove)));
+        chain.updateSchedule();
+
+        // the audio thread might still be processing with the old schedule
+        chain.waitForAudioThread();
         saveProc->freeInternalMemory();
     }
 
@@ -71,20 +68,9 @@ public:
                             + String (info.startPort) + " to " + info.endProc->getName() + " port #"
                             + String (info.endPort));
 
-        chain.connectionsCount++;
-        const auto arenaBytes = chain.getRequiredArenaSizeBytes();
-        const auto needsNewArena = chain.needsNewArena (arenaBytes);
-        std::span<std::byte> arenaData {};
-        if (needsNewArena)
-            arenaData = chain.allocArena (arenaBytes);
-
-        {
-            SpinLock::ScopedLockType scopedProcessingLock { chain.processingLock };
-            info.startProc->addConnection (ConnectionInfo (info));
-            if (needsNewArena)
-                std::swap (arenaData, chain.arena.get_memory_resource());
-        }
-        chain.deallocArena (arenaData);
+        // the audio thread will pick up the new connection along with the new schedule
+        info.startProc->addConnection (ConnectionInfo (info), false);
+        chain.updateSchedule();
         chain.connectionAddedBroadcaster (info);
     }
 
@@ -94,20 +80,9 @@ public:
                             + String (info.startPort) + " to " + info.endProc->getName() + " port #"
                             + String (info.endPort));
 
-        chain.connectionsCount--;
-        const auto arenaBytes = chain.getRequiredArenaSizeBytes();
-        const auto needsNewArena = chain.needsNewArena (arenaBytes);
-        std::span<std::byte> arenaData {};
-        if (needsNewArena)
-            arenaData = chain.allocArena (arenaBytes);
-
-        {
-            SpinLock::ScopedLockType scopedProcessingLock { chain.processingLock };
-            info.startProc->removeConnection (info);
-            if (needsNewArena)
-                std::swap (arenaData, chain.arena.get_memory_resource());
-        }
-        chain.deallocArena (arenaData);
+        // the audio thread will pick up the new connection along with the new schedule
+        info.startProc->removeConnection (info, false);
+        chain.updateSchedule();
         chain.connectionRemovedBroadcaster (info);
     }
 
@@ -247,3 +222,45 @@ bool AddOrRemoveConnection::undo()
 
     return true;
 }
+
+//=========================================================
+LoadProcessorState::LoadProcessorState (BaseProcessor* proc, std::function<void (BaseProcessor&)>&& loadNewState) : actionProc (proc),
+                                                                                                                  loadNewStateFunc (std::move (loadNewState))
+{
+}
+
+void LoadProcessorState::loadState (const XmlElement& state)
+{
+    const auto slotIndex = actionProc->getForwardingParameterSlotIndex();
+    auto stateCopy = state;
+    actionProc->fromXML (&stateCopy, chowdsp::Version { std::string_view { JucePlugin_VersionString } });
+    actionProc->setForwardingParameterSlotIndex (slotIndex);
+}
+
+bool LoadProcessorState::perform()
+{
+    if (newState != nullptr) // redo
+    {
+        loadState (*newState);
+        return true;
+    }
+
+    // the new state might only be available for the first load, so we keep a copy for re-doing
+    const auto slotIndex = actionProc->getForwardingParameterSlotIndex();
+    oldState = actionProc->toXML();
+    loadNewStateFunc (*actionProc);
+    actionProc->setForwardingParameterSlotIndex (slotIndex);
+    newState = actionProc->toXML();
+    loadNewStateFunc = nullptr;
+
+    return true;
+}
+
+bool LoadProcessorState::undo()
+{
+    if (oldState == nullptr)
+        return false;
+
+    loadState (*oldState);
+    return true;
+}
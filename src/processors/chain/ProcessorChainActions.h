@@ -45,3 +45,28 @@ private:
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AddOrRemoveConnection)
 };
+
+/**
+ * Loads a new state into a processor that's already in the chain (e.g. when a preset re-uses the processor).
+ * The processor keeps its forwarding parameters slot, since the slot belongs to the processor, not the state.
+ */
+class LoadProcessorState : public UndoableAction
+{
+public:
+    LoadProcessorState (BaseProcessor* proc, std::function<void (BaseProcessor&)>&& loadNewState);
+
+    bool perform() override;
+    bool undo() override;
+    int getSizeInUnits() override { return 10; }
+
+private:
+    void loadState (const XmlElement& state);
+
+    BaseProcessor* actionProc;
+    std::function<void (BaseProcessor&)> loadNewStateFunc;
+
+    std::unique_ptr<XmlElement> oldState;
+    std::unique_ptr<XmlElement> newState;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LoadProcessorState)
+};
@@ -11,7 +11,7 @@ public:
     ~ProcessorChainPortMagnitudesHelper();
 
     void globalSettingChanged (SettingID settingID);
-    void preparePortMagnitudes();
+    void preparePortMagnitudes (const ProcessorChainSchedule& schedule);
 
     static constexpr SettingID cableVizOnOffID = "cable_viz_onoff";
 
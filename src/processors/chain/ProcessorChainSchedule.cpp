@@ -0,0 +1,405 @@
+#include "ProcessorChainSchedule.h"
+
+namespace
+{
+struct ScheduleCompiler
+{
+    ProcessorChainSchedule& schedule;
+    const BaseProcessor& inputProc;
+    const BaseProcessor& outputProc;
+
+    int numSlots = 1;
+    std::unordered_map<const BaseProcessor*, int> numInputsReady {};
+
+    void addProcessor (BaseProcessor* proc, int bufferSlot)
+    {
+        int nextNumProcs = 0;
+        const int numOutputs = proc->getNumOutputs();
+        int numAudioOutputs = 0;
+        for (int i = 0; i < numOutputs; ++i)
+        {
+            nextNumProcs += proc->getNumOutputConnections (i);
+            numAudioOutputs += proc->getOutputPortType (i) == PortType::audio ? 1 : 0;
+        }
+
+        if (proc == &outputProc) // we've reached the output processor, so we're done!
+        {
+            schedule.steps.push_back ({ proc, bufferSlot });
+            schedule.reachesOutput = true;
+            return;
+        }
+
+        if (numOutputs == 0) // this processor has no outputs, so after we process, we're done!
+        {
+            schedule.steps.push_back ({ proc, bufferSlot });
+            return;
+        }
+
+        if (nextNumProcs == 0 && numAudioOutputs > 0) // the output of this processor is connected to nothing, so let's not waste our processing...
+            return;
+
+        if (proc == &inputProc)
+            schedule.isInputConnected = true;
+
+        const auto stepIndex = schedule.steps.size();
+        schedule.steps.push_back ({ proc, bufferSlot });
+
+        std::vector<std::pair<BaseProcessor*, int>> nextProcs;
+        for (int i = 0; i < numOutputs; ++i)
+        {
+            const int numOutProcs = proc->getNumOutputConnections (i);
+            for (int j = numOutProcs - 1; j >= 0; --j)
+            {
+                const auto& connectionInfo = proc->getOutputConnection (i, j);
+                auto* nextProc = connectionInfo.endProc;
+
+                ProcessorChainSchedule::Route route;
+                route.outputPort = i;
+                route.destSlot = numSlots++;
+                route.destProc = nextProc;
+
+                // Control-rate signals can only be passed along as they are to modulation inputs.
+                // (Single-input processors process the input buffer directly, so they always need audio-rate signals.)
+                route.controlRate = proc->getOutputControlRate (i);
+                route.upsample = route.controlRate.has_value()
+                                 && (nextProc->getNumInputs() == 1 || nextProc->getInputPortType (connectionInfo.endPort) != PortType::modulation);
+
+                // The last processor connected to this one can use the output buffer in-place
+                route.copy = nextNumProcs > 1 || route.upsample;
+
+                if (nextProc->getNumInputs() == 1)
+                {
+                    route.destInputPort = 0;
+                    nextProcs.emplace_back (nextProc, route.destSlot);
+                }
+                else
+                {
+                    route.destInputPort = connectionInfo.endPort;
+
+                    // only process once all the inputs are ready
+                    if (++numInputsReady[nextProc] >= nextProc->getNumInputConnections())
+                        nextProcs.emplace_back (nextProc, route.destSlot);
+                }
+
+                schedule.steps[stepIndex].routes.push_back (route);
+                nextNumProcs -= 1;
+            }
+        }
+
+        for (auto [nextProc, nextSlot] : nextProcs)
+            addProcessor (nextProc, nextSlot);
+    }
+};
+
+/**
+ * Assigns registers to the copying routes, so that registers can be re-used
+ * once they're no longer needed.
+ *
+ * Since a processor's output buffer might refer to any of the buffers that
+ * the processor reads from, the registers that a buffer might refer to are
+ * tracked through the in-place routes, and a register is kept alive until
+ * the last step that might read from it.
+ */
+void assignRegisters (ProcessorChainSchedule& schedule, bool reuseRegisters)
+{
+    const auto numSteps = (int) schedule.steps.size();
+
+    // the copies that each slot might refer to
+    std::vector<std::vector<int>> slotCopies (schedule.slotBuffers.size());
+
+    struct Copy
+    {
+        ProcessorChainSchedule::Route* route;
+        int firstUse;
+        int lastUse;
+    };
+    std::vector<Copy> copies;
+
+    std::vector<int> stepCopies;
+    for (int stepIndex = 0; stepIndex < numSteps; ++stepIndex)
+    {
+        auto& step = schedule.steps[(size_t) stepIndex];
+
+        stepCopies = slotCopies[(size_t) step.bufferSlot];
+        for (auto slot : step.inputSlots)
+            stepCopies.insert (stepCopies.end(), slotCopies[(size_t) slot].begin(), slotCopies[(size_t) slot].end());
+        std::sort (stepCopies.begin(), stepCopies.end());
+        stepCopies.erase (std::unique (stepCopies.begin(), stepCopies.end()), stepCopies.end());
+
+        for (auto copyIndex : stepCopies)
+            copies[(size_t) copyIndex].lastUse = stepIndex;
+
+        for (auto& route : step.routes)
+        {
+            if (! route.copy)
+            {
+                slotCopies[(size_t) route.destSlot] = stepCopies;
+                continue;
+            }
+
+            slotCopies[(size_t) route.destSlot] = { (int) copies.size() };
+            copies.push_back ({ &route, stepIndex, stepIndex });
+        }
+    }
+
+    // linear scan register allocation, with separate registers for audio-rate and control-rate copies
+    struct RegisterPool
+    {
+        int numRegisters = 0;
+        std::vector<int> freeRegisters {};
+        std::vector<std::pair<int, int>> activeRegisters {}; // (register, last use)
+    };
+    RegisterPool audioRatePool, controlRatePool;
+
+    for (const auto& copy : copies)
+    {
+        auto& [numRegisters, freeRegisters, activeRegisters] = copy.route->isControlRateCopy() ? controlRatePool : audioRatePool;
+        for (auto iter = activeRegisters.begin(); iter != activeRegisters.end();)
+        {
+            if (reuseRegisters && iter->second < copy.firstUse)
+            {
+                freeRegisters.push_back (iter->first);
+                iter = activeRegisters.erase (iter);
+            }
+            else
+            {
+                ++iter;
+            }
+        }
+
+        int reg;
+        if (freeRegisters.empty())
+        {
+            reg = numRegisters++;
+        }
+        else
+        {
+            reg = freeRegisters.back();
+            freeRegisters.pop_back();
+        }
+
+        copy.route->destRegister = reg;
+        activeRegisters.emplace_back (reg, copy.lastUse);
+    }
+
+    schedule.numRegisters = audioRatePool.numRegisters;
+    schedule.numControlRateRegisters = controlRatePool.numRegisters;
+    schedule.registerBuffers.resize ((size_t) schedule.numRegisters);
+    schedule.controlRateRegisterBuffers.resize ((size_t) schedule.numControlRateRegisters);
+}
+
+/** Collects the slots that each step reads from. */
+void findInputSlots (ProcessorChainSchedule& schedule)
+{
+    std::unordered_map<const BaseProcessor*, std::vector<int>> procInputSlots;
+    for (const auto& step : schedule.steps)
+        for (const auto& route : step.routes)
+            procInputSlots[route.destProc].push_back (route.destSlot);
+
+    for (auto& step : schedule.steps)
+    {
+        if (auto inputSlotsIter = procInputSlots.find (step.proc); inputSlotsIter != procInputSlots.end())
+            step.inputSlots = inputSlotsIter->second;
+    }
+}
+
+/**
+ * Finds groups of nonlinear modules that are connected in series,
+ * so they can be oversampled together.
+ */
+void findOversamplingGroups (ProcessorChainSchedule& schedule)
+{
+    ProcessorChainSchedule::Step* prevStep = nullptr;
+    for (auto& step : schedule.steps)
+    {
+        if (! ProcessorChainSchedule::canOversampleIndividually (*step.proc))
+        {
+            prevStep = nullptr;
+            continue;
+        }
+
+        // the previous step is oversampled, and passes its output straight to this step
+        if (prevStep != nullptr
+            && prevStep->routes.size() == 1
+            && ! prevStep->routes.front().copy
+            && prevStep->routes.front().destProc == step.proc)
+        {
+            step.oversamplingGroupHead = prevStep->oversamplingGroupHead;
+            step.upsampleInput = false;
+            step.downsampleOutput = true;
+            prevStep->downsampleOutput = false;
+        }
+        else
+        {
+            step.oversamplingGroupHead = step.proc;
+            step.upsampleInput = true;
+            step.downsampleOutput = true;
+        }
+
+        prevStep = &step;
+    }
+}
+
+/** Finds the largest number of oversampling groups that the signal passes through on its way to the output. */
+void countOversamplingGroupsInSeries (ProcessorChainSchedule& schedule, const BaseProcessor& outputProc)
+{
+    // the steps are in processing order, so every step has seen all of its inputs by the time it's processed
+    std::unordered_map<const BaseProcessor*, int> procNumGroups;
+    for (const auto& step : schedule.steps)
+    {
+        const auto numGroups = procNumGroups[step.proc] + (step.upsampleInput ? 1 : 0);
+        if (step.proc == &outputProc)
+            schedule.numOversamplingGroupsInSeries = numGroups;
+
+        for (const auto& route : step.routes)
+        {
+            // modulation signals don't add any latency to the audio
+            if (route.controlRate.has_value())
+                continue;
+
+            auto& destNumGroups = procNumGroups[route.destProc];
+            destNumGroups = std::max (destNumGroups, numGroups);
+        }
+    }
+}
+
+/**
+ * Splits the parallel part of the schedule into tasks. A step joins the
+ * task of the step that it depends on, if neither step has any other
+ * dependencies or dependents. Otherwise the step starts a new task.
+ */
+void buildTasks (ProcessorChainSchedule& schedule)
+{
+    const auto firstStep = schedule.firstParallelStep;
+    const auto numSteps = (int) schedule.steps.size();
+
+    std::unordered_map<const BaseProcessor*, int> procStepIndex;
+    for (int stepIndex = firstStep; stepIndex < numSteps; ++stepIndex)
+        procStepIndex[schedule.steps[(size_t) stepIndex].proc] = stepIndex;
+
+    const auto addUnique = [] (std::vector<int>& vec, int value)
+    {
+        if (std::find (vec.begin(), vec.end(), value) == vec.end())
+            vec.push_back (value);
+    };
+
+    std::vector<std::vector<int>> stepDependencies ((size_t) numSteps);
+    std::vector<std::vector<int>> stepDependents ((size_t) numSteps);
+    for (int stepIndex = firstStep; stepIndex < numSteps; ++stepIndex)
+    {
+        for (const auto& route : schedule.steps[(size_t) stepIndex].routes)
+        {
+            const auto destStepIter = procStepIndex.find (route.destProc);
+            if (destStepIter == procStepIndex.end())
+                continue; // the destination processor is never processed
+
+            addUnique (stepDependents[(size_t) stepIndex], destStepIter->second);
+            addUnique (stepDependencies[(size_t) destStepIter->second], stepIndex);
+        }
+    }
+
+    std::vector<int> stepTask ((size_t) numSteps, -1);
+    for (int stepIndex = firstStep; stepIndex < numSteps; ++stepIndex)
+    {
+        const auto& dependencies = stepDependencies[(size_t) stepIndex];
+        if (dependencies.size() == 1)
+        {
+            const auto prevStep = dependencies.front();
+            auto& prevTask = schedule.tasks[(size_t) stepTask[(size_t) prevStep]];
+            if (stepDependents[(size_t) prevStep].size() == 1 && prevTask.steps.back() == prevStep)
+            {
+                prevTask.steps.push_back (stepIndex);
+                stepTask[(size_t) stepIndex] = stepTask[(size_t) prevStep];
+                continue;
+            }
+        }
+
+        stepTask[(size_t) stepIndex] = (int) schedule.tasks.size();
+        schedule.tasks.push_back ({ { stepIndex } });
+    }
+
+    for (int stepIndex = firstStep; stepIndex < numSteps; ++stepIndex)
+    {
+        auto& task = schedule.tasks[(size_t) stepTask[(size_t) stepIndex]];
+        for (auto dependentStep : stepDependents[(size_t) stepIndex])
+        {
+            const auto dependentTaskIndex = stepTask[(size_t) dependentStep];
+            if (dependentTaskIndex == stepTask[(size_t) stepIndex])
+                continue;
+
+            if (std::find (task.dependentTasks.begin(), task.dependentTasks.end(), dependentTaskIndex) == task.dependentTasks.end())
+            {
+                task.dependentTasks.push_back (dependentTaskIndex);
+                schedule.tasks[(size_t) dependentTaskIndex].numDependencies++;
+            }
+        }
+    }
+
+    // no point in running a single task in parallel...
+    if (schedule.tasks.size() < 2)
+    {
+        schedule.tasks.clear();
+        return;
+    }
+
+    schedule.taskDependencyCounters = std::vector<std::atomic<int>> (schedule.tasks.size());
+    schedule.readyTaskQueue = std::vector<std::atomic<int>> (schedule.tasks.size());
+    schedule.taskStarted = std::vector<std::atomic_bool> (schedule.tasks.size());
+}
+} // namespace
+
+bool ProcessorChainSchedule::canOversampleIndividually (const BaseProcessor& proc)
+{
+    return proc.isNonlinear()
+           && proc.getNumInputs() == 1
+           && proc.getNumOutputs() == 1
+           && proc.getInputPortType (0) == PortType::audio
+           && proc.getOutputPortType (0) == PortType::audio;
+}
+
+std::unique_ptr<ProcessorChainSchedule> ProcessorChainSchedule::compile (const OwnedArray<BaseProcessor>& procs,
+                                                                         BaseProcessor& inputProc,
+                                                                         BaseProcessor& outputProc,
+                                                                         bool allowParallel)
+{
+    auto schedule = std::make_unique<ProcessorChainSchedule>();
+    ScheduleCompiler compiler { *schedule, inputProc, outputProc };
+
+    schedule->processors.reserve ((size_t) procs.size());
+    for (auto* proc : procs)
+        schedule->processors.push_back ({ proc, proc->getConnectedInputPorts() });
+
+    // standalone modulation sources need to be processed first
+    for (auto* proc : procs)
+    {
+        auto noInputsConnected = proc->getNumInputConnections() == 0;
+        auto modOutputConnected = proc->isOutputModulationPortConnected();
+        auto onlyModOut = proc->onlyHasModulationOutput();
+        if (noInputsConnected && (modOutputConnected || onlyModOut))
+            compiler.addProcessor (proc, 0);
+    }
+
+    schedule->firstParallelStep = (int) schedule->steps.size();
+    compiler.addProcessor (&inputProc, 0);
+
+    schedule->slotBuffers.resize ((size_t) compiler.numSlots);
+    schedule->slotIsSilent.resize ((size_t) compiler.numSlots, 0);
+    findInputSlots (*schedule);
+    findOversamplingGroups (*schedule);
+    countOversamplingGroupsInSeries (*schedule, outputProc);
+    if (allowParallel)
+        buildTasks (*schedule);
+
+    // Registers can't be re-used in parallel schedules, since the order in which the steps are processed isn't known.
+    assignRegisters (*schedule, schedule->tasks.empty());
+
+    return schedule;
+}
+
+std::unique_ptr<ProcessorChainSchedule> ProcessorChainSchedule::createSilent()
+{
+    auto schedule = std::make_unique<ProcessorChainSchedule>();
+    schedule->slotBuffers.resize (1);
+    schedule->slotIsSilent.resize (1, 0);
+    return schedule;
+}
@@ -0,0 +1,196 @@
+#pragma once
+
+#include "processors/BaseProcessor.h"
+
+/**
+ * A flattened processing order for the processor chain.
+ *
+ * The schedule is compiled on the message thread whenever the chain
+ * topology changes, so that the audio thread can process the whole
+ * chain as a straight loop, without traversing the processor graph,
+ * or deciding whether buffers need to be copied.
+ *
+ * Once compiled, a schedule is never modified by the message thread.
+ * Instead, a new schedule is compiled and published to the audio thread,
+ * which picks it up at the start of the next block. The old schedule
+ * is reclaimed on the message thread, once the audio thread is done with it.
+ *
+ * Buffers are referred to by "slot" indices. Slot 0 is always the
+ * chain's input buffer, and every other slot is written by exactly
+ * one route, before it is read by exactly one step.
+ *
+ * When a processor output needs to be copied, the copy is stored
+ * in one of the schedule's "registers", which are allocated from the
+ * arena at the start of each block. The registers are assigned with
+ * a liveness pass, so that a register can be re-used once every
+ * processor that might be reading from it has been processed.
+ *
+ * Control-rate modulation signals (see ControlRate.h) are passed along
+ * as they are to modulation inputs, so copying them only needs a (much
+ * smaller) control-rate register. Any other input needs an audio-rate
+ * signal, so the route upsamples the signal into an audio-rate register.
+ */
+struct ProcessorChainSchedule
+{
+    /** Describes where the buffer from a processor output port should go. */
+    struct Route
+    {
+        int outputPort = 0;
+        int destSlot = 0;
+
+        /**
+         * If true, the output buffer is copied into the destination register.
+         * Otherwise the output buffer is passed to the destination processor in-place.
+         */
+        bool copy = false;
+        int destRegister = -1;
+
+        /** If the output port produces a control-rate signal, this is the signal's smoothing policy. */
+        std::optional<ControlRate::Smoothing> controlRate {};
+
+        /**
+         * If true, the control-rate signal is upsampled into the destination register,
+         * since the destination input needs an audio-rate signal.
+         */
+        bool upsample = false;
+
+        /** Returns true if the route copies a control-rate signal into a control-rate register. */
+        bool isControlRateCopy() const noexcept { return copy && controlRate.has_value() && ! upsample; }
+
+        BaseProcessor* destProc = nullptr;
+        int destInputPort = 0;
+    };
+
+    struct Step
+    {
+        BaseProcessor* proc = nullptr;
+        int bufferSlot = 0;
+
+        /** Routes are ordered so that all the copies happen before any in-place routing. */
+        std::vector<Route> routes {};
+
+        /**
+         * When the chain is only oversampling the nonlinear modules, a group of
+         * nonlinear modules connected in series is oversampled together, using
+         * the oversampling from the first module in the group.
+         */
+        BaseProcessor* oversamplingGroupHead = nullptr;
+        bool upsampleInput = false;
+        bool downsampleOutput = false;
+
+        /** All the slots that the processor reads from, (used to check if the processor's inputs are silent). */
+        std::vector<int> inputSlots {};
+    };
+
+    /** Returns true if the processor should be oversampled when the chain is only oversampling the nonlinear modules. */
+    static bool canOversampleIndividually (const BaseProcessor& proc);
+
+    /**
+     * A group of steps that need to be processed in order, on the same thread.
+     * Independent tasks may be processed in parallel.
+     */
+    struct Task
+    {
+        std::vector<int> steps {};
+        std::vector<int> dependentTasks {};
+        int numDependencies = 0;
+    };
+
+    /**
+     * Compiles a schedule from the current connections between the chain processors.
+     *
+     * If allowParallel is true, the schedule will be split into tasks that
+     * can be processed on multiple threads (if the graph has any independent branches).
+     */
+    static std::unique_ptr<ProcessorChainSchedule> compile (const OwnedArray<BaseProcessor>& procs,
+                                                             BaseProcessor& inputProc,
+                                                             BaseProcessor& outputProc,
+                                                             bool allowParallel = false);
+
+    /**
+     * Creates a schedule that doesn't process any processors (not even the input or
+     * output processors), so the chain output is silent while it's in use.
+     */
+    static std::unique_ptr<ProcessorChainSchedule> createSilent();
+
+    /** The chain processors, along with the input ports that the processor should see as connected. */
+    struct ProcessorInfo
+    {
+        BaseProcessor* proc = nullptr;
+        Array<int> inputsConnected {};
+    };
+
+    std::vector<Step> steps {};
+    std::vector<ProcessorInfo> processors {};
+
+    /**
+     * Tasks for parallel processing, (empty if the schedule needs to be processed serially).
+     * The steps before firstParallelStep (i.e. standalone modulation sources) are always
+     * processed serially, before any of the tasks.
+     */
+    std::vector<Task> tasks {};
+    int firstParallelStep = 0;
+
+    /** The number of unfinished dependencies for each task, (used by the thread pool while processing). */
+    std::vector<std::atomic<int>> taskDependencyCounters {};
+
+    /** Queue of tasks that are ready to be processed, (used by the thread pool while processing). */
+    std::vector<std::atomic<int>> readyTaskQueue {};
+
+    /** Whether each task has been claimed by a thread, (used by the thread pool while processing). */
+    std::vector<std::atomic_bool> taskStarted {};
+
+    /** Buffers for each slot, (slot 0 is unused, since it always refers to the chain input buffer). */
+    std::vector<AudioBuffer<float>> slotBuffers {};
+
+    /**
+     * True for each slot that is known to be silent, because it was written by a processor
+     * that was asleep, (updated by the audio thread while processing). Downstream processors
+     * can use this to skip checking those buffers for silence.
+     */
+    std::vector<uint8_t> slotIsSilent {};
+
+    /** Stereo buffers for each register, allocated from the arena by the audio thread. */
+    std::vector<chowdsp::BufferView<float>> registerBuffers {};
+
+    /** Mono control-rate buffers for each control-rate register, allocated from the arena by the audio thread. */
+    std::vector<chowdsp::BufferView<float>> controlRateRegisterBuffers {};
+
+    /** True if the input processor is connected to anything. */
+    bool isInputConnected = false;
+
+    /** True if the output processor will be processed. */
+    bool reachesOutput = false;
+
+    /**
+     * The largest number of oversampling groups that the signal passes through on its way to
+     * the output, (used to work out the latency when the chain is only oversampling the nonlinear modules).
+     */
+    int numOversamplingGroupsInSeries = 0;
+
+    /** Unique ID for this schedule. */
+    uint64_t id = 0;
+
+    /** The number of registers needed to process the schedule. */
+    int numRegisters = 0;
+
+    /** The number of control-rate registers needed to process the schedule. */
+    int numControlRateRegisters = 0;
+
+    /** The number of processing buffers that need to fit in the arena. */
+    int numArenaBuffers = 0;
+
+    /**
+     * If the arena needs to grow (or shrink) for this schedule, then the message thread
+     * allocates the new arena memory here, and the audio thread takes ownership of it
+     * when the schedule is picked up.
+     */
+    std::span<std::byte> arenaMemory {};
+
+    /**
+     * Likewise, if the thread pool's worker arenas need to grow for this schedule, then the
+     * message thread allocates the new memory here (one span per worker). The audio thread swaps
+     * it with the workers' old arena memory, which is then freed along with the schedule.
+     */
+    std::vector<std::span<std::byte>> workerArenaMemory {};
+};
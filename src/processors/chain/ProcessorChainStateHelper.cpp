@@ -10,6 +10,11 @@ static String getPortTag (int portIdx)
     return "port_" + String (portIdx);
 }
 
+static bool isPortTag (const String& tag)
+{
+    return tag.startsWith ("port_");
+}
+
 static String getConnectionTag (int connectionIdx)
 {
     return "connection_" + String (connectionIdx);
@@ -29,8 +34,31 @@ static String getProcessorName (const String& tag)
 {
     return tag.replaceCharacter ('_', ' ');
 }
+
+static bool isConnectionInChain (const ConnectionInfo& info)
+{
+    for (int cIdx = 0; cIdx < info.startProc->getNumOutputConnections (info.startPort); ++cIdx)
+    {
+        const auto& connection = info.startProc->getOutputConnection (info.startPort, cIdx);
+        if (connection.endProc == info.endProc && connection.endPort == info.endPort)
+            return true;
+    }
+
+    return false;
+}
 } // namespace ChainStateHelperFuncs
 
+using PortMap = std::vector<std::pair<int, int>>;
+using ProcConnectionMap = std::unordered_map<int, PortMap>;
+
+struct ProcessorChainStateHelper::ProcessorState
+{
+    String name;
+    XmlElement* xml = nullptr; // for XML states
+    std::optional<BinaryStateReader> binary {}; // for binary states
+    ProcConnectionMap connections {}; // port index -> (processor index, end port), where processor index -1 is the output processor
+};
+
 ProcessorChainStateHelper::ProcessorChainStateHelper (ProcessorChain& thisChain, chowdsp::DeferredAction& deferredAction)
     : chain (thisChain),
       um (chain.um),
@@ -51,11 +79,103 @@ void ProcessorChainStateHelper::loadProcChain (const XmlElement* xml,
         return;
     }
 
+    loadProcChainDeferred (
+        [xmlState = std::make_shared<XmlElement> (*xml)]
+        {
+            std::vector<ProcessorState> procStates;
+            for (auto* procXml : xmlState->getChildIterator())
+            {
+                if (procXml == nullptr)
+                {
+                    jassertfalse;
+                    continue;
+                }
+
+                ProcessorState procState { ChainStateHelperFuncs::getProcessorName (procXml->getTagName()) };
+                procState.xml = procXml->getChildElement (0);
+
+                for (auto* portElement : procXml->getChildIterator())
+                {
+                    if (! ChainStateHelperFuncs::isPortTag (portElement->getTagName()))
+                        continue;
+
+                    auto numConnections = portElement->getNumAttributes() / 2;
+                    PortMap portConnections ((size_t) numConnections);
+                    for (int cIdx = 0; cIdx < numConnections; ++cIdx)
+                    {
+                        auto processorIdx = portElement->getIntAttribute (ChainStateHelperFuncs::getConnectionTag (cIdx));
+                        auto endPort = portElement->getIntAttribute (ChainStateHelperFuncs::getConnectionEndTag (cIdx));
+                        portConnections[(size_t) cIdx] = std::make_pair (processorIdx, endPort);
+                    }
+
+                    procState.connections.insert ({ portElement->getTagName().getTrailingIntValue(), std::move (portConnections) });
+                }
+
+                procStates.push_back (std::move (procState));
+            }
+            return procStates;
+        },
+        stateVersion,
+        loadingPreset,
+        associatedComponent,
+        waiter,
+        paramForwardManager);
+}
+
+void ProcessorChainStateHelper::loadProcChain (const BinaryStateReader& reader,
+                                               const chowdsp::Version& stateVersion,
+                                               bool loadingPreset,
+                                               Component* associatedComponent,
+                                               WaitableEvent* waiter,
+                                               ParamForwardManager* paramForwardManager)
+{
+    loadProcChainDeferred (
+        [reader]() mutable
+        {
+            std::vector<ProcessorState> procStates;
+            const auto numProcs = reader.readCount();
+            for (int i = 0; i < numProcs && ! reader.hasFailed(); ++i)
+            {
+                ProcessorState procState { reader.readString() };
+                procState.binary = reader.readRecord();
+
+                const auto numPorts = reader.readCount();
+                for (int p = 0; p < numPorts; ++p)
+                {
+                    const auto portIdx = reader.readInt();
+                    PortMap portConnections ((size_t) reader.readCount (2));
+                    for (auto& [processorIdx, endPort] : portConnections)
+                    {
+                        processorIdx = reader.readInt();
+                        endPort = reader.readInt();
+                    }
+                    procState.connections.insert ({ portIdx, std::move (portConnections) });
+                }
+
+                if (! reader.hasFailed())
+                    procStates.push_back (std::move (procState));
+            }
+            return procStates;
+        },
+        stateVersion,
+        loadingPreset,
+        associatedComponent,
+        waiter,
+        paramForwardManager);
+}
+
+void ProcessorChainStateHelper::loadProcChainDeferred (std::function<std::vector<ProcessorState>()>&& getProcessorStates,
+                                                       const chowdsp::Version& stateVersion,
+                                                       bool loadingPreset,
+                                                       Component* associatedComponent,
+                                                       WaitableEvent* waiter,
+                                                       ParamForwardManager* paramForwardManager)
+{
     mainThreadStateLoader.call (
         [this,
          stateVersion,
          loadingPreset,
-         xmlState = *xml,
+         getStates = std::move (getProcessorStates),
          safeComp = Component::SafePointer { associatedComponent },
          waiter,
          paramForwardManager]
@@ -69,7 +189,7 @@ void ProcessorChainStateHelper::loadProcChain (const XmlElement* xml,
 #endif
                 paramForwardManager->setUsingLegacyMode (true);
 
-            loadProcChainInternal (&xmlState, stateVersion, loadingPreset, safeComp.getComponent());
+            loadProcChainInternal (getStates(), stateVersion, loadingPreset, safeComp.getComponent());
 
             if (paramForwardManager != nullptr
 #if JUCE_IOS
@@ -133,7 +253,93 @@ std::unique_ptr<XmlElement> ProcessorChainStateHelper::saveProcChain (bool savin
     return std::move (xml);
 }
 
-void ProcessorChainStateHelper::loadProcChainInternal (const XmlElement* xml,
+void ProcessorChainStateHelper::saveProcChain (BinaryStateWriter& writer)
+{
+    auto saveProcessor = [&] (BaseProcessor* proc)
+    {
+        writer.writeString (proc->getName());
+        writer.writeRecord ([proc] (BinaryStateWriter& procWriter)
+                            { proc->toBinary (procWriter); });
+
+        int numConnectedPorts = 0;
+        for (int portIdx = 0; portIdx < proc->getNumOutputs(); ++portIdx)
+            numConnectedPorts += proc->getNumOutputConnections (portIdx) > 0 ? 1 : 0;
+
+        writer.writeInt (numConnectedPorts);
+        for (int portIdx = 0; portIdx < proc->getNumOutputs(); ++portIdx)
+        {
+            auto numOutputs = proc->getNumOutputConnections (portIdx);
+            if (numOutputs == 0)
+                continue;
+
+            writer.writeInt (portIdx);
+            writer.writeInt (numOutputs);
+            for (int cIdx = 0; cIdx < numOutputs; ++cIdx)
+            {
+                auto& connection = proc->getOutputConnection (portIdx, cIdx);
+                writer.writeInt (chain.procs.indexOf (connection.endProc)); // -1 for the output processor
+                writer.writeInt (connection.endPort);
+            }
+        }
+    };
+
+    writer.writeInt (chain.procs.size() + 2);
+    for (auto* proc : chain.procs)
+        saveProcessor (proc);
+
+    saveProcessor (&chain.inputProcessor);
+    saveProcessor (&chain.outputProcessor);
+}
+
+std::vector<BaseProcessor*> ProcessorChainStateHelper::findExistingProcessors (const std::vector<ProcessorState>& procStates, bool reuseProcessors)
+{
+    std::vector<BaseProcessor*> existingProcs (procStates.size(), nullptr);
+    std::vector<int> stateProcIndices (procStates.size(), -1);
+    for (size_t stateIdx = 0, procIdx = 0; stateIdx < procStates.size(); ++stateIdx)
+    {
+        if (procStates[stateIdx].name == chain.inputProcessor.getName())
+            existingProcs[stateIdx] = &chain.inputProcessor;
+        else if (procStates[stateIdx].name == chain.outputProcessor.getName())
+            existingProcs[stateIdx] = &chain.outputProcessor;
+        else
+            stateProcIndices[stateIdx] = (int) procIdx++;
+    }
+
+    if (! reuseProcessors)
+        return existingProcs;
+
+    std::vector<bool> procIsUsed ((size_t) chain.procs.size(), false);
+    const auto tryMatch = [&] (size_t stateIdx, int procIdx)
+    {
+        if (procIsUsed[(size_t) procIdx] || chain.procs[procIdx]->getName() != procStates[stateIdx].name)
+            return false;
+
+        existingProcs[stateIdx] = chain.procs[procIdx];
+        procIsUsed[(size_t) procIdx] = true;
+        return true;
+    };
+
+    // processors are matched by type, preferring the processor in the same position in the chain
+    for (size_t stateIdx = 0; stateIdx < procStates.size(); ++stateIdx)
+    {
+        if (const auto procIdx = stateProcIndices[stateIdx]; procIdx >= 0 && procIdx < chain.procs.size())
+            tryMatch (stateIdx, procIdx);
+    }
+
+    for (size_t stateIdx = 0; stateIdx < procStates.size(); ++stateIdx)
+    {
+        if (stateProcIndices[stateIdx] < 0 || existingProcs[stateIdx] != nullptr)
+            continue;
+
+        for (int procIdx = 0; procIdx < chain.procs.size(); ++procIdx)
+            if (tryMatch (stateIdx, procIdx))
+                break;
+    }
+
+    return existingProcs;
+}
+
+void ProcessorChainStateHelper::loadProcChainInternal (std::vector<ProcessorState>&& procStates,
                                                        const chowdsp::Version& stateVersion,
                                                        bool loadingPreset,
                                                        Component* associatedComp)
@@ -143,88 +349,113 @@ void ProcessorChainStateHelper::loadProcChainInternal (const XmlElement* xml,
     if (! loadingPreset)
         um->beginNewTransaction();
 
-    for (auto* proc : chain.procs)
-        ProcessorChainHelpers::removeOutputConnectionsFromProcessor (chain, proc, chain.um);
-    ProcessorChainHelpers::removeOutputConnectionsFromProcessor (chain, &chain.inputProcessor, chain.um);
+    // Presets re-use the processors that are already in the chain where possible, so switching
+    // between presets with mostly the same modules only updates the parameters and the connections
+    // that have changed, rather than re-creating (and re-allocating) every processor. The plugin state
+    // always re-creates the processors, so that they get the forwarding parameter slots from the state.
+    auto statesProcs = findExistingProcessors (procStates, loadingPreset);
 
-    while (! chain.procs.isEmpty())
-        um->perform (new AddOrRemoveProcessor (chain, chain.procs.getLast()));
+    // connections refer to processors by their index in the state (not counting the input/output processors)
+    std::vector<size_t> procIndexToStateIndex;
+    for (auto [stateIdx, proc] : chowdsp::enumerate (statesProcs))
+        if (proc != &chain.inputProcessor && proc != &chain.outputProcessor)
+            procIndexToStateIndex.push_back (stateIdx);
 
-    using PortMap = std::vector<std::pair<int, int>>;
-    using ProcConnectionMap = std::unordered_map<int, PortMap>;
-    auto loadProcessorState = [this, &stateVersion] (XmlElement* procXml, BaseProcessor* newProc, auto& connectionMaps, bool shouldLoadState = true)
+    const auto getConnectionEndProc = [&] (int procIdx) -> BaseProcessor*
     {
-        if (procXml->getNumChildElements() > 0)
-        {
-            if (shouldLoadState)
-                newProc->fromXML (procXml->getChildElement (0), stateVersion);
-            else // don't load state, only load position
-                newProc->loadPositionInfoFromXML (procXml->getChildElement (0));
-        }
+        if (procIdx < 0)
+            return &chain.outputProcessor;
+        if (procIdx < (int) procIndexToStateIndex.size())
+            return statesProcs[procIndexToStateIndex[(size_t) procIdx]];
+        return nullptr;
+    };
 
-        ProcConnectionMap connectionMap;
-        for (int portIdx = 0; portIdx < newProc->getNumOutputs(); ++portIdx)
+    const auto isConnectionInState = [&] (const ConnectionInfo& connection)
+    {
+        const auto procIter = std::find (statesProcs.begin(), statesProcs.end(), connection.startProc);
+        if (procIter == statesProcs.end())
+            return false;
+
+        const auto& connectionMap = procStates[(size_t) std::distance (statesProcs.begin(), procIter)].connections;
+        const auto portIter = connectionMap.find (connection.startPort);
+        if (portIter == connectionMap.end())
+            return false;
+
+        return std::any_of (portIter->second.begin(), portIter->second.end(), [&] (const std::pair<int, int>& portConnection)
+                            { return getConnectionEndProc (portConnection.first) == connection.endProc && portConnection.second == connection.endPort; });
+    };
+
+    // remove the connections and processors that are not in the new state
+    const auto removeOldConnections = [&] (BaseProcessor* proc)
+    {
+        for (int portIdx = 0; portIdx < proc->getNumOutputs(); ++portIdx)
         {
-            if (auto* portElement = procXml->getChildByName (ChainStateHelperFuncs::getPortTag (portIdx)))
+            for (int cIdx = proc->getNumOutputConnections (portIdx) - 1; cIdx >= 0; --cIdx)
             {
-                auto numConnections = portElement->getNumAttributes() / 2;
-                PortMap portConnections (numConnections);
-                for (int cIdx = 0; cIdx < numConnections; ++cIdx)
-                {
-                    auto processorIdx = portElement->getIntAttribute (ChainStateHelperFuncs::getConnectionTag (cIdx));
-                    auto endPort = portElement->getIntAttribute (ChainStateHelperFuncs::getConnectionEndTag (cIdx));
-                    portConnections[cIdx] = std::make_pair (processorIdx, endPort);
-                }
-
-                connectionMap.insert ({ portIdx, std::move (portConnections) });
+                auto connection = proc->getOutputConnection (portIdx, cIdx);
+                if (! isConnectionInState (connection))
+                    um->perform (new AddOrRemoveConnection (chain, std::move (connection), true));
             }
         }
+    };
 
-        if (newProc == &chain.outputProcessor)
-            return;
+    for (auto* proc : chain.procs)
+        removeOldConnections (proc);
+    removeOldConnections (&chain.inputProcessor);
+
+    for (int procIdx = chain.procs.size() - 1; procIdx >= 0; --procIdx)
+    {
+        if (std::find (statesProcs.begin(), statesProcs.end(), chain.procs[procIdx]) == statesProcs.end())
+            um->perform (new AddOrRemoveProcessor (chain, chain.procs[procIdx]));
+    }
 
-        int procIdx = newProc == &chain.inputProcessor ? -1 : chain.procs.size();
-        connectionMaps.insert ({ procIdx, std::move (connectionMap) });
+    const auto loadProcessorState = [&stateVersion] (ProcessorState& procState, BaseProcessor& proc)
+    {
+        if (procState.binary.has_value())
+            proc.fromBinary (*procState.binary, stateVersion);
+        else if (procState.xml != nullptr)
+            proc.fromXML (procState.xml, stateVersion);
     };
 
-    std::unordered_map<int, ProcConnectionMap> connectionMaps;
     StringArray unavailableProcessors;
-    for (auto* procXml : xml->getChildIterator())
+    for (size_t stateIdx = 0; stateIdx < procStates.size(); ++stateIdx)
     {
-        if (procXml == nullptr)
-        {
-            jassertfalse;
-            continue;
-        }
-
-        const auto procName = ChainStateHelperFuncs::getProcessorName (procXml->getTagName());
-        if (procName == chain.inputProcessor.getName())
+        auto& procState = procStates[stateIdx];
+        auto*& proc = statesProcs[stateIdx];
+        if (proc == &chain.inputProcessor || proc == &chain.outputProcessor)
         {
-            loadProcessorState (procXml, &chain.inputProcessor, connectionMaps, ! loadingPreset);
+            if (! loadingPreset)
+                loadProcessorState (procState, *proc);
+            else if (procState.binary.has_value()) // don't load state, only load position
+                proc->loadPositionInfoFromBinary (*procState.binary);
+            else
+                proc->loadPositionInfoFromXML (procState.xml);
             continue;
         }
 
-        if (procName == chain.outputProcessor.getName())
+        if (proc != nullptr)
         {
-            loadProcessorState (procXml, &chain.outputProcessor, connectionMaps, ! loadingPreset);
+            um->perform (new LoadProcessorState (proc, [&procState, &loadProcessorState] (BaseProcessor& existingProc)
+                                                 { loadProcessorState (procState, existingProc); }));
             continue;
         }
 
-        if (! chain.procStore.isModuleAvailable (procName))
+        if (! chain.procStore.isModuleAvailable (procState.name))
         {
-            Logger::writeToLog ("Skipping loading processor: " + procName + ", since it is currently locked!");
-            unavailableProcessors.addIfNotAlreadyThere (procName);
+            Logger::writeToLog ("Skipping loading processor: " + procState.name + ", since it is currently locked!");
+            unavailableProcessors.addIfNotAlreadyThere (procState.name);
             continue;
         }
 
-        auto newProc = chain.procStore.createProcByName (procName);
+        auto newProc = chain.procStore.createProcByName (procState.name);
         if (newProc == nullptr)
         {
             jassertfalse; // unable to create this processor
             continue;
         }
 
-        loadProcessorState (procXml, newProc.get(), connectionMaps);
+        loadProcessorState (procState, *newProc);
+        proc = newProc.get();
         um->perform (new AddOrRemoveProcessor (chain, std::move (newProc)));
     }
 
@@ -238,30 +469,24 @@ void ProcessorChainStateHelper::loadProcChainInternal (const XmlElement* xml,
         PresetManager::showErrorMessage ("Error Loading Preset", warningStream.str(), associatedComp);
     }
 
-    // wait until all the processors are created before connecting them
-    for (auto [procIdx, connectionMap] : connectionMaps)
+    // wait until all the processors are in the chain before connecting them
+    for (size_t stateIdx = 0; stateIdx < procStates.size(); ++stateIdx)
     {
-        auto* proc = procIdx >= 0 ? chain.procs[(int) procIdx] : &chain.inputProcessor;
-        if (proc == nullptr)
-        {
-            jassertfalse;
+        auto* proc = statesProcs[stateIdx];
+        if (proc == nullptr || proc == &chain.outputProcessor)
             continue;
-        }
 
-        for (int portIdx = 0; portIdx < proc->getNumOutputs(); ++portIdx)
+        for (const auto& [portIdx, connections] : procStates[stateIdx].connections)
         {
-            if (connectionMap.find (portIdx) == connectionMap.end())
-                continue; // no connections!
-
-            const auto& connections = connectionMap.at (portIdx);
-            for (auto [cIdx, endPort] : connections)
+            for (auto [procIdx, endPort] : connections)
             {
-                if (auto* procToConnect = cIdx >= 0 ? chain.procs[cIdx] : &chain.outputProcessor;
-                    procToConnect != nullptr && procToConnect != proc && proc->getNumOutputs() > portIdx && procToConnect->getNumInputs() > endPort)
-                {
-                    ConnectionInfo info { proc, portIdx, procToConnect, endPort };
+                auto* procToConnect = getConnectionEndProc (procIdx);
+                if (procToConnect == nullptr || procToConnect == proc || ! isPositiveAndBelow (portIdx, proc->getNumOutputs()) || ! isPositiveAndBelow (endPort, procToConnect->getNumInputs()))
+                    continue;
+
+                ConnectionInfo info { proc, portIdx, procToConnect, endPort };
+                if (! ChainStateHelperFuncs::isConnectionInChain (info))
                     um->perform (new AddOrRemoveConnection (chain, std::move (info)));
-                }
             }
         }
     }
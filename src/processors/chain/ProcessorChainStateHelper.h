@@ -15,10 +15,29 @@ public:
                         WaitableEvent* waiter = nullptr,
                         ParamForwardManager* paramForwardManager = nullptr);
 
+    /** Binary versions of the processor chain state, used for the plugin state (but not for presets). */
+    void saveProcChain (BinaryStateWriter& writer);
+    void loadProcChain (const BinaryStateReader& reader,
+                        const chowdsp::Version& stateVersion,
+                        bool loadingPreset = false,
+                        Component* associatedComponent = nullptr,
+                        WaitableEvent* waiter = nullptr,
+                        ParamForwardManager* paramForwardManager = nullptr);
+
     static bool validateProcChainState (const XmlElement* xml, const ProcessorStore& processorStore);
 
+    static inline const String procChainStateTag = "proc_chain";
+
 private:
-    void loadProcChainInternal (const XmlElement* xml,
+    struct ProcessorState;
+    void loadProcChainDeferred (std::function<std::vector<ProcessorState>()>&& getProcessorStates,
+                                const chowdsp::Version& stateVersion,
+                                bool loadingPreset,
+                                Component* associatedComponent,
+                                WaitableEvent* waiter,
+                                ParamForwardManager* paramForwardManager);
+    std::vector<BaseProcessor*> findExistingProcessors (const std::vector<ProcessorState>& procStates, bool reuseProcessors);
+    void loadProcChainInternal (std::vector<ProcessorState>&& procStates,
                                 const chowdsp::Version& stateVersion,
                                 bool loadingPreset,
                                 Component* associatedComp);
@@ -28,7 +47,5 @@ private:
 
     chowdsp::DeferredAction& mainThreadStateLoader;
 
-    static inline const String procChainStateTag = "proc_chain";
-
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ProcessorChainStateHelper)
 };
@@ -0,0 +1,282 @@
+#include "ProcessorChainThreadPool.h"
+#include "ProcessorChain.h"
+
+#if JUCE_INTEL
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+constexpr int numSpinsBeforeSleeping = 4096;
+
+// how long the audio thread waits for the workers before taking over their unstarted tasks
+constexpr double workerStallTimeoutSeconds = 1.0e-4;
+
+inline void spinPause() noexcept
+{
+#if JUCE_INTEL
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+} // namespace
+
+ProcessorChainThreadPool::Worker::Worker (ProcessorChainThreadPool& threadPool, int index)
+    : Thread ("Processing Worker " + String (index)),
+      pool (threadPool)
+{
+}
+
+ProcessorChainThreadPool::ProcessorChainThreadPool (int numWorkers, size_t arenaBytes)
+{
+    Logger::writeToLog ("Starting processing thread pool with " + String (numWorkers) + " workers");
+
+    for (int i = 0; i < numWorkers; ++i)
+        workers.push_back (std::make_unique<Worker> (*this, i));
+    prepareArenas (arenaBytes);
+
+    for (auto& worker : workers)
+    {
+        // the audio thread waits for the workers, so they need to run at real-time priority
+        if (! worker->startRealtimeThread (Thread::RealtimeOptions {}))
+        {
+            Logger::writeToLog ("Unable to start real-time processing worker thread!");
+            worker->startThread (Thread::Priority::highest);
+        }
+    }
+}
+
+ProcessorChainThreadPool::~ProcessorChainThreadPool()
+{
+    shouldExit.store (true);
+    for (auto& worker : workers)
+    {
+        worker->wakeEvent.signal();
+        worker->waitForThreadToExit (-1);
+        ProcessorChain::deallocArena (worker->arena.get_memory_resource());
+    }
+}
+
+int ProcessorChainThreadPool::getDefaultNumWorkers()
+{
+    return jlimit (1, 7, SystemStats::getNumPhysicalCpus() - 1);
+}
+
+void ProcessorChainThreadPool::prepareArenas (size_t arenaBytes)
+{
+    for (auto& worker : workers)
+    {
+        ProcessorChain::deallocArena (worker->arena.get_memory_resource());
+        worker->arena.get_memory_resource() = ProcessorChain::allocArena (arenaBytes);
+    }
+    arenaSizeBytes.store (arenaBytes);
+}
+
+void ProcessorChainThreadPool::swapArenas (std::vector<std::span<std::byte>>& arenaMemory) noexcept
+{
+    if (arenaMemory.size() != workers.size())
+    {
+        jassertfalse; // this memory was allocated for a different thread pool!
+        return;
+    }
+
+    auto newArenaBytes = std::numeric_limits<size_t>::max();
+    for (size_t i = 0; i < workers.size(); ++i)
+    {
+        std::swap (workers[i]->arena.get_memory_resource(), arenaMemory[i]);
+        newArenaBytes = std::min (newArenaBytes, workers[i]->arena.get_memory_resource().size());
+    }
+    arenaSizeBytes.store (newArenaBytes);
+}
+
+void ProcessorChainThreadPool::processTasks (ProcessorChainSchedule& schedule, TaskCallback callback, void* context, DSPArena& audioThreadArena)
+{
+    jassert (! schedule.tasks.empty());
+
+    jobSchedule = &schedule;
+    jobCallback = callback;
+    jobContext = context;
+
+    const auto numTasks = (int) schedule.tasks.size();
+    for (int i = 0; i < numTasks; ++i)
+    {
+        schedule.taskDependencyCounters[(size_t) i].store (schedule.tasks[(size_t) i].numDependencies, std::memory_order_relaxed);
+        schedule.readyTaskQueue[(size_t) i].store (-1, std::memory_order_relaxed);
+        schedule.taskStarted[(size_t) i].store (false, std::memory_order_relaxed);
+    }
+    readyTasksPushIndex.store (0, std::memory_order_relaxed);
+    readyTasksPopIndex.store (0, std::memory_order_relaxed);
+    numTasksRemaining.store (numTasks, std::memory_order_relaxed);
+
+    for (int i = 0; i < numTasks; ++i)
+    {
+        if (schedule.tasks[(size_t) i].numDependencies == 0)
+            pushReadyTask (i);
+    }
+
+    // start the job, and wake up any workers that have gone to sleep
+    jobIsRunning.store (true);
+    jobCounter.fetch_add (1);
+    for (auto& worker : workers)
+    {
+        if (worker->isSleeping.load())
+            worker->wakeEvent.signal();
+    }
+
+    runTasks (audioThreadArena, true);
+
+    // make sure none of the workers are still looking at this job before we return
+    jobIsRunning.store (false);
+    while (numActiveWorkers.load() > 0)
+        spinPause();
+}
+
+void ProcessorChainThreadPool::workerLoop (Worker& worker)
+{
+    auto lastJob = jobCounter.load();
+    while (true)
+    {
+        int numSpins = 0;
+        while (jobCounter.load() == lastJob && ! shouldExit.load())
+        {
+            if (++numSpins < numSpinsBeforeSleeping)
+            {
+                spinPause();
+                continue;
+            }
+
+            worker.isSleeping.store (true);
+            if (jobCounter.load() == lastJob && ! shouldExit.load())
+                worker.wakeEvent.wait();
+            worker.isSleeping.store (false);
+            numSpins = 0;
+        }
+
+        if (shouldExit.load())
+            return;
+
+        lastJob = jobCounter.load();
+
+        numActiveWorkers.fetch_add (1);
+        if (jobIsRunning.load() && jobCounter.load() == lastJob)
+            runTasks (worker.arena, false);
+        numActiveWorkers.fetch_sub (1);
+    }
+}
+
+void ProcessorChainThreadPool::runTasks (DSPArena& arena, bool isAudioThread)
+{
+    juce::ScopedNoDenormals noDenormals;
+
+    static const auto stallTimeoutTicks = Time::secondsToHighResolutionTicks (workerStallTimeoutSeconds);
+    int64 waitStartTicks = 0;
+    int numTasksRemainingWhenWaitStarted = 0;
+
+    int taskIndex = -1;
+    while (true)
+    {
+        if (taskIndex < 0)
+            taskIndex = popReadyTask();
+
+        if (taskIndex < 0)
+        {
+            const auto numTasksLeft = numTasksRemaining.load (std::memory_order_acquire);
+            if (numTasksLeft == 0)
+                return;
+
+            if (isAudioThread)
+            {
+                // if the workers haven't made any progress for a while, take over any tasks they haven't started
+                const auto nowTicks = Time::getHighResolutionTicks();
+                if (waitStartTicks == 0 || numTasksLeft != numTasksRemainingWhenWaitStarted)
+                {
+                    waitStartTicks = nowTicks;
+                    numTasksRemainingWhenWaitStarted = numTasksLeft;
+                }
+                else if (nowTicks - waitStartTicks > stallTimeoutTicks)
+                {
+                    taskIndex = findUnstartedReadyTask();
+                    waitStartTicks = 0;
+                }
+            }
+
+            if (taskIndex < 0)
+            {
+                spinPause();
+                continue;
+            }
+        }
+
+        // another thread might have already taken this task
+        if (! claimTask (taskIndex))
+        {
+            taskIndex = -1;
+            continue;
+        }
+
+        waitStartTicks = 0;
+        const auto& task = jobSchedule->tasks[(size_t) taskIndex];
+        {
+            const auto frame = arena.create_frame();
+            jobCallback (jobContext, task, arena);
+        }
+
+        // keep one of the dependent tasks for this thread, and let the other threads steal the rest
+        int nextTaskIndex = -1;
+        for (auto dependentTaskIndex : task.dependentTasks)
+        {
+            if (jobSchedule->taskDependencyCounters[(size_t) dependentTaskIndex].fetch_sub (1, std::memory_order_acq_rel) != 1)
+                continue;
+
+            if (nextTaskIndex < 0)
+                nextTaskIndex = dependentTaskIndex;
+            else
+                pushReadyTask (dependentTaskIndex);
+        }
+
+        numTasksRemaining.fetch_sub (1, std::memory_order_release);
+        taskIndex = nextTaskIndex;
+    }
+}
+
+bool ProcessorChainThreadPool::claimTask (int taskIndex)
+{
+    return ! jobSchedule->taskStarted[(size_t) taskIndex].exchange (true, std::memory_order_acq_rel);
+}
+
+int ProcessorChainThreadPool::findUnstartedReadyTask() const
+{
+    const auto numTasks = (int) jobSchedule->tasks.size();
+    for (int i = 0; i < numTasks; ++i)
+    {
+        if (jobSchedule->taskDependencyCounters[(size_t) i].load (std::memory_order_acquire) == 0
+            && ! jobSchedule->taskStarted[(size_t) i].load (std::memory_order_relaxed))
+            return i;
+    }
+
+    return -1;
+}
+
+void ProcessorChainThreadPool::pushReadyTask (int taskIndex)
+{
+    const auto queueIndex = readyTasksPushIndex.fetch_add (1, std::memory_order_relaxed);
+    jobSchedule->readyTaskQueue[(size_t) queueIndex].store (taskIndex, std::memory_order_release);
+}
+
+int ProcessorChainThreadPool::popReadyTask()
+{
+    auto& queue = jobSchedule->readyTaskQueue;
+    auto queueIndex = readyTasksPopIndex.load (std::memory_order_acquire);
+    while (queueIndex < (int) queue.size())
+    {
+        const auto taskIndex = queue[(size_t) queueIndex].load (std::memory_order_acquire);
+        if (taskIndex < 0)
+            return -1; // the next task hasn't been pushed yet
+
+        if (readyTasksPopIndex.compare_exchange_weak (queueIndex, queueIndex + 1, std::memory_order_acq_rel))
+            return taskIndex;
+    }
+
+    return -1;
+}
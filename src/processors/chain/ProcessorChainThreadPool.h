@@ -0,0 +1,93 @@
+#pragma once
+
+#include "ProcessorChainSchedule.h"
+
+/**
+ * A pool of worker threads, used for processing the independent
+ * branches of a parallel processing schedule.
+ *
+ * While processing, the audio thread processes tasks along with the workers.
+ * When a thread finishes a task, it keeps one of the newly ready dependent
+ * tasks for itself, and pushes the rest to a shared lock-free queue, where
+ * idle threads can steal them. Between blocks, the workers spin for a short
+ * time before going to sleep, so they're ready to go if the next block
+ * arrives soon.
+ *
+ * The workers run at real-time priority, since the audio thread has to wait
+ * for them. If the audio thread runs out of work, and none of the remaining
+ * tasks have finished for a little while (e.g. because a worker has been
+ * pre-empted), the audio thread takes over any tasks that are ready but
+ * haven't been started yet, so a stalled worker can't hold up the block for
+ * longer than the tasks it's actually processing.
+ *
+ * Since each processor input gets its own buffer, and the merging processors
+ * (Mixer, StereoMerger, etc.) sum their inputs in port order, the output is
+ * the same as when the schedule is processed serially.
+ */
+class ProcessorChainThreadPool
+{
+public:
+    using TaskCallback = void (*) (void* context, const ProcessorChainSchedule::Task& task, DSPArena& arena);
+
+    ProcessorChainThreadPool (int numWorkers, size_t arenaBytes);
+    ~ProcessorChainThreadPool();
+
+    /** Re-allocates the worker arenas. Must not be called while processing. */
+    void prepareArenas (size_t arenaBytes);
+
+    /**
+     * Swaps the worker arenas with some memory that was allocated elsewhere (one span per worker),
+     * leaving the old arena memory in the vector. This doesn't allocate, so it can be called from
+     * the audio thread, but must not be called while processing.
+     */
+    void swapArenas (std::vector<std::span<std::byte>>& arenaMemory) noexcept;
+
+    /** Processes all the tasks in the schedule, and returns once they're done. */
+    void processTasks (ProcessorChainSchedule& schedule, TaskCallback callback, void* context, DSPArena& audioThreadArena);
+
+    int getNumWorkers() const noexcept { return (int) workers.size(); }
+    size_t getArenaSizeBytes() const noexcept { return arenaSizeBytes.load(); }
+
+    /** Returns a reasonable number of worker threads to use on this machine. */
+    static int getDefaultNumWorkers();
+
+private:
+    struct Worker : Thread
+    {
+        Worker (ProcessorChainThreadPool& threadPool, int index);
+        void run() override { pool.workerLoop (*this); }
+
+        ProcessorChainThreadPool& pool;
+        DSPArena arena {};
+        WaitableEvent wakeEvent;
+        std::atomic_bool isSleeping { false };
+    };
+
+    void workerLoop (Worker& worker);
+    void runTasks (DSPArena& arena, bool isAudioThread);
+    void pushReadyTask (int taskIndex);
+    int popReadyTask();
+    bool claimTask (int taskIndex);
+    int findUnstartedReadyTask() const;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<size_t> arenaSizeBytes { 0 };
+    std::atomic_bool shouldExit { false };
+
+    // the current job (only changed by the audio thread while no workers are active)
+    ProcessorChainSchedule* jobSchedule = nullptr;
+    TaskCallback jobCallback = nullptr;
+    void* jobContext = nullptr;
+
+    std::atomic<uint32_t> jobCounter { 0 };
+    std::atomic_bool jobIsRunning { false };
+    std::atomic<int> numActiveWorkers { 0 };
+    std::atomic<int> numTasksRemaining { 0 };
+
+    // Each task becomes ready exactly once per job, so the queue is just an array
+    // of task slots (stored in the schedule), with separate indices for pushing and popping.
+    std::atomic<int> readyTasksPushIndex { 0 };
+    std::atomic<int> readyTasksPopIndex { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ProcessorChainThreadPool)
+};
@@ -26,12 +26,12 @@ void BassFace::prepare (double sampleRate, int samplesPerBlock)
     if ((int) sampleRate % 44100 == 0)
     {
         for (auto& m : model)
-            m.initialise (BinaryData::bass_face_model_88_2k_json, BinaryData::bass_face_model_88_2k_jsonSize, 88200.0);
+            m.initialise (BinaryData::bass_face_model_88_2k_bnnw, BinaryData::bass_face_model_88_2k_bnnwSize, 88200.0);
     }
     else
     {
         for (auto& m : model)
-            m.initialise (BinaryData::bass_face_model_96k_json, BinaryData::bass_face_model_96k_jsonSize, 96000.0);
+            m.initialise (BinaryData::bass_face_model_96k_bnnw, BinaryData::bass_face_model_96k_bnnwSize, 96000.0);
     }
 
     const size_t oversamplingOrder = sampleRate <= 48000.0 ? 1 : 0;
@@ -41,7 +41,7 @@ void BassFace::prepare (double sampleRate, int samplesPerBlock)
     const auto osSamplesPerBlock = samplesPerBlock * (int) oversampling->getOversamplingFactor();
 
     for (auto& m : model)
-        m.prepare (osSampleRate, osSamplesPerBlock);
+        m.prepare (osSampleRate, osSamplesPerBlock, getMathsQuality());
 
     gainSmoothed.prepare (osSampleRate, osSamplesPerBlock);
     gainSmoothed.setRampLength (0.05);
@@ -14,6 +14,7 @@ public:
 
     void prepare (double sampleRate, int samplesPerBlock) override;
     void processAudio (AudioBuffer<float>& buffer) override;
+    double getTailLengthSeconds() const override { return jmax (stateSettleTimeSeconds, getFilterTailLengthSeconds (15.0, MathConstants<double>::sqrt2 / 2.0)); }
 
 private:
     chowdsp::SmoothedBufferValue<float> gainSmoothed;
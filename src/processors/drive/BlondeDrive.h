@@ -12,6 +12,7 @@ public:
 
     void prepare (double sampleRate, int samplesPerBlock) override;
     void processAudio (AudioBuffer<float>& buffer) override;
+    double getTailLengthSeconds() const override { return jmax (stateSettleTimeSeconds, getFilterTailLengthSeconds (30.0)); }
 
 private:
     chowdsp::SmoothedBufferValue<double> driveParamSmooth;
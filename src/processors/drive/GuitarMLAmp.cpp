@@ -1,13 +1,14 @@
 #include "GuitarMLAmp.h"
+#include "neural_utils/ModelWeights.h"
 #include "gui/utils/ErrorMessageView.h"
 #include "gui/utils/ModulatableSlider.h"
 
 namespace RONNTags
 {
 const juce::StringArray guitarMLModelResources {
-    "BluesJrAmp_VolKnob_json",
-    "TS9_DriveKnob_json",
-    "MesaRecMini_ModernChannel_GainKnob_json",
+    "BluesJrAmp_VolKnob_bnnw",
+    "TS9_DriveKnob_bnnw",
+    "MesaRecMini_ModernChannel_GainKnob_bnnw",
 };
 
 const juce::StringArray guitarMLModelNames {
@@ -23,9 +24,35 @@ const String gainTag = "gain";
 const String conditionTag = "condition";
 const String sampleRateCorrFilterTag = "sample_rate_corr_filter";
 const String customModelTag = "custom_model";
+const String builtInModelTag = "builtin_model";
 constexpr std::string_view modelNameTag = "byod_guitarml_model_name";
 } // namespace RONNTags
 
+namespace
+{
+constexpr double crossfadeTimeSeconds = 0.05;
+
+[[maybe_unused]] bool shouldUseAVX()
+{
+    return juce::SystemStats::hasAVX() && juce::SystemStats::hasFMA3();
+}
+
+/** Adds the model name to the model JSON (if it's not in there already), so it can be restored along with the model. */
+String getModelJsonWithName (std::string_view modelJson, const String& modelName)
+{
+    const auto objectStart = modelJson.find ('{');
+    if (modelName.isEmpty() || objectStart == std::string_view::npos || modelJson.find (RONNTags::modelNameTag) != std::string_view::npos)
+        return String::fromUTF8 (modelJson.data(), (int) modelJson.size());
+
+    const auto nameEntry = chowdsp::json (std::string { RONNTags::modelNameTag }).dump() + ": " + chowdsp::json (modelName.toStdString()).dump() + ", ";
+
+    std::string result;
+    result.reserve (modelJson.size() + nameEntry.size());
+    result.append (modelJson.substr (0, objectStart + 1)).append (nameEntry).append (modelJson.substr (objectStart + 1));
+    return String::fromUTF8 (result.data(), (int) result.size());
+}
+} // namespace
+
 GuitarMLAmp::GuitarMLAmp (UndoManager* um) : BaseProcessor ("GuitarML", createParameterLayout(), um)
 {
     using namespace ParameterHelpers;
@@ -34,6 +61,7 @@ GuitarMLAmp::GuitarMLAmp (UndoManager* um) : BaseProcessor ("GuitarML", createPa
     loadParameterPointer (sampleRateCorrectionFilterParam, vts, RONNTags::sampleRateCorrFilterTag);
     addPopupMenuParameter (RONNTags::sampleRateCorrFilterTag);
 
+    loadingState->processor = this;
     loadModel (0); // load Blues Jr. model by default
 
     uiOptions.backgroundColour = Colours::cornsilk.darker();
@@ -43,18 +71,19 @@ GuitarMLAmp::GuitarMLAmp (UndoManager* um) : BaseProcessor ("GuitarML", createPa
     uiOptions.info.infoLink = "https://guitarml.com";
 
 #if JUCE_INTEL
-    if (juce::SystemStats::hasAVX() && juce::SystemStats::hasFMA3())
-    {
+    if (shouldUseAVX())
         juce::Logger::writeToLog ("Using RNN model with AVX SIMD instructions!");
-        lstm40CondModels[0].template emplace<rnn_avx::RNNAccelerated<2, 40, RecurrentLayerType::LSTMLayer, (int) RTNeural::SampleRateCorrectionMode::LinInterp>>();
-        lstm40CondModels[1].template emplace<rnn_avx::RNNAccelerated<2, 40, RecurrentLayerType::LSTMLayer, (int) RTNeural::SampleRateCorrectionMode::LinInterp>>();
-        lstm40NoCondModels[0].template emplace<rnn_avx::RNNAccelerated<1, 40, RecurrentLayerType::LSTMLayer, (int) RTNeural::SampleRateCorrectionMode::LinInterp>>();
-        lstm40NoCondModels[1].template emplace<rnn_avx::RNNAccelerated<1, 40, RecurrentLayerType::LSTMLayer, (int) RTNeural::SampleRateCorrectionMode::LinInterp>>();
-    }
 #endif
 }
 
-GuitarMLAmp::~GuitarMLAmp() = default;
+GuitarMLAmp::~GuitarMLAmp()
+{
+    // make sure that any models that are still being loaded are thrown away
+    const std::lock_guard lock { loadingState->mutex };
+    loadingState->processor = nullptr;
+    loadingState->requestedGeneration++;
+    cancelPendingUpdate();
+}
 
 ParamLayout GuitarMLAmp::createParameterLayout()
 {
@@ -68,89 +97,262 @@ ParamLayout GuitarMLAmp::createParameterLayout()
     return { params.begin(), params.end() };
 }
 
-void GuitarMLAmp::loadModelFromJson (const chowdsp::json& modelJson, const String& newModelName)
+std::string_view GuitarMLAmp::ModelSource::getModelData() const
+{
+    if (juce::isPositiveAndBelow (builtInIndex, RONNTags::numBuiltInModels))
+    {
+        int modelDataSize = 0;
+        const auto* builtInData = BinaryData::getNamedResource (RONNTags::guitarMLModelResources[builtInIndex].toRawUTF8(), modelDataSize);
+        jassert (builtInData != nullptr);
+        return { builtInData, (size_t) modelDataSize };
+    }
+
+    if (modelFile != nullptr && modelFile->getData() != nullptr)
+        return { static_cast<const char*> (modelFile->getData()), modelFile->getSize() };
+
+    return modelData != nullptr ? std::string_view { *modelData } : std::string_view {};
+}
+
+//======================================================================
+GuitarMLAmp::NeuralModel::NeuralModel (const GuitarMLModelArch& modelArch)
+    : arch (modelArch),
+      rnn (GuitarMLModelRegistry::createModel (arch))
+{
+}
+
+void GuitarMLAmp::NeuralModel::prepare (double sampleRate, int samplesPerBlock, MathsQuality mathsQuality)
 {
-    const auto& modelDataJson = modelJson.at ("model_data");
-    const auto numInputs = modelDataJson.value ("input_size", 1);
-    const auto hiddenSize = modelDataJson.value ("hidden_size", 0);
-    const auto modelSampleRate = modelDataJson.value ("sample_rate", 44100.0);
-    const auto rnnDelaySamples = jmax (1.0, processSampleRate / modelSampleRate);
+    inGain.prepare ({ sampleRate, (uint32) samplesPerBlock, 2 });
+    inGain.setRampDurationSeconds (0.1);
 
-    sampleRateCorrectionFilter.reset();
+    const auto rnnDelaySamples = jmax (1.0, sampleRate / modelSampleRate);
+    rnn->prepare ((float) rnnDelaySamples, mathsQuality);
+
+    sampleRateCorrectionFilter.prepare (2);
     sampleRateCorrectionFilter.calcCoefs (8100.0f,
                                           chowdsp::CoefficientCalculators::butterworthQ<float>,
-                                          (processSampleRate < modelSampleRate * 1.1) ? 1.0f : 0.25f,
-                                          (float) processSampleRate);
+                                          (sampleRate < modelSampleRate * 1.1) ? 1.0f : 0.25f,
+                                          (float) sampleRate);
+}
 
-    if (numInputs == 1 && hiddenSize == 40) // non-conditioned LSMT40
+void GuitarMLAmp::NeuralModel::process (AudioBuffer<float>& buffer, float gainDB, const float* conditionData, bool useSampleRateCorrectionFilter) noexcept
+{
+    const auto numChannels = buffer.getNumChannels();
+    const auto numSamples = buffer.getNumSamples();
+    auto* const* channelData = buffer.getArrayOfWritePointers();
+
+    if (! arch.isConditioned())
     {
-        SpinLock::ScopedLockType modelChangingLock { modelChangingMutex };
-        for (auto& modelVariant : lstm40NoCondModels)
-        {
-            modelVariant.visit (
-                [rnnDelaySamples, &modelJson] (auto& model)
-                {
-                    model.initialise (modelJson);
-                    model.prepare ((float) rnnDelaySamples);
-                });
-        }
+        inGain.setGainDecibels (gainDB);
+        inGain.process (buffer);
+    }
 
-        modelArch = ModelArch::LSTM40NoCond;
+    rnn->process ({ channelData, (size_t) numChannels }, (size_t) numSamples, conditionData, useResiduals);
+
+    if (useSampleRateCorrectionFilter)
+    {
+        sampleRateCorrectionFilter.processBlock (buffer);
     }
-    else if (numInputs == 2 && hiddenSize == 40) // conditioned LSMT40
+
+    buffer.applyGain (normalizationGain);
+}
+
+std::unique_ptr<GuitarMLAmp::NeuralModel> GuitarMLAmp::createModel (const ModelSource& source, String& modelName)
+{
+    const auto modelData = source.getModelData();
+    modelName = source.name;
+
+    // built-in models (and converted custom models) use the binary weights format, so there's nothing to parse,
+    // otherwise we need to convert the model JSON to binary weights
+    std::vector<std::byte> convertedWeightsData;
+    auto weights = ModelWeights::fromData (modelData.data(), modelData.size());
+    if (! weights.has_value())
     {
-        SpinLock::ScopedLockType modelChangingLock { modelChangingMutex };
-        for (auto& modelVariant : lstm40CondModels)
-        {
-            modelVariant.visit (
-                [rnnDelaySamples, &modelJson] (auto& model)
-                {
-                    model.initialise (modelJson);
-                    model.prepare ((float) rnnDelaySamples);
-                });
-        }
+        const auto modelJson = chowdsp::json::parse (modelData.begin(), modelData.end());
+        if (modelName.isEmpty())
+            modelName = String { modelJson.value (RONNTags::modelNameTag, "") };
 
-        modelArch = ModelArch::LSTM40Cond;
-        conditionParam.reset();
+        convertedWeightsData = ModelWeights::fromJson (modelJson);
+        weights = ModelWeights::fromData (convertedWeightsData.data(), convertedWeightsData.size());
+    }
+
+    // picks a pre-compiled model for the model size if there is one, or a dynamic model otherwise
+    auto model = std::make_unique<NeuralModel> (GuitarMLModelArch::fromWeights (*weights));
+    model->rnn->initialise (*weights);
+    model->modelSampleRate = (double) weights->getScalar ("model_data/sample_rate", 44100.0f);
+    model->useResiduals = weights->getScalar ("model_data/skip", 1.0f) != 0.0f;
+
+    // The Mesa model is a bit loud, so let's normalize the level down a bit
+    // Eventually it would be good to do this sort of thing programmatically.
+    // so that it could work for custom loaded models as well.
+    if (source.builtInIndex == 2)
+        model->normalizationGain = 0.5f;
+
+    return model;
+}
+
+//======================================================================
+GuitarMLAmp::LoadingState::~LoadingState()
+{
+    delete pendingModel.exchange (nullptr);
+    deleteRetiredModels();
+}
+
+bool GuitarMLAmp::LoadingState::retire (NeuralModel* model) noexcept
+{
+    for (auto& retiredModel : retiredModels)
+    {
+        NeuralModel* emptySlot = nullptr;
+        if (retiredModel.compare_exchange_strong (emptySlot, model))
+            return true;
+    }
+
+    return false;
+}
+
+void GuitarMLAmp::LoadingState::deleteRetiredModels()
+{
+    for (auto& retiredModel : retiredModels)
+        delete retiredModel.exchange (nullptr);
+}
+
+void GuitarMLAmp::requestModel (ModelSource&& source)
+{
+    auto sharedSource = std::make_shared<const ModelSource> (std::move (source));
+
+    int generation;
+    {
+        const std::lock_guard lock { loadingState->mutex };
+        generation = ++loadingState->requestedGeneration;
+        loadingState->requestedSource = sharedSource;
+    }
+
+    loadingJobPool->pool.addJob ([state = loadingState, modelSource = std::move (sharedSource), generation]
+                                 { runLoadingJob (state, modelSource, generation); });
+}
+
+void GuitarMLAmp::runLoadingJob (const std::shared_ptr<LoadingState>& state, std::shared_ptr<const ModelSource> source, int generation)
+{
+    {
+        const std::lock_guard lock { state->mutex };
+        if (generation != state->requestedGeneration)
+            return; // another model has been requested since this one
+    }
+
+    std::unique_ptr<NeuralModel> model;
+    String modelName, errorMessage;
+    try
+    {
+        model = createModel (*source, modelName);
+    }
+    catch (const std::exception& exc)
+    {
+        errorMessage = exc.what();
+    }
+
+    const std::lock_guard lock { state->mutex };
+
+    // the model has already been loaded by prepare(), or it's no longer needed
+    if (generation != state->requestedGeneration || generation <= state->loadedGeneration)
+        return;
+
+    if (model == nullptr)
+    {
+        state->failedSource = std::move (source);
+        state->failureMessage = errorMessage;
     }
     else
     {
-        // unsupported number of inputs!
-        throw std::exception();
+        model->prepare (state->sampleRate, state->samplesPerBlock, state->mathsQuality);
+        state->loadedGeneration = generation;
+        state->loadedSource = std::move (source);
+        state->loadedModelName = modelName;
+        state->loadedModelArch = model->arch;
+
+        // if the audio thread hasn't picked up the previous pending model yet, then it never will
+        state->deleteRetiredModels();
+        delete state->pendingModel.exchange (model.release());
     }
 
-    cachedModel = modelJson;
-    if (newModelName.isNotEmpty())
-        cachedModel[RONNTags::modelNameTag] = newModelName;
+    if (state->processor != nullptr)
+        state->processor->triggerAsyncUpdate();
+}
 
-    modelChangeBroadcaster();
+void GuitarMLAmp::loadRequestedModel()
+{
+    // this is called from prepare(), with the loading state locked
+    auto& state = *loadingState;
+
+    String modelName;
+    try
+    {
+        currentModel = createModel (*state.requestedSource, modelName);
+        state.loadedSource = state.requestedSource;
+    }
+    catch (const std::exception& exc)
+    {
+        state.failedSource = state.requestedSource;
+        state.failureMessage = exc.what();
+
+        // go back to Blues Jr. model
+        ModelSource defaultSource;
+        defaultSource.builtInIndex = 0;
+        defaultSource.name = RONNTags::guitarMLModelNames[0];
+        state.loadedSource = std::make_shared<const ModelSource> (std::move (defaultSource));
+        state.requestedSource = state.loadedSource;
+        currentModel = createModel (*state.loadedSource, modelName);
+    }
+
+    state.loadedGeneration = state.requestedGeneration;
+    state.loadedModelName = modelName;
+    state.loadedModelArch = currentModel->arch;
+    triggerAsyncUpdate();
 }
 
-void GuitarMLAmp::loadModel (int modelIndex, Component* parentComponent)
+void GuitarMLAmp::handleAsyncUpdate()
 {
-    normalizationGain = 1.0f;
+    std::shared_ptr<const ModelSource> failedSource;
+    String failureMessage;
+    bool shouldLoadDefaultModel;
+    {
+        const std::lock_guard lock { loadingState->mutex };
+        modelArch = loadingState->loadedModelArch;
+        failedSource = std::exchange (loadingState->failedSource, nullptr);
+        failureMessage = loadingState->failureMessage;
+        shouldLoadDefaultModel = failedSource != nullptr && failedSource == loadingState->requestedSource;
+    }
 
-    if (juce::isPositiveAndBelow (modelIndex, RONNTags::numBuiltInModels))
+    if (shouldLoadDefaultModel)
+        loadModel (0); // go back to Blues Jr. model
+
+    if (failedSource != nullptr && failedSource->showErrorMessage)
     {
-        int modelDataSize = 0;
-        const auto* modelData = BinaryData::getNamedResource (RONNTags::guitarMLModelResources[modelIndex].toRawUTF8(), modelDataSize);
-        jassert (modelData != nullptr);
+        const auto errorMessage = String { "Unable to load GuitarML model from file!\n\n" } + failureMessage;
+        ErrorMessageView::showErrorMessage ("GuitarML Error",
+                                            errorMessage,
+                                            "OK",
+                                            failedSource->errorMessageParent.getComponent());
+    }
 
-        const auto modelJson = chowdsp::JSONUtils::fromBinaryData (modelData, modelDataSize);
-        loadModelFromJson (modelJson, RONNTags::guitarMLModelNames[modelIndex]);
+    modelChangeBroadcaster();
+}
 
-        // The Mesa model is a bit loud, so let's normalize the level down a bit
-        // Eventually it would be good to do this sort of thing programmatically.
-        // so that it could work for custom loaded models as well.
-        if (modelIndex == 2)
-            normalizationGain = 0.5f;
+void GuitarMLAmp::loadModel (int modelIndex, Component* parentComponent)
+{
+    if (juce::isPositiveAndBelow (modelIndex, RONNTags::numBuiltInModels))
+    {
+        ModelSource source;
+        source.builtInIndex = modelIndex;
+        source.name = RONNTags::guitarMLModelNames[modelIndex];
+        requestModel (std::move (source));
     }
     else if (modelIndex == RONNTags::numBuiltInModels)
     {
-        customModelChooser = std::make_shared<FileChooser> ("GuitarML Model", File {}, "*.json", true, false, parentComponent);
+        customModelChooser = std::make_shared<FileChooser> ("GuitarML Model", File {}, "*.json;*.bnnw", true, false, parentComponent);
         customModelChooser->launchAsync (FileBrowserComponent::FileChooserFlags::canSelectFiles,
                                          [this, safeParent = Component::SafePointer { parentComponent }] (const FileChooser& modelChooser)
                                          {
+                                             ModelSource source;
 #if JUCE_IOS
                                              const auto chosenFile = modelChooser.getURLResult();
                                              if (chosenFile == URL {})
@@ -159,12 +361,13 @@ void GuitarMLAmp::loadModel (int modelIndex, Component* parentComponent)
                                                  return;
                                              }
 
-                                             try
+                                             if (auto chosenFileStream = chosenFile.createInputStream (URL::InputStreamOptions (URL::ParameterHandling::inAddress)))
                                              {
-                                                 auto chosenFileStream = chosenFile.createInputStream (URL::InputStreamOptions (URL::ParameterHandling::inAddress));
-                                                 const auto& modelJson = chowdsp::JSONUtils::fromInputStream (*chosenFileStream);
-                                                 loadModelFromJson (modelJson, chosenFile.getLocalFile().getFileNameWithoutExtension());
+                                                 MemoryBlock chosenFileData;
+                                                 chosenFileStream->readIntoMemoryBlock (chosenFileData);
+                                                 source.modelData = std::make_shared<const std::string> (static_cast<const char*> (chosenFileData.getData()), chosenFileData.getSize());
                                              }
+                                             source.name = chosenFile.getLocalFile().getFileNameWithoutExtension();
 #else
                 const auto chosenFile = modelChooser.getResult();
                 if (chosenFile == File {})
@@ -173,21 +376,17 @@ void GuitarMLAmp::loadModel (int modelIndex, Component* parentComponent)
                     return;
                 }
 
-                try
-                {
-                    const auto& modelJson = chowdsp::JSONUtils::fromFile (chosenFile);
-                    loadModelFromJson (modelJson, chosenFile.getFileNameWithoutExtension());
-                }
+                // binary weights files can be used straight from disk, without copying them into memory
+                if (chosenFile.hasFileExtension ("bnnw"))
+                    source.modelFile = std::make_shared<const MemoryMappedFile> (chosenFile, MemoryMappedFile::readOnly);
+                else
+                    source.modelData = std::make_shared<const std::string> (chosenFile.loadFileAsString().toStdString());
+                source.name = chosenFile.getFileNameWithoutExtension();
 #endif
-                                             catch (const std::exception& exc)
-                                             {
-                                                 loadModel (0);
-                                                 const auto errorMessage = String { "Unable to load GuitarML model from file!\n\n" } + exc.what();
-                                                 ErrorMessageView::showErrorMessage ("GuitarML Error",
-                                                                                     errorMessage,
-                                                                                     "OK",
-                                                                                     safeParent.getComponent());
-                                             }
+                                             // the model is parsed on the loading thread, so any errors will be shown from there
+                                             source.errorMessageParent = safeParent;
+                                             source.showErrorMessage = true;
+                                             requestModel (std::move (source));
                                          });
     }
     else
@@ -200,22 +399,43 @@ void GuitarMLAmp::loadModel (int modelIndex, Component* parentComponent)
 
 String GuitarMLAmp::getCurrentModelName() const
 {
-    return cachedModel.value (RONNTags::modelNameTag, "");
+    const std::lock_guard lock { loadingState->mutex };
+    return loadingState->loadedModelName;
 }
 
-void GuitarMLAmp::prepare (double sampleRate, int samplesPerBlock)
+bool GuitarMLAmp::isBackgroundLoadingIdle()
 {
-    dsp::ProcessSpec spec { sampleRate, (uint32) samplesPerBlock, 2 };
-    inGain.prepare (spec);
-    inGain.setRampDurationSeconds (0.1);
-
-    sampleRateCorrectionFilter.prepare (2);
+    // the jobs stay in the pool until they've finished running
+    return SharedResourcePointer<LoadingJobPool>()->pool.getNumJobs() == 0;
+}
 
+void GuitarMLAmp::prepare (double sampleRate, int samplesPerBlock)
+{
     conditionParam.prepare (sampleRate, samplesPerBlock);
     conditionParam.setRampLength (0.05);
 
-    processSampleRate = sampleRate;
-    loadModelFromJson (cachedModel);
+    {
+        const std::lock_guard lock { loadingState->mutex };
+        loadingState->sampleRate = sampleRate;
+        loadingState->samplesPerBlock = samplesPerBlock;
+        loadingState->mathsQuality = getMathsQuality();
+
+        // the audio thread isn't running right now, so we can hand over the models here
+        if (auto* pendingModel = loadingState->pendingModel.exchange (nullptr))
+            currentModel.reset (pendingModel);
+        loadingState->deleteRetiredModels();
+        fadingOutModel.reset();
+
+        // if the latest model is still being loaded, then we'll load it here instead
+        if (currentModel == nullptr || loadingState->loadedGeneration != loadingState->requestedGeneration)
+            loadRequestedModel();
+
+        currentModel->prepare (sampleRate, samplesPerBlock, getMathsQuality());
+    }
+
+    crossfade.reset (sampleRate, crossfadeTimeSeconds);
+    crossfade.setCurrentAndTargetValue (1.0f);
+    fadeBuffer.setSize (2, samplesPerBlock);
 
     dcBlocker.prepare (sampleRate, samplesPerBlock);
 
@@ -228,70 +448,102 @@ void GuitarMLAmp::prepare (double sampleRate, int samplesPerBlock)
     }
 }
 
-void GuitarMLAmp::processAudio (AudioBuffer<float>& buffer)
+void GuitarMLAmp::retireFadingOutModel() noexcept
 {
-    const SpinLock::ScopedTryLockType modelChangingLock { modelChangingMutex };
-    if (! modelChangingLock.isLocked())
-        return;
+    // if the retire queue is full, we'll hang on to the model and try again on the next block
+    if (fadingOutModel != nullptr && ! crossfade.isSmoothing() && loadingState->retire (fadingOutModel.get()))
+        fadingOutModel.release();
+}
 
-    const auto numChannels = buffer.getNumChannels();
-    const auto numSamples = buffer.getNumSamples();
+void GuitarMLAmp::processAudio (AudioBuffer<float>& buffer)
+{
+    retireFadingOutModel();
 
-    if (modelArch == ModelArch::LSTM40NoCond)
+    // only pick up a new model once we're done with the previous one
+    if (fadingOutModel == nullptr)
     {
-        inGain.setGainDecibels (gainParam->getCurrentValue() - 12.0f);
-        inGain.process (buffer);
-
-        for (int ch = 0; ch < numChannels; ++ch)
+        if (auto* newModel = loadingState->pendingModel.exchange (nullptr))
         {
-            auto* x = buffer.getWritePointer (ch);
-            lstm40NoCondModels[ch].visit ([x, numSamples] (auto& model)
-                                          { model.process ({ x, (size_t) numSamples }, true); });
+            fadingOutModel = std::move (currentModel);
+            currentModel.reset (newModel);
+            crossfade.setCurrentAndTargetValue (0.0f);
+            crossfade.setTargetValue (1.0f);
         }
     }
-    else if (modelArch == ModelArch::LSTM40Cond)
+
+    const auto numChannels = buffer.getNumChannels();
+    const auto numSamples = buffer.getNumSamples();
+
+    conditionParam.process (numSamples);
+    const auto* conditionData = conditionParam.getSmoothedBuffer();
+    const auto gainDB = gainParam->getCurrentValue() - 12.0f;
+    const auto useSampleRateCorrectionFilter = sampleRateCorrectionFilterParam->get();
+
+    const auto isCrossfading = fadingOutModel != nullptr && crossfade.isSmoothing();
+    if (isCrossfading)
     {
-        conditionParam.process (numSamples);
-        const auto* conditionData = conditionParam.getSmoothedBuffer();
+        fadeBuffer.makeCopyOf (buffer, true);
+        fadingOutModel->process (fadeBuffer, gainDB, conditionData, useSampleRateCorrectionFilter);
+    }
 
-        for (int ch = 0; ch < numChannels; ++ch)
+    currentModel->process (buffer, gainDB, conditionData, useSampleRateCorrectionFilter);
+
+    if (isCrossfading)
+    {
+        // Both models are processing the same signal, so the outputs should
+        // be fairly well correlated, and a linear crossfade is fine here.
+        auto* const* channelData = buffer.getArrayOfWritePointers();
+        const auto* const* fadeData = fadeBuffer.getArrayOfReadPointers();
+        for (int n = 0; n < numSamples; ++n)
         {
-            auto* x = buffer.getWritePointer (ch);
-            lstm40CondModels[ch].visit ([x, conditionData, numSamples] (auto& model)
-                                        { model.process_conditioned ({ x, (size_t) numSamples }, { conditionData, (size_t) numSamples }, true); });
+            const auto fadeInGain = crossfade.getNextValue();
+            for (int ch = 0; ch < numChannels; ++ch)
+                channelData[ch][n] = fadeInGain * channelData[ch][n] + (1.0f - fadeInGain) * fadeData[ch][n];
         }
-    }
 
-    if (sampleRateCorrectionFilterParam->get())
-    {
-        sampleRateCorrectionFilter.processBlock (buffer);
+        retireFadingOutModel();
     }
 
-    buffer.applyGain (normalizationGain);
-
     dcBlocker.processAudio (buffer);
 }
 
 std::unique_ptr<XmlElement> GuitarMLAmp::toXML()
 {
     auto xml = BaseProcessor::toXML();
-    xml->setAttribute (RONNTags::customModelTag, cachedModel.dump());
+
+    {
+        const std::lock_guard lock { loadingState->mutex };
+        if (const auto& source = loadingState->requestedSource)
+        {
+            if (juce::isPositiveAndBelow (source->builtInIndex, RONNTags::numBuiltInModels))
+                xml->setAttribute (RONNTags::builtInModelTag, source->builtInIndex);
+
+            // presets always store the model as JSON, so that they can be loaded by older versions of the plugin
+            const auto modelData = source->getModelData();
+            if (const auto weights = ModelWeights::fromData (modelData.data(), modelData.size()))
+                xml->setAttribute (RONNTags::customModelTag, getModelJsonWithName (weights->toJson().dump(), source->name));
+            else
+                xml->setAttribute (RONNTags::customModelTag, getModelJsonWithName (modelData, source->name));
+        }
+    }
 
     return std::move (xml);
 }
 
 void GuitarMLAmp::fromXML (XmlElement* xml, const chowdsp::Version& version, bool loadPosition)
 {
-    const auto modelJsonString = xml->getStringAttribute (RONNTags::customModelTag, {});
-    try
+    // if the model can't be loaded, we'll go back to the Blues Jr. model
+    ModelSource source;
+    if (const auto builtInIndex = xml->getIntAttribute (RONNTags::builtInModelTag, -1); juce::isPositiveAndBelow (builtInIndex, RONNTags::numBuiltInModels))
     {
-        const auto& modelJson = chowdsp::json::parse (modelJsonString.toStdString());
-        loadModelFromJson (modelJson);
+        source.builtInIndex = builtInIndex;
+        source.name = RONNTags::guitarMLModelNames[builtInIndex];
     }
-    catch (...)
+    else
     {
-        loadModel (0); // go back to Blues Jr. model
+        source.modelData = std::make_shared<const std::string> (xml->getStringAttribute (RONNTags::customModelTag, {}).toStdString());
     }
+    requestModel (std::move (source));
 
     BaseProcessor::fromXML (xml, version, loadPosition);
 
@@ -303,13 +555,66 @@ void GuitarMLAmp::fromXML (XmlElement* xml, const chowdsp::Version& version, boo
     }
 }
 
+void GuitarMLAmp::toBinary (BinaryStateWriter& writer)
+{
+    BaseProcessor::toBinary (writer);
+
+    const std::lock_guard lock { loadingState->mutex };
+    const auto& source = loadingState->requestedSource;
+    if (source == nullptr)
+    {
+        writer.writeInt (-1);
+        writer.writeString ({});
+        writer.writeData (nullptr, 0);
+        return;
+    }
+
+    // unlike presets, the plugin state stores custom models in whatever format they were loaded from
+    writer.writeInt (source->builtInIndex);
+    writer.writeString (source->name);
+    if (juce::isPositiveAndBelow (source->builtInIndex, RONNTags::numBuiltInModels))
+    {
+        writer.writeData (nullptr, 0);
+    }
+    else
+    {
+        const auto modelData = source->getModelData();
+        writer.writeData (modelData.data(), modelData.size());
+    }
+}
+
+void GuitarMLAmp::fromBinary (BinaryStateReader& reader, const chowdsp::Version& version, bool loadPosition)
+{
+    BaseProcessor::fromBinary (reader, version, loadPosition);
+
+    const auto builtInIndex = reader.readInt();
+    const auto modelName = reader.readString();
+    const auto modelData = reader.readData();
+    if (reader.hasFailed())
+        return;
+
+    // if the model can't be loaded, we'll go back to the Blues Jr. model
+    ModelSource source;
+    if (juce::isPositiveAndBelow (builtInIndex, RONNTags::numBuiltInModels))
+    {
+        source.builtInIndex = builtInIndex;
+        source.name = RONNTags::guitarMLModelNames[builtInIndex];
+    }
+    else
+    {
+        source.name = modelName;
+        source.modelData = std::make_shared<const std::string> (static_cast<const char*> (modelData.getData()), modelData.getSize());
+    }
+    requestModel (std::move (source));
+}
+
 bool GuitarMLAmp::getCustomComponents (OwnedArray<Component>& customComps, chowdsp::HostContextProvider& hcp)
 {
     using namespace chowdsp::ParamUtils;
     class MainParamSlider : public Slider
     {
     public:
-        MainParamSlider (const ModelArch& modelArchitecture,
+        MainParamSlider (const GuitarMLModelArch& modelArchitecture,
                          AudioProcessorValueTreeState& vts,
                          ModelChangeBroadcaster& modelChangeCaster,
                          chowdsp::HostContextProvider& hcp)
@@ -347,7 +652,7 @@ bool GuitarMLAmp::getCustomComponents (OwnedArray<Component>& customComps, chowd
 
         void updateSliderVisibility()
         {
-            const auto usingConditionedModel = currentModelArch == ModelArch::LSTM40Cond;
+            const auto usingConditionedModel = currentModelArch.isConditioned();
 
             conditionSlider.setVisible (usingConditionedModel);
             gainSlider.setVisible (! usingConditionedModel);
@@ -375,7 +680,7 @@ bool GuitarMLAmp::getCustomComponents (OwnedArray<Component>& customComps, chowd
     private:
         using SliderAttachment = AudioProcessorValueTreeState::SliderAttachment;
 
-        const ModelArch& currentModelArch;
+        const GuitarMLModelArch& currentModelArch;
         ModulatableSlider gainSlider, conditionSlider;
         SliderAttachment gainAttach, conditionAttach;
 
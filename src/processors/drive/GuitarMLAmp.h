@@ -1,11 +1,12 @@
 #pragma once
 
-#include "neural_utils/ResampledRNNAccelerated.h"
+#include "neural_utils/GuitarMLModel.h"
 
 #include "../BaseProcessor.h"
 #include "../utility/DCBlocker.h"
 
-class GuitarMLAmp : public BaseProcessor
+class GuitarMLAmp : public BaseProcessor,
+                    private AsyncUpdater
 {
 public:
     explicit GuitarMLAmp (UndoManager* um = nullptr);
@@ -16,9 +17,12 @@ public:
 
     void prepare (double sampleRate, int samplesPerBlock) override;
     void processAudio (AudioBuffer<float>& buffer) override;
+    double getTailLengthSeconds() const override { return jmax (stateSettleTimeSeconds, dcBlocker.getTailLengthSeconds()); }
 
     std::unique_ptr<XmlElement> toXML() override;
     void fromXML (XmlElement* xml, const chowdsp::Version& version, bool loadPosition) override;
+    void toBinary (BinaryStateWriter& writer) override;
+    void fromBinary (BinaryStateReader& reader, const chowdsp::Version& version, bool loadPosition) override;
 
     bool getCustomComponents (OwnedArray<Component>& customComps, chowdsp::HostContextProvider& hcp) override;
     void addToPopupMenu (PopupMenu& menu) override;
@@ -26,48 +30,113 @@ public:
     void loadModel (int modelIndex, Component* parentComponent = nullptr);
     String getCurrentModelName() const;
 
+    /** Returns true if the shared loading jobs have no models left to load, (useful for tests). */
+    static bool isBackgroundLoadingIdle();
+
 private:
-    void loadModelFromJson (const chowdsp::json& modelJson, const String& newModelName = {});
     using ModelChangeBroadcaster = chowdsp::Broadcaster<void()>;
     ModelChangeBroadcaster modelChangeBroadcaster;
 
     chowdsp::FloatParameter* gainParam = nullptr;
     chowdsp::SmoothedBufferValue<float> conditionParam;
     chowdsp::BoolParameter* sampleRateCorrectionFilterParam = nullptr;
-    chowdsp::Gain<float> inGain;
 
-    SpinLock modelChangingMutex;
-    double processSampleRate = 96000.0;
     std::shared_ptr<FileChooser> customModelChooser;
 
-    template <int numIns, int hiddenSize>
-    using GuitarML_LSTM = EA::Variant<rnn_sse_arm::RNNAccelerated<numIns, hiddenSize, RecurrentLayerType::LSTMLayer, (int) RTNeural::SampleRateCorrectionMode::LinInterp>
-#if JUCE_INTEL
-                                      ,
-                                      rnn_avx::RNNAccelerated<numIns, hiddenSize, RecurrentLayerType::LSTMLayer, (int) RTNeural::SampleRateCorrectionMode::LinInterp>
-#endif
-                                      >;
+    GuitarMLModelArch modelArch {}; // (message thread only)
+
+    /**
+     * Where a model comes from: either one of the built-in models, some model data
+     * (JSON or binary weights, from a file or a preset), or a memory-mapped binary weights file.
+     */
+    struct ModelSource
+    {
+        int builtInIndex = -1;
+        std::shared_ptr<const std::string> modelData {};
+        std::shared_ptr<const MemoryMappedFile> modelFile {};
+        String name {};
+        Component::SafePointer<Component> errorMessageParent {};
+        bool showErrorMessage = false;
+
+        std::string_view getModelData() const;
+    };
+
+    /** A fully initialised model, along with the processing that depends on the model. */
+    struct NeuralModel
+    {
+        explicit NeuralModel (const GuitarMLModelArch& arch);
+
+        void prepare (double sampleRate, int samplesPerBlock, MathsQuality mathsQuality);
+        void process (AudioBuffer<float>& buffer, float gainDB, const float* conditionData, bool useSampleRateCorrectionFilter) noexcept;
 
-    using LSTM40Cond = GuitarML_LSTM<2, 40>;
-    using LSTM40NoCond = GuitarML_LSTM<1, 40>;
+        const GuitarMLModelArch arch;
+        std::unique_ptr<GuitarMLModel> rnn;
+        bool useResiduals = true;
+        double modelSampleRate = 44100.0;
+        float normalizationGain = 1.0f;
 
-    std::array<LSTM40Cond, 2> lstm40CondModels;
-    std::array<LSTM40NoCond, 2> lstm40NoCondModels;
-    chowdsp::HighShelfFilter<float> sampleRateCorrectionFilter;
+        chowdsp::Gain<float> inGain;
+        chowdsp::HighShelfFilter<float> sampleRateCorrectionFilter;
+    };
 
-    enum class ModelArch
+    /** Parses and initialises a model. Throws if the model can't be loaded. */
+    static std::unique_ptr<NeuralModel> createModel (const ModelSource& source, String& modelName);
+
+    /** The state that's shared between the processor, the loading jobs, and the audio thread. */
+    struct LoadingState
     {
-        LSTM40Cond,
-        LSTM40NoCond,
+        ~LoadingState();
+
+        /** Hands a model that the audio thread is done with back to the loading jobs (returns false if the queue is full). */
+        bool retire (NeuralModel* model) noexcept;
+        void deleteRetiredModels();
+
+        std::mutex mutex; // never locked by the audio thread
+        GuitarMLAmp* processor = nullptr;
+        double sampleRate = 48000.0;
+        int samplesPerBlock = 512;
+        MathsQuality mathsQuality = MathsQuality::Normal;
+
+        int requestedGeneration = 0;
+        int loadedGeneration = -1;
+        std::shared_ptr<const ModelSource> requestedSource;
+        std::shared_ptr<const ModelSource> loadedSource;
+        String loadedModelName;
+        GuitarMLModelArch loadedModelArch {};
+        std::shared_ptr<const ModelSource> failedSource;
+        String failureMessage;
+
+        std::atomic<NeuralModel*> pendingModel { nullptr };
+
+        static constexpr size_t retireQueueSize = 4;
+        std::array<std::atomic<NeuralModel*>, retireQueueSize> retiredModels {};
     };
 
-    ModelArch modelArch = ModelArch::LSTM40NoCond;
+    struct LoadingJobPool
+    {
+        ~LoadingJobPool()
+        {
+            pool.removeAllJobs (true, 5000);
+        }
 
-    chowdsp::json cachedModel {};
+        ThreadPool pool { 1 };
+    };
 
-    DCBlocker dcBlocker;
+    void requestModel (ModelSource&& source);
+    void loadRequestedModel();
+    static void runLoadingJob (const std::shared_ptr<LoadingState>& state, std::shared_ptr<const ModelSource> source, int generation);
+    void handleAsyncUpdate() override;
+    void retireFadingOutModel() noexcept;
 
-    float normalizationGain = 1.0f;
+    SharedResourcePointer<LoadingJobPool> loadingJobPool;
+    std::shared_ptr<LoadingState> loadingState = std::make_shared<LoadingState>();
+
+    std::unique_ptr<NeuralModel> currentModel;
+    std::unique_ptr<NeuralModel> fadingOutModel;
+    SmoothedValue<float, ValueSmoothingTypes::Linear> crossfade;
+    AudioBuffer<float> fadeBuffer;
+
+    DCBlocker dcBlocker;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GuitarMLAmp)
 };
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <math_approx/math_approx.hpp>
+#include <variant>
+
+/**
+ * Quality tiers for the approximate maths used in the drive processors' inner loops.
+ * Lower tiers use lower-order approximations, trading some accuracy for less CPU.
+ *
+ * The numbers are stored in the plugin settings, so don't change them!
+ */
+enum class MathsQuality
+{
+    Eco = 0,
+    Normal = 1,
+    High = 2,
+};
+
+/**
+ * Approximate maths functions for a given quality tier. This works as an RTNeural
+ * MathsProvider (tanh and sigmoid), and as a chowdsp::wdft diode OmegaProvider.
+ */
+template <MathsQuality quality>
+struct ApproxMaths;
+
+template <>
+struct ApproxMaths<MathsQuality::Eco>
+{
+    template <typename T>
+    static T tanh (T x)
+    {
+        return math_approx::tanh<5> (x);
+    }
+
+    template <typename T>
+    static T sigmoid (T x)
+    {
+        return math_approx::sigmoid_exp<3, true> (x);
+    }
+
+    template <typename T>
+    static T omega (T x)
+    {
+        return math_approx::wright_omega<2, 3> (x);
+    }
+};
+
+template <>
+struct ApproxMaths<MathsQuality::Normal>
+{
+    template <typename T>
+    static T tanh (T x)
+    {
+        return math_approx::tanh<7> (x);
+    }
+
+    template <typename T>
+    static T sigmoid (T x)
+    {
+        return math_approx::sigmoid_exp<5, true> (x);
+    }
+
+    template <typename T>
+    static T omega (T x)
+    {
+        return math_approx::wright_omega<3, 3> (x);
+    }
+};
+
+template <>
+struct ApproxMaths<MathsQuality::High>
+{
+    template <typename T>
+    static T tanh (T x)
+    {
+        return math_approx::tanh<9> (x);
+    }
+
+    template <typename T>
+    static T sigmoid (T x)
+    {
+        return math_approx::sigmoid_exp<6, true> (x);
+    }
+
+    template <typename T>
+    static T omega (T x)
+    {
+        return math_approx::wright_omega<3, 5> (x);
+    }
+};
+
+/**
+ * Calls func.template operator()<ApproxMaths<quality>>() for a run-time quality,
+ * so the quality only needs to be checked once per block, rather than once per sample.
+ */
+template <typename Func>
+decltype (auto) visitMathsQuality (MathsQuality quality, Func&& func)
+{
+    switch (quality)
+    {
+        case MathsQuality::Eco:
+            return func.template operator()<ApproxMaths<MathsQuality::Eco>>();
+        case MathsQuality::High:
+            return func.template operator()<ApproxMaths<MathsQuality::High>>();
+        case MathsQuality::Normal:
+        default:
+            return func.template operator()<ApproxMaths<MathsQuality::Normal>>();
+    }
+}
+
+/**
+ * Holds a processor that's templated on the approximate maths (ProcessorType<ApproxMaths<...>>),
+ * instantiated for whichever quality tier is active. Only the active tier is constructed,
+ * and changing the tier re-constructs the processor in place, so the tier should only be
+ * changed when the processor is being prepared.
+ */
+template <template <typename> typename ProcessorType>
+class MathsQualityVariant
+{
+public:
+    MathsQualityVariant() = default;
+
+    /** Returns true if the tier has changed, in which case the processor has been re-constructed. */
+    bool setQuality (MathsQuality newQuality)
+    {
+        if (newQuality == quality)
+            return false;
+
+        quality = newQuality;
+        switch (quality)
+        {
+            case MathsQuality::Eco:
+                processor.template emplace<ProcessorType<ApproxMaths<MathsQuality::Eco>>>();
+                break;
+            case MathsQuality::High:
+                processor.template emplace<ProcessorType<ApproxMaths<MathsQuality::High>>>();
+                break;
+            case MathsQuality::Normal:
+            default:
+                processor.template emplace<ProcessorType<ApproxMaths<MathsQuality::Normal>>>();
+                break;
+        }
+        return true;
+    }
+
+    MathsQuality getQuality() const noexcept { return quality; }
+
+    /** Calls func with the active processor. */
+    template <typename Func>
+    decltype (auto) visit (Func&& func)
+    {
+        return std::visit (std::forward<Func> (func), processor);
+    }
+
+private:
+    MathsQuality quality = MathsQuality::Normal;
+    std::variant<ProcessorType<ApproxMaths<MathsQuality::Normal>>,
+                 ProcessorType<ApproxMaths<MathsQuality::Eco>>,
+                 ProcessorType<ApproxMaths<MathsQuality::High>>>
+        processor;
+};
@@ -11,7 +11,7 @@ MetalFace::MetalFace (UndoManager* um) : BaseProcessor ("Metal Face", createPara
     uiOptions.info.authors = StringArray { "Jatin Chowdhury" };
 
     for (auto& model : rnn)
-        model.initialise (BinaryData::metal_face_model_json, BinaryData::metal_face_model_jsonSize, 96000.0);
+        model.initialise (BinaryData::metal_face_model_bnnw, BinaryData::metal_face_model_bnnwSize, 96000.0);
 }
 
 ParamLayout MetalFace::createParameterLayout()
@@ -30,7 +30,7 @@ void MetalFace::prepare (double sampleRate, int samplesPerBlock)
     gain.setRampDurationSeconds (0.1);
 
     for (auto& model : rnn)
-        model.prepare (sampleRate, samplesPerBlock);
+        model.prepare (sampleRate, samplesPerBlock, getMathsQuality());
 
     dcBlocker.prepare (sampleRate, samplesPerBlock);
 
@@ -13,6 +13,7 @@ public:
 
     void prepare (double sampleRate, int samplesPerBlock) override;
     void processAudio (AudioBuffer<float>& buffer) override;
+    double getTailLengthSeconds() const override { return std::numeric_limits<double>::infinity(); } // the feedback loop might not decay
 
 private:
     chowdsp::FloatParameter* freqHzParam = nullptr;
@@ -16,6 +16,7 @@ public:
 
     void prepare (double sampleRate, int samplesPerBlock) override;
     void processAudio (AudioBuffer<float>& buffer) override;
+    double getTailLengthSeconds() const override { return jmax (stateSettleTimeSeconds, dcBlocker.getTailLengthSeconds()); }
 
 private:
     chowdsp::FloatParameter* gainParam = nullptr;
@@ -2,11 +2,11 @@
 
 GainStageML::GainStageML (AudioProcessorValueTreeState& vts)
 {
-    loadModel (gainStageML[0], BinaryData::centaur_0_json, BinaryData::centaur_0_jsonSize);
-    loadModel (gainStageML[1], BinaryData::centaur_25_json, BinaryData::centaur_25_jsonSize);
-    loadModel (gainStageML[2], BinaryData::centaur_50_json, BinaryData::centaur_50_jsonSize);
-    loadModel (gainStageML[3], BinaryData::centaur_75_json, BinaryData::centaur_75_jsonSize);
-    loadModel (gainStageML[4], BinaryData::centaur_100_json, BinaryData::centaur_100_jsonSize);
+    loadModel (gainStageML[0], BinaryData::centaur_0_bnnw, BinaryData::centaur_0_bnnwSize);
+    loadModel (gainStageML[1], BinaryData::centaur_25_bnnw, BinaryData::centaur_25_bnnwSize);
+    loadModel (gainStageML[2], BinaryData::centaur_50_bnnw, BinaryData::centaur_50_bnnwSize);
+    loadModel (gainStageML[3], BinaryData::centaur_75_bnnw, BinaryData::centaur_75_bnnwSize);
+    loadModel (gainStageML[4], BinaryData::centaur_100_bnnw, BinaryData::centaur_100_bnnwSize);
 
     chowdsp::ParamUtils::loadParameterPointer (gainParam, vts, "gain");
 }
@@ -31,11 +31,16 @@ ParamLayout DiodeClipper::createParameterLayout()
 void DiodeClipper::prepare (double sampleRate, int samplesPerBlock)
 {
     int diodeType = static_cast<int> (*diodeTypeParam);
-    for (auto& wdfProc : wdf)
-    {
-        wdfProc.prepare ((float) sampleRate);
-        wdfProc.setParameters (*cutoffParam, DiodeParameter::getDiodeIs (diodeType), *nDiodesParam, true);
-    }
+    wdf.setQuality (getMathsQuality());
+    wdf.visit (
+        [&] (auto& wdfModels)
+        {
+            for (auto& wdfProc : wdfModels)
+            {
+                wdfProc.prepare ((float) sampleRate);
+                wdfProc.setParameters (*cutoffParam, DiodeParameter::getDiodeIs (diodeType), *nDiodesParam, true);
+            }
+        });
 
     dsp::ProcessSpec spec { sampleRate, (uint32) samplesPerBlock, 2 };
     for (auto* gain : { &inGain, &outGain })
@@ -54,12 +59,16 @@ void DiodeClipper::processAudio (AudioBuffer<float>& buffer)
     inGain.process (context);
 
     int diodeType = static_cast<int> (*diodeTypeParam);
-    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
-    {
-        wdf[ch].setParameters (*cutoffParam, DiodeParameter::getDiodeIs (diodeType), *nDiodesParam);
-        auto* x = buffer.getWritePointer (ch);
-        wdf[ch].process (x, buffer.getNumSamples());
-    }
+    wdf.visit (
+        [&] (auto& wdfModels)
+        {
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            {
+                wdfModels[(size_t) ch].setParameters (*cutoffParam, DiodeParameter::getDiodeIs (diodeType), *nDiodesParam);
+                auto* x = buffer.getWritePointer (ch);
+                wdfModels[(size_t) ch].process (x, buffer.getNumSamples());
+            }
+        });
 
     outGain.process (context);
 }
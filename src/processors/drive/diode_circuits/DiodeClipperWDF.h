@@ -1,9 +1,9 @@
 #pragma once
 
-#include "OmegaProvider.h"
+#include "../MathsQuality.h"
 #include <pch.h>
 
-template <template <typename, typename, wdft::DiodeQuality, typename> typename DiodeType>
+template <template <typename, typename, wdft::DiodeQuality, typename> typename DiodeType, typename OmegaProvider>
 class DiodeClipperWDF
 {
 public:
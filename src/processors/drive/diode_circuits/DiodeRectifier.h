@@ -13,6 +13,7 @@ public:
 
     void prepare (double sampleRate, int samplesPerBlock) override;
     void processAudio (AudioBuffer<float>& buffer) override;
+    double getTailLengthSeconds() const override { return jmax (stateSettleTimeSeconds, getFilterTailLengthSeconds ((double) cutoffParam->getCurrentValue())); }
     void setGains (float driveValue);
 
 private:
@@ -22,8 +23,9 @@ private:
     chowdsp::FloatParameter* nDiodesParam = nullptr;
 
     dsp::Gain<float> inGain, outGain;
-    using DiodeRectifierWDF = DiodeClipperWDF<wdft::DiodeT>;
-    DiodeRectifierWDF wdf[2];
+    template <typename OmegaProvider>
+    using WDFModels = std::array<DiodeClipperWDF<wdft::DiodeT, OmegaProvider>, 2>;
+    MathsQualityVariant<WDFModels> wdf;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DiodeRectifier)
 };
@@ -13,6 +13,7 @@ public:
 
     void prepare (double sampleRate, int samplesPerBlock) override;
     void processAudio (AudioBuffer<float>& buffer) override;
+    double getTailLengthSeconds() const override { return jmax (stateSettleTimeSeconds, getFilterTailLengthSeconds (20.0)); }
 
 private:
     chowdsp::SmoothedBufferValue<float> driveParam;
@@ -38,17 +38,17 @@ void FuzzMachine::prepare (double sampleRate, int samplesPerBlock)
     {
         if ((int) sampleRate % 44100 == 0)
         {
-            model_ff_15[ch].initialise (BinaryData::fuzz_15_88_json, BinaryData::fuzz_15_88_jsonSize, 88200.0);
-            model_ff_2[ch].initialise (BinaryData::fuzz_2_88_json, BinaryData::fuzz_2_88_jsonSize, 88200.0);
+            model_ff_15[ch].initialise (BinaryData::fuzz_15_88_bnnw, BinaryData::fuzz_15_88_bnnwSize, 88200.0);
+            model_ff_2[ch].initialise (BinaryData::fuzz_2_88_bnnw, BinaryData::fuzz_2_88_bnnwSize, 88200.0);
         }
         else
         {
-            model_ff_15[ch].initialise (BinaryData::fuzz_15_json, BinaryData::fuzz_15_jsonSize, 96000.0);
-            model_ff_2[ch].initialise (BinaryData::fuzz_2_json, BinaryData::fuzz_2_jsonSize, 96000.0);
+            model_ff_15[ch].initialise (BinaryData::fuzz_15_bnnw, BinaryData::fuzz_15_bnnwSize, 96000.0);
+            model_ff_2[ch].initialise (BinaryData::fuzz_2_bnnw, BinaryData::fuzz_2_bnnwSize, 96000.0);
         }
 
-        model_ff_15[ch].prepare (osRatio * sampleRate, osRatio * samplesPerBlock);
-        model_ff_2[ch].prepare (osRatio * sampleRate, osRatio * samplesPerBlock);
+        model_ff_15[ch].prepare (osRatio * sampleRate, osRatio * samplesPerBlock, getMathsQuality());
+        model_ff_2[ch].prepare (osRatio * sampleRate, osRatio * samplesPerBlock, getMathsQuality());
     }
 
     upsampler.prepare ({ sampleRate, (uint32_t) samplesPerBlock, 2 }, osRatio);
@@ -9,7 +9,7 @@ MouseDrive::MouseDrive (UndoManager* um) : BaseProcessor ("Mouse Drive", createP
     distortionParam.setRampLength (0.025);
     distortionParam.mappingFunction = [] (float x)
     {
-        return 1.0f + MouseDriveWDF::Rdistortion * std::pow (x, 5.0f);
+        return 1.0f + MouseDriveWDF<ApproxMaths<MathsQuality::Normal>>::Rdistortion * std::pow (x, 5.0f);
     };
     loadParameterPointer (volumeParam, vts, "volume");
 
@@ -25,8 +25,12 @@ MouseDrive::MouseDrive (UndoManager* um) : BaseProcessor ("Mouse Drive", createP
         "R2",
         [this] (const netlist::CircuitQuantity& self)
         {
-            for (auto& wdfModel : wdf)
-                wdfModel.R2.setResistanceValue (self.value.load());
+            wdf.visit (
+                [&self] (auto& wdfModels)
+                {
+                    for (auto& wdfModel : wdfModels)
+                        wdfModel.R2.setResistanceValue (self.value.load());
+                });
         },
         10.0e3f,
         2.0e6f);
@@ -35,8 +39,12 @@ MouseDrive::MouseDrive (UndoManager* um) : BaseProcessor ("Mouse Drive", createP
         "R3",
         [this] (const netlist::CircuitQuantity& self)
         {
-            for (auto& wdfModel : wdf)
-                wdfModel.R3.setResistanceValue (self.value.load());
+            wdf.visit (
+                [&self] (auto& wdfModels)
+                {
+                    for (auto& wdfModel : wdfModels)
+                        wdfModel.R3.setResistanceValue (self.value.load());
+                });
         },
         100.0f,
         1.0e6f);
@@ -45,8 +53,12 @@ MouseDrive::MouseDrive (UndoManager* um) : BaseProcessor ("Mouse Drive", createP
         "R4",
         [this] (const netlist::CircuitQuantity& self)
         {
-            for (auto& wdfModel : wdf)
-                wdfModel.R4_C5.setResistanceValue (self.value.load());
+            wdf.visit (
+                [&self] (auto& wdfModels)
+                {
+                    for (auto& wdfModel : wdfModels)
+                        wdfModel.R4_C5.setResistanceValue (self.value.load());
+                });
         },
         10.0f,
         10.0e3f);
@@ -55,8 +67,12 @@ MouseDrive::MouseDrive (UndoManager* um) : BaseProcessor ("Mouse Drive", createP
         "R5",
         [this] (const netlist::CircuitQuantity& self)
         {
-            for (auto& wdfModel : wdf)
-                wdfModel.R5_C6.setResistanceValue (self.value.load());
+            wdf.visit (
+                [&self] (auto& wdfModels)
+                {
+                    for (auto& wdfModel : wdfModels)
+                        wdfModel.R5_C6.setResistanceValue (self.value.load());
+                });
         },
         10.0f,
         100.0e3f);
@@ -65,8 +81,12 @@ MouseDrive::MouseDrive (UndoManager* um) : BaseProcessor ("Mouse Drive", createP
         "R6",
         [this] (const netlist::CircuitQuantity& self)
         {
-            for (auto& wdfModel : wdf)
-                wdfModel.R6_C7.setResistanceValue (self.value.load());
+            wdf.visit (
+                [&self] (auto& wdfModels)
+                {
+                    for (auto& wdfModel : wdfModels)
+                        wdfModel.R6_C7.setResistanceValue (self.value.load());
+                });
         },
         100.0f,
         1.0e6f);
@@ -75,8 +95,12 @@ MouseDrive::MouseDrive (UndoManager* um) : BaseProcessor ("Mouse Drive", createP
         "C1",
         [this] (const netlist::CircuitQuantity& self)
         {
-            for (auto& wdfModel : wdf)
-                wdfModel.Vin_C1.setCapacitanceValue (self.value.load());
+            wdf.visit (
+                [&self] (auto& wdfModels)
+                {
+                    for (auto& wdfModel : wdfModels)
+                        wdfModel.Vin_C1.setCapacitanceValue (self.value.load());
+                });
         },
         100.0e-12f,
         1.0e-3f);
@@ -85,8 +109,12 @@ MouseDrive::MouseDrive (UndoManager* um) : BaseProcessor ("Mouse Drive", createP
         "C2",
         [this] (const netlist::CircuitQuantity& self)
         {
-            for (auto& wdfModel : wdf)
-                wdfModel.C2.setCapacitanceValue (self.value.load());
+            wdf.visit (
+                [&self] (auto& wdfModels)
+                {
+                    for (auto& wdfModel : wdfModels)
+                        wdfModel.C2.setCapacitanceValue (self.value.load());
+                });
         },
         1.0e-12f,
         1.0e-6f);
@@ -95,8 +123,12 @@ MouseDrive::MouseDrive (UndoManager* um) : BaseProcessor ("Mouse Drive", createP
         "C4",
         [this] (const netlist::CircuitQuantity& self)
         {
-            for (auto& wdfModel : wdf)
-                wdfModel.Rd_C4.setCapacitanceValue (self.value.load());
+            wdf.visit (
+                [&self] (auto& wdfModels)
+                {
+                    for (auto& wdfModel : wdfModels)
+                        wdfModel.Rd_C4.setCapacitanceValue (self.value.load());
+                });
         },
         1.0e-12f,
         1.0e-6f);
@@ -105,8 +137,12 @@ MouseDrive::MouseDrive (UndoManager* um) : BaseProcessor ("Mouse Drive", createP
         "C5",
         [this] (const netlist::CircuitQuantity& self)
         {
-            for (auto& wdfModel : wdf)
-                wdfModel.R4_C5.setCapacitanceValue (self.value.load());
+            wdf.visit (
+                [&self] (auto& wdfModels)
+                {
+                    for (auto& wdfModel : wdfModels)
+                        wdfModel.R4_C5.setCapacitanceValue (self.value.load());
+                });
         },
         100.0e-12f,
         1.0e-3f);
@@ -115,8 +151,12 @@ MouseDrive::MouseDrive (UndoManager* um) : BaseProcessor ("Mouse Drive", createP
         "C6",
         [this] (const netlist::CircuitQuantity& self)
         {
-            for (auto& wdfModel : wdf)
-                wdfModel.R5_C6.setCapacitanceValue (self.value.load());
+            wdf.visit (
+                [&self] (auto& wdfModels)
+                {
+                    for (auto& wdfModel : wdfModels)
+                        wdfModel.R5_C6.setCapacitanceValue (self.value.load());
+                });
         },
         100.0e-12f,
         1.0e-3f);
@@ -125,8 +165,12 @@ MouseDrive::MouseDrive (UndoManager* um) : BaseProcessor ("Mouse Drive", createP
         "C7",
         [this] (const netlist::CircuitQuantity& self)
         {
-            for (auto& wdfModel : wdf)
-                wdfModel.R6_C7.setCapacitanceValue (self.value.load());
+            wdf.visit (
+                [&self] (auto& wdfModels)
+                {
+                    for (auto& wdfModel : wdfModels)
+                        wdfModel.R6_C7.setCapacitanceValue (self.value.load());
+                });
         },
         100.0e-12f,
         1.0e-3f);
@@ -146,8 +190,15 @@ ParamLayout MouseDrive::createParameterLayout()
 void MouseDrive::prepare (double sampleRate, int samplesPerBlock)
 {
     distortionParam.prepare (sampleRate, samplesPerBlock);
-    for (auto& model : wdf)
-        model.prepare (sampleRate);
+    if (wdf.setQuality (getMathsQuality()))
+        applyNetlistCircuitQuantities();
+
+    wdf.visit (
+        [sampleRate] (auto& wdfModels)
+        {
+            for (auto& model : wdfModels)
+                model.prepare (sampleRate);
+        });
 
     const auto spec = dsp::ProcessSpec { sampleRate, (uint32_t) samplesPerBlock, 2 };
     gain.setGainLinear (0.0f);
@@ -169,24 +220,29 @@ void MouseDrive::prepare (double sampleRate, int samplesPerBlock)
 void MouseDrive::processAudio (AudioBuffer<float>& buffer)
 {
     distortionParam.process (buffer.getNumSamples());
-    for (auto [ch, data] : chowdsp::buffer_iters::channels (buffer))
-    {
-        if (distortionParam.isSmoothing())
+    wdf.visit (
+        [this, &buffer] (auto& wdfModels)
         {
-            const auto* distParamSmoothData = distortionParam.getSmoothedBuffer();
-            for (auto [n, x] : chowdsp::enumerate (data))
+            for (auto [ch, data] : chowdsp::buffer_iters::channels (buffer))
             {
-                wdf[ch].Rd_C4.setResistanceValue (distParamSmoothData[n]);
-                x = wdf[ch].process (x);
+                auto& model = wdfModels[(size_t) ch];
+                if (distortionParam.isSmoothing())
+                {
+                    const auto* distParamSmoothData = distortionParam.getSmoothedBuffer();
+                    for (auto [n, x] : chowdsp::enumerate (data))
+                    {
+                        model.Rd_C4.setResistanceValue (distParamSmoothData[n]);
+                        x = model.process (x);
+                    }
+                }
+                else
+                {
+                    model.Rd_C4.setResistanceValue (distortionParam.getCurrentValue());
+                    for (auto& x : data)
+                        x = model.process (x);
+                }
             }
-        }
-        else
-        {
-            wdf[ch].Rd_C4.setResistanceValue (distortionParam.getCurrentValue());
-            for (auto& x : data)
-                x = wdf[ch].process (x);
-        }
-    }
+        });
 
     const auto volumeParamVal = volumeParam->getCurrentValue();
     if (volumeParamVal < 0.01f)
@@ -13,12 +13,15 @@ public:
 
     void prepare (double sampleRate, int samplesPerBlock) override;
     void processAudio (AudioBuffer<float>& buffer) override;
+    double getTailLengthSeconds() const override { return jmax (stateSettleTimeSeconds, getFilterTailLengthSeconds (15.0)); }
 
 private:
     chowdsp::SmoothedBufferValue<float, juce::ValueSmoothingTypes::Multiplicative> distortionParam;
     chowdsp::FloatParameter* volumeParam = nullptr;
 
-    MouseDriveWDF wdf[2];
+    template <typename OmegaProvider>
+    using WDFModels = std::array<MouseDriveWDF<OmegaProvider>, 2>;
+    MathsQualityVariant<WDFModels> wdf;
     chowdsp::Gain<float> gain;
     chowdsp::FirstOrderHPF<float> dcBlocker;
 
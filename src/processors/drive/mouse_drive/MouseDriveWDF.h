@@ -1,8 +1,9 @@
 #pragma once
 
-#include "../diode_circuits/OmegaProvider.h"
+#include "../MathsQuality.h"
 #include <pch.h>
 
+template <typename OmegaProvider>
 class MouseDriveWDF
 {
 public:
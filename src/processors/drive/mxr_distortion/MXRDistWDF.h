@@ -1,11 +1,12 @@
 #pragma once
 
-#include "../diode_circuits/OmegaProvider.h"
+#include "../MathsQuality.h"
 #include <pch.h>
 
 // This circuit model was originally implemented as part of Sam Schachter's
 // Master's Thesis (https://github.com/schachtersam32/WaveDigitalFilters_Sharc/blob/master/MXR_DistPlus.h).
 // Since then, we've re-derived the R-adaptor to adapt to the port facing the diode pair.
+template <typename OmegaProvider>
 class MXRDistWDF
 {
 public:
@@ -29,8 +29,12 @@ MXRDistortion::MXRDistortion (UndoManager* um) : BaseProcessor ("Distortion Plus
         "R1",
         [this] (const netlist::CircuitQuantity& self)
         {
-            for (auto& wdfModel : wdf)
-                wdfModel.R1_C2.setResistanceValue (self.value.load());
+            wdf.visit (
+                [&self] (auto& wdfModels)
+                {
+                    for (auto& wdfModel : wdfModels)
+                        wdfModel.R1_C2.setResistanceValue (self.value.load());
+                });
         },
         100.0f,
         500.0e3f);
@@ -39,8 +43,12 @@ MXRDistortion::MXRDistortion (UndoManager* um) : BaseProcessor ("Distortion Plus
         "R2",
         [this] (const netlist::CircuitQuantity& self)
         {
-            for (auto& wdfModel : wdf)
-                wdfModel.Vb.setResistanceValue (self.value.load());
+            wdf.visit (
+                [&self] (auto& wdfModels)
+                {
+                    for (auto& wdfModel : wdfModels)
+                        wdfModel.Vb.setResistanceValue (self.value.load());
+                });
         },
         10.0e3f,
         10.0e6f);
@@ -49,8 +57,12 @@ MXRDistortion::MXRDistortion (UndoManager* um) : BaseProcessor ("Distortion Plus
         "R4",
         [this] (const netlist::CircuitQuantity& self)
         {
-            for (auto& wdfModel : wdf)
-                wdfModel.R4.setResistanceValue (self.value.load());
+            wdf.visit (
+                [&self] (auto& wdfModels)
+                {
+                    for (auto& wdfModel : wdfModels)
+                        wdfModel.R4.setResistanceValue (self.value.load());
+                });
         },
         10.0e3f,
         10.0e6f);
@@ -59,8 +71,12 @@ MXRDistortion::MXRDistortion (UndoManager* um) : BaseProcessor ("Distortion Plus
         "R5",
         [this] (const netlist::CircuitQuantity& self)
         {
-            for (auto& wdfModel : wdf)
-                wdfModel.R5_C4.setResistanceValue (self.value.load());
+            wdf.visit (
+                [&self] (auto& wdfModels)
+                {
+                    for (auto& wdfModel : wdfModels)
+                        wdfModel.R5_C4.setResistanceValue (self.value.load());
+                });
         },
         100.0f,
         500.0e3f);
@@ -69,8 +85,12 @@ MXRDistortion::MXRDistortion (UndoManager* um) : BaseProcessor ("Distortion Plus
         "C1",
         [this] (const netlist::CircuitQuantity& self)
         {
-            for (auto& wdfModel : wdf)
-                wdfModel.C1.setCapacitanceValue (self.value.load());
+            wdf.visit (
+                [&self] (auto& wdfModels)
+                {
+                    for (auto& wdfModel : wdfModels)
+                        wdfModel.C1.setCapacitanceValue (self.value.load());
+                });
         },
         1.0e-12f,
         500.0e-3f);
@@ -79,8 +99,12 @@ MXRDistortion::MXRDistortion (UndoManager* um) : BaseProcessor ("Distortion Plus
         "C2",
         [this] (const netlist::CircuitQuantity& self)
         {
-            for (auto& wdfModel : wdf)
-                wdfModel.R1_C2.setCapacitanceValue (self.value.load());
+            wdf.visit (
+                [&self] (auto& wdfModels)
+                {
+                    for (auto& wdfModel : wdfModels)
+                        wdfModel.R1_C2.setCapacitanceValue (self.value.load());
+                });
         },
         1.0e-12f,
         500.0e-3f);
@@ -89,8 +113,12 @@ MXRDistortion::MXRDistortion (UndoManager* um) : BaseProcessor ("Distortion Plus
         "C3",
         [this] (const netlist::CircuitQuantity& self)
         {
-            for (auto& wdfModel : wdf)
-                wdfModel.ResDist_R3_C3.setCapacitanceValue (self.value.load());
+            wdf.visit (
+                [&self] (auto& wdfModels)
+                {
+                    for (auto& wdfModel : wdfModels)
+                        wdfModel.ResDist_R3_C3.setCapacitanceValue (self.value.load());
+                });
         },
         1.0e-12f,
         500.0e-3f);
@@ -99,8 +127,12 @@ MXRDistortion::MXRDistortion (UndoManager* um) : BaseProcessor ("Distortion Plus
         "C4",
         [this] (const netlist::CircuitQuantity& self)
         {
-            for (auto& wdfModel : wdf)
-                wdfModel.R5_C4.setCapacitanceValue (self.value.load());
+            wdf.visit (
+                [&self] (auto& wdfModels)
+                {
+                    for (auto& wdfModel : wdfModels)
+                        wdfModel.R5_C4.setCapacitanceValue (self.value.load());
+                });
         },
         1.0e-12f,
         500.0e-3f);
@@ -109,8 +141,12 @@ MXRDistortion::MXRDistortion (UndoManager* um) : BaseProcessor ("Distortion Plus
         "C5",
         [this] (const netlist::CircuitQuantity& self)
         {
-            for (auto& wdfModel : wdf)
-                wdfModel.C5.setCapacitanceValue (self.value.load());
+            wdf.visit (
+                [&self] (auto& wdfModels)
+                {
+                    for (auto& wdfModel : wdfModels)
+                        wdfModel.C5.setCapacitanceValue (self.value.load());
+                });
         },
         1.0e-12f,
         500.0e-3f);
@@ -128,11 +164,18 @@ ParamLayout MXRDistortion::createParameterLayout()
 
 void MXRDistortion::prepare (double sampleRate, int samplesPerBlock)
 {
-    for (auto& wdfProc : wdf)
-    {
-        wdfProc.prepare (sampleRate);
-        wdfProc.setParams (MXRDistortionParams::paramSkew (*distParam));
-    }
+    if (wdf.setQuality (getMathsQuality()))
+        applyNetlistCircuitQuantities();
+
+    wdf.visit (
+        [this, sampleRate] (auto& wdfModels)
+        {
+            for (auto& wdfProc : wdfModels)
+            {
+                wdfProc.prepare (sampleRate);
+                wdfProc.setParams (MXRDistortionParams::paramSkew (*distParam));
+            }
+        });
 
     dcBlocker.prepare (sampleRate, samplesPerBlock);
 
@@ -154,14 +197,18 @@ void MXRDistortion::processAudio (AudioBuffer<float>& buffer)
     dsp::AudioBlock<float> block (buffer);
     dsp::ProcessContextReplacing<float> context (block);
 
-    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
-    {
-        wdf[ch].setParams (MXRDistortionParams::paramSkew (*distParam));
-
-        auto* x = buffer.getWritePointer (ch);
-        for (int n = 0; n < buffer.getNumSamples(); ++n)
-            x[n] = wdf[ch].processSample (x[n]);
-    }
+    wdf.visit (
+        [this, &buffer] (auto& wdfModels)
+        {
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            {
+                wdfModels[(size_t) ch].setParams (MXRDistortionParams::paramSkew (*distParam));
+
+                auto* x = buffer.getWritePointer (ch);
+                for (int n = 0; n < buffer.getNumSamples(); ++n)
+                    x[n] = wdfModels[(size_t) ch].processSample (x[n]);
+            }
+        });
 
     dcBlocker.processAudio (buffer);
 
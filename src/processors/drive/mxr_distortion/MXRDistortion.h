@@ -13,12 +13,15 @@ public:
 
     void prepare (double sampleRate, int samplesPerBlock) override;
     void processAudio (AudioBuffer<float>& buffer) override;
+    double getTailLengthSeconds() const override { return jmax (stateSettleTimeSeconds, dcBlocker.getTailLengthSeconds()); }
 
 private:
     chowdsp::FloatParameter* distParam = nullptr;
     chowdsp::FloatParameter* levelParam = nullptr;
 
-    MXRDistWDF wdf[2];
+    template <typename OmegaProvider>
+    using WDFModels = std::array<MXRDistWDF<OmegaProvider>, 2>;
+    MathsQualityVariant<WDFModels> wdf;
 
     dsp::Gain<float> gain;
     DCBlocker dcBlocker;
@@ -0,0 +1,349 @@
+#include "GuitarMLModel.h"
+
+namespace
+{
+constexpr int numModelChannels = 2;
+
+template <int numIns, int hiddenSize, int RecurrentLayerType>
+class PrecompiledGuitarMLModel : public GuitarMLModel
+{
+public:
+    PrecompiledGuitarMLModel()
+    {
+#if JUCE_INTEL
+        if (juce::SystemStats::hasAVX() && juce::SystemStats::hasFMA3())
+            model.template emplace<rnn_avx::RNNAccelerated<numIns, hiddenSize, RecurrentLayerType, (int) RTNeural::SampleRateCorrectionMode::LinInterp, numModelChannels>>();
+#endif
+    }
+
+    void initialise (const ModelWeights& weights) override
+    {
+        model.visit ([&weights] (auto& rnn)
+                     { rnn.initialise (weights); });
+    }
+
+    void prepare (float rnnDelaySamples, MathsQuality mathsQuality) override
+    {
+        model.visit ([rnnDelaySamples, mathsQuality] (auto& rnn)
+                     { rnn.prepare (rnnDelaySamples, mathsQuality); });
+    }
+
+    void reset() override
+    {
+        model.visit ([] (auto& rnn)
+                     { rnn.reset(); });
+    }
+
+    void process (std::span<float* const> channelData, size_t numSamples, const float* conditionData, bool useResiduals) noexcept override
+    {
+        model.visit (
+            [&] (auto& rnn)
+            {
+                if constexpr (numIns == 1)
+                    rnn.process_multichannel (channelData, numSamples, useResiduals);
+                else
+                    rnn.process_conditioned_multichannel (channelData, { conditionData, numSamples }, useResiduals);
+            });
+    }
+
+private:
+    EA::Variant<rnn_sse_arm::RNNAccelerated<numIns, hiddenSize, RecurrentLayerType, (int) RTNeural::SampleRateCorrectionMode::LinInterp, numModelChannels>
+#if JUCE_INTEL
+                ,
+                rnn_avx::RNNAccelerated<numIns, hiddenSize, RecurrentLayerType, (int) RTNeural::SampleRateCorrectionMode::LinInterp, numModelChannels>
+#endif
+                >
+        model;
+};
+
+/**
+ * A GuitarML model for any model size, using plain scalar maths. This uses the same approximate
+ * maths and delay-line sample rate correction as the pre-compiled models, just without the SIMD.
+ */
+class DynamicGuitarMLModel : public GuitarMLModel
+{
+public:
+    explicit DynamicGuitarMLModel (const GuitarMLModelArch& modelArch)
+        : arch (modelArch),
+          numGates (arch.recurrentLayerType == RecurrentLayerType::LSTMLayer ? 4 : 3) // PyTorch gate order: (i, f, g, o) or (r, z, n)
+    {
+        const auto gatesSize = (size_t) (numGates * arch.hiddenSize);
+        kernelWeights.resize (gatesSize * (size_t) arch.numInputs);
+        recurrentWeights.resize (gatesSize * (size_t) arch.hiddenSize);
+        inputBiases.resize (gatesSize);
+        recurrentBiases.resize (gatesSize);
+        inputGates.resize (gatesSize);
+        recurrentGates.resize (gatesSize);
+        denseWeights.resize ((size_t) arch.hiddenSize);
+
+        for (auto& state : states)
+        {
+            state.h.resize ((size_t) arch.hiddenSize);
+            state.c.resize ((size_t) arch.hiddenSize);
+        }
+
+        prepare (1.0f, MathsQuality::Normal);
+    }
+
+    void initialise (const ModelWeights& weights) override
+    {
+        const auto kernel = weights.at ("state_dict/rec.weight_ih_l0");
+        const auto recurrent = weights.at ("state_dict/rec.weight_hh_l0");
+        const auto bias_ih = weights.at ("state_dict/rec.bias_ih_l0");
+        const auto bias_hh = weights.at ("state_dict/rec.bias_hh_l0");
+        const auto dense = weights.at ("state_dict/lin.weight");
+        const auto dense_bias = weights.at ("state_dict/lin.bias");
+
+        for (size_t i = 0; i < kernelWeights.size(); ++i)
+            kernelWeights[i] = kernel[i];
+        for (size_t i = 0; i < recurrentWeights.size(); ++i)
+            recurrentWeights[i] = recurrent[i];
+        for (size_t i = 0; i < inputBiases.size(); ++i)
+        {
+            inputBiases[i] = bias_ih[i];
+            recurrentBiases[i] = bias_hh[i];
+        }
+        for (size_t i = 0; i < denseWeights.size(); ++i)
+            denseWeights[i] = dense[i];
+        denseBias = dense_bias[0];
+    }
+
+    /** Same delay-line sample rate correction as the pre-compiled models (see BatchedLSTM in RNNAccelerated.cpp). */
+    void prepare (float rnnDelaySamples, MathsQuality newMathsQuality) override
+    {
+        // the pre-compiled GRU models always use the "Normal" maths
+        mathsQuality = arch.recurrentLayerType == RecurrentLayerType::LSTMLayer ? newMathsQuality : MathsQuality::Normal;
+
+        delayPlus1Mult = rnnDelaySamples - std::floor (rnnDelaySamples);
+        delayMult = 1.0f - delayPlus1Mult;
+        delayWriteIndex = (int) std::ceil (rnnDelaySamples) - 1;
+
+        for (auto& state : states)
+        {
+            state.hDelayed.resize ((size_t) ((delayWriteIndex + 2) * arch.hiddenSize));
+            state.cDelayed.resize ((size_t) ((delayWriteIndex + 2) * arch.hiddenSize));
+        }
+        reset();
+    }
+
+    void reset() override
+    {
+        for (auto& state : states)
+        {
+            std::fill (state.h.begin(), state.h.end(), 0.0f);
+            std::fill (state.c.begin(), state.c.end(), 0.0f);
+            std::fill (state.hDelayed.begin(), state.hDelayed.end(), 0.0f);
+            std::fill (state.cDelayed.begin(), state.cDelayed.end(), 0.0f);
+        }
+    }
+
+    void process (std::span<float* const> channelData, size_t numSamples, const float* conditionData, bool useResiduals) noexcept override
+    {
+        visitMathsQuality (mathsQuality,
+                           [&]<typename MathsProvider>()
+                           {
+                               float input[2] {};
+                               for (size_t ch = 0; ch < std::min (channelData.size(), states.size()); ++ch)
+                               {
+                                   auto& state = states[ch];
+                                   auto* x = channelData[ch];
+                                   for (size_t n = 0; n < numSamples; ++n)
+                                   {
+                                       input[0] = x[n];
+                                       if (arch.isConditioned())
+                                           input[1] = conditionData[n];
+
+                                       const auto y = arch.recurrentLayerType == RecurrentLayerType::LSTMLayer
+                                                          ? forwardLSTM<MathsProvider> (state, input)
+                                                          : forwardGRU<MathsProvider> (state, input);
+                                       x[n] = useResiduals ? x[n] + y : y;
+                                   }
+                               }
+                           });
+    }
+
+private:
+    struct ChannelState
+    {
+        std::vector<float> h, c, hDelayed, cDelayed;
+    };
+
+    void computeGates (const ChannelState& state, const float* input) noexcept
+    {
+        const auto numInputs = (size_t) arch.numInputs;
+        const auto hiddenSize = (size_t) arch.hiddenSize;
+        for (size_t g = 0; g < inputGates.size(); ++g)
+        {
+            auto inputSum = inputBiases[g];
+            for (size_t i = 0; i < numInputs; ++i)
+                inputSum += kernelWeights[g * numInputs + i] * input[i];
+            inputGates[g] = inputSum;
+
+            auto recurrentSum = recurrentBiases[g];
+            for (size_t k = 0; k < hiddenSize; ++k)
+                recurrentSum += recurrentWeights[g * hiddenSize + k] * state.h[k];
+            recurrentGates[g] = recurrentSum;
+        }
+    }
+
+    float processDelay (std::vector<float>& delayBuffer, float newValue, size_t j) const noexcept
+    {
+        const auto hiddenSize = (size_t) arch.hiddenSize;
+        auto* delayData = delayBuffer.data() + j;
+        delayData[(size_t) delayWriteIndex * hiddenSize] = newValue;
+        const auto delayedValue = delayMult * delayData[0] + delayPlus1Mult * delayData[hiddenSize];
+        for (size_t d = 0; d < (size_t) delayWriteIndex; ++d)
+            delayData[d * hiddenSize] = delayData[(d + 1) * hiddenSize];
+        return delayedValue;
+    }
+
+    template <typename MathsProvider>
+    float forwardLSTM (ChannelState& state, const float* input) noexcept
+    {
+        computeGates (state, input);
+
+        const auto hiddenSize = (size_t) arch.hiddenSize;
+        const auto gate = [this] (size_t idx)
+        { return inputGates[idx] + recurrentGates[idx]; };
+
+        auto y = denseBias;
+        for (size_t j = 0; j < hiddenSize; ++j)
+        {
+            const auto inputGate = MathsProvider::sigmoid (gate (j));
+            const auto forgetGate = MathsProvider::sigmoid (gate (hiddenSize + j));
+            const auto cellGate = MathsProvider::tanh (gate (2 * hiddenSize + j));
+            const auto outputGate = MathsProvider::sigmoid (gate (3 * hiddenSize + j));
+
+            const auto c = forgetGate * state.c[j] + inputGate * cellGate;
+            const auto h = outputGate * MathsProvider::tanh (c);
+
+            state.c[j] = processDelay (state.cDelayed, c, j);
+            state.h[j] = processDelay (state.hDelayed, h, j);
+            y += denseWeights[j] * state.h[j];
+        }
+        return y;
+    }
+
+    template <typename MathsProvider>
+    float forwardGRU (ChannelState& state, const float* input) noexcept
+    {
+        computeGates (state, input);
+
+        const auto hiddenSize = (size_t) arch.hiddenSize;
+        auto y = denseBias;
+        for (size_t j = 0; j < hiddenSize; ++j)
+        {
+            const auto resetGate = MathsProvider::sigmoid (inputGates[j] + recurrentGates[j]);
+            const auto updateGate = MathsProvider::sigmoid (inputGates[hiddenSize + j] + recurrentGates[hiddenSize + j]);
+            const auto newGate = MathsProvider::tanh (inputGates[2 * hiddenSize + j] + resetGate * recurrentGates[2 * hiddenSize + j]);
+
+            const auto h = (1.0f - updateGate) * newGate + updateGate * state.h[j];
+
+            state.h[j] = processDelay (state.hDelayed, h, j);
+            y += denseWeights[j] * state.h[j];
+        }
+        return y;
+    }
+
+    const GuitarMLModelArch arch;
+    const int numGates;
+
+    std::vector<float> kernelWeights; // [numGates * hiddenSize][numInputs]
+    std::vector<float> recurrentWeights; // [numGates * hiddenSize][hiddenSize]
+    std::vector<float> inputBiases, recurrentBiases;
+    std::vector<float> denseWeights;
+    float denseBias = 0.0f;
+
+    std::vector<float> inputGates, recurrentGates;
+    std::array<ChannelState, numModelChannels> states;
+
+    MathsQuality mathsQuality = MathsQuality::Normal;
+    float delayMult = 1.0f;
+    float delayPlus1Mult = 0.0f;
+    int delayWriteIndex = 0;
+};
+
+using ModelFactory = std::unique_ptr<GuitarMLModel> (*)();
+
+template <int numIns, int hiddenSize, int RecurrentLayerType>
+std::pair<GuitarMLModelArch, ModelFactory> makeRegistryEntry()
+{
+    return { GuitarMLModelArch { RecurrentLayerType, numIns, hiddenSize },
+             []() -> std::unique_ptr<GuitarMLModel>
+             { return std::make_unique<PrecompiledGuitarMLModel<numIns, hiddenSize, RecurrentLayerType>>(); } };
+}
+
+const auto& getRegistry()
+{
+#define BYOD_GUITARML_REGISTRY_ENTRIES(hiddenSize)                         \
+    makeRegistryEntry<1, hiddenSize, RecurrentLayerType::LSTMLayer>(),     \
+        makeRegistryEntry<2, hiddenSize, RecurrentLayerType::LSTMLayer>(), \
+        makeRegistryEntry<1, hiddenSize, RecurrentLayerType::GRULayer>(),  \
+        makeRegistryEntry<2, hiddenSize, RecurrentLayerType::GRULayer>(),
+
+    static const std::vector<std::pair<GuitarMLModelArch, ModelFactory>> registry {
+        BYOD_FOR_EACH_GUITARML_HIDDEN_SIZE (BYOD_GUITARML_REGISTRY_ENTRIES)
+    };
+#undef BYOD_GUITARML_REGISTRY_ENTRIES
+
+    return registry;
+}
+
+auto findRegistryEntry (const GuitarMLModelArch& arch)
+{
+    const auto& registry = getRegistry();
+    return std::find_if (registry.begin(), registry.end(), [&arch] (const auto& entry)
+                         { return entry.first == arch; });
+}
+} // namespace
+
+GuitarMLModelArch GuitarMLModelArch::fromWeights (const ModelWeights& weights)
+{
+    const auto kernel = weights.getTensor ("state_dict/rec.weight_ih_l0");
+    const auto recurrent = weights.getTensor ("state_dict/rec.weight_hh_l0");
+    if (! kernel.has_value() || ! recurrent.has_value())
+        throw std::runtime_error ("Model does not contain a recurrent layer!");
+
+    if (weights.getScalar ("model_data/num_layers", 1.0f) != 1.0f)
+        throw std::runtime_error ("Models with more than one recurrent layer are not supported!");
+
+    GuitarMLModelArch arch;
+    arch.numInputs = (int) kernel->cols;
+    arch.hiddenSize = (int) recurrent->cols;
+    if (arch.numInputs < 1 || arch.numInputs > 2)
+        throw std::runtime_error ("Unsupported number of model inputs: " + std::to_string (arch.numInputs));
+
+    // The recurrent weights have one block of rows for each gate: 4 for an LSTM, and 3 for a GRU
+    if (arch.hiddenSize > 0 && recurrent->rows == 4 * recurrent->cols)
+        arch.recurrentLayerType = RecurrentLayerType::LSTMLayer;
+    else if (arch.hiddenSize > 0 && recurrent->rows == 3 * recurrent->cols)
+        arch.recurrentLayerType = RecurrentLayerType::GRULayer;
+    else
+        throw std::runtime_error ("Unsupported recurrent layer type!");
+
+    if (kernel->rows != recurrent->rows)
+        throw std::runtime_error ("Model weights have mismatched shapes!");
+
+    return arch;
+}
+
+namespace GuitarMLModelRegistry
+{
+bool isPrecompiled (const GuitarMLModelArch& arch)
+{
+    return findRegistryEntry (arch) != getRegistry().end();
+}
+
+std::unique_ptr<GuitarMLModel> createModel (const GuitarMLModelArch& arch)
+{
+    if (const auto entry = findRegistryEntry (arch); entry != getRegistry().end())
+        return entry->second();
+
+    return createDynamicModel (arch);
+}
+
+std::unique_ptr<GuitarMLModel> createDynamicModel (const GuitarMLModelArch& arch)
+{
+    return std::make_unique<DynamicGuitarMLModel> (arch);
+}
+} // namespace GuitarMLModelRegistry
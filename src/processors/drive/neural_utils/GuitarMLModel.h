@@ -0,0 +1,49 @@
+#pragma once
+
+#include "RNNAccelerated.h"
+#include <pch.h>
+
+/** The architecture of a GuitarML model (a single recurrent layer, followed by a dense layer). */
+struct GuitarMLModelArch
+{
+    int recurrentLayerType = RecurrentLayerType::LSTMLayer;
+    int numInputs = 1; // 2 for models with a conditioning parameter
+    int hiddenSize = 40;
+
+    bool isConditioned() const noexcept { return numInputs > 1; }
+    bool operator== (const GuitarMLModelArch&) const = default;
+
+    /** Reads the architecture from the shapes of the model weights. Throws if the model is not supported. */
+    static GuitarMLModelArch fromWeights (const ModelWeights& weights);
+};
+
+/** A GuitarML model, which runs every channel through the same weights, with a separate state for each channel. */
+class GuitarMLModel
+{
+public:
+    virtual ~GuitarMLModel() = default;
+
+    virtual void initialise (const ModelWeights& weights) = 0;
+    virtual void prepare (float rnnDelaySamples, MathsQuality mathsQuality) = 0;
+    virtual void reset() = 0;
+
+    /** Processes up to two channels. The condition data is only used by conditioned models. */
+    virtual void process (std::span<float* const> channelData, size_t numSamples, const float* conditionData, bool useResiduals) noexcept = 0;
+};
+
+/**
+ * GuitarML models are compiled for a fixed set of sizes (see BYOD_FOR_EACH_GUITARML_HIDDEN_SIZE),
+ * so that the SIMD implementations can be used. Any other sizes fall back to a dynamic model,
+ * which is a good bit slower.
+ */
+namespace GuitarMLModelRegistry
+{
+/** Returns true if there's a pre-compiled implementation for this architecture. */
+bool isPrecompiled (const GuitarMLModelArch& arch);
+
+/** Creates the fastest available model implementation for this architecture. */
+std::unique_ptr<GuitarMLModel> createModel (const GuitarMLModelArch& arch);
+
+/** Creates a dynamic (scalar) model, which supports any model size. */
+std::unique_ptr<GuitarMLModel> createDynamicModel (const GuitarMLModelArch& arch);
+} // namespace GuitarMLModelRegistry
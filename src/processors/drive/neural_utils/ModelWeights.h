@@ -0,0 +1,316 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <functional>
+#include <modules/json/json.hpp>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * A compact binary container for neural network weights.
+ *
+ * Every number and every numeric array (with up to 2 dimensions) in a model's
+ * JSON file is stored as a named float32 tensor, where the name is the path to
+ * the values in the JSON (e.g. "state_dict/lin.bias", or "layers/0/weights/1").
+ * Loading a model is then just a lookup in the tensor table, so the weights can
+ * be read straight out of BinaryData or a memory-mapped file, without parsing
+ * any text, or building any intermediate containers.
+ *
+ * Layout (little-endian):
+ * - Header: the magic number "BNNW", format version, number of tensors, and 4 reserved bytes.
+ * - Tensor table: one TensorEntry for each tensor.
+ * - Tensor data: row-major float32 values, with each tensor starting on a 32-byte boundary.
+ *
+ * Use the headless app's --convert-model command to convert a JSON model.
+ */
+class ModelWeights
+{
+public:
+    static constexpr char magic[4] { 'B', 'N', 'N', 'W' };
+    static constexpr uint32_t formatVersion = 1;
+    static constexpr size_t dataAlignment = 32;
+    static constexpr size_t maxNameLength = 63;
+
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t numTensors;
+        uint32_t reserved;
+    };
+
+    struct TensorEntry
+    {
+        char name[maxNameLength + 1]; // null-terminated
+        uint32_t rank; // 0 (scalar), 1 (vector), or 2 (matrix)
+        uint32_t rows;
+        uint32_t cols;
+        uint32_t reserved;
+        uint64_t dataOffset; // in bytes, from the start of the data
+        uint64_t reserved2;
+    };
+
+    static_assert (sizeof (Header) == 16);
+    static_assert (sizeof (TensorEntry) == 96);
+    static_assert (std::endian::native == std::endian::little, "The weights format assumes a little-endian system!");
+
+    /** A read-only view of one tensor. The data might not be aligned, so values are read with memcpy. */
+    struct Tensor
+    {
+        const std::byte* data = nullptr;
+        uint32_t rank = 0;
+        size_t rows = 0; // a scalar has one row and one column, and a vector has one row
+        size_t cols = 0;
+
+        size_t size() const noexcept { return rows * cols; }
+
+        float operator[] (size_t index) const noexcept
+        {
+            float value;
+            std::memcpy (&value, data + index * sizeof (float), sizeof (float));
+            return value;
+        }
+
+        float operator() (size_t row, size_t col) const noexcept { return (*this)[row * cols + col]; }
+
+        std::vector<float> toVector() const
+        {
+            std::vector<float> result (size());
+            std::memcpy (result.data(), data, result.size() * sizeof (float));
+            return result;
+        }
+
+        std::vector<std::vector<float>> toMatrix() const
+        {
+            std::vector<std::vector<float>> result (rows, std::vector<float> (cols));
+            for (size_t i = 0; i < rows; ++i)
+                std::memcpy (result[i].data(), data + i * cols * sizeof (float), cols * sizeof (float));
+            return result;
+        }
+
+        std::vector<std::vector<float>> toTransposedMatrix() const
+        {
+            std::vector<std::vector<float>> result (cols, std::vector<float> (rows));
+            for (size_t i = 0; i < rows; ++i)
+                for (size_t j = 0; j < cols; ++j)
+                    result[j][i] = (*this) (i, j);
+            return result;
+        }
+    };
+
+    /**
+     * Creates a view of some binary weights data, which must outlive the ModelWeights object.
+     * Returns nullopt if the data is not in the binary weights format (e.g. if it's JSON).
+     */
+    static std::optional<ModelWeights> fromData (const void* data, size_t dataSize) noexcept
+    {
+        const auto* bytes = static_cast<const std::byte*> (data);
+        if (bytes == nullptr || dataSize < sizeof (Header))
+            return std::nullopt;
+
+        Header header;
+        std::memcpy (&header, bytes, sizeof (Header));
+        if (std::memcmp (header.magic, magic, sizeof (magic)) != 0 || header.version != formatVersion)
+            return std::nullopt;
+
+        if ((dataSize - sizeof (Header)) / sizeof (TensorEntry) < header.numTensors)
+            return std::nullopt;
+
+        ModelWeights weights { bytes, header.numTensors };
+        for (uint32_t i = 0; i < header.numTensors; ++i)
+        {
+            const auto entry = weights.getEntry (i);
+            const auto dataBytes = (uint64_t) entry.rows * entry.cols * sizeof (float);
+            if (entry.name[maxNameLength] != '\0' || entry.rank > 2 || entry.dataOffset > dataSize || dataBytes > dataSize - entry.dataOffset)
+                return std::nullopt;
+        }
+
+        return weights;
+    }
+
+    size_t getNumTensors() const noexcept { return numTensors; }
+    std::string_view getTensorName (size_t index) const noexcept { return getEntryName (index); }
+
+    /** Returns the tensor with the given name, or nullopt if there's no such tensor. */
+    std::optional<Tensor> getTensor (std::string_view name) const noexcept
+    {
+        for (size_t i = 0; i < numTensors; ++i)
+        {
+            if (getEntryName (i) == name)
+            {
+                const auto entry = getEntry (i);
+                return Tensor { data + entry.dataOffset, entry.rank, entry.rows, entry.cols };
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    /** Returns the tensor with the given name, or throws if there's no such tensor. */
+    Tensor at (std::string_view name) const
+    {
+        if (auto tensor = getTensor (name))
+            return *tensor;
+        throw std::out_of_range ("Model weights do not contain tensor: " + std::string { name });
+    }
+
+    /** Returns a scalar value (e.g. "model_data/hidden_size"), or the default value if it's not found. */
+    float getScalar (std::string_view name, float defaultValue) const noexcept
+    {
+        if (const auto tensor = getTensor (name); tensor.has_value() && tensor->size() == 1)
+            return (*tensor)[0];
+        return defaultValue;
+    }
+
+    /** Converts model JSON to the binary weights format. Strings and booleans in the JSON are not stored. */
+    static std::vector<std::byte> fromJson (const nlohmann::json& modelJson)
+    {
+        struct PendingTensor
+        {
+            std::string name;
+            uint32_t rank;
+            size_t rows, cols;
+            std::vector<float> values;
+        };
+        std::vector<PendingTensor> tensors;
+
+        const auto isNumericArray = [] (const nlohmann::json& j)
+        {
+            return j.is_array() && std::all_of (j.begin(), j.end(), [] (const nlohmann::json& x)
+                                                { return x.is_number(); });
+        };
+
+        std::function<void (const nlohmann::json&, const std::string&)> collectTensors;
+        collectTensors = [&] (const nlohmann::json& j, const std::string& path)
+        {
+            if (j.is_number())
+            {
+                tensors.push_back ({ path, 0, 1, 1, { j.get<float>() } });
+            }
+            else if (isNumericArray (j))
+            {
+                tensors.push_back ({ path, 1, 1, j.size(), j.get<std::vector<float>>() });
+            }
+            else if (j.is_array() && ! j.empty() && std::all_of (j.begin(), j.end(), [&j, &isNumericArray] (const nlohmann::json& row)
+                                                                 { return isNumericArray (row) && row.size() == j.front().size(); }))
+            {
+                PendingTensor tensor { path, 2, j.size(), j.front().size(), {} };
+                tensor.values.reserve (tensor.rows * tensor.cols);
+                for (const auto& row : j)
+                    for (const auto& x : row)
+                        tensor.values.push_back (x.get<float>());
+                tensors.push_back (std::move (tensor));
+            }
+            else if (j.is_array())
+            {
+                for (size_t i = 0; i < j.size(); ++i)
+                    collectTensors (j[i], path.empty() ? std::to_string (i) : path + "/" + std::to_string (i));
+            }
+            else if (j.is_object())
+            {
+                for (const auto& [key, value] : j.items())
+                    collectTensors (value, path.empty() ? key : path + "/" + key);
+            }
+        };
+        collectTensors (modelJson, {});
+
+        const auto alignUp = [] (size_t x)
+        { return (x + dataAlignment - 1) / dataAlignment * dataAlignment; };
+
+        auto dataOffset = alignUp (sizeof (Header) + tensors.size() * sizeof (TensorEntry));
+        std::vector<TensorEntry> entries;
+        for (const auto& tensor : tensors)
+        {
+            if (tensor.name.size() > maxNameLength)
+                throw std::invalid_argument ("Tensor name is too long: " + tensor.name);
+
+            TensorEntry entry {};
+            std::copy (tensor.name.begin(), tensor.name.end(), entry.name);
+            entry.rank = tensor.rank;
+            entry.rows = (uint32_t) tensor.rows;
+            entry.cols = (uint32_t) tensor.cols;
+            entry.dataOffset = dataOffset;
+            entries.push_back (entry);
+
+            dataOffset = alignUp (dataOffset + tensor.values.size() * sizeof (float));
+        }
+
+        std::vector<std::byte> result (dataOffset);
+        Header header {};
+        std::memcpy (header.magic, magic, sizeof (magic));
+        header.version = formatVersion;
+        header.numTensors = (uint32_t) tensors.size();
+        std::memcpy (result.data(), &header, sizeof (Header));
+
+        for (size_t i = 0; i < tensors.size(); ++i)
+        {
+            std::memcpy (result.data() + sizeof (Header) + i * sizeof (TensorEntry), &entries[i], sizeof (TensorEntry));
+            std::memcpy (result.data() + entries[i].dataOffset, tensors[i].values.data(), tensors[i].values.size() * sizeof (float));
+        }
+
+        return result;
+    }
+
+    /** Converts the weights back to JSON, with the same structure as the JSON they were converted from. */
+    nlohmann::json toJson() const
+    {
+        nlohmann::json result = nlohmann::json::object();
+        for (size_t i = 0; i < numTensors; ++i)
+        {
+            const auto name = getEntryName (i);
+            const auto entry = getEntry (i);
+            const Tensor tensor { data + entry.dataOffset, entry.rank, entry.rows, entry.cols };
+
+            // walk down the path, creating objects (or arrays, for numeric path elements) as needed
+            auto* node = &result;
+            for (size_t start = 0;;)
+            {
+                const auto end = name.find ('/', start);
+                const auto key = std::string { name.substr (start, end - start) };
+                const auto isIndex = ! key.empty() && std::all_of (key.begin(), key.end(), [] (char c)
+                                                                   { return c >= '0' && c <= '9'; });
+
+                node = isIndex ? &(*node)[(size_t) std::stoul (key)] : &(*node)[key];
+                if (end == std::string_view::npos)
+                    break;
+                start = end + 1;
+            }
+
+            if (tensor.rank == 0)
+                *node = tensor[0];
+            else if (tensor.rank == 1)
+                *node = tensor.toVector();
+            else
+                *node = tensor.toMatrix();
+        }
+
+        return result;
+    }
+
+private:
+    ModelWeights (const std::byte* weightsData, size_t numWeightsTensors)
+        : data (weightsData), numTensors (numWeightsTensors)
+    {
+    }
+
+    TensorEntry getEntry (size_t index) const noexcept
+    {
+        TensorEntry entry;
+        std::memcpy (&entry, data + sizeof (Header) + index * sizeof (TensorEntry), sizeof (TensorEntry));
+        return entry;
+    }
+
+    std::string_view getEntryName (size_t index) const noexcept
+    {
+        const auto* name = reinterpret_cast<const char*> (data + sizeof (Header) + index * sizeof (TensorEntry));
+        return { name, strnlen (name, maxNameLength) };
+    }
+
+    const std::byte* data = nullptr;
+    size_t numTensors = 0;
+};
@@ -13,20 +13,8 @@
 #include <RTNeural/RTNeural.h>
 #include <math_approx/math_approx.hpp>
 
-struct RNNMathsProvider
-{
-    template <typename T>
-    static T tanh (T x)
-    {
-        return math_approx::tanh<7> (x);
-    }
-
-    template <typename T>
-    static T sigmoid (T x)
-    {
-        return math_approx::sigmoid_exp<5, true> (x);
-    }
-};
+// The RTNeural GRU layers always use the "Normal" maths (see PerChannelRNN)
+using RNNMathsProvider = ApproxMaths<MathsQuality::Normal>;
 
 #include "model_loaders.h"
 
@@ -42,104 +30,371 @@ namespace rnn_sse_arm
 {
 #if ! (XSIMD_WITH_NEON && BYOD_COMPILING_WITH_AVX)
 
-template <int inputSize, int hiddenSize, int RecurrentLayerType, int SRCMode>
-struct RNNAccelerated<inputSize, hiddenSize, RecurrentLayerType, SRCMode>::Internal
+/**
+ * An LSTM layer + dense output layer, which runs several channels through the
+ * same weights, each with its own state. The weights are laid out so that each
+ * weight vector is loaded once per step, and then multiplied with the state of
+ * every channel.
+ */
+template <int inputSize, int hiddenSize, int numChannels>
+struct BatchedLSTM
+{
+    using v_type = xsimd::batch<float>;
+    static constexpr int v_size = (int) v_type::size;
+    static constexpr int v_hidden_size = (hiddenSize + v_size - 1) / v_size;
+    static constexpr int numGates = 4; // input, forget, cell, output (same order as PyTorch)
+    static constexpr int v_gates_size = numGates * v_hidden_size;
+
+    BatchedLSTM()
+    {
+        prepare (1.0f);
+    }
+
+    void loadWeights (const ModelWeights& weights)
+    {
+        const auto kernel = weights.at ("state_dict/rec.weight_ih_l0");
+        const auto recurrent = weights.at ("state_dict/rec.weight_hh_l0");
+        const auto bias_ih = weights.at ("state_dict/rec.bias_ih_l0");
+        const auto bias_hh = weights.at ("state_dict/rec.bias_hh_l0");
+        const auto dense = weights.at ("state_dict/lin.weight");
+        const auto dense_bias = weights.at ("state_dict/lin.bias");
+
+        // PyTorch stores the gates as rows [4 * hiddenSize], which we pad out to a whole number of SIMD registers per gate
+        const auto loadGateRows = [] (auto&& getRowValue)
+        {
+            alignas (v_type::arch_type::alignment()) float padded[v_gates_size * v_size] {};
+            for (int gate = 0; gate < numGates; ++gate)
+                for (int i = 0; i < hiddenSize; ++i)
+                    padded[gate * v_hidden_size * v_size + i] = getRowValue ((size_t) (gate * hiddenSize + i));
+
+            std::array<v_type, v_gates_size> result;
+            for (int g = 0; g < v_gates_size; ++g)
+                result[(size_t) g] = xsimd::load_aligned (padded + g * v_size);
+            return result;
+        };
+
+        for (size_t i = 0; i < (size_t) inputSize; ++i)
+        {
+            const auto column = loadGateRows ([&kernel, i] (size_t row)
+                                              { return kernel (row, i); });
+            std::copy (column.begin(), column.end(), kernelWeights[i]);
+        }
+
+        for (size_t k = 0; k < (size_t) hiddenSize; ++k)
+        {
+            const auto column = loadGateRows ([&recurrent, k] (size_t row)
+                                              { return recurrent (row, k); });
+            for (size_t g = 0; g < (size_t) v_gates_size; ++g)
+                recurrentWeights[g][k] = column[g];
+        }
+
+        const auto bias = loadGateRows ([&bias_ih, &bias_hh] (size_t row)
+                                        { return bias_ih[row] + bias_hh[row]; });
+        std::copy (bias.begin(), bias.end(), biases);
+
+        alignas (v_type::arch_type::alignment()) float paddedDense[v_hidden_size * v_size] {};
+        for (size_t i = 0; i < (size_t) hiddenSize; ++i)
+            paddedDense[i] = dense[i];
+        for (int j = 0; j < v_hidden_size; ++j)
+            denseWeights[j] = xsimd::load_aligned (paddedDense + j * v_size);
+        denseBias = dense_bias[0];
+    }
+
+    /** Same delay-line sample rate correction as RTNeural, which NoInterp mode uses with a whole number of samples. */
+    void prepare (float delaySamples)
+    {
+        delayPlus1Mult = delaySamples - std::floor (delaySamples);
+        delayMult = 1.0f - delayPlus1Mult;
+        delayWriteIndex = (int) std::ceil (delaySamples) - 1;
+
+        for (auto& state : states)
+        {
+            state.hDelayed.resize ((size_t) ((delayWriteIndex + 2) * v_hidden_size));
+            state.cDelayed.resize ((size_t) ((delayWriteIndex + 2) * v_hidden_size));
+        }
+        reset();
+    }
+
+    void reset()
+    {
+        for (auto& state : states)
+        {
+            std::fill (std::begin (state.h), std::end (state.h), 0.0f);
+            std::fill (std::begin (state.c), std::end (state.c), v_type (0.0f));
+            std::fill (state.hDelayed.begin(), state.hDelayed.end(), v_type (0.0f));
+            std::fill (state.cDelayed.begin(), state.cDelayed.end(), v_type (0.0f));
+        }
+    }
+
+    template <typename DelayBuffer>
+    v_type processDelay (DelayBuffer& delayBuffer, v_type newValue, int j) const noexcept
+    {
+        auto* delayData = delayBuffer.data() + j;
+        delayData[delayWriteIndex * v_hidden_size] = newValue;
+        const auto delayedValue = delayMult * delayData[0] + delayPlus1Mult * delayData[v_hidden_size];
+        for (int d = 0; d < delayWriteIndex; ++d)
+            delayData[d * v_hidden_size] = delayData[(d + 1) * v_hidden_size];
+        return delayedValue;
+    }
+
+    /** Runs one sample for channels [firstChannel, firstChannel + numActive). */
+    template <int numActive, typename MathsProvider>
+    void forward (int firstChannel, const float (&ins)[numActive][inputSize], float (&outs)[numActive]) noexcept
+    {
+        v_type gates[numActive][v_gates_size];
+        for (int g = 0; g < v_gates_size; ++g)
+        {
+            v_type acc[numActive];
+            for (int ch = 0; ch < numActive; ++ch)
+                acc[ch] = biases[g];
+
+            for (int i = 0; i < inputSize; ++i)
+            {
+                const auto w = kernelWeights[i][g];
+                for (int ch = 0; ch < numActive; ++ch)
+                    acc[ch] = xsimd::fma (w, v_type (ins[ch][i]), acc[ch]);
+            }
+
+            for (int k = 0; k < hiddenSize; ++k)
+            {
+                const auto w = recurrentWeights[g][k];
+                for (int ch = 0; ch < numActive; ++ch)
+                    acc[ch] = xsimd::fma (w, v_type (states[firstChannel + ch].h[k]), acc[ch]);
+            }
+
+            for (int ch = 0; ch < numActive; ++ch)
+                gates[ch][g] = acc[ch];
+        }
+
+        for (int ch = 0; ch < numActive; ++ch)
+        {
+            auto& state = states[firstChannel + ch];
+            v_type y (0.0f);
+            for (int j = 0; j < v_hidden_size; ++j)
+            {
+                const auto inputGate = MathsProvider::sigmoid (gates[ch][j]);
+                const auto forgetGate = MathsProvider::sigmoid (gates[ch][v_hidden_size + j]);
+                const auto cellGate = MathsProvider::tanh (gates[ch][2 * v_hidden_size + j]);
+                const auto outputGate = MathsProvider::sigmoid (gates[ch][3 * v_hidden_size + j]);
+
+                const auto c = xsimd::fma (forgetGate, state.c[j], inputGate * cellGate);
+                const auto h = outputGate * MathsProvider::tanh (c);
+
+                state.c[j] = processDelay (state.cDelayed, c, j);
+                const auto hDelayed = processDelay (state.hDelayed, h, j);
+                hDelayed.store_aligned (state.h + j * v_size);
+                y = xsimd::fma (denseWeights[j], hDelayed, y);
+            }
+            outs[ch] = xsimd::reduce_add (y) + denseBias;
+        }
+    }
+
+    v_type kernelWeights[inputSize][v_gates_size];
+    v_type recurrentWeights[v_gates_size][hiddenSize];
+    v_type biases[v_gates_size];
+    v_type denseWeights[v_hidden_size];
+    float denseBias = 0.0f;
+
+    struct ChannelState
+    {
+        alignas (v_type::arch_type::alignment()) float h[v_hidden_size * v_size] {};
+        v_type c[v_hidden_size];
+        std::vector<v_type, xsimd::aligned_allocator<v_type>> hDelayed, cDelayed;
+    };
+    ChannelState states[numChannels];
+
+    float delayMult = 1.0f;
+    float delayPlus1Mult = 0.0f;
+    int delayWriteIndex = 0;
+};
+
+/**
+ * Runs several channels through separate copies of a single-channel RTNeural model,
+ * with the same interface as BatchedLSTM. This is used for GRU models, which don't
+ * have a batched implementation (yet). The RTNeural layers choose their maths at
+ * compile time, so the MathsProvider is ignored here.
+ */
+template <typename ModelType, int inputSize, int numChannels, int SRCMode>
+struct PerChannelRNN
 {
-    using RecurrentLayerTypeComplete = std::conditional_t<RecurrentLayerType == RecurrentLayerType::LSTMLayer,
-                                                          RTNEURAL_NAMESPACE::LSTMLayerT<float, inputSize, hiddenSize, (RTNEURAL_NAMESPACE::SampleRateCorrectionMode) SRCMode, RNNMathsProvider>,
-                                                          RTNEURAL_NAMESPACE::GRULayerT<float, inputSize, hiddenSize, (RTNEURAL_NAMESPACE::SampleRateCorrectionMode) SRCMode, RNNMathsProvider>>;
+    void loadWeights (const ModelWeights& weights)
+    {
+        for (auto& model : models)
+            model_loaders::loadTorchGRUModel (model, weights);
+    }
+
+    void prepare (float delaySamples)
+    {
+        for (auto& model : models)
+        {
+            if constexpr (SRCMode == (int) RTNEURAL_NAMESPACE::SampleRateCorrectionMode::LinInterp)
+                model.template get<0>().prepare (delaySamples);
+            else
+                model.template get<0>().prepare ((int) delaySamples);
+            model.reset();
+        }
+    }
+
+    void reset()
+    {
+        for (auto& model : models)
+            model.reset();
+    }
+
+    template <int numActive, typename>
+    void forward (int firstChannel, const float (&ins)[numActive][inputSize], float (&outs)[numActive]) noexcept
+    {
+        // RTNeural reads a whole SIMD register from the input
+        alignas (xsimd::batch<float>::arch_type::alignment()) float input_vec[xsimd::batch<float>::size] {};
+        for (int ch = 0; ch < numActive; ++ch)
+        {
+            std::copy (std::begin (ins[ch]), std::end (ins[ch]), input_vec);
+            outs[ch] = models[firstChannel + ch].forward (input_vec);
+        }
+    }
+
+    ModelType models[numChannels];
+};
+
+template <int inputSize, int hiddenSize, int RecurrentLayerType, int SRCMode, int numChannels>
+struct RNNAccelerated<inputSize, hiddenSize, RecurrentLayerType, SRCMode, numChannels>::Internal
+{
+    using GRULayerType = RTNEURAL_NAMESPACE::GRULayerT<float, inputSize, hiddenSize, (RTNEURAL_NAMESPACE::SampleRateCorrectionMode) SRCMode, RNNMathsProvider>;
     using DenseLayerType = RTNEURAL_NAMESPACE::DenseT<float, hiddenSize, 1>;
-    RTNEURAL_NAMESPACE::ModelT<float, inputSize, 1, RecurrentLayerTypeComplete, DenseLayerType> model;
+    using GRUModel = RTNEURAL_NAMESPACE::ModelT<float, inputSize, 1, GRULayerType, DenseLayerType>;
+    std::conditional_t<RecurrentLayerType == RecurrentLayerType::LSTMLayer,
+                       BatchedLSTM<inputSize, hiddenSize, numChannels>,
+                       PerChannelRNN<GRUModel, inputSize, numChannels, SRCMode>>
+        model;
+
+    MathsQuality mathsQuality = MathsQuality::Normal;
+
+    template <int numActive, typename MathsProvider>
+    void processBatched (std::span<float* const> channelData, int firstChannel, size_t numSamples, const float* condition, bool useResiduals) noexcept
+    {
+        float ins[numActive][inputSize] {};
+        float outs[numActive] {};
+        for (size_t n = 0; n < numSamples; ++n)
+        {
+            for (int ch = 0; ch < numActive; ++ch)
+            {
+                ins[ch][0] = channelData[(size_t) (firstChannel + ch)][n];
+                if constexpr (inputSize > 1)
+                    ins[ch][1] = condition[n];
+            }
+
+            model.template forward<numActive, MathsProvider> (firstChannel, ins, outs);
+
+            for (int ch = 0; ch < numActive; ++ch)
+            {
+                auto& x = channelData[(size_t) (firstChannel + ch)][n];
+                x = useResiduals ? x + outs[ch] : outs[ch];
+            }
+        }
+    }
+
+    void processBatched (std::span<float* const> channelData, size_t numSamples, const float* condition, bool useResiduals) noexcept
+    {
+        visitMathsQuality (mathsQuality,
+                           [&]<typename MathsProvider>()
+                           {
+                               if (channelData.size() >= (size_t) numChannels)
+                               {
+                                   processBatched<numChannels, MathsProvider> (channelData, 0, numSamples, condition, useResiduals);
+                                   return;
+                               }
+
+                               // not enough channels to fill the batch, so just process one at a time
+                               for (int ch = 0; ch < (int) channelData.size(); ++ch)
+                                   processBatched<1, MathsProvider> (channelData, ch, numSamples, condition, useResiduals);
+                           });
+    }
 };
 
-template <int inputSize, int hiddenSize, int RecurrentLayerType, int SRCMode>
-RNNAccelerated<inputSize, hiddenSize, RecurrentLayerType, SRCMode>::RNNAccelerated()
+template <int inputSize, int hiddenSize, int RecurrentLayerType, int SRCMode, int numChannels>
+RNNAccelerated<inputSize, hiddenSize, RecurrentLayerType, SRCMode, numChannels>::RNNAccelerated()
 {
     static_assert (sizeof (Internal) <= max_model_size);
     internal = new (internal_data) Internal();
 }
 
-template <int inputSize, int hiddenSize, int RecurrentLayerType, int SRCMode>
-RNNAccelerated<inputSize, hiddenSize, RecurrentLayerType, SRCMode>::~RNNAccelerated()
+template <int inputSize, int hiddenSize, int RecurrentLayerType, int SRCMode, int numChannels>
+RNNAccelerated<inputSize, hiddenSize, RecurrentLayerType, SRCMode, numChannels>::~RNNAccelerated()
 {
     internal->~Internal();
 }
 
-template <int inputSize, int hiddenSize, int RecurrentLayerType, int SRCMode>
-void RNNAccelerated<inputSize, hiddenSize, RecurrentLayerType, SRCMode>::initialise (const nlohmann::json& weights_json)
+template <int inputSize, int hiddenSize, int RecurrentLayerType, int SRCMode, int numChannels>
+void RNNAccelerated<inputSize, hiddenSize, RecurrentLayerType, SRCMode, numChannels>::initialise (const nlohmann::json& weights_json)
 {
-    // @TODO: handle GRU models if needed...
-    model_loaders::loadLSTMModel (internal->model, weights_json);
+    const auto weightsData = ModelWeights::fromJson (weights_json);
+    initialise (*ModelWeights::fromData (weightsData.data(), weightsData.size()));
 }
 
-template <int inputSize, int hiddenSize, int RecurrentLayerType, int SRCMode>
-void RNNAccelerated<inputSize, hiddenSize, RecurrentLayerType, SRCMode>::prepare ([[maybe_unused]] int rnnDelaySamples)
+template <int inputSize, int hiddenSize, int RecurrentLayerType, int SRCMode, int numChannels>
+void RNNAccelerated<inputSize, hiddenSize, RecurrentLayerType, SRCMode, numChannels>::initialise (const ModelWeights& weights)
 {
+    internal->model.loadWeights (weights);
+}
+
+template <int inputSize, int hiddenSize, int RecurrentLayerType, int SRCMode, int numChannels>
+void RNNAccelerated<inputSize, hiddenSize, RecurrentLayerType, SRCMode, numChannels>::prepare ([[maybe_unused]] int rnnDelaySamples, MathsQuality mathsQuality)
+{
+    internal->mathsQuality = mathsQuality;
     if constexpr (SRCMode == (int) RTNEURAL_NAMESPACE::SampleRateCorrectionMode::NoInterp)
-    {
-        internal->model.template get<0>().prepare (rnnDelaySamples);
-        internal->model.reset();
-    }
+        internal->model.prepare ((float) rnnDelaySamples);
 }
 
-template <int inputSize, int hiddenSize, int RecurrentLayerType, int SRCMode>
-void RNNAccelerated<inputSize, hiddenSize, RecurrentLayerType, SRCMode>::prepare ([[maybe_unused]] float rnnDelaySamples)
+template <int inputSize, int hiddenSize, int RecurrentLayerType, int SRCMode, int numChannels>
+void RNNAccelerated<inputSize, hiddenSize, RecurrentLayerType, SRCMode, numChannels>::prepare ([[maybe_unused]] float rnnDelaySamples, MathsQuality mathsQuality)
 {
+    internal->mathsQuality = mathsQuality;
     if constexpr (SRCMode == (int) RTNEURAL_NAMESPACE::SampleRateCorrectionMode::LinInterp)
-    {
-        internal->model.template get<0>().prepare (rnnDelaySamples);
-        internal->model.reset();
-    }
+        internal->model.prepare (rnnDelaySamples);
 }
 
-template <int inputSize, int hiddenSize, int RecurrentLayerType, int SRCMode>
-void RNNAccelerated<inputSize, hiddenSize, RecurrentLayerType, SRCMode>::reset()
+template <int inputSize, int hiddenSize, int RecurrentLayerType, int SRCMode, int numChannels>
+void RNNAccelerated<inputSize, hiddenSize, RecurrentLayerType, SRCMode, numChannels>::reset()
 {
     internal->model.reset();
 }
 
-template <int inputSize, int hiddenSize, int RecurrentLayerType, int SRCMode>
-void RNNAccelerated<inputSize, hiddenSize, RecurrentLayerType, SRCMode>::process (std::span<float> buffer, bool useResiduals) noexcept
+template <int inputSize, int hiddenSize, int RecurrentLayerType, int SRCMode, int numChannels>
+void RNNAccelerated<inputSize, hiddenSize, RecurrentLayerType, SRCMode, numChannels>::process (std::span<float> buffer, bool useResiduals) noexcept
 {
-    if (useResiduals)
-    {
-        for (auto& x : buffer)
-            x += internal->model.forward (&x);
-    }
-    else
-    {
-        for (auto& x : buffer)
-            x = internal->model.forward (&x);
-    }
+    float* channelData[] { buffer.data() };
+    internal->processBatched (channelData, buffer.size(), nullptr, useResiduals);
 }
 
-template <int inputSize, int hiddenSize, int RecurrentLayerType, int SRCMode>
-void RNNAccelerated<inputSize, hiddenSize, RecurrentLayerType, SRCMode>::process_conditioned (std::span<float> buffer, std::span<const float> condition, bool useResiduals) noexcept
+template <int inputSize, int hiddenSize, int RecurrentLayerType, int SRCMode, int numChannels>
+void RNNAccelerated<inputSize, hiddenSize, RecurrentLayerType, SRCMode, numChannels>::process_conditioned (std::span<float> buffer, std::span<const float> condition, bool useResiduals) noexcept
 {
-    alignas (alignment) float input_vec[xsimd::batch<float>::size] {};
-    if (useResiduals)
-    {
-        for (size_t n = 0; n < buffer.size(); ++n)
-        {
-            input_vec[0] = buffer[n];
-            input_vec[1] = condition[n];
-            buffer[n] += internal->model.forward (input_vec);
-        }
-    }
-    else
-    {
-        for (size_t n = 0; n < buffer.size(); ++n)
-        {
-            input_vec[0] = buffer[n];
-            input_vec[1] = condition[n];
-            buffer[n] = internal->model.forward (input_vec);
-        }
-    }
+    float* channelData[] { buffer.data() };
+    internal->processBatched (channelData, buffer.size(), condition.data(), useResiduals);
+}
+
+template <int inputSize, int hiddenSize, int RecurrentLayerType, int SRCMode, int numChannels>
+void RNNAccelerated<inputSize, hiddenSize, RecurrentLayerType, SRCMode, numChannels>::process_multichannel (std::span<float* const> channelData, size_t numSamples, bool useResiduals) noexcept
+{
+    internal->processBatched (channelData, numSamples, nullptr, useResiduals);
+}
+
+template <int inputSize, int hiddenSize, int RecurrentLayerType, int SRCMode, int numChannels>
+void RNNAccelerated<inputSize, hiddenSize, RecurrentLayerType, SRCMode, numChannels>::process_conditioned_multichannel (std::span<float* const> channelData, std::span<const float> condition, bool useResiduals) noexcept
+{
+    internal->processBatched (channelData, condition.size(), condition.data(), useResiduals);
 }
 
 template class RNNAccelerated<1, 28, RecurrentLayerType::LSTMLayer, (int) RTNEURAL_NAMESPACE::SampleRateCorrectionMode::NoInterp>; // MetalFace
 template class RNNAccelerated<2, 24, RecurrentLayerType::LSTMLayer, (int) RTNEURAL_NAMESPACE::SampleRateCorrectionMode::NoInterp>; // BassFace
-template class RNNAccelerated<1, 40, RecurrentLayerType::LSTMLayer, (int) RTNEURAL_NAMESPACE::SampleRateCorrectionMode::LinInterp>; // GuitarML (no-cond)
-template class RNNAccelerated<2, 40, RecurrentLayerType::LSTMLayer, (int) RTNEURAL_NAMESPACE::SampleRateCorrectionMode::LinInterp>; // GuitarML (cond)
+
+// GuitarML (stereo): LSTM and GRU, with and without conditioning
+#define BYOD_INSTANTIATE_GUITARML_MODELS(hiddenSize)                                                                                                \
+    template class RNNAccelerated<1, hiddenSize, RecurrentLayerType::LSTMLayer, (int) RTNEURAL_NAMESPACE::SampleRateCorrectionMode::LinInterp, 2>; \
+    template class RNNAccelerated<2, hiddenSize, RecurrentLayerType::LSTMLayer, (int) RTNEURAL_NAMESPACE::SampleRateCorrectionMode::LinInterp, 2>; \
+    template class RNNAccelerated<1, hiddenSize, RecurrentLayerType::GRULayer, (int) RTNEURAL_NAMESPACE::SampleRateCorrectionMode::LinInterp, 2>;  \
+    template class RNNAccelerated<2, hiddenSize, RecurrentLayerType::GRULayer, (int) RTNEURAL_NAMESPACE::SampleRateCorrectionMode::LinInterp, 2>;
+BYOD_FOR_EACH_GUITARML_HIDDEN_SIZE (BYOD_INSTANTIATE_GUITARML_MODELS)
+#undef BYOD_INSTANTIATE_GUITARML_MODELS
 #endif // NEON + AVX
 }
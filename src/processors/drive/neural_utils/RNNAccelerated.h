@@ -1,6 +1,7 @@
 #pragma once
 
-#include <modules/json/json.hpp>
+#include "../MathsQuality.h"
+#include "ModelWeights.h"
 #include <span>
 
 namespace RecurrentLayerType
@@ -9,9 +10,26 @@ constexpr int LSTMLayer = 1;
 constexpr int GRULayer = 2;
 } // namespace RecurrentLayerType
 
+/**
+ * The hidden sizes of the GuitarML models that have pre-compiled implementations,
+ * for LSTM and GRU models, with and without conditioning (see GuitarMLModel.h).
+ * X is called as X (hiddenSize) for each size.
+ */
+#define BYOD_FOR_EACH_GUITARML_HIDDEN_SIZE(X) X (8) X (12) X (16) X (20) X (32) X (40) X (64)
+
 namespace rnn_sse_arm
 {
-template <int inputSize, int hiddenSize, int RecurrentLayerType, int SRCMode>
+/**
+ * An RNN (recurrent layer + dense output layer), compiled for a specific SIMD instruction set.
+ *
+ * With numChannels > 1, the model runs several channels through the same set of
+ * weights at once, with separate states for each channel. Each weight vector is
+ * loaded once per step and applied to every channel, so the recurrent step becomes
+ * a matrix-matrix product rather than one matrix-vector product per channel.
+ * GRU models don't have a batched implementation yet, so each channel gets its own
+ * copy of the model.
+ */
+template <int inputSize, int hiddenSize, int RecurrentLayerType, int SRCMode, int numChannels = 1>
 class RNNAccelerated
 {
 public:
@@ -24,19 +42,33 @@ public:
     RNNAccelerated& operator= (RNNAccelerated&&) noexcept = delete;
 
     void initialise (const nlohmann::json& weights_json);
+    void initialise (const ModelWeights& weights);
 
-    void prepare (int rnnDelaySamples);
-    void prepare (float rnnDelaySamples);
+    /** The maths quality sets the accuracy of the LSTM activation functions (GRU models always use the "Normal" quality). */
+    void prepare (int rnnDelaySamples, MathsQuality mathsQuality = MathsQuality::Normal);
+    void prepare (float rnnDelaySamples, MathsQuality mathsQuality = MathsQuality::Normal);
     void reset();
 
     void process (std::span<float> buffer, bool useResiduals = false) noexcept;
     void process_conditioned (std::span<float> buffer, std::span<const float> condition, bool useResiduals = false) noexcept;
 
+    /** Processes up to numChannels channels at once (any extra channels are left untouched). */
+    void process_multichannel (std::span<float* const> channelData, size_t numSamples, bool useResiduals = false) noexcept;
+    void process_conditioned_multichannel (std::span<float* const> channelData, std::span<const float> condition, bool useResiduals = false) noexcept;
+
 private:
     struct Internal;
     Internal* internal = nullptr;
 
-    static constexpr size_t max_model_size = 30000;
+    static constexpr size_t getMaxModelSize()
+    {
+        // a generous bound on the size of the weights and state, since GRU models keep a separate model for each channel
+        constexpr size_t paddedHiddenSize = (hiddenSize + 7) / 8 * 8;
+        constexpr size_t numModelCopies = RecurrentLayerType == RecurrentLayerType::LSTMLayer ? 1 : (size_t) numChannels;
+        constexpr size_t modelSize = numModelCopies * (4 * paddedHiddenSize * (inputSize + hiddenSize + 4) * sizeof (float) + 4096);
+        return modelSize > 30000 ? modelSize : 30000;
+    }
+    static constexpr size_t max_model_size = getMaxModelSize();
     static constexpr size_t alignment = 16;
     alignas (alignment) char internal_data[max_model_size] {};
 };
@@ -45,7 +77,17 @@ private:
 #if __MMX__ || __SSE__ || __amd64__ // INTEL
 namespace rnn_avx
 {
-template <int inputSize, int hiddenSize, int RecurrentLayerType, int SRCMode>
+/**
+ * An RNN (recurrent layer + dense output layer), compiled for a specific SIMD instruction set.
+ *
+ * With numChannels > 1, the model runs several channels through the same set of
+ * weights at once, with separate states for each channel. Each weight vector is
+ * loaded once per step and applied to every channel, so the recurrent step becomes
+ * a matrix-matrix product rather than one matrix-vector product per channel.
+ * GRU models don't have a batched implementation yet, so each channel gets its own
+ * copy of the model.
+ */
+template <int inputSize, int hiddenSize, int RecurrentLayerType, int SRCMode, int numChannels = 1>
 class RNNAccelerated
 {
 public:
@@ -58,19 +100,33 @@ public:
     RNNAccelerated& operator= (RNNAccelerated&&) noexcept = delete;
 
     void initialise (const nlohmann::json& weights_json);
+    void initialise (const ModelWeights& weights);
 
-    void prepare (int rnnDelaySamples);
-    void prepare (float rnnDelaySamples);
+    /** The maths quality sets the accuracy of the LSTM activation functions (GRU models always use the "Normal" quality). */
+    void prepare (int rnnDelaySamples, MathsQuality mathsQuality = MathsQuality::Normal);
+    void prepare (float rnnDelaySamples, MathsQuality mathsQuality = MathsQuality::Normal);
     void reset();
 
     void process (std::span<float> buffer, bool useResiduals = false) noexcept;
     void process_conditioned (std::span<float> buffer, std::span<const float> condition, bool useResiduals = false) noexcept;
 
+    /** Processes up to numChannels channels at once (any extra channels are left untouched). */
+    void process_multichannel (std::span<float* const> channelData, size_t numSamples, bool useResiduals = false) noexcept;
+    void process_conditioned_multichannel (std::span<float* const> channelData, std::span<const float> condition, bool useResiduals = false) noexcept;
+
 private:
     struct Internal;
     Internal* internal = nullptr;
 
-    static constexpr size_t max_model_size = 40000;
+    static constexpr size_t getMaxModelSize()
+    {
+        // a generous bound on the size of the weights and state, since GRU models keep a separate model for each channel
+        constexpr size_t paddedHiddenSize = (hiddenSize + 7) / 8 * 8;
+        constexpr size_t numModelCopies = RecurrentLayerType == RecurrentLayerType::LSTMLayer ? 1 : (size_t) numChannels;
+        constexpr size_t modelSize = numModelCopies * (4 * paddedHiddenSize * (inputSize + hiddenSize + 4) * sizeof (float) + 4096);
+        return modelSize > 40000 ? modelSize : 40000;
+    }
+    static constexpr size_t max_model_size = getMaxModelSize();
     static constexpr size_t alignment = 32;
     alignas (alignment) char internal_data[max_model_size] {};
 };
@@ -6,6 +6,15 @@ void ResampledRNN<hiddenSize, RecurrentLayerType>::initialise (const void* model
 {
     targetSampleRate = modelSampleRate;
 
+    if (const auto weights = ModelWeights::fromData (modelData, (size_t) modelDataSize))
+    {
+        if constexpr (std::is_same_v<RecurrentLayerTypeComplete, RTNeural::GRULayerT<float, 1, 8, DefaultSRCMode>>) // Centaur model has keras-style weights
+            model_loaders::loadGRUModel (model, *weights);
+        else
+            model_loaders::loadLSTMModel (model, *weights);
+        return;
+    }
+
     MemoryInputStream jsonInputStream (modelData, (size_t) modelDataSize, false);
     auto weightsJson = nlohmann::json::parse (jsonInputStream.readEntireStreamAsString().toStdString());
 
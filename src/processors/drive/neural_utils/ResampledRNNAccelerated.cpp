@@ -18,6 +18,13 @@ void ResampledRNNAccelerated<numIns, hiddenSize, RecurrentLayerType>::initialise
 {
     targetSampleRate = modelSampleRate;
 
+    if (const auto weights = ModelWeights::fromData (modelData, (size_t) modelDataSize))
+    {
+        model_variant.visit ([&weights] (auto& model)
+                             { model.initialise (*weights); });
+        return;
+    }
+
     MemoryInputStream jsonInputStream (modelData, (size_t) modelDataSize, false);
     auto weightsJson = nlohmann::json::parse (jsonInputStream.readEntireStreamAsString().toStdString());
 
@@ -26,7 +33,7 @@ void ResampledRNNAccelerated<numIns, hiddenSize, RecurrentLayerType>::initialise
 }
 
 template <int numIns, int hiddenSize, int RecurrentLayerType>
-void ResampledRNNAccelerated<numIns, hiddenSize, RecurrentLayerType>::prepare (double sampleRate, int samplesPerBlock)
+void ResampledRNNAccelerated<numIns, hiddenSize, RecurrentLayerType>::prepare (double sampleRate, int samplesPerBlock, MathsQuality mathsQuality)
 {
     const auto [resampleRatio, rnnDelaySamples] = [] (auto curFs, auto targetFs)
     {
@@ -46,8 +53,8 @@ void ResampledRNNAccelerated<numIns, hiddenSize, RecurrentLayerType>::prepare (d
     needsResampling = resampleRatio != 1.0;
     resampler.prepareWithTargetSampleRate ({ sampleRate, (uint32) samplesPerBlock, 1 }, sampleRate * resampleRatio);
 
-    model_variant.visit ([delaySamples = rnnDelaySamples] (auto& model)
-                         { model.prepare (delaySamples); });
+    model_variant.visit ([delaySamples = rnnDelaySamples, mathsQuality] (auto& model)
+                         { model.prepare (delaySamples, mathsQuality); });
 }
 
 template <int numIns, int hiddenSize, int RecurrentLayerType>
@@ -13,7 +13,7 @@ public:
 
     void initialise (const void* modelData, int modelDataSize, double modelSampleRate);
 
-    void prepare (double sampleRate, int samplesPerBlock);
+    void prepare (double sampleRate, int samplesPerBlock, MathsQuality mathsQuality = MathsQuality::Normal);
     void reset();
 
     template <bool useResiduals = false>
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "ModelWeights.h"
 #include <RTNeural/RTNeural.h>
 
 namespace model_loaders
@@ -43,4 +44,84 @@ void loadGRUModel (ModelType& model, const nlohmann::json& weights_json)
     RTNEURAL_NAMESPACE::json_parser::loadGRU<float> (gru, gru_weights);
     RTNEURAL_NAMESPACE::modelt_detail::loadLayer<float> (dense, layer_idx, dense_layer_json, "dense", 1, false);
 }
+
+/** Loads a PyTorch LSTM layer from binary weights (e.g. "state_dict/rec.weight_ih_l0") */
+template <typename LayerType>
+void loadTorchLSTM (LayerType& lstm, const ModelWeights& weights, const std::string& prefix = "state_dict/rec.")
+{
+    lstm.setWVals (weights.at (prefix + "weight_ih_l0").toTransposedMatrix());
+    lstm.setUVals (weights.at (prefix + "weight_hh_l0").toTransposedMatrix());
+
+    const auto bias_ih = weights.at (prefix + "bias_ih_l0");
+    const auto bias_hh = weights.at (prefix + "bias_hh_l0");
+    std::vector<float> bias (bias_ih.size());
+    for (size_t i = 0; i < bias.size(); ++i)
+        bias[i] = bias_ih[i] + bias_hh[i];
+    lstm.setBVals (bias);
+}
+
+/** Loads a PyTorch GRU layer from binary weights (e.g. "state_dict/rec.weight_ih_l0") */
+template <typename LayerType>
+void loadTorchGRU (LayerType& gru, const ModelWeights& weights, const std::string& prefix = "state_dict/rec.")
+{
+    // PyTorch stores the gates as (r, z, n), but RTNeural expects (z, r, n)
+    const auto swap_rz = [] (std::vector<float>& x)
+    {
+        const auto hidden_size = (std::ptrdiff_t) x.size() / 3;
+        std::swap_ranges (x.begin(), x.begin() + hidden_size, x.begin() + hidden_size);
+    };
+
+    auto w_vals = weights.at (prefix + "weight_ih_l0").toTransposedMatrix();
+    std::for_each (w_vals.begin(), w_vals.end(), swap_rz);
+    gru.setWVals (w_vals);
+
+    auto u_vals = weights.at (prefix + "weight_hh_l0").toTransposedMatrix();
+    std::for_each (u_vals.begin(), u_vals.end(), swap_rz);
+    gru.setUVals (u_vals);
+
+    Vec2d b_vals { weights.at (prefix + "bias_ih_l0").toVector(), weights.at (prefix + "bias_hh_l0").toVector() };
+    std::for_each (b_vals.begin(), b_vals.end(), swap_rz);
+    gru.setBVals (b_vals);
+}
+
+/** Loads a PyTorch dense layer from binary weights (e.g. "state_dict/lin.weight") */
+template <typename LayerType>
+void loadTorchDense (LayerType& dense, const ModelWeights& weights, const std::string& prefix = "state_dict/lin.")
+{
+    dense.setWeights (weights.at (prefix + "weight").toMatrix());
+    const auto dense_bias = weights.at (prefix + "bias").toVector();
+    dense.setBias (dense_bias.data());
+}
+
+/** Loads a PyTorch-style LSTM model from binary weights (see loadLSTMModel (ModelType&, const nlohmann::json&)) */
+template <typename ModelType>
+void loadLSTMModel (ModelType& model, const ModelWeights& weights)
+{
+    loadTorchLSTM (model.template get<0>(), weights);
+    loadTorchDense (model.template get<1>(), weights);
+}
+
+/** Loads a PyTorch-style GRU model from binary weights */
+template <typename ModelType>
+void loadTorchGRUModel (ModelType& model, const ModelWeights& weights)
+{
+    loadTorchGRU (model.template get<0>(), weights);
+    loadTorchDense (model.template get<1>(), weights);
+}
+
+/** Loads a Keras-style GRU model from binary weights (see loadGRUModel (ModelType&, const nlohmann::json&)) */
+template <typename ModelType>
+void loadGRUModel (ModelType& model, const ModelWeights& weights)
+{
+    auto& gru = model.template get<0>();
+    gru.setWVals (weights.at ("layers/0/weights/0").toMatrix());
+    gru.setUVals (weights.at ("layers/0/weights/1").toMatrix());
+    gru.setBVals (weights.at ("layers/0/weights/2").toMatrix());
+
+    // Keras stores the dense weights as [in][out], but RTNeural wants [out][in]
+    auto& dense = model.template get<1>();
+    dense.setWeights (weights.at ("layers/1/weights/0").toTransposedMatrix());
+    const auto dense_bias = weights.at ("layers/1/weights/1").toVector();
+    dense.setBias (dense_bias.data());
+}
 } // namespace model_loaders
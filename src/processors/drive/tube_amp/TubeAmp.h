@@ -14,6 +14,7 @@ public:
 
     void prepare (double sampleRate, int samplesPerBlock) override;
     void processAudio (AudioBuffer<float>& buffer) override;
+    double getTailLengthSeconds() const override { return stateSettleTimeSeconds; }
 
 private:
     chowdsp::FloatParameter* driveParam = nullptr;
@@ -23,8 +23,12 @@ TubeScreamer::TubeScreamer (UndoManager* um)
         "R4",
         [this] (const netlist::CircuitQuantity& self)
         {
-            for (auto& wdfModel : wdf)
-                wdfModel.R4_ser_C3.setResistanceValue (self.value.load());
+            wdf.visit (
+                [&self] (auto& wdfModels)
+                {
+                    for (auto& wdfModel : wdfModels)
+                        wdfModel.R4_ser_C3.setResistanceValue (self.value.load());
+                });
         },
         100.0f,
         25.0e3f);
@@ -32,16 +36,24 @@ TubeScreamer::TubeScreamer (UndoManager* um)
                                            "R5",
                                            [this] (const netlist::CircuitQuantity& self)
                                            {
-                                               for (auto& wdfModel : wdf)
-                                                   wdfModel.R5.setResistanceValue (self.value.load());
+                                               wdf.visit (
+                                                   [&self] (auto& wdfModels)
+                                                   {
+                                                       for (auto& wdfModel : wdfModels)
+                                                           wdfModel.R5.setResistanceValue (self.value.load());
+                                                   });
                                            });
     netlistCircuitQuantities->addCapacitor (
         1.0e-6f,
         "C2",
         [this] (const netlist::CircuitQuantity& self)
         {
-            for (auto& wdfModel : wdf)
-                wdfModel.Vin_C2.setCapacitanceValue (self.value.load());
+            wdf.visit (
+                [&self] (auto& wdfModels)
+                {
+                    for (auto& wdfModel : wdfModels)
+                        wdfModel.Vin_C2.setCapacitanceValue (self.value.load());
+                });
         },
         100.0e-12f);
     netlistCircuitQuantities->addCapacitor (
@@ -49,16 +61,24 @@ TubeScreamer::TubeScreamer (UndoManager* um)
         "C3",
         [this] (const netlist::CircuitQuantity& self)
         {
-            for (auto& wdfModel : wdf)
-                wdfModel.R4_ser_C3.setCapacitanceValue (self.value.load());
+            wdf.visit (
+                [&self] (auto& wdfModels)
+                {
+                    for (auto& wdfModel : wdfModels)
+                        wdfModel.R4_ser_C3.setCapacitanceValue (self.value.load());
+                });
         },
         1.0e-9f);
     netlistCircuitQuantities->addCapacitor (51.0e-12f,
                                             "C4",
                                             [this] (const netlist::CircuitQuantity& self)
                                             {
-                                                for (auto& wdfModel : wdf)
-                                                    wdfModel.R6_P1_par_C4.setCapacitanceValue (self.value.load());
+                                                wdf.visit (
+                                                    [&self] (auto& wdfModels)
+                                                    {
+                                                        for (auto& wdfModel : wdfModels)
+                                                            wdfModel.R6_P1_par_C4.setCapacitanceValue (self.value.load());
+                                                    });
                                             });
 }
 
@@ -78,11 +98,18 @@ void TubeScreamer::prepare (double sampleRate, int samplesPerBlock)
 {
     int diodeType = static_cast<int> (*diodeTypeParam);
     auto gainParamSkew = ParameterHelpers::logPot (*gainParam);
-    for (auto& wdfProc : wdf)
-    {
-        wdfProc.prepare (sampleRate);
-        wdfProc.setParameters (gainParamSkew, DiodeParameter::getDiodeIs (diodeType), *nDiodesParam, true);
-    }
+    if (wdf.setQuality (getMathsQuality()))
+        applyNetlistCircuitQuantities();
+
+    wdf.visit (
+        [&] (auto& wdfModels)
+        {
+            for (auto& wdfProc : wdfModels)
+            {
+                wdfProc.prepare (sampleRate);
+                wdfProc.setParameters (gainParamSkew, DiodeParameter::getDiodeIs (diodeType), *nDiodesParam, true);
+            }
+        });
 
     dcBlocker.prepare (sampleRate, samplesPerBlock);
 
@@ -101,11 +128,15 @@ void TubeScreamer::processAudio (AudioBuffer<float>& buffer)
 
     int diodeType = static_cast<int> (*diodeTypeParam);
     auto gainParamSkew = ParameterHelpers::logPot (*gainParam);
-    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
-    {
-        wdf[ch].setParameters (gainParamSkew, DiodeParameter::getDiodeIs (diodeType), *nDiodesParam);
-        wdf[ch].process (buffer.getWritePointer (ch), buffer.getNumSamples());
-    }
+    wdf.visit (
+        [&] (auto& wdfModels)
+        {
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            {
+                wdfModels[(size_t) ch].setParameters (gainParamSkew, DiodeParameter::getDiodeIs (diodeType), *nDiodesParam);
+                wdfModels[(size_t) ch].process (buffer.getWritePointer (ch), buffer.getNumSamples());
+            }
+        });
 
     dcBlocker.processAudio (buffer);
 
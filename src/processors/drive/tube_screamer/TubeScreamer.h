@@ -14,13 +14,16 @@ public:
 
     void prepare (double sampleRate, int samplesPerBlock) override;
     void processAudio (AudioBuffer<float>& buffer) override;
+    double getTailLengthSeconds() const override { return jmax (stateSettleTimeSeconds, dcBlocker.getTailLengthSeconds()); }
 
 private:
     chowdsp::FloatParameter* gainParam = nullptr;
     std::atomic<float>* diodeTypeParam = nullptr;
     chowdsp::FloatParameter* nDiodesParam = nullptr;
 
-    TubeScreamerWDF wdf[2];
+    template <typename OmegaProvider>
+    using WDFModels = std::array<TubeScreamerWDF<OmegaProvider>, 2>;
+    MathsQualityVariant<WDFModels> wdf;
     DCBlocker dcBlocker;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TubeScreamer)
@@ -19,8 +19,12 @@ ZenDrive::ZenDrive (UndoManager* um) : BaseProcessor ("Yen Drive", createParamet
         "R4",
         [this] (const netlist::CircuitQuantity& self)
         {
-            for (auto& wdfModel : wdf)
-                wdfModel.R4.setResistanceValue (self.value.load());
+            wdf.visit (
+                [&self] (auto& wdfModels)
+                {
+                    for (auto& wdfModel : wdfModels)
+                        wdfModel.R4.setResistanceValue (self.value.load());
+                });
         },
         10.0e3f,
         2.0e6f);
@@ -29,8 +33,12 @@ ZenDrive::ZenDrive (UndoManager* um) : BaseProcessor ("Yen Drive", createParamet
         "C3",
         [this] (const netlist::CircuitQuantity& self)
         {
-            for (auto& wdfModel : wdf)
-                wdfModel.Vin_C3.setCapacitanceValue (self.value.load());
+            wdf.visit (
+                [&self] (auto& wdfModels)
+                {
+                    for (auto& wdfModel : wdfModels)
+                        wdfModel.Vin_C3.setCapacitanceValue (self.value.load());
+                });
         },
         1.0e-12f,
         1.0e-3f);
@@ -39,8 +47,12 @@ ZenDrive::ZenDrive (UndoManager* um) : BaseProcessor ("Yen Drive", createParamet
         "C4",
         [this] (const netlist::CircuitQuantity& self)
         {
-            for (auto& wdfModel : wdf)
-                wdfModel.Rv9_C4.setCapacitanceValue (self.value.load());
+            wdf.visit (
+                [&self] (auto& wdfModels)
+                {
+                    for (auto& wdfModel : wdfModels)
+                        wdfModel.Rv9_C4.setCapacitanceValue (self.value.load());
+                });
         },
         1.0e-15f,
         1.0e-3f);
@@ -49,8 +61,12 @@ ZenDrive::ZenDrive (UndoManager* um) : BaseProcessor ("Yen Drive", createParamet
         "C5",
         [this] (const netlist::CircuitQuantity& self)
         {
-            for (auto& wdfModel : wdf)
-                wdfModel.R5_R6_C5.setCapacitanceValue (self.value.load());
+            wdf.visit (
+                [&self] (auto& wdfModels)
+                {
+                    for (auto& wdfModel : wdfModels)
+                        wdfModel.R5_R6_C5.setCapacitanceValue (self.value.load());
+                });
         },
         1.0e-9f,
         1.0e-3f);
@@ -69,11 +85,18 @@ ParamLayout ZenDrive::createParameterLayout()
 
 void ZenDrive::prepare (double sampleRate, int samplesPerBlock)
 {
-    for (auto& wdfProc : wdf)
-    {
-        wdfProc.prepare (sampleRate);
-        wdfProc.setParameters (1.0f - *voiceParam, ParameterHelpers::logPot (*gainParam));
-    }
+    if (wdf.setQuality (getMathsQuality()))
+        applyNetlistCircuitQuantities();
+
+    wdf.visit (
+        [this, sampleRate] (auto& wdfModels)
+        {
+            for (auto& wdfProc : wdfModels)
+            {
+                wdfProc.prepare (sampleRate);
+                wdfProc.setParameters (1.0f - *voiceParam, ParameterHelpers::logPot (*gainParam));
+            }
+        });
 
     dcBlocker.prepare (sampleRate, samplesPerBlock);
 
@@ -90,11 +113,15 @@ void ZenDrive::processAudio (AudioBuffer<float>& buffer)
 {
     buffer.applyGain (0.5f);
 
-    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
-    {
-        wdf[ch].setParameters (1.0f - *voiceParam, ParameterHelpers::logPot (*gainParam));
-        wdf[ch].process (buffer.getWritePointer (ch), buffer.getNumSamples());
-    }
+    wdf.visit (
+        [this, &buffer] (auto& wdfModels)
+        {
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            {
+                wdfModels[(size_t) ch].setParameters (1.0f - *voiceParam, ParameterHelpers::logPot (*gainParam));
+                wdfModels[(size_t) ch].process (buffer.getWritePointer (ch), buffer.getNumSamples());
+            }
+        });
 
     dcBlocker.processAudio (buffer);
 
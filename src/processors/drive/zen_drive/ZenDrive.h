@@ -14,12 +14,15 @@ public:
 
     void prepare (double sampleRate, int samplesPerBlock) override;
     void processAudio (AudioBuffer<float>& buffer) override;
+    double getTailLengthSeconds() const override { return jmax (stateSettleTimeSeconds, dcBlocker.getTailLengthSeconds()); }
 
 private:
     chowdsp::FloatParameter* voiceParam = nullptr;
     chowdsp::FloatParameter* gainParam = nullptr;
 
-    ZenDriveWDF wdf[2];
+    template <typename OmegaProvider>
+    using WDFModels = std::array<ZenDriveWDF<OmegaProvider>, 2>;
+    MathsQualityVariant<WDFModels> wdf;
     DCBlocker dcBlocker;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ZenDrive)
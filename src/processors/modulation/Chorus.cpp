@@ -1,5 +1,4 @@
 #include "Chorus.h"
-#include "../BufferHelpers.h"
 #include "../ParameterHelpers.h"
 
 namespace ChorusTags
@@ -41,6 +40,7 @@ Chorus::Chorus (UndoManager* um) : BaseProcessor (
     uiOptions.info.authors = StringArray { "Jatin Chowdhury" };
 
     disableWhenInputConnected ({ "rate" }, ModulationInput);
+    setControlRateOutput (ModulationOutput);
 }
 
 ParamLayout Chorus::createParameterLayout()
@@ -72,6 +72,8 @@ void Chorus::prepare (double sampleRate, int samplesPerBlock)
 
             slowLFOs[ch][i].prepare (monoSpec);
             fastLFOs[ch][i].prepare (monoSpec);
+            slowLFOSignals[ch][i].prepare (samplesPerBlock);
+            fastLFOSignals[ch][i].prepare (samplesPerBlock);
 
             slowLFOData[ch][i].resize ((size_t) samplesPerBlock, 0.0f);
             fastLFOData[ch][i].resize ((size_t) samplesPerBlock, 0.0f);
@@ -101,7 +103,7 @@ void Chorus::prepare (double sampleRate, int samplesPerBlock)
     dcBlocker.setCutoffFrequency (60.0f);
 
     audioOutBuffer.setSize (2, samplesPerBlock);
-    modOutBuffer.setSize (1, samplesPerBlock);
+    modOutSignal.prepare (samplesPerBlock);
 
     for (auto& filt : hilbertFilter)
         filt.reset();
@@ -111,12 +113,10 @@ void Chorus::prepare (double sampleRate, int samplesPerBlock)
 
 void Chorus::processModulation (int numSamples)
 {
-    modOutBuffer.setSize (1, numSamples, false, false, true);
     if (inputsConnected.contains (ModulationInput))
     {
-        // get modulation buffer from input (-1, 1)
-        const auto& modInputBuffer = getInputBuffer (ModulationInput);
-        BufferHelpers::collapseToMonoBuffer (modInputBuffer, modOutBuffer);
+        // get modulation signal from input (-1, 1)
+        getModulationInput (ModulationInput, modOutSignal, numSamples);
 
         auto phaseShiftSlowLFO = [this, numSamples, filterIndex = 0] (float* lfoIn, float* lfoOut) mutable
         {
@@ -137,9 +137,7 @@ void Chorus::processModulation (int numSamples)
             FloatVectorOperations::multiply (fastLFO, 4.0f, numSamples);
         };
 
-        auto* modOutData = modOutBuffer.getReadPointer (0);
-
-        FloatVectorOperations::copy (slowLFOData[0][0].data(), modOutData, numSamples);
+        modOutSignal.upsample (slowLFOData[0][0].data(), numSamples, ControlRate::Smoothing::Linear);
         phaseShiftSlowLFO (slowLFOData[0][0].data(), slowLFOData[0][1].data());
         FloatVectorOperations::copy (slowLFOData[1][0].data(), slowLFOData[0][1].data(), numSamples);
         phaseShiftSlowLFO (slowLFOData[1][0].data(), slowLFOData[1][1].data());
@@ -156,8 +154,11 @@ void Chorus::processModulation (int numSamples)
         static constexpr float rate2Low = 0.5f;
         static constexpr float rate2High = 40.0f;
 
-        auto slowRate = rate1Low * std::pow (rate1High / rate1Low, *rateParam);
-        auto fastRate = rate2Low * std::pow (rate2High / rate2Low, *rateParam);
+        // the LFOs run at control rate, so each step covers a whole segment
+        const auto numSegments = ControlRate::getNumSegments (numSamples);
+        const auto segmentLength = ControlRate::getSegmentLength (numSamples);
+        auto slowRate = rate1Low * std::pow (rate1High / rate1Low, *rateParam) * segmentLength;
+        auto fastRate = rate2Low * std::pow (rate2High / rate2Low, *rateParam) * segmentLength;
 
         for (int ch = 0; ch < 2; ++ch)
         {
@@ -169,21 +170,24 @@ void Chorus::processModulation (int numSamples)
 
             for (int i = 0; i < delaysPerChannel; ++i)
             {
-                auto* slowData = slowLFOData[ch][i].data();
-                auto* fastData = fastLFOData[ch][i].data();
+                auto* slowData = slowLFOSignals[ch][i].startBlock (numSamples);
+                auto* fastData = fastLFOSignals[ch][i].startBlock (numSamples);
 
-                for (int n = 0; n < numSamples; ++n)
+                for (int k = 0; k < numSegments; ++k)
                 {
-                    slowData[n] = slowLFOs[ch][i].processSample();
-                    fastData[n] = fastLFOs[ch][i].processSample();
+                    slowData[k] = slowLFOs[ch][i].processSample();
+                    fastData[k] = fastLFOs[ch][i].processSample();
                 }
+
+                slowLFOSignals[ch][i].upsample (slowLFOData[ch][i].data(), numSamples, ControlRate::Smoothing::Linear);
+                fastLFOSignals[ch][i].upsample (fastLFOData[ch][i].data(), numSamples, ControlRate::Smoothing::Linear);
             }
         }
 
-        auto* modOutData = modOutBuffer.getWritePointer (0);
-        FloatVectorOperations::copy (modOutData, slowLFOData[0][0].data(), numSamples);
-        FloatVectorOperations::add (modOutData, fastLFOData[0][0].data(), numSamples);
-        FloatVectorOperations::multiply (modOutData, 0.5f, numSamples); // make sure the end result never goes larger than 1!
+        auto* modOutData = modOutSignal.startBlock (numSamples);
+        FloatVectorOperations::copy (modOutData, slowLFOSignals[0][0].getBuffer().getReadPointer (0, 1), numSegments);
+        FloatVectorOperations::add (modOutData, fastLFOSignals[0][0].getBuffer().getReadPointer (0, 1), numSegments);
+        FloatVectorOperations::multiply (modOutData, 0.5f, numSegments); // make sure the end result never goes larger than 1!
     }
 }
 
@@ -286,7 +290,7 @@ void Chorus::processAudio (AudioBuffer<float>& buffer)
     }
 
     outputBuffers.getReference (AudioOutput) = audioOutBuffer;
-    outputBuffers.getReference (ModulationOutput) = modOutBuffer;
+    outputBuffers.getReference (ModulationOutput) = modOutSignal.getBuffer();
 
     bypassNeedsReset = true;
 }
@@ -308,16 +312,14 @@ void Chorus::processAudioBypassed (AudioBuffer<float>& buffer)
 
     const auto numSamples = buffer.getNumSamples();
 
-    modOutBuffer.setSize (1, numSamples, false, false, true);
     if (inputsConnected.contains (ModulationInput)) // make mono and pass samples through
     {
-        // get modulation buffer from input (-1, 1)
-        const auto& modInputBuffer = getInputBuffer (ModulationInput);
-        BufferHelpers::collapseToMonoBuffer (modInputBuffer, modOutBuffer);
+        // get modulation signal from input (-1, 1)
+        getModulationInput (ModulationInput, modOutSignal, numSamples);
     }
     else
     {
-        modOutBuffer.clear();
+        modOutSignal.fill (numSamples, 0.0f);
     }
 
     if (inputsConnected.contains (AudioInput))
@@ -334,5 +336,5 @@ void Chorus::processAudioBypassed (AudioBuffer<float>& buffer)
     }
 
     outputBuffers.getReference (AudioOutput) = audioOutBuffer;
-    outputBuffers.getReference (ModulationOutput) = modOutBuffer;
+    outputBuffers.getReference (ModulationOutput) = modOutSignal.getBuffer();
 }
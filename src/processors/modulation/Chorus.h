@@ -51,6 +51,9 @@ private:
     chowdsp::SineWave<float> slowLFOs[2][delaysPerChannel];
     chowdsp::SineWave<float> fastLFOs[2][delaysPerChannel];
 
+    ControlRate::Signal slowLFOSignals[2][delaysPerChannel];
+    ControlRate::Signal fastLFOSignals[2][delaysPerChannel];
+
     std::vector<float> slowLFOData[2][delaysPerChannel];
     std::vector<float> fastLFOData[2][delaysPerChannel];
     chowdsp::HilbertFilter<float> hilbertFilter[2];
@@ -71,7 +74,7 @@ private:
 
     float fs = 48000.0f;
     AudioBuffer<float> audioOutBuffer;
-    AudioBuffer<float> modOutBuffer;
+    ControlRate::Signal modOutSignal;
 
     bool bypassNeedsReset = false;
 
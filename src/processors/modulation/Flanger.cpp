@@ -1,5 +1,4 @@
 #include "Flanger.h"
-#include "../BufferHelpers.h"
 #include "../ParameterHelpers.h"
 
 namespace FlangerTags
@@ -119,8 +118,7 @@ void Flanger::processModulation (int numSamples)
     if (inputsConnected.contains (ModulationInput))
     {
         // get modulation buffer from input (-1, 1)
-        const auto& modInputBuffer = getInputBuffer (ModulationInput);
-        BufferHelpers::collapseToMonoBuffer (modInputBuffer, modOutBuffer);
+        getModulationInput (ModulationInput, modOutBuffer);
 
         auto phaseShiftLFO = [this, numSamples, filterIndex = 0] (float* lfoIn, float* lfoOut) mutable
         {
@@ -285,8 +283,7 @@ void Flanger::processAudioBypassed (AudioBuffer<float>& buffer)
     if (inputsConnected.contains (ModulationInput)) // make mono and pass samples through
     {
         // get modulation buffer from input (-1, 1)
-        const auto& modInputBuffer = getInputBuffer (ModulationInput);
-        BufferHelpers::collapseToMonoBuffer (modInputBuffer, modOutBuffer);
+        getModulationInput (ModulationInput, modOutBuffer);
     }
     else
     {
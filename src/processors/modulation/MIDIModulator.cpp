@@ -1,4 +1,5 @@
 #include "MIDIModulator.h"
+#include "gui/utils/FrameScheduler.h"
 #include "processors/ParameterHelpers.h"
 
 namespace MidiModulatorTags
@@ -28,6 +29,7 @@ MidiModulator::MidiModulator (UndoManager* um)
     uiOptions.info.authors = StringArray { "Jatin Chowdhury" };
 
     addPopupMenuParameter (MidiModulatorTags::bipolarTag);
+    setControlRateOutput (0);
 }
 
 ParamLayout MidiModulator::createParameterLayout()
@@ -40,9 +42,10 @@ ParamLayout MidiModulator::createParameterLayout()
 
 void MidiModulator::prepare (double sampleRate, int samplesPerBlock)
 {
-    midiModSmooth.prepare (sampleRate, samplesPerBlock);
+    // the modulation signal is generated at control rate
+    midiModSmooth.prepare (sampleRate / ControlRate::interval, ControlRate::getNumSegments (samplesPerBlock));
     modControlValue = 0;
-    modOutBuffer.setSize (1, samplesPerBlock);
+    modOutSignal.prepare (samplesPerBlock);
 }
 
 static auto getModFloatValue (int val, bool isBipolar)
@@ -79,22 +82,18 @@ void MidiModulator::processAudio (AudioBuffer<float>& buffer)
         }
     }
 
-    midiModSmooth.process (getModFloatValue (modControlValue.load(), bipolarParam->get()), numSamples);
+    const auto numSegments = ControlRate::getNumSegments (numSamples);
+    midiModSmooth.process (getModFloatValue (modControlValue.load(), bipolarParam->get()), numSegments);
 
-    modOutBuffer.setSize (1, numSamples, false, false, true);
-    modOutBuffer.copyFrom (0, 0, midiModSmooth.getSmoothedBuffer(), numSamples, 1.0f);
+    FloatVectorOperations::copy (modOutSignal.startBlock (numSamples), midiModSmooth.getSmoothedBuffer(), numSegments);
 
-    outputBuffers.getReference (0) = modOutBuffer;
+    outputBuffers.getReference (0) = modOutSignal.getBuffer();
 }
 
 void MidiModulator::processAudioBypassed (AudioBuffer<float>& buffer)
 {
-    const auto numSamples = buffer.getNumSamples();
-
-    modOutBuffer.setSize (1, numSamples, false, false, true);
-    modOutBuffer.clear();
-
-    outputBuffers.getReference (0) = modOutBuffer;
+    modOutSignal.fill (buffer.getNumSamples(), 0.0f);
+    outputBuffers.getReference (0) = modOutSignal.getBuffer();
 }
 
 //===================================================================
@@ -111,11 +110,25 @@ void MidiModulator::fromXML (XmlElement* xml, const chowdsp::Version& version, b
     mappedModController = xml->getIntAttribute (MidiModulatorTags::midiMapTag, 1);
 }
 
+void MidiModulator::toBinary (BinaryStateWriter& writer)
+{
+    BaseProcessor::toBinary (writer);
+    writer.writeInt (mappedModController);
+}
+
+void MidiModulator::fromBinary (BinaryStateReader& reader, const chowdsp::Version& version, bool loadPosition)
+{
+    BaseProcessor::fromBinary (reader, version, loadPosition);
+
+    const auto midiMap = reader.readInt();
+    mappedModController = reader.hasFailed() ? 1 : midiMap;
+}
+
 //===================================================================
 bool MidiModulator::getCustomComponents (OwnedArray<Component>& customComps, chowdsp::HostContextProvider&)
 {
     struct MidiComp : public Component,
-                      private Timer
+                      private FrameScheduler::Client
     {
         explicit MidiComp (MidiModulator& processor)
             : proc (processor),
@@ -141,7 +154,7 @@ bool MidiModulator::getCustomComponents (OwnedArray<Component>& customComps, cho
             { proc.isLearning.store (learnButton.getToggleState()); };
             addAndMakeVisible (learnButton);
 
-            startTimerHz (24);
+            startFrameCallbacks (24);
         }
 
         ~MidiComp() override
@@ -244,12 +257,24 @@ bool MidiModulator::getCustomComponents (OwnedArray<Component>& customComps, cho
             bipolarButton.setBounds (getWidth() - (buttonWidth + pad), pad, buttonWidth, buttonHeight);
         }
 
-        void timerCallback() override
+        void frameCallback() override
         {
-            repaint();
+            const auto modValue = proc.modControlValue.load();
+            const auto modController = chowdsp::AtomicRef { proc.mappedModController }.load();
+            const auto isBipolar = proc.bipolarParam->get();
+            if (modValue == lastModValue && modController == lastModController && isBipolar == lastIsBipolar)
+                return;
+
+            lastModValue = modValue;
+            lastModController = modController;
+            lastIsBipolar = isBipolar;
+            frameScheduler->markDirty (*this);
         }
 
         MidiModulator& proc;
+        int lastModValue = -1;
+        int lastModController = -1;
+        bool lastIsBipolar = false;
 
         struct TunerButton : TextButton
         {
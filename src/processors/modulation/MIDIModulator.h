@@ -18,6 +18,8 @@ public:
 
     std::unique_ptr<XmlElement> toXML() override;
     void fromXML (XmlElement* xml, const chowdsp::Version& version, bool loadPosition) override;
+    void toBinary (BinaryStateWriter& writer) override;
+    void fromBinary (BinaryStateReader& reader, const chowdsp::Version& version, bool loadPosition) override;
 
 private:
     chowdsp::BoolParameter* bipolarParam = nullptr;
@@ -27,7 +29,7 @@ private:
     int mappedModController = 1;
     std::atomic_bool isLearning { false };
 
-    AudioBuffer<float> modOutBuffer;
+    ControlRate::Signal modOutSignal;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MidiModulator)
 };
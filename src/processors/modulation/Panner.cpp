@@ -120,8 +120,8 @@ void Panner::generateModulationSignal (chowdsp::BufferView<float> modulationBuff
     if (inputsConnected.contains (ModulationInput))
     {
         // get modulation buffer from input (-1, 1)
-        const auto& modInputBuffer = getInputBuffer (ModulationInput);
-        chowdsp::BufferMath::sumToMono (modInputBuffer, modulationBuffer);
+        auto modulationAudioBuffer = modulationBuffer.toAudioBuffer();
+        getModulationInput (ModulationInput, modulationAudioBuffer);
     }
     else
     {
@@ -238,8 +238,8 @@ void Panner::processAudioBypassed (AudioBuffer<float>& buffer)
     if (inputsConnected.contains (ModulationInput)) // make mono and pass samples through
     {
         // get modulation buffer from input (-1, 1)
-        const auto& modInputBuffer = getInputBuffer (ModulationInput);
-        chowdsp::BufferMath::sumToMono (modInputBuffer, modulationBuffer);
+        auto modulationAudioBuffer = modulationBuffer.toAudioBuffer();
+        getModulationInput (ModulationInput, modulationAudioBuffer);
     }
 
     stereoBuffer.clear();
@@ -344,7 +344,7 @@ bool Panner::getCustomComponents (OwnedArray<Component>& customComps, chowdsp::H
 
     /** Width or right pan */
     class PanSlider2 : public Slider,
-                       private Timer
+                       private FrameScheduler::Client
     {
     public:
         PanSlider2 (AudioProcessorValueTreeState& vtState, std::atomic_bool& isStereo, chowdsp::HostContextProvider& hcp)
@@ -368,10 +368,10 @@ bool Panner::getCustomComponents (OwnedArray<Component>& customComps, chowdsp::H
 
             Component::setName (PannerTags::stereoWidthTag + "__" + PannerTags::rightPanTag + "__");
 
-            startTimerHz (10);
+            startFrameCallbacks (10);
         }
 
-        void timerCallback() override
+        void frameCallback() override
         {
             setEnabled (isStereoInput);
         }
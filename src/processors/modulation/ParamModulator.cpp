@@ -32,6 +32,7 @@ ParamModulator::ParamModulator (UndoManager* um)
     uiOptions.info.authors = StringArray { "Jatin Chowdhury" };
 
     addPopupMenuParameter (ParamModulatorTags::bipolarModeTag);
+    setControlRateOutput (0);
 }
 
 ParamLayout ParamModulator::createParameterLayout()
@@ -46,33 +47,30 @@ ParamLayout ParamModulator::createParameterLayout()
 
 void ParamModulator::prepare (double sampleRate, int samplesPerBlock)
 {
+    // the modulation signal is generated at control rate
     modSmooth.setRampLength (0.01f);
-    modSmooth.prepare (sampleRate, samplesPerBlock);
+    modSmooth.prepare (sampleRate / ControlRate::interval, ControlRate::getNumSegments (samplesPerBlock));
 
-    modOutBuffer.setSize (1, samplesPerBlock);
+    modOutSignal.prepare (samplesPerBlock);
 }
 
 void ParamModulator::processAudio (AudioBuffer<float>& buffer)
 {
     const auto numSamples = buffer.getNumSamples();
+    const auto numSegments = ControlRate::getNumSegments (numSamples);
 
     const auto modValue = bipolarModeParam->get() ? bipolarModParam->getCurrentValue() : unipolarModParam->getCurrentValue();
-    modSmooth.process (modValue, numSamples);
+    modSmooth.process (modValue, numSegments);
 
-    modOutBuffer.setSize (1, numSamples, false, false, true);
-    modOutBuffer.copyFrom (0, 0, modSmooth.getSmoothedBuffer(), numSamples, 1.0f);
+    FloatVectorOperations::copy (modOutSignal.startBlock (numSamples), modSmooth.getSmoothedBuffer(), numSegments);
 
-    outputBuffers.getReference (0) = modOutBuffer;
+    outputBuffers.getReference (0) = modOutSignal.getBuffer();
 }
 
 void ParamModulator::processAudioBypassed (AudioBuffer<float>& buffer)
 {
-    const auto numSamples = buffer.getNumSamples();
-
-    modOutBuffer.setSize (1, numSamples, false, false, true);
-    modOutBuffer.clear();
-
-    outputBuffers.getReference (0) = modOutBuffer;
+    modOutSignal.fill (buffer.getNumSamples(), 0.0f);
+    outputBuffers.getReference (0) = modOutSignal.getBuffer();
 }
 
 bool ParamModulator::getCustomComponents (OwnedArray<Component>& customComps, chowdsp::HostContextProvider& hcp)
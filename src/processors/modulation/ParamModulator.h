@@ -23,7 +23,7 @@ private:
 
     chowdsp::SmoothedBufferValue<float> modSmooth;
 
-    AudioBuffer<float> modOutBuffer;
+    ControlRate::Signal modOutSignal;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParamModulator)
 };
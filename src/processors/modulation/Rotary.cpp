@@ -1,5 +1,4 @@
 #include "Rotary.h"
-#include "../BufferHelpers.h"
 #include "../ParameterHelpers.h"
 
 namespace RotaryTags
@@ -108,8 +107,7 @@ void Rotary::processModulation (int numSamples)
     if (inputsConnected.contains (ModulationInput))
     {
         // get modulation buffer from input (-1, 1)
-        const auto& modInputBuffer = getInputBuffer (ModulationInput);
-        BufferHelpers::collapseToMonoBuffer (modInputBuffer, modulationBuffer);
+        getModulationInput (ModulationInput, modulationBuffer);
         FloatVectorOperations::clip (modulationBuffer.getWritePointer (0),
                                      modulationBuffer.getReadPointer (0),
                                      -1.0f,
@@ -230,8 +228,7 @@ void Rotary::processAudioBypassed (AudioBuffer<float>& buffer)
     if (inputsConnected.contains (ModulationInput)) // make mono and pass samples through
     {
         // get modulation buffer from input (-1, 1)
-        const auto& modInputBuffer = getInputBuffer (ModulationInput);
-        BufferHelpers::collapseToMonoBuffer (modInputBuffer, modulationBuffer);
+        getModulationInput (ModulationInput, modulationBuffer);
     }
     else
     {
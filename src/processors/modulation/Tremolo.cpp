@@ -1,5 +1,4 @@
 #include "Tremolo.h"
-#include "../BufferHelpers.h"
 #include "../ParameterHelpers.h"
 
 namespace TremoloTags
@@ -43,6 +42,7 @@ Tremolo::Tremolo (UndoManager* um) : BaseProcessor (
     uiOptions.info.authors = StringArray { "Jatin Chowdhury" };
 
     disableWhenInputConnected ({ "rate", "wave" }, ModulationInput);
+    setControlRateOutput (ModulationOutput);
 }
 
 ParamLayout Tremolo::createParameterLayout()
@@ -61,12 +61,16 @@ ParamLayout Tremolo::createParameterLayout()
 
 void Tremolo::prepare (double sampleRate, int samplesPerBlock)
 {
-    dsp::ProcessSpec monoSpec { sampleRate, (uint32) samplesPerBlock, 1 };
+    // the LFO is generated at control rate
+    const auto controlSampleRate = sampleRate / ControlRate::interval;
+    const auto controlBlockSize = ControlRate::getNumSegments (samplesPerBlock);
+    dsp::ProcessSpec controlSpec { controlSampleRate, (uint32) controlBlockSize, 1 };
 
-    filter.prepare (monoSpec);
+    filter.prepare (controlSpec);
     filter.setCutoffFrequency (250.0f);
 
-    modOutBuffer.setSize (1, samplesPerBlock);
+    modOutSignal.prepare (samplesPerBlock);
+    modBuffer.setSize (1, samplesPerBlock);
     audioOutBuffer.setSize (2, samplesPerBlock);
 
     phaseSmooth.setRampLength (0.01);
@@ -74,8 +78,8 @@ void Tremolo::prepare (double sampleRate, int samplesPerBlock)
     depthGainSmooth.setRampLength (0.01);
     depthAddSmooth.setRampLength (0.01);
 
-    phaseSmooth.prepare (sampleRate, samplesPerBlock);
-    waveSmooth.prepare (sampleRate, samplesPerBlock);
+    phaseSmooth.prepare (controlSampleRate, controlBlockSize);
+    waveSmooth.prepare (controlSampleRate, controlBlockSize);
     depthGainSmooth.prepare (sampleRate, samplesPerBlock);
     depthAddSmooth.prepare (sampleRate, samplesPerBlock);
 
@@ -181,29 +185,32 @@ void Tremolo::fillWaveBuffer (float* waveBuff, const int numSamples, float& p)
 void Tremolo::processAudio (AudioBuffer<float>& buffer)
 {
     const auto numSamples = buffer.getNumSamples();
-    modOutBuffer.setSize (1, numSamples, false, false, true);
+    const auto numSegments = ControlRate::getNumSegments (numSamples);
+    modBuffer.setSize (1, numSamples, false, false, true);
 
-    phaseSmooth.process (*rateParam * MathConstants<float>::pi / fs, numSamples);
-    waveSmooth.process (*waveParam, numSamples);
+    // the LFO runs at control rate, so each step covers a whole segment
+    phaseSmooth.process (*rateParam * MathConstants<float>::pi / fs * ControlRate::getSegmentLength (numSamples), numSegments);
+    waveSmooth.process (*waveParam, numSegments);
 
     if (inputsConnected.contains (ModulationInput)) // make mono and pass samples through
     {
-        // get modulation buffer from input (-1, 1)
-        const auto& modInputBuffer = getInputBuffer (ModulationInput);
-        BufferHelpers::collapseToMonoBuffer (modInputBuffer, modOutBuffer);
+        // get modulation signal from input (-1, 1)
+        getModulationInput (ModulationInput, modOutSignal, numSamples);
     }
     else // create our own modulation signal
     {
-        // fill modulation buffer (-1, 1)
+        // fill modulation signal (-1, 1)
+        auto* modData = modOutSignal.startBlock (numSamples);
         if (! v1WaveParam->get())
-            fillWaveBuffer (modOutBuffer.getWritePointer (0), numSamples, phase);
+            fillWaveBuffer (modData, numSegments, phase);
         else
-            fillWaveBuffer_old (modOutBuffer.getWritePointer (0), numSamples, phase);
+            fillWaveBuffer_old (modData, numSegments, phase);
 
         // smooth out modulation signal
-        auto&& modBlock = dsp::AudioBlock<float> { modOutBuffer };
+        auto&& modBlock = dsp::AudioBlock<float> { &modData, 1, (size_t) numSegments };
         filter.process (dsp::ProcessContextReplacing<float> { modBlock });
     }
+    modOutSignal.upsample (modBuffer.getWritePointer (0), numSamples, ControlRate::Smoothing::Linear);
 
     if (inputsConnected.contains (AudioInput))
     {
@@ -215,7 +222,7 @@ void Tremolo::processAudio (AudioBuffer<float>& buffer)
         audioOutBuffer.setSize (numOutChannels, numSamples, false, false, true);
 
         // copy modulation data into channel 0 of audio output buffer, and shrink range to (0, 1)
-        audioOutBuffer.copyFrom (0, 0, modOutBuffer.getReadPointer (0), numSamples, 0.5f);
+        audioOutBuffer.copyFrom (0, 0, modBuffer.getReadPointer (0), numSamples, 0.5f);
         FloatVectorOperations::add (audioOutBuffer.getWritePointer (0), 0.5f, numSamples);
 
         // apply depth parameter
@@ -257,23 +264,21 @@ void Tremolo::processAudio (AudioBuffer<float>& buffer)
     }
 
     outputBuffers.getReference (AudioOutput) = audioOutBuffer;
-    outputBuffers.getReference (ModulationOutput) = modOutBuffer;
+    outputBuffers.getReference (ModulationOutput) = modOutSignal.getBuffer();
 }
 
 void Tremolo::processAudioBypassed (AudioBuffer<float>& buffer)
 {
     const auto numSamples = buffer.getNumSamples();
-    modOutBuffer.setSize (1, numSamples, false, false, true);
 
     if (inputsConnected.contains (ModulationInput)) // make mono and pass samples through
     {
-        // get modulation buffer from input (-1, 1)
-        const auto& modInputBuffer = getInputBuffer (ModulationInput);
-        BufferHelpers::collapseToMonoBuffer (modInputBuffer, modOutBuffer);
+        // get modulation signal from input (-1, 1)
+        getModulationInput (ModulationInput, modOutSignal, numSamples);
     }
     else
     {
-        modOutBuffer.clear();
+        modOutSignal.fill (numSamples, 0.0f);
     }
 
     if (inputsConnected.contains (AudioInput))
@@ -290,7 +295,7 @@ void Tremolo::processAudioBypassed (AudioBuffer<float>& buffer)
     }
 
     outputBuffers.getReference (AudioOutput) = audioOutBuffer;
-    outputBuffers.getReference (ModulationOutput) = modOutBuffer;
+    outputBuffers.getReference (ModulationOutput) = modOutSignal.getBuffer();
 }
 
 void Tremolo::fromXML (XmlElement* xml, const chowdsp::Version& version, bool loadPosition)
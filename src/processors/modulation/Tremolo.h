@@ -43,7 +43,8 @@ private:
 
     chowdsp::SVFLowpass<float> filter;
 
-    AudioBuffer<float> modOutBuffer;
+    ControlRate::Signal modOutSignal;
+    AudioBuffer<float> modBuffer;
     AudioBuffer<float> audioOutBuffer;
     chowdsp::SmoothedBufferValue<float> phaseSmooth;
     chowdsp::SmoothedBufferValue<float> waveSmooth;
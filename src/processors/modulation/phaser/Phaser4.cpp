@@ -1,5 +1,4 @@
 #include "Phaser4.h"
-#include "processors/BufferHelpers.h"
 #include "processors/ParameterHelpers.h"
 #include "processors/netlist_helpers/CircuitQuantity.h"
 
@@ -153,8 +152,7 @@ void Phaser4::processModulation (int numSamples)
     if (inputsConnected.contains (ModulationInput))
     {
         // get modulation buffer from input (-1, 1)
-        const auto& modInputBuffer = getInputBuffer (ModulationInput);
-        BufferHelpers::collapseToMonoBuffer (modInputBuffer, modOutBuffer);
+        getModulationInput (ModulationInput, modOutBuffer);
         for (auto [ch, data] : chowdsp::buffer_iters::channels (modOutBuffer))
             juce::FloatVectorOperations::clip (data.data(), data.data(), -1.0f, 1.0f, numSamples);
     }
@@ -239,8 +237,7 @@ void Phaser4::processAudioBypassed (AudioBuffer<float>& buffer)
     if (inputsConnected.contains (ModulationInput)) // make mono and pass samples through
     {
         // get modulation buffer from input (-1, 1)
-        const auto& modInputBuffer = getInputBuffer (ModulationInput);
-        BufferHelpers::collapseToMonoBuffer (modInputBuffer, modOutBuffer);
+        getModulationInput (ModulationInput, modOutBuffer);
     }
     else
     {
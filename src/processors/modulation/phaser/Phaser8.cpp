@@ -121,8 +121,7 @@ void Phaser8::processModulation (int numSamples)
     if (inputsConnected.contains (ModulationInput))
     {
         // get modulation buffer from input (-1, 1)
-        const auto& modInputBuffer = getInputBuffer (ModulationInput);
-        BufferHelpers::collapseToMonoBuffer (modInputBuffer, modOutBuffer);
+        getModulationInput (ModulationInput, modOutBuffer);
         FloatVectorOperations::clip (modOutBuffer.getWritePointer (0),
                                      modOutBuffer.getReadPointer (0),
                                      -1.0f,
@@ -199,8 +198,7 @@ void Phaser8::processAudioBypassed (AudioBuffer<float>& buffer)
     if (inputsConnected.contains (ModulationInput)) // make mono and pass samples through
     {
         // get modulation buffer from input (-1, 1)
-        const auto& modInputBuffer = getInputBuffer (ModulationInput);
-        BufferHelpers::collapseToMonoBuffer (modInputBuffer, modOutBuffer);
+        getModulationInput (ModulationInput, modOutBuffer);
     }
     else
     {
@@ -1,5 +1,4 @@
 #include "ScannerVibrato.h"
-#include "processors/BufferHelpers.h"
 #include "processors/ParameterHelpers.h"
 
 namespace ScannerVibratoTags
@@ -136,8 +135,7 @@ void ScannerVibrato::processAudio (AudioBuffer<float>& buffer)
     if (inputsConnected.contains (ModulationInput)) // make mono and pass samples through
     {
         // get modulation buffer from input (-1, 1)
-        const auto& modInputBuffer = getInputBuffer (ModulationInput);
-        BufferHelpers::collapseToMonoBuffer (modInputBuffer, modOutBuffer);
+        getModulationInput (ModulationInput, modOutBuffer);
     }
     else // create our own modulation signal
     {
@@ -238,8 +236,7 @@ void ScannerVibrato::processAudioBypassed (AudioBuffer<float>& buffer)
     if (inputsConnected.contains (ModulationInput)) // make mono and pass samples through
     {
         // get modulation buffer from input (-1, 1)
-        const auto& modInputBuffer = getInputBuffer (ModulationInput);
-        BufferHelpers::collapseToMonoBuffer (modInputBuffer, modOutBuffer);
+        getModulationInput (ModulationInput, modOutBuffer);
     }
     else
     {
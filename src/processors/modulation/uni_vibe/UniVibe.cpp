@@ -1,5 +1,4 @@
 #include "UniVibe.h"
-#include "processors/BufferHelpers.h"
 #include "processors/ParameterHelpers.h"
 
 namespace UniVibeTags
@@ -125,8 +124,7 @@ void UniVibe::processAudio (AudioBuffer<float>& buffer)
     if (inputsConnected.contains (ModulationInput)) // make mono and pass samples through
     {
         // get modulation buffer from input (-1, 1)
-        const auto& modInputBuffer = getInputBuffer (ModulationInput);
-        BufferHelpers::collapseToMonoBuffer (modInputBuffer, modOutBuffer);
+        getModulationInput (ModulationInput, modOutBuffer);
         for (auto [ch, data] : chowdsp::buffer_iters::channels (modOutBuffer))
             juce::FloatVectorOperations::clip (data.data(), data.data(), -1.0f, 1.0f, numSamples);
     }
@@ -234,8 +232,7 @@ void UniVibe::processAudioBypassed (AudioBuffer<float>& buffer)
     if (inputsConnected.contains (ModulationInput)) // make mono and pass samples through
     {
         // get modulation buffer from input (-1, 1)
-        const auto& modInputBuffer = getInputBuffer (ModulationInput);
-        BufferHelpers::collapseToMonoBuffer (modInputBuffer, modOutBuffer);
+        getModulationInput (ModulationInput, modOutBuffer);
     }
     else
     {
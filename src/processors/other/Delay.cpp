@@ -295,6 +295,15 @@ void DelayModule::processAudioBypassed (AudioBuffer<float>& buffer)
     outputBuffers[0] = buffer;
 }
 
+double DelayModule::getTailLengthSeconds() const
+{
+    // wait for the feedback to decay by 80 dB
+    const auto feedback = (double) std::pow (feedbackParam->getCurrentValue() * 0.67f, 0.9f);
+    const auto numRepeats = feedback > 0.0 ? std::log (1.0e-4) / std::log (feedback) : 0.0;
+    const auto delaySeconds = (double) delaySmooth.getTargetValue() / (double) fs;
+    return delaySeconds * (1.0 + numRepeats);
+}
+
 bool DelayModule::getCustomComponents (OwnedArray<Component>& customComps, chowdsp::HostContextProvider& hcp)
 {
     using namespace chowdsp::ParamUtils;
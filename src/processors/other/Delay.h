@@ -15,6 +15,7 @@ public:
     void releaseMemory() override;
     void processAudio (AudioBuffer<float>& buffer) override;
     void processAudioBypassed (AudioBuffer<float>& buffer) override;
+    double getTailLengthSeconds() const override;
 
 private:
     template <typename DelayType>
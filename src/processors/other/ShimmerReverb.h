@@ -13,6 +13,7 @@ public:
     void prepare (double sampleRate, int samplesPerBlock) override;
     void releaseMemory() override;
     void processAudio (AudioBuffer<float>& buffer) override;
+    double getTailLengthSeconds() const override { return 20.0; } // twice the longest decay time
 
 private:
     chowdsp::SmoothedBufferValue<float> shiftParam;
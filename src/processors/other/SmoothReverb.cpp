@@ -191,6 +191,13 @@ void SmoothReverb::processAudio (AudioBuffer<float>& buffer)
     outputBuffers.getReference (0) = outBuffer;
 }
 
+double SmoothReverb::getTailLengthSeconds() const
+{
+    // the decay time is ~60 dB, so let's wait for twice as long
+    const auto preDelaySeconds = (SmoothReverbTags::preDelay1LengthMs + SmoothReverbTags::preDelay2LengthMs) * 0.001f;
+    return 2.0 * (double) decayMsParam->getCurrentValue() * 0.001 + (double) preDelaySeconds;
+}
+
 void SmoothReverb::processAudioBypassed (AudioBuffer<float>& buffer)
 {
     outBuffer.makeCopyOf (buffer, true);
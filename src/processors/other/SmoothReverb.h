@@ -14,6 +14,7 @@ public:
     void releaseMemory() override;
     void processAudio (AudioBuffer<float>& buffer) override;
     void processAudioBypassed (AudioBuffer<float>& buffer) override;
+    double getTailLengthSeconds() const override;
 
 private:
     void processReverb (float* left, float* right, int numSamples);
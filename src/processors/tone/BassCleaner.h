@@ -12,6 +12,7 @@ public:
 
     void prepare (double sampleRate, int samplesPerBlock) override;
     void processAudio (AudioBuffer<float>& buffer) override;
+    double getTailLengthSeconds() const override { return getFilterTailLengthSeconds (toneStackLowestFreqHz); }
 
 private:
     inline void calcCoefs (float Rv1Val) noexcept
@@ -12,6 +12,7 @@ public:
 
     void prepare (double sampleRate, int samplesPerBlock) override;
     void processAudio (AudioBuffer<float>& buffer) override;
+    double getTailLengthSeconds() const override { return getFilterTailLengthSeconds (87.0, 0.45); } // the bass filter
 
 private:
     chowdsp::FloatParameter* bassParam = nullptr;
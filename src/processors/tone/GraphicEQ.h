@@ -12,6 +12,7 @@ public:
 
     void prepare (double sampleRate, int samplesPerBlock) override;
     void processAudio (AudioBuffer<float>& buffer) override;
+    double getTailLengthSeconds() const override { return getFilterTailLengthSeconds ((double) bandFreqs[0], 2.0); } // the lowest band, at its highest Q
 
 private:
     static constexpr int nBands = 6;
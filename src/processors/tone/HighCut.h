@@ -12,6 +12,7 @@ public:
 
     void prepare (double sampleRate, int samplesPerBlock) override;
     void processAudio (AudioBuffer<float>& buffer) override;
+    double getTailLengthSeconds() const override { return getFilterTailLengthSeconds ((double) cutoffParam->getCurrentValue()); }
 
     void fromXML (XmlElement* xml, const chowdsp::Version& version, bool loadPosition) override;
 
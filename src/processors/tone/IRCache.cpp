@@ -0,0 +1,181 @@
+#include "IRCache.h"
+
+namespace
+{
+size_t hashBytes (const void* data, size_t numBytes)
+{
+    return std::hash<std::string_view> {}(std::string_view { static_cast<const char*> (data), numBytes });
+}
+
+AudioBuffer<float> fixNumChannels (const AudioBuffer<float>& buffer, dsp::Convolution::Stereo stereo)
+{
+    const auto numChannels = jmin (buffer.getNumChannels(), stereo == dsp::Convolution::Stereo::yes ? 2 : 1);
+    AudioBuffer<float> result { jmax (1, numChannels), jmax (1, buffer.getNumSamples()) };
+    result.clear();
+
+    if (numChannels == 0 || buffer.getNumSamples() == 0)
+    {
+        result.setSample (0, 0, 1.0f); // an empty IR should just pass the signal through
+        return result;
+    }
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        result.copyFrom (ch, 0, buffer, ch, 0, buffer.getNumSamples());
+    return result;
+}
+
+/** Removes any silence from the start and end of the IR. */
+AudioBuffer<float> trimImpulseResponse (const AudioBuffer<float>& buffer)
+{
+    const auto threshold = Decibels::decibelsToGain (-80.0f);
+    const auto numSamples = buffer.getNumSamples();
+
+    auto firstIndex = numSamples;
+    auto lastIndex = 0;
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    {
+        const auto* data = buffer.getReadPointer (ch);
+        const auto isAboveThreshold = [threshold] (float x)
+        { return std::abs (x) >= threshold; };
+
+        const auto* firstAbove = std::find_if (data, data + numSamples, isAboveThreshold);
+        firstIndex = jmin (firstIndex, (int) std::distance (data, firstAbove));
+
+        const auto lastAbove = std::find_if (std::make_reverse_iterator (data + numSamples), std::make_reverse_iterator (data), isAboveThreshold);
+        lastIndex = jmax (lastIndex, (int) std::distance (data, lastAbove.base()));
+    }
+
+    if (firstIndex >= lastIndex)
+        return buffer;
+
+    AudioBuffer<float> result { buffer.getNumChannels(), lastIndex - firstIndex };
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        result.copyFrom (ch, 0, buffer, ch, firstIndex, result.getNumSamples());
+    return result;
+}
+
+AudioBuffer<float> resampleImpulseResponse (const AudioBuffer<float>& buffer, double sourceSampleRate, double destSampleRate)
+{
+    if (approximatelyEqual (sourceSampleRate, destSampleRate))
+        return buffer;
+
+    const auto resampleRatio = sourceSampleRate / destSampleRate;
+    const auto resampledNumSamples = roundToInt (jmax (1.0, (double) buffer.getNumSamples() / resampleRatio));
+
+    AudioBuffer<float> source { buffer };
+    MemoryAudioSource memorySource { source, false };
+    ResamplingAudioSource resamplingSource { &memorySource, false, buffer.getNumChannels() };
+    resamplingSource.setResamplingRatio (resampleRatio);
+    resamplingSource.prepareToPlay (resampledNumSamples, sourceSampleRate);
+
+    AudioBuffer<float> result { buffer.getNumChannels(), resampledNumSamples };
+    resamplingSource.getNextAudioBlock ({ &result, 0, result.getNumSamples() });
+    return result;
+}
+
+void normaliseImpulseResponse (AudioBuffer<float>& buffer)
+{
+    auto maxSumSquared = 0.0f;
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    {
+        const auto* data = buffer.getReadPointer (ch);
+        maxSumSquared = jmax (maxSumSquared, std::inner_product (data, data + buffer.getNumSamples(), data, 0.0f));
+    }
+
+    if (maxSumSquared > 0.0f)
+        buffer.applyGain (0.125f / std::sqrt (maxSumSquared));
+}
+} // namespace
+
+IRCache::IRCache()
+{
+    formatManager.registerBasicFormats();
+}
+
+IRCache::Key IRCache::makeKey (size_t contentHash, const Settings& settings)
+{
+    return std::make_tuple (contentHash,
+                            settings.sampleRate,
+                            settings.partitionSize,
+                            (int) settings.stereo,
+                            (int) settings.trim,
+                            (int) settings.normalise,
+                            settings.maxLengthSamples);
+}
+
+std::shared_ptr<const PartitionedIR> IRCache::getImpulseResponse (const void* audioFileData, size_t audioFileDataSize, const Settings& settings)
+{
+    const auto key = makeKey (hashBytes (audioFileData, audioFileDataSize), settings);
+    if (auto ir = findImpulseResponse (key))
+        return ir;
+
+    AudioBuffer<float> buffer;
+    double bufferSampleRate;
+    {
+        const std::lock_guard lock { formatManagerMutex };
+        std::unique_ptr<AudioFormatReader> reader (formatManager.createReaderFor (std::make_unique<MemoryInputStream> (audioFileData, audioFileDataSize, false)));
+        if (reader == nullptr)
+            return {};
+
+        const auto fileLength = (size_t) reader->lengthInSamples;
+        const auto lengthToLoad = settings.maxLengthSamples == 0 ? fileLength : jmin (settings.maxLengthSamples, fileLength);
+        buffer.setSize (jlimit (1, 2, (int) reader->numChannels), (int) lengthToLoad);
+        if (! reader->read (buffer.getArrayOfWritePointers(), buffer.getNumChannels(), 0, buffer.getNumSamples()))
+            return {};
+
+        bufferSampleRate = reader->sampleRate;
+    }
+
+    return insertImpulseResponse (key, createImpulseResponse (buffer, bufferSampleRate, settings));
+}
+
+size_t IRCache::getNumCachedImpulseResponses()
+{
+    const std::lock_guard lock { mutex };
+    return (size_t) std::count_if (cache.begin(), cache.end(), [] (const auto& entry)
+                                   { return ! entry.second.expired(); });
+}
+
+std::shared_ptr<const PartitionedIR> IRCache::findImpulseResponse (const Key& key)
+{
+    const std::lock_guard lock { mutex };
+    if (auto iter = cache.find (key); iter != cache.end())
+        return iter->second.lock();
+    return {};
+}
+
+std::shared_ptr<const PartitionedIR> IRCache::insertImpulseResponse (const Key& key, std::shared_ptr<const PartitionedIR>&& ir)
+{
+    const std::lock_guard lock { mutex };
+
+    // if another thread has created the same IR in the meantime, then we should use that one instead
+    auto& entry = cache[key];
+    if (auto existingIR = entry.lock())
+        return existingIR;
+    entry = ir;
+
+    for (auto iter = cache.begin(); iter != cache.end();)
+    {
+        if (iter->second.expired())
+            iter = cache.erase (iter);
+        else
+            ++iter;
+    }
+
+    return std::move (ir);
+}
+
+std::shared_ptr<const PartitionedIR> IRCache::createImpulseResponse (const AudioBuffer<float>& buffer, double bufferSampleRate, const Settings& settings)
+{
+    auto irBuffer = fixNumChannels (buffer, settings.stereo);
+    if (settings.trim == dsp::Convolution::Trim::yes)
+        irBuffer = trimImpulseResponse (irBuffer);
+
+    auto resampledBuffer = resampleImpulseResponse (irBuffer, bufferSampleRate, settings.sampleRate);
+    if (settings.normalise == dsp::Convolution::Normalise::yes)
+        normaliseImpulseResponse (resampledBuffer);
+    else
+        resampledBuffer.applyGain ((float) (bufferSampleRate / settings.sampleRate));
+
+    return std::make_shared<const PartitionedIR> (resampledBuffer, settings.sampleRate, settings.partitionSize);
+}
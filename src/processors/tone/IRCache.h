@@ -0,0 +1,52 @@
+#pragma once
+
+#include "PartitionedConvolution.h"
+
+/**
+ * A process-wide cache of partitioned impulse responses.
+ *
+ * IRs are keyed by a hash of their content, along with the settings used to
+ * prepare them (sample rate, trimming, etc.), so that every convolution in the
+ * process that uses the same IR shares one read-only copy of the resampled,
+ * partitioned spectra. The cache only holds weak references, so an IR is
+ * freed once the last convolution engine using it has been destroyed.
+ *
+ * Use with SharedResourcePointer<IRCache>.
+ */
+class IRCache
+{
+public:
+    IRCache();
+
+    struct Settings
+    {
+        double sampleRate = 48000.0;
+        int partitionSize = 512;
+        dsp::Convolution::Stereo stereo = dsp::Convolution::Stereo::yes;
+        dsp::Convolution::Trim trim = dsp::Convolution::Trim::yes;
+        dsp::Convolution::Normalise normalise = dsp::Convolution::Normalise::yes;
+        size_t maxLengthSamples = 0; // zero for no limit
+    };
+
+    /** Returns the IR for some audio file data (or nullptr if the data can't be read). */
+    std::shared_ptr<const PartitionedIR> getImpulseResponse (const void* audioFileData, size_t audioFileDataSize, const Settings& settings);
+
+    /** Returns the number of IRs that are currently in use. */
+    size_t getNumCachedImpulseResponses();
+
+private:
+    using Key = std::tuple<size_t, double, int, int, int, int, size_t>;
+    static Key makeKey (size_t contentHash, const Settings& settings);
+
+    std::shared_ptr<const PartitionedIR> findImpulseResponse (const Key& key);
+    std::shared_ptr<const PartitionedIR> insertImpulseResponse (const Key& key, std::shared_ptr<const PartitionedIR>&& ir);
+    static std::shared_ptr<const PartitionedIR> createImpulseResponse (const AudioBuffer<float>& buffer, double bufferSampleRate, const Settings& settings);
+
+    std::mutex mutex;
+    std::map<Key, std::weak_ptr<const PartitionedIR>> cache;
+
+    std::mutex formatManagerMutex;
+    AudioFormatManager formatManager;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (IRCache)
+};
@@ -0,0 +1,416 @@
+#include "IRConvolution.h"
+
+namespace
+{
+constexpr int minPartitionSize = 128;
+constexpr double crossfadeTimeSeconds = 0.03;
+constexpr int requestPollIntervalMs = 10;
+constexpr int retiredEnginesCheckIntervalMs = 500;
+} // namespace
+
+IRConvolution::LoadingState::~LoadingState()
+{
+    clearEngines();
+}
+
+std::shared_ptr<const IRConvolution::IRSource> IRConvolution::LoadingState::getRequestedSource() const
+{
+    const auto index = requestedIndex.load();
+    if (index == customSourceIndex)
+        return customSource;
+
+    if (! juce::isPositiveAndBelow (index, (int) sources.size()))
+        return {};
+
+    return sources[(size_t) index];
+}
+
+void IRConvolution::LoadingState::publish (std::unique_ptr<Engine>&& engine, int engineGeneration)
+{
+    const std::lock_guard lock { mutex };
+
+    // the convolution has been re-prepared (or destroyed) since this engine was requested
+    if (engineGeneration != generation)
+        return;
+
+    // if the audio thread hasn't picked up the previous pending engine yet, then it never will
+    deleteRetiredEngines();
+    delete pendingEngine.exchange (engine.release());
+}
+
+void IRConvolution::LoadingState::clearEngines()
+{
+    delete pendingEngine.exchange (nullptr);
+    deleteRetiredEngines();
+}
+
+bool IRConvolution::LoadingState::retire (Engine* engine) noexcept
+{
+    for (auto& retiredEngine : retiredEngines)
+    {
+        Engine* emptySlot = nullptr;
+        if (retiredEngine.compare_exchange_strong (emptySlot, engine))
+            return true;
+    }
+
+    return false;
+}
+
+void IRConvolution::LoadingState::deleteRetiredEngines()
+{
+    for (auto& retiredEngine : retiredEngines)
+        delete retiredEngine.exchange (nullptr);
+}
+
+//======================================================================
+IRConvolution::LoadingThread::LoadingThread() : Thread ("IR Loading Thread")
+{
+    startThread();
+}
+
+IRConvolution::LoadingThread::~LoadingThread()
+{
+    signalThreadShouldExit();
+    notify();
+    stopThread (5000);
+}
+
+void IRConvolution::LoadingThread::addState (const std::shared_ptr<LoadingState>& state)
+{
+    const std::lock_guard lock { statesMutex };
+    states.push_back (state);
+}
+
+void IRConvolution::LoadingThread::removeState (const std::shared_ptr<LoadingState>& state)
+{
+    const std::lock_guard lock { statesMutex };
+    const auto isExpiredOrRemoved = [&state] (const std::weak_ptr<LoadingState>& weakState)
+    {
+        const auto lockedState = weakState.lock();
+        return lockedState == nullptr || lockedState == state;
+    };
+    states.erase (std::remove_if (states.begin(), states.end(), isExpiredOrRemoved), states.end());
+}
+
+std::unique_ptr<IRConvolution::Engine> IRConvolution::LoadingThread::createEngine (IRCache& cache, const IRSource& source, IRCache::Settings settings)
+{
+    auto ir = cache.getImpulseResponse (source.data, source.dataSize, settings);
+    if (ir == nullptr)
+        return {};
+
+    return std::make_unique<Engine> (std::move (ir), 2);
+}
+
+void IRConvolution::LoadingThread::handleRequests (LoadingState& state)
+{
+    while (! threadShouldExit())
+    {
+        std::shared_ptr<const IRSource> source;
+        IRCache::Settings settings;
+        int generation;
+        {
+            const std::lock_guard lock { state.mutex };
+            const auto numRequests = state.numRequests.load();
+            if (numRequests == state.numRequestsHandled)
+                return;
+
+            // if there have been several requests since we last checked, we only need to load the latest one
+            state.numRequestsHandled = numRequests;
+            if (! state.isPrepared)
+                return; // the engine will be created when the convolution is prepared
+
+            source = state.getRequestedSource();
+            if (source == nullptr)
+                continue;
+
+            settings = source->settings;
+            settings.sampleRate = state.sampleRate;
+            settings.partitionSize = state.partitionSize;
+            generation = state.generation;
+        }
+
+        if (auto engine = createEngine (irCache.get(), *source, settings))
+            state.publish (std::move (engine), generation);
+    }
+}
+
+void IRConvolution::LoadingThread::run()
+{
+    int msSinceRetiredEnginesCheck = 0;
+    while (! threadShouldExit())
+    {
+        // Waking this thread up would mean locking a mutex, which the audio thread can't do,
+        // so instead we check for new requests (and retired engines) every so often.
+        wait (requestPollIntervalMs);
+
+        msSinceRetiredEnginesCheck += requestPollIntervalMs;
+        const auto shouldCheckRetiredEngines = msSinceRetiredEnginesCheck >= retiredEnginesCheckIntervalMs;
+        const auto shouldHandleRequests = loadRequested.exchange (false);
+        if (! shouldCheckRetiredEngines && ! shouldHandleRequests)
+            continue;
+
+        isBusy.store (true);
+        std::vector<std::shared_ptr<LoadingState>> statesToCheck;
+        {
+            const std::lock_guard lock { statesMutex };
+            for (auto& weakState : states)
+                if (auto state = weakState.lock())
+                    statesToCheck.push_back (std::move (state));
+        }
+
+        for (auto& state : statesToCheck)
+        {
+            state->deleteRetiredEngines();
+            handleRequests (*state);
+        }
+
+        msSinceRetiredEnginesCheck = 0;
+        isBusy.store (false);
+    }
+}
+
+bool IRConvolution::LoadingThread::isIdle()
+{
+    // The requests need to be checked before the busy flag: the thread is always
+    // busy while it's handling a request that it has already marked as handled.
+    {
+        const std::lock_guard lock { statesMutex };
+        for (auto& weakState : states)
+        {
+            if (auto state = weakState.lock())
+            {
+                const std::lock_guard stateLock { state->mutex };
+                if (state->isPrepared && state->numRequests.load() != state->numRequestsHandled)
+                    return false;
+            }
+        }
+    }
+
+    return ! isBusy.load();
+}
+
+//======================================================================
+IRConvolution::IRConvolution()
+{
+    loadingThread->addState (loadingState);
+}
+
+IRConvolution::~IRConvolution()
+{
+    loadingThread->removeState (loadingState);
+
+    // make sure that any engines that are still being loaded are thrown away
+    const std::lock_guard lock { loadingState->mutex };
+    loadingState->generation++;
+}
+
+int IRConvolution::addImpulseResponse (const void* audioFileData, size_t audioFileDataSize, const IRCache::Settings& settings)
+{
+    auto source = std::make_shared<IRSource>();
+    source->data = audioFileData;
+    source->dataSize = audioFileDataSize;
+    source->settings = settings;
+
+    const std::lock_guard lock { loadingState->mutex };
+    loadingState->sources.push_back (std::move (source));
+    return (int) loadingState->sources.size() - 1;
+}
+
+void IRConvolution::loadImpulseResponse (int index)
+{
+    // the index must be stored before the request is counted, so the loading thread is guaranteed to see it
+    loadingState->requestedIndex.store (index);
+    loadingState->numRequests.fetch_add (1);
+    loadingThread->requestLoad();
+}
+
+void IRConvolution::loadImpulseResponse (MemoryBlock&& audioFileData, const IRCache::Settings& settings)
+{
+    auto source = std::make_shared<IRSource>();
+    source->ownedData = std::move (audioFileData);
+    source->data = source->ownedData.getData();
+    source->dataSize = source->ownedData.getSize();
+    source->settings = settings;
+
+    {
+        const std::lock_guard lock { loadingState->mutex };
+        loadingState->customSource = std::move (source);
+    }
+
+    loadImpulseResponse (customSourceIndex);
+}
+
+void IRConvolution::prepare (double sampleRate, int samplesPerBlock, int oversamplingFactor)
+{
+    // the processor chain always uses a block size that's a multiple of the oversampling factor
+    jassert (samplesPerBlock % oversamplingFactor == 0);
+
+    resampleFactor = oversamplingFactor;
+    convolutionSampleRate = sampleRate / (double) resampleFactor;
+    const auto convolutionBlockSize = samplesPerBlock / resampleFactor;
+
+    std::shared_ptr<const IRSource> source;
+    IRCache::Settings settings;
+    std::unique_ptr<Engine> previousPendingEngine;
+    {
+        const std::lock_guard lock { loadingState->mutex };
+        loadingState->generation++;
+        previousPendingEngine.reset (loadingState->pendingEngine.exchange (nullptr));
+        loadingState->clearEngines();
+        loadingState->sampleRate = convolutionSampleRate;
+        loadingState->partitionSize = jmax (minPartitionSize, nextPowerOfTwo (convolutionBlockSize));
+        loadingState->isPrepared = true;
+        loadingState->numRequestsHandled = loadingState->numRequests.load();
+
+        source = loadingState->getRequestedSource();
+        if (source != nullptr)
+        {
+            settings = source->settings;
+            settings.sampleRate = loadingState->sampleRate;
+            settings.partitionSize = loadingState->partitionSize;
+        }
+    }
+
+    // The audio thread isn't running right now, so we can create the engine here.
+    // The old engines need to stay alive until the new one has been created, otherwise
+    // the IR would be dropped from the cache, and we'd have to load it all over again.
+    auto previousEngine = std::move (currentEngine);
+    if (source != nullptr)
+        currentEngine = LoadingThread::createEngine (loadingThread->irCache.get(), *source, settings);
+    previousEngine.reset();
+    previousPendingEngine.reset();
+    fadingOutEngine.reset();
+    currentIRLengthSamples.store (currentEngine != nullptr ? currentEngine->getImpulseResponse().irLengthSamples : 0);
+
+    crossfade.reset (convolutionSampleRate, crossfadeTimeSeconds);
+    crossfade.setCurrentAndTargetValue (1.0f);
+    fadeBuffer.setSize (2, convolutionBlockSize);
+
+    if (resampleFactor > 1)
+    {
+        downsampler.prepare ({ sampleRate, (uint32) samplesPerBlock, 2 }, resampleFactor);
+        upsampler.prepare ({ convolutionSampleRate, (uint32) convolutionBlockSize, 2 }, resampleFactor);
+        downsampledBuffer.setSize (2, convolutionBlockSize);
+    }
+    else
+    {
+        downsampledBuffer.setSize (0, 0);
+    }
+}
+
+void IRConvolution::process (const dsp::ProcessContextReplacing<float>& context) noexcept
+{
+    if (resampleFactor == 1)
+    {
+        processConvolution (context.getOutputBlock());
+        return;
+    }
+
+    auto& block = context.getOutputBlock();
+    const auto numChannels = (int) block.getNumChannels();
+    const auto numSamples = (int) block.getNumSamples();
+    const auto dsNumSamples = numSamples / resampleFactor;
+
+    downsampledBuffer.setSize (numChannels, dsNumSamples, false, false, true);
+    for (int ch = 0; ch < numChannels; ++ch)
+        downsampler.process (block.getChannelPointer ((size_t) ch), downsampledBuffer.getWritePointer (ch), ch, numSamples);
+
+    processConvolution (dsp::AudioBlock<float> { downsampledBuffer });
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        upsampler.process (downsampledBuffer.getReadPointer (ch), block.getChannelPointer ((size_t) ch), ch, dsNumSamples);
+}
+
+void IRConvolution::retireFadingOutEngine() noexcept
+{
+    // if the retire queue is full, we'll hang on to the engine and try again on the next block
+    if (fadingOutEngine != nullptr && ! crossfade.isSmoothing() && loadingState->retire (fadingOutEngine.get()))
+        fadingOutEngine.release();
+}
+
+void IRConvolution::processConvolution (const dsp::AudioBlock<float>& block) noexcept
+{
+    retireFadingOutEngine();
+
+    // only pick up a new engine once we're done with the previous one
+    if (fadingOutEngine == nullptr)
+    {
+        if (auto* newEngine = loadingState->pendingEngine.exchange (nullptr))
+        {
+            fadingOutEngine = std::move (currentEngine);
+            currentEngine.reset (newEngine);
+
+            const auto newIRLength = currentEngine->getImpulseResponse().irLengthSamples;
+            if (fadingOutEngine != nullptr)
+            {
+                crossfade.setCurrentAndTargetValue (0.0f);
+                crossfade.setTargetValue (1.0f);
+                currentIRLengthSamples.store (jmax (newIRLength, fadingOutEngine->getImpulseResponse().irLengthSamples));
+            }
+            else
+            {
+                currentIRLengthSamples.store (newIRLength);
+            }
+        }
+    }
+
+    // no IR has been loaded yet, so just pass the signal through
+    if (currentEngine == nullptr)
+        return;
+
+    const auto numChannels = (int) block.getNumChannels();
+    const auto numSamples = (int) block.getNumSamples();
+    const auto isCrossfading = fadingOutEngine != nullptr && crossfade.isSmoothing();
+
+    if (isCrossfading)
+    {
+        fadeBuffer.setSize (numChannels, numSamples, false, false, true);
+        for (int ch = 0; ch < numChannels; ++ch)
+            FloatVectorOperations::copy (fadeBuffer.getWritePointer (ch), block.getChannelPointer ((size_t) ch), numSamples);
+    }
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto* data = block.getChannelPointer ((size_t) ch);
+        currentEngine->process (data, data, ch, numSamples);
+    }
+
+    if (! isCrossfading)
+        return;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto* data = fadeBuffer.getWritePointer (ch);
+        fadingOutEngine->process (data, data, ch, numSamples);
+    }
+
+    // The two IRs are mostly uncorrelated, so an equal-power crossfade
+    // avoids a dip in the level halfway through the crossfade.
+    for (int n = 0; n < numSamples; ++n)
+    {
+        const auto fadeAngle = crossfade.getNextValue() * MathConstants<float>::halfPi;
+        const auto fadeInGain = std::sin (fadeAngle);
+        const auto fadeOutGain = std::cos (fadeAngle);
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto& y = block.getChannelPointer ((size_t) ch)[n];
+            y = fadeInGain * y + fadeOutGain * fadeBuffer.getSample (ch, n);
+        }
+    }
+
+    if (! crossfade.isSmoothing())
+    {
+        currentIRLengthSamples.store (currentEngine->getImpulseResponse().irLengthSamples);
+        retireFadingOutEngine();
+    }
+}
+
+double IRConvolution::getTailLengthSeconds() const
+{
+    return (double) currentIRLengthSamples.load() / convolutionSampleRate;
+}
+
+bool IRConvolution::isBackgroundLoadingIdle()
+{
+    return SharedResourcePointer<LoadingThread>()->isIdle();
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "IRCache.h"
+
+/**
+ * Convolution with an impulse response (e.g. a guitar cabinet), which
+ * always runs at the host sample rate.
+ *
+ * When the module is being processed at an oversampled rate, the signal is
+ * decimated down to the host rate, convolved, and then interpolated back up.
+ * The IRs don't have any useful content above the host's Nyquist frequency,
+ * so there's no point in paying for a convolution (and an IR) that's 8 or 16
+ * times longer than it needs to be.
+ *
+ * The partitioned IRs come from the shared IRCache, so instances using the
+ * same IR share the same memory. IRs are decoded, resampled, normalised and
+ * partitioned on a shared loading thread, and the new convolution engine is
+ * handed over to the audio thread without any locks, and crossfaded in with
+ * a short equal-power crossfade.
+ */
+class IRConvolution
+{
+public:
+    IRConvolution();
+    ~IRConvolution();
+
+    /**
+     * Adds an IR from some audio file data, which must outlive the convolution
+     * (e.g. BinaryData), and returns the index of the IR. This should only be
+     * called while setting up the convolution (i.e. in the module's constructor).
+     *
+     * The sample rate and partition size in the settings are set by the convolution.
+     */
+    int addImpulseResponse (const void* audioFileData, size_t audioFileDataSize, const IRCache::Settings& settings = {});
+
+    /**
+     * Switches to one of the IRs added with addImpulseResponse().
+     * This is real-time safe (it only sets some atomics, which the loading
+     * thread polls), so it can be called from the audio thread.
+     */
+    void loadImpulseResponse (int index);
+
+    /** Loads an IR from some audio file data, (e.g. a user's IR file). */
+    void loadImpulseResponse (MemoryBlock&& audioFileData, const IRCache::Settings& settings = {});
+
+    void prepare (double sampleRate, int samplesPerBlock, int oversamplingFactor);
+    void process (const dsp::ProcessContextReplacing<float>& context) noexcept;
+
+    /** Returns the sample rate that the convolution is running at. */
+    double getConvolutionSampleRate() const noexcept { return convolutionSampleRate; }
+
+    /** Returns the length of the current IR in seconds. */
+    double getTailLengthSeconds() const;
+
+    /** Returns true if the shared loading thread has no IRs left to load, (useful for tests). */
+    static bool isBackgroundLoadingIdle();
+
+private:
+    struct IRSource
+    {
+        const void* data = nullptr;
+        size_t dataSize = 0;
+        MemoryBlock ownedData {};
+        IRCache::Settings settings {};
+    };
+
+    using Engine = PartitionedConvolutionEngine;
+
+    /** The state that's shared between the convolution, the loading thread, and the audio thread. */
+    struct LoadingState
+    {
+        ~LoadingState();
+        std::shared_ptr<const IRSource> getRequestedSource() const;
+        void publish (std::unique_ptr<Engine>&& engine, int engineGeneration);
+        void clearEngines();
+
+        /** Hands an engine that the audio thread is done with back to the loading thread (returns false if the queue is full). */
+        bool retire (Engine* engine) noexcept;
+        void deleteRetiredEngines();
+
+        std::mutex mutex; // never locked by the audio thread
+        std::vector<std::shared_ptr<const IRSource>> sources;
+        std::shared_ptr<const IRSource> customSource;
+        double sampleRate = 48000.0;
+        int partitionSize = 512;
+        bool isPrepared = false;
+        int generation = 0;
+        uint32_t numRequestsHandled = 0;
+
+        std::atomic_int requestedIndex { 0 };
+        std::atomic<uint32_t> numRequests { 0 };
+
+        std::atomic<Engine*> pendingEngine { nullptr };
+
+        static constexpr size_t retireQueueSize = 4;
+        std::array<std::atomic<Engine*>, retireQueueSize> retiredEngines {};
+    };
+
+    /** A single background thread that does the loading for every convolution in the process. */
+    struct LoadingThread : private Thread
+    {
+        LoadingThread();
+        ~LoadingThread() override;
+
+        void addState (const std::shared_ptr<LoadingState>& state);
+        void removeState (const std::shared_ptr<LoadingState>& state);
+        void requestLoad() noexcept { loadRequested.store (true); }
+
+        static std::unique_ptr<Engine> createEngine (IRCache& cache, const IRSource& source, IRCache::Settings settings);
+        void handleRequests (LoadingState& state);
+        void run() override;
+        bool isIdle();
+
+        SharedResourcePointer<IRCache> irCache;
+
+        std::mutex statesMutex;
+        std::vector<std::weak_ptr<LoadingState>> states;
+        std::atomic_bool loadRequested { false };
+        std::atomic_bool isBusy { false };
+    };
+
+    void processConvolution (const dsp::AudioBlock<float>& block) noexcept;
+    void retireFadingOutEngine() noexcept;
+
+    static constexpr int customSourceIndex = -1;
+
+    double convolutionSampleRate = 48000.0;
+
+    SharedResourcePointer<LoadingThread> loadingThread;
+    std::shared_ptr<LoadingState> loadingState = std::make_shared<LoadingState>();
+
+    std::unique_ptr<Engine> currentEngine;
+    std::unique_ptr<Engine> fadingOutEngine;
+    SmoothedValue<float, ValueSmoothingTypes::Linear> crossfade;
+    AudioBuffer<float> fadeBuffer;
+    std::atomic_int currentIRLengthSamples { 0 };
+
+    using AAFilter = chowdsp::ButterworthFilter<8>;
+    chowdsp::Downsampler<float, AAFilter, false> downsampler;
+    chowdsp::Upsampler<float, AAFilter, false> upsampler;
+    AudioBuffer<float> downsampledBuffer;
+    int resampleFactor = 1;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (IRConvolution)
+};
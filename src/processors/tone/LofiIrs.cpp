@@ -21,8 +21,7 @@ const String mixTag = "mix";
 const String gainTag = "gain";
 } // namespace LofiIRTags
 
-LofiIrs::LofiIrs (UndoManager* um) : BaseProcessor ("LoFi IRs", createParameterLayout(), um),
-                                     convolution (getSharedConvolutionMessageQueue())
+LofiIrs::LofiIrs (UndoManager* um) : BaseProcessor ("LoFi IRs", createParameterLayout(), um)
 {
     for (const auto& irName : LofiIRTags::irNames)
     {
@@ -30,7 +29,7 @@ LofiIrs::LofiIrs (UndoManager* um) : BaseProcessor ("LoFi IRs", createParameterL
         int binarySize;
         auto* irData = BinaryData::getNamedResource (binaryName.getCharPointer(), binarySize);
 
-        irMap.insert (std::make_pair (irName, std::make_pair ((void*) irData, (size_t) binarySize)));
+        convolution.addImpulseResponse (irData, (size_t) binarySize);
     }
 
     using namespace ParameterHelpers;
@@ -70,24 +69,23 @@ void LofiIrs::parameterChanged (const String& parameterID, float newValue)
     if (parameterID != LofiIRTags::irTag)
         return;
 
-    auto irIdx = (int) newValue;
-    auto& irData = irMap[LofiIRTags::irNames[irIdx]];
-    convolution.loadImpulseResponse (irData.first, irData.second, dsp::Convolution::Stereo::yes, dsp::Convolution::Trim::yes, 0);
+    convolution.loadImpulseResponse ((int) newValue);
 }
 
 void LofiIrs::prepare (double sampleRate, int samplesPerBlock)
 {
-    dsp::ProcessSpec spec { sampleRate, (uint32) samplesPerBlock, 2 };
-    convolution.prepare (spec);
+    // load the IR first, so that the convolution engine is ready as soon as we're prepared
     parameterChanged (LofiIRTags::irTag, vts.getRawParameterValue (LofiIRTags::irTag)->load());
+    convolution.prepare (sampleRate, samplesPerBlock, getOversamplingFactor());
 
+    dsp::ProcessSpec spec { sampleRate, (uint32) samplesPerBlock, 2 };
     gain.prepare (spec);
     gain.setRampDurationSeconds (0.01);
 
     dryWetMixer.prepare (spec);
     dryWetMixerMono.prepare ({ sampleRate, (uint32) samplesPerBlock, 1 });
 
-    makeupGainDB = Decibels::gainToDecibels (std::sqrt (96000.0f / (float) sampleRate));
+    makeupGainDB = Decibels::gainToDecibels (std::sqrt (96000.0f / (float) convolution.getConvolutionSampleRate()));
 }
 
 void LofiIrs::processAudio (AudioBuffer<float>& buffer)
@@ -106,3 +104,8 @@ void LofiIrs::processAudio (AudioBuffer<float>& buffer)
     gain.process (context);
     dryWet.mixWetSamples (block);
 }
+
+double LofiIrs::getTailLengthSeconds() const
+{
+    return convolution.getTailLengthSeconds();
+}
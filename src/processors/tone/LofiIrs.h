@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../BaseProcessor.h"
+#include "IRConvolution.h"
 
 class LofiIrs : public BaseProcessor, private AudioProcessorValueTreeState::Listener
 {
@@ -15,15 +16,13 @@ public:
 
     void prepare (double sampleRate, int samplesPerBlock) override;
     void processAudio (AudioBuffer<float>& buffer) override;
+    double getTailLengthSeconds() const override;
 
 private:
     chowdsp::FloatParameter* mixParam = nullptr;
     chowdsp::FloatParameter* gainParam = nullptr;
 
-    using IRType = std::pair<void*, size_t>;
-    std::unordered_map<String, IRType> irMap;
-
-    dsp::Convolution convolution;
+    IRConvolution convolution;
     dsp::Gain<float> gain;
 
     float makeupGainDB = 0.0f;
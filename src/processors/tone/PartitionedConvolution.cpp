@@ -0,0 +1,139 @@
+#include "PartitionedConvolution.h"
+
+namespace
+{
+int getFFTOrder (int partitionSize)
+{
+    jassert (isPowerOfTwo (partitionSize));
+    return roundToInt (std::log2 (2 * partitionSize));
+}
+
+/** Multiplies two spectra (interleaved complex values), and adds the result to the output. */
+void complexMultiplyAccumulate (const float* a, const float* b, float* output, int spectrumSize) noexcept
+{
+    for (int i = 0; i < spectrumSize; i += 2)
+    {
+        output[i] += a[i] * b[i] - a[i + 1] * b[i + 1];
+        output[i + 1] += a[i] * b[i + 1] + a[i + 1] * b[i];
+    }
+}
+} // namespace
+
+PartitionedIR::PartitionedIR (const AudioBuffer<float>& impulseResponse, double irSampleRate, int partitionSizeToUse)
+    : sampleRate (irSampleRate),
+      partitionSize (partitionSizeToUse),
+      fftSize (2 * partitionSizeToUse),
+      spectrumSize (fftSize + 2),
+      numPartitions (jmax (1, (impulseResponse.getNumSamples() + partitionSizeToUse - 1) / partitionSizeToUse)),
+      numChannels (jmax (1, impulseResponse.getNumChannels())),
+      irLengthSamples (impulseResponse.getNumSamples())
+{
+    const dsp::FFT fft { getFFTOrder (partitionSize) };
+    std::vector<float> fftData ((size_t) fftSize * 2, 0.0f);
+
+    spectra.resize ((size_t) numChannels, std::vector<float> ((size_t) (numPartitions * spectrumSize), 0.0f));
+    for (int ch = 0; ch < impulseResponse.getNumChannels(); ++ch)
+    {
+        for (int partitionIndex = 0; partitionIndex < numPartitions; ++partitionIndex)
+        {
+            const auto startSample = partitionIndex * partitionSize;
+            const auto numSamples = jmin (partitionSize, irLengthSamples - startSample);
+
+            std::fill (fftData.begin(), fftData.end(), 0.0f);
+            FloatVectorOperations::copy (fftData.data(), impulseResponse.getReadPointer (ch, startSample), numSamples);
+            fft.performRealOnlyForwardTransform (fftData.data(), true);
+
+            std::copy (fftData.begin(), fftData.begin() + spectrumSize, spectra[(size_t) ch].begin() + partitionIndex * spectrumSize);
+        }
+    }
+}
+
+//======================================================================
+PartitionedConvolutionEngine::PartitionedConvolutionEngine (std::shared_ptr<const PartitionedIR> impulseResponse, int numChannels)
+    : ir (std::move (impulseResponse)),
+      fft (getFFTOrder (ir->partitionSize))
+{
+    channelStates.resize ((size_t) numChannels);
+    for (auto& state : channelStates)
+    {
+        state.inputBlock.resize ((size_t) ir->partitionSize);
+        state.inputSpectra.resize ((size_t) (ir->numPartitions * ir->spectrumSize));
+        state.tailSpectrum.resize ((size_t) ir->spectrumSize);
+        state.overlap.resize ((size_t) ir->partitionSize);
+    }
+    fftData.resize ((size_t) ir->fftSize * 2);
+
+    reset();
+}
+
+void PartitionedConvolutionEngine::reset()
+{
+    for (auto& state : channelStates)
+    {
+        std::fill (state.inputBlock.begin(), state.inputBlock.end(), 0.0f);
+        std::fill (state.inputSpectra.begin(), state.inputSpectra.end(), 0.0f);
+        std::fill (state.tailSpectrum.begin(), state.tailSpectrum.end(), 0.0f);
+        std::fill (state.overlap.begin(), state.overlap.end(), 0.0f);
+        state.inputPosition = 0;
+        state.currentSegment = 0;
+    }
+}
+
+void PartitionedConvolutionEngine::process (const float* input, float* output, int channel, int numSamples) noexcept
+{
+    auto& state = channelStates[(size_t) channel];
+    const auto partitionSize = ir->partitionSize;
+    const auto spectrumSize = ir->spectrumSize;
+    const auto numPartitions = ir->numPartitions;
+
+    int sampleIndex = 0;
+    while (sampleIndex < numSamples)
+    {
+        const auto isNewInputBlock = state.inputPosition == 0;
+        const auto numSamplesToProcess = jmin (numSamples - sampleIndex, partitionSize - state.inputPosition);
+        FloatVectorOperations::copy (state.inputBlock.data() + state.inputPosition, input + sampleIndex, numSamplesToProcess);
+
+        // transform the (possibly incomplete) input block, so that the output has zero latency
+        std::fill (fftData.begin(), fftData.end(), 0.0f);
+        FloatVectorOperations::copy (fftData.data(), state.inputBlock.data(), partitionSize);
+        fft.performRealOnlyForwardTransform (fftData.data(), true);
+        auto* currentInputSpectrum = state.inputSpectra.data() + state.currentSegment * spectrumSize;
+        std::copy (fftData.begin(), fftData.begin() + spectrumSize, currentInputSpectrum);
+
+        // the previous input blocks only need to be convolved with the rest of the IR once per block
+        if (isNewInputBlock)
+        {
+            std::fill (state.tailSpectrum.begin(), state.tailSpectrum.end(), 0.0f);
+            for (int partitionIndex = 1; partitionIndex < numPartitions; ++partitionIndex)
+            {
+                const auto segmentIndex = (state.currentSegment + partitionIndex) % numPartitions;
+                complexMultiplyAccumulate (state.inputSpectra.data() + segmentIndex * spectrumSize,
+                                           ir->getPartitionSpectrum (channel, partitionIndex),
+                                           state.tailSpectrum.data(),
+                                           spectrumSize);
+            }
+        }
+
+        std::fill (fftData.begin(), fftData.end(), 0.0f);
+        std::copy (state.tailSpectrum.begin(), state.tailSpectrum.end(), fftData.begin());
+        complexMultiplyAccumulate (currentInputSpectrum, ir->getPartitionSpectrum (channel, 0), fftData.data(), spectrumSize);
+        fft.performRealOnlyInverseTransform (fftData.data());
+
+        FloatVectorOperations::add (output + sampleIndex,
+                                    fftData.data() + state.inputPosition,
+                                    state.overlap.data() + state.inputPosition,
+                                    numSamplesToProcess);
+
+        state.inputPosition += numSamplesToProcess;
+        sampleIndex += numSamplesToProcess;
+
+        if (state.inputPosition == partitionSize)
+        {
+            // the input block is complete, so save the overlap, and move on to the next block
+            FloatVectorOperations::copy (state.overlap.data(), fftData.data() + partitionSize, partitionSize);
+            std::fill (state.inputBlock.begin(), state.inputBlock.end(), 0.0f);
+            state.inputPosition = 0;
+            state.currentSegment = state.currentSegment > 0 ? state.currentSegment - 1 : numPartitions - 1;
+        }
+    }
+}
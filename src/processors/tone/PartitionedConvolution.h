@@ -0,0 +1,73 @@
+#pragma once
+
+#include <pch.h>
+
+/**
+ * An impulse response that has been split into uniform partitions,
+ * and transformed to the frequency domain.
+ *
+ * Once it has been created, the IR is read-only, so it can be shared
+ * between any number of convolution engines (see IRCache).
+ */
+struct PartitionedIR
+{
+    PartitionedIR (const AudioBuffer<float>& impulseResponse, double sampleRate, int partitionSize);
+
+    /** Returns the spectrum of a given partition, (fftSize / 2 + 1 interleaved complex values). */
+    const float* getPartitionSpectrum (int channel, int partitionIndex) const noexcept
+    {
+        return spectra[(size_t) jmin (channel, numChannels - 1)].data() + (size_t) partitionIndex * (size_t) spectrumSize;
+    }
+
+    const double sampleRate;
+    const int partitionSize;
+    const int fftSize;
+    const int spectrumSize;
+    const int numPartitions;
+    const int numChannels;
+    const int irLengthSamples;
+
+private:
+    std::vector<std::vector<float>> spectra;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PartitionedIR)
+};
+
+/**
+ * Zero-latency uniformly partitioned convolution, (overlap-add with a
+ * frequency-domain delay line), using a shared PartitionedIR.
+ *
+ * Only the convolution state (input spectra, overlap, etc.) belongs to the
+ * engine, so creating several engines for the same IR is relatively cheap.
+ * A mono IR will be used for all channels.
+ */
+class PartitionedConvolutionEngine
+{
+public:
+    PartitionedConvolutionEngine (std::shared_ptr<const PartitionedIR> impulseResponse, int numChannels);
+
+    void reset();
+
+    /** Processes a block of samples for a single channel. The input and output may point to the same memory. */
+    void process (const float* input, float* output, int channel, int numSamples) noexcept;
+
+    const PartitionedIR& getImpulseResponse() const noexcept { return *ir; }
+
+private:
+    std::shared_ptr<const PartitionedIR> ir;
+    dsp::FFT fft;
+
+    struct ChannelState
+    {
+        std::vector<float> inputBlock;
+        std::vector<float> inputSpectra; // frequency-domain delay line
+        std::vector<float> tailSpectrum; // accumulated spectrum from the previous input blocks
+        std::vector<float> overlap;
+        int inputPosition = 0;
+        int currentSegment = 0;
+    };
+    std::vector<ChannelState> channelStates;
+    std::vector<float> fftData;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PartitionedConvolutionEngine)
+};
@@ -65,6 +65,12 @@ void StateVariableFilter::prepare (double sampleRate, int samplesPerBlock)
     modeSmoothed.setRampLength (0.025);
 }
 
+double StateVariableFilter::getTailLengthSeconds() const
+{
+    // wait for the filter's resonance to decay
+    return getFilterTailLengthSeconds ((double) freqParam->getCurrentValue(), (double) qParam->getCurrentValue());
+}
+
 void StateVariableFilter::processAudio (AudioBuffer<float>& buffer)
 {
     const auto numChannels = buffer.getNumChannels();
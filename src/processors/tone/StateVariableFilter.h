@@ -10,6 +10,8 @@ public:
     ProcessorType getProcessorType() const override { return Tone; }
     static ParamLayout createParameterLayout();
 
+    double getTailLengthSeconds() const override;
+
     void prepare (double sampleRate, int samplesPerBlock) override;
     void processAudio (AudioBuffer<float>& buffer) override;
 
@@ -1,8 +1,7 @@
 #include "AmpIRs.h"
 #include "processors/ParameterHelpers.h"
 
-AmpIRs::AmpIRs (UndoManager* um) : BaseProcessor ("Amp IRs", createParameterLayout(), um),
-                                   convolution (getSharedConvolutionMessageQueue())
+AmpIRs::AmpIRs (UndoManager* um) : BaseProcessor ("Amp IRs", createParameterLayout(), um)
 {
     audioFormatManager.registerBasicFormats();
 
@@ -12,7 +11,7 @@ AmpIRs::AmpIRs (UndoManager* um) : BaseProcessor ("Amp IRs", createParameterLayo
         int binarySize;
         auto* irData = BinaryData::getNamedResource (binaryName.getCharPointer(), binarySize);
 
-        irMap.insert (std::make_pair (irName, std::make_pair ((void*) irData, (size_t) binarySize)));
+        convolution.addImpulseResponse (irData, (size_t) binarySize);
     }
 
     using namespace ParameterHelpers;
@@ -63,8 +62,6 @@ void AmpIRs::parameterChanged (const String& parameterID, float newValue)
     if (irIdx >= irNames.size() - 1)
         return;
 
-    const auto& irName = irNames[irIdx];
-    auto& irData = irMap[irName];
     irState.file = File {};
     irState.data = {};
     irState.paramIndex = irIdx;
@@ -73,27 +70,22 @@ void AmpIRs::parameterChanged (const String& parameterID, float newValue)
 
     setMakeupGain (96000.0f);
 
-    ScopedLock sl (irMutex);
-    convolution.loadImpulseResponse (irData.first, irData.second, dsp::Convolution::Stereo::yes, dsp::Convolution::Trim::yes, 0);
+    // this might be called from the audio thread (e.g. from a MIDI footswitch), but it won't block
+    convolution.loadImpulseResponse (irIdx);
 }
 
 void AmpIRs::prepare (double sampleRate, int samplesPerBlock)
 {
-    fs = (float) sampleRate;
+    convolution.prepare (sampleRate, samplesPerBlock, getOversamplingFactor());
+    fs = (float) convolution.getConvolutionSampleRate();
 
     dsp::ProcessSpec spec { sampleRate, (uint32) samplesPerBlock, 2 };
-    convolution.prepare (spec);
 
     gain.prepare (spec);
     gain.setRampDurationSeconds (0.01);
 
     dryWetMixer.prepare (spec);
     dryWetMixerMono.prepare ({ sampleRate, (uint32) samplesPerBlock, 1 });
-
-    if (irState.paramIndex == customIRIndex)
-        loadIRFromCurrentState();
-    else
-        parameterChanged (irTag, vts.getRawParameterValue (irTag)->load());
 }
 
 void AmpIRs::processAudio (AudioBuffer<float>& buffer)
@@ -112,3 +104,8 @@ void AmpIRs::processAudio (AudioBuffer<float>& buffer)
     gain.process (context);
     dryWet.mixWetSamples (block);
 }
+
+double AmpIRs::getTailLengthSeconds() const
+{
+    return convolution.getTailLengthSeconds();
+}
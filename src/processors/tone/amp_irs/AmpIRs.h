@@ -1,6 +1,7 @@
 #pragma once
 
 #include "processors/BaseProcessor.h"
+#include "processors/tone/IRConvolution.h"
 
 class AmpIRs : public BaseProcessor, private AudioProcessorValueTreeState::Listener
 {
@@ -16,11 +17,14 @@ public:
 
     void prepare (double sampleRate, int samplesPerBlock) override;
     void processAudio (AudioBuffer<float>& buffer) override;
+    double getTailLengthSeconds() const override;
 
     bool getCustomComponents (OwnedArray<Component>& customComps, chowdsp::HostContextProvider& hcp) override;
 
     std::unique_ptr<XmlElement> toXML() override;
     void fromXML (XmlElement* xml, const chowdsp::Version& version, bool loadPosition) override;
+    void toBinary (BinaryStateWriter& writer) override;
+    void fromBinary (BinaryStateReader& reader, const chowdsp::Version& version, bool loadPosition) override;
 
 private:
     void loadIRFromCurrentState();
@@ -29,16 +33,13 @@ private:
     chowdsp::FloatParameter* mixParam = nullptr;
     chowdsp::FloatParameter* gainParam = nullptr;
 
-    dsp::Convolution convolution { juce::dsp::Convolution::NonUniform { 256 } };
+    IRConvolution convolution;
     dsp::Gain<float> gain;
     std::atomic<float> makeupGainDB { 0.0f };
 
     dsp::DryWetMixer<float> dryWetMixer;
     dsp::DryWetMixer<float> dryWetMixerMono;
-    float fs = 48000.0f;
-
-    using IRType = std::pair<void*, size_t>;
-    std::unordered_map<String, IRType> irMap; // store the IRs that come from BinaryData
+    float fs = 48000.0f; // convolution sample rate
 
     struct IRState
     {
@@ -53,7 +54,6 @@ private:
     };
 
     IRState irState;
-    CriticalSection irMutex;
     chowdsp::Broadcaster<void()> irChangedBroadcaster;
     AudioFormatManager audioFormatManager;
 
@@ -27,13 +27,8 @@ void AmpIRs::loadIRFromStream (std::unique_ptr<InputStream>&& stream, const Stri
         return;
     }
 
-    const auto fileLength = static_cast<size_t> (formatReader->lengthInSamples);
-    AudioBuffer<float> resultBuffer { jlimit (1, 2, static_cast<int> (formatReader->numChannels)), static_cast<int> (fileLength) };
-
-    if (! formatReader->read (resultBuffer.getArrayOfWritePointers(),
-                              resultBuffer.getNumChannels(),
-                              0,
-                              resultBuffer.getNumSamples()))
+    // we only need to check the header here, since the IR is decoded on the convolution's loading thread
+    if (formatReader->lengthInSamples <= 0 || formatReader->numChannels == 0)
     {
         failToLoad ("Unable to read data from IR file: " + file.getFullPathName());
         return;
@@ -57,8 +52,7 @@ void AmpIRs::loadIRFromStream (std::unique_ptr<InputStream>&& stream, const Stri
 
     setMakeupGain ((float) formatReader->sampleRate);
 
-    ScopedLock sl (irMutex);
-    convolution.loadImpulseResponse (std::move (resultBuffer), formatReader->sampleRate, dsp::Convolution::Stereo::yes, dsp::Convolution::Trim::yes, dsp::Convolution::Normalise::yes);
+    convolution.loadImpulseResponse (MemoryBlock { *irState.data });
 }
 
 void AmpIRs::loadIRFromCurrentState()
@@ -117,3 +111,32 @@ void AmpIRs::fromXML (XmlElement* xml, const chowdsp::Version& version, bool loa
             loadIRFromStream (irFile.createInputStream());
     }
 }
+
+void AmpIRs::toBinary (BinaryStateWriter& writer)
+{
+    BaseProcessor::toBinary (writer);
+
+    // the binary state can store the IR data directly, without needing to encode it as Base64
+    writer.writeString (irState.name);
+    writer.writeString (irState.file.getFullPathName());
+    if (irState.data != nullptr)
+        writer.writeData (irState.data->getData(), irState.data->getSize());
+    else
+        writer.writeData (nullptr, 0);
+}
+
+void AmpIRs::fromBinary (BinaryStateReader& reader, const chowdsp::Version& version, bool loadPosition)
+{
+    BaseProcessor::fromBinary (reader, version, loadPosition);
+
+    const auto irName = reader.readString();
+    const auto irFilePath = reader.readString();
+    auto irData = reader.readData();
+    if (reader.hasFailed() || irData.isEmpty())
+        return;
+
+    irState.name = irName;
+    irState.file = irFilePath.isNotEmpty() ? File { irFilePath } : File {};
+    irState.data = std::make_unique<MemoryBlock> (std::move (irData));
+    loadIRFromCurrentState();
+}
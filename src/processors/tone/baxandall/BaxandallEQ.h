@@ -13,6 +13,7 @@ public:
 
     void prepare (double sampleRate, int samplesPerBlock) override;
     void processAudio (AudioBuffer<float>& buffer) override;
+    double getTailLengthSeconds() const override { return getFilterTailLengthSeconds (toneStackLowestFreqHz); }
 
 private:
     chowdsp::FloatParameter* bassParam = nullptr;
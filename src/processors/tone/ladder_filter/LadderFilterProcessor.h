@@ -17,6 +17,9 @@ public:
 
     ProcessorType getProcessorType() const override { return Tone; }
 
+    /** The filters can self-oscillate (or ring for a very long time), so they shouldn't be put to sleep. */
+    double getTailLengthSeconds() const override { return std::numeric_limits<double>::infinity(); }
+
     void prepare (double sampleRate, int samplesPerBlock) override;
     void processAudio (AudioBuffer<float>& buffer) override;
 
@@ -38,6 +38,11 @@ public:
         filter.processBlock (buffer);
     }
 
+    double getTailLengthSeconds() const override
+    {
+        return getFilterTailLengthSeconds ((double) freqHzParam->getCurrentValue(), MathConstants<double>::sqrt2 / 2.0);
+    }
+
 private:
     chowdsp::FloatParameter* freqHzParam = nullptr;
     chowdsp::SVFHighpass<float> filter;
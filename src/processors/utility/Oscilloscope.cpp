@@ -1,5 +1,6 @@
 #include "Oscilloscope.h"
 #include "../ParameterHelpers.h"
+#include "gui/utils/FrameScheduler.h"
 
 namespace ScopeConstants
 {
@@ -67,6 +68,7 @@ void Oscilloscope::ScopeBackgroundTask::resetTask()
     scopePath.clear();
     scopePath.startNewSubPath (mapXY (0, 0.0f));
     scopePath.lineTo (mapXY (samplesToDisplay, 0.0f));
+    scopePathVersion++;
 }
 
 juce::Point<float> Oscilloscope::ScopeBackgroundTask::mapXY (int sampleIndex, float yVal) const
@@ -98,6 +100,7 @@ void Oscilloscope::ScopeBackgroundTask::runTask (const AudioBuffer<float>& buffe
     scopePath.startNewSubPath (mapXY (0, data[triggerOffset]));
     for (int i = 1; i < samplesToDisplay; ++i)
         scopePath.lineTo (mapXY (i, data[triggerOffset + i]));
+    scopePathVersion++;
 }
 
 void Oscilloscope::ScopeBackgroundTask::setBounds (juce::Rectangle<int> newBounds)
@@ -116,12 +119,12 @@ Path Oscilloscope::ScopeBackgroundTask::getScopePath() const noexcept
 bool Oscilloscope::getCustomComponents (OwnedArray<Component>& customComps, chowdsp::HostContextProvider&)
 {
     struct ScopeComp : public Component,
-                       private Timer
+                       private FrameScheduler::Client
     {
         explicit ScopeComp (ScopeBackgroundTask& sTask) : scopeTask (sTask)
         {
             scopeTask.setShouldBeRunning (true);
-            startTimerHz (ScopeConstants::scopeFps);
+            startFrameCallbacks (ScopeConstants::scopeFps);
         }
 
         ~ScopeComp() override
@@ -148,9 +151,18 @@ bool Oscilloscope::getCustomComponents (OwnedArray<Component>& customComps, chow
         }
 
         void resized() override { scopeTask.setBounds (getLocalBounds()); }
-        void timerCallback() override { repaint(); }
+        void frameCallback() override
+        {
+            const auto scopePathVersion = scopeTask.getScopePathVersion();
+            if (scopePathVersion == lastScopePathVersion)
+                return;
+
+            lastScopePathVersion = scopePathVersion;
+            frameScheduler->markDirty (*this);
+        }
 
         ScopeBackgroundTask& scopeTask;
+        uint32_t lastScopePathVersion = 0;
     };
 
     customComps.add (std::make_unique<ScopeComp> (scopeTask));
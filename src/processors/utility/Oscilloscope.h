@@ -29,9 +29,13 @@ private:
         void setBounds (juce::Rectangle<int> newBounds);
         Path getScopePath() const noexcept;
 
+        /** Incremented whenever the scope path changes, so the GUI can skip repainting when nothing has changed. */
+        uint32_t getScopePathVersion() const noexcept { return scopePathVersion.load(); }
+
     private:
         CriticalSection crit;
         Path scopePath;
+        std::atomic<uint32_t> scopePathVersion { 0 };
         juce::Rectangle<float> bounds {};
 
         int samplesToDisplay = 0;
@@ -1,9 +1,10 @@
 #include "Tuner.h"
 #include "../ParameterHelpers.h"
+#include "gui/utils/FrameScheduler.h"
 
 namespace TunerConstants
 {
-constexpr int tunerRefreshHz = 24;
+constexpr int tunerRefreshHz = 20; // a divisor of FrameScheduler::frameRateHz, so the frequency smoothing is correct
 }
 
 Tuner::Tuner (UndoManager* um) : BaseProcessor ("Tuner",
@@ -80,12 +81,12 @@ double Tuner::TunerBackgroundTask::getCurrentFreqHz() noexcept
 bool Tuner::getCustomComponents (OwnedArray<Component>& customComps, chowdsp::HostContextProvider&)
 {
     struct TunerComp : public Component,
-                       private Timer
+                       private FrameScheduler::Client
     {
         explicit TunerComp (TunerBackgroundTask& tTask) : tunerTask (tTask)
         {
             tunerTask.setShouldBeRunning (true);
-            startTimerHz (TunerConstants::tunerRefreshHz);
+            startFrameCallbacks (TunerConstants::tunerRefreshHz);
         }
 
         ~TunerComp() override
@@ -178,9 +179,10 @@ bool Tuner::getCustomComponents (OwnedArray<Component>& customComps, chowdsp::Ho
             g.drawFittedText (noteString + " | " + freqString, nameBounds, Justification::centred, 1);
         }
 
-        void timerCallback() override
+        void frameCallback() override
         {
-            repaint();
+            // the frequency smoother is advanced every time the tuner is painted, so we always need to repaint
+            frameScheduler->markDirty (*this);
         }
 
         TunerBackgroundTask& tunerTask;
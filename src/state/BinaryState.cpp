@@ -0,0 +1,278 @@
+#include "BinaryState.h"
+#include <bit>
+
+namespace
+{
+// these need to match the identifiers used by AudioProcessorValueTreeState
+const Identifier paramType { "PARAM" };
+const Identifier paramIDTag { "id" };
+const Identifier paramValueTag { "value" };
+
+bool isParameterState (const ValueTree& child)
+{
+    return child.hasType (paramType)
+           && child.getNumProperties() == 2
+           && child.getNumChildren() == 0
+           && child.hasProperty (paramIDTag)
+           && (child.getProperty (paramValueTag).isDouble() || child.getProperty (paramValueTag).isInt());
+}
+
+void writeDataToStream (OutputStream& stream, const void* data, size_t numBytes)
+{
+    stream.writeCompressedInt ((int) numBytes);
+    stream.write (data, numBytes);
+}
+
+void writeStringToStream (OutputStream& stream, const String& value)
+{
+    writeDataToStream (stream, value.toRawUTF8(), value.getNumBytesAsUTF8());
+}
+} // namespace
+
+BinaryStateWriter::BinaryStateWriter() : stream (std::make_unique<MemoryOutputStream>())
+{
+}
+
+void BinaryStateWriter::writeInt (int value)
+{
+    stream->writeCompressedInt (value);
+}
+
+void BinaryStateWriter::writeFloat (float value)
+{
+    stream->writeFloat (value);
+}
+
+void BinaryStateWriter::writeString (const String& value)
+{
+    writeStringToStream (*stream, value);
+}
+
+void BinaryStateWriter::writeData (const void* data, size_t numBytes)
+{
+    writeDataToStream (*stream, data, numBytes);
+}
+
+int BinaryStateWriter::getIDTableIndex (const StringArray& ids)
+{
+    const auto key = ids.joinIntoString ("\n");
+    if (const auto iter = idTableIndices.find (key); iter != idTableIndices.end())
+        return iter->second;
+
+    const auto newIndex = (int) idTables.size();
+    idTables.push_back (ids);
+    idTableIndices.emplace (key, newIndex);
+    return newIndex;
+}
+
+void BinaryStateWriter::writeParameterState (const ValueTree& state)
+{
+    // anything that isn't a plain parameter value gets stored as a ValueTree
+    ValueTree otherState { state.getType() };
+    otherState.copyPropertiesFrom (state, nullptr);
+
+    StringArray paramIDs;
+    Array<float> paramValues;
+    for (const auto& child : state)
+    {
+        if (isParameterState (child))
+        {
+            paramIDs.add (child.getProperty (paramIDTag).toString());
+            paramValues.add ((float) child.getProperty (paramValueTag));
+        }
+        else
+        {
+            otherState.appendChild (child.createCopy(), nullptr);
+        }
+    }
+
+    writeInt (getIDTableIndex (paramIDs));
+    for (auto value : paramValues)
+        writeFloat (value);
+
+    MemoryOutputStream otherStateStream;
+    otherState.writeToStream (otherStateStream);
+    writeData (otherStateStream.getData(), otherStateStream.getDataSize());
+}
+
+void BinaryStateWriter::writeIDTable (const StringArray& ids)
+{
+    writeInt (getIDTableIndex (ids));
+}
+
+void BinaryStateWriter::writeTo (OutputStream& output, const String& pluginVersion) const
+{
+    output.writeInt (BinaryState::magic);
+    output.writeCompressedInt (BinaryState::formatVersion);
+    writeStringToStream (output, pluginVersion);
+
+    output.writeCompressedInt ((int) idTables.size());
+    for (const auto& table : idTables)
+    {
+        output.writeCompressedInt (table.size());
+        for (const auto& id : table)
+            writeStringToStream (output, id);
+    }
+
+    output.write (stream->getData(), stream->getDataSize());
+}
+
+//===================================================================
+BinaryStateReader::BinaryStateReader (std::shared_ptr<const SharedState> sharedState, size_t startPosition, size_t endPosition)
+    : shared (std::move (sharedState)),
+      position (startPosition),
+      end (endPosition)
+{
+}
+
+std::optional<BinaryStateReader> BinaryStateReader::fromData (const void* data, size_t numBytes)
+{
+    if (data == nullptr || numBytes < sizeof (int) || (int) ByteOrder::littleEndianInt (data) != BinaryState::magic)
+        return std::nullopt;
+
+    auto sharedState = std::make_shared<SharedState>();
+    sharedState->data = MemoryBlock { data, numBytes };
+
+    BinaryStateReader reader { sharedState, sizeof (int), numBytes };
+    sharedState->formatVersion = reader.readInt();
+    if (sharedState->formatVersion < 1 || sharedState->formatVersion > BinaryState::formatVersion)
+        return std::nullopt;
+
+    sharedState->pluginVersion = reader.readString();
+
+    const auto numTables = reader.readCount();
+    sharedState->idTables.resize ((size_t) numTables);
+    for (auto& table : sharedState->idTables)
+    {
+        const auto numParams = reader.readCount();
+        table.ensureStorageAllocated (numParams);
+        for (int i = 0; i < numParams; ++i)
+            table.add (reader.readString());
+    }
+
+    if (reader.hasFailed())
+        return std::nullopt;
+
+    return reader;
+}
+
+bool BinaryStateReader::checkAvailable (size_t numBytes)
+{
+    if (failed || numBytes > getNumBytesRemaining())
+        failed = true;
+
+    return ! failed;
+}
+
+int BinaryStateReader::readInt()
+{
+    // see OutputStream::writeCompressedInt()
+    if (! checkAvailable (1))
+        return 0;
+
+    const auto sizeByte = *getReadPointer();
+    const auto numBytes = (size_t) (sizeByte & 0x7f);
+    if (numBytes > sizeof (int) || ! checkAvailable (1 + numBytes))
+    {
+        failed = true;
+        return 0;
+    }
+
+    uint32 value = 0;
+    for (size_t i = 0; i < numBytes; ++i)
+        value |= (uint32) getReadPointer()[1 + i] << (8 * i);
+    position += 1 + numBytes;
+
+    return (sizeByte & 0x80) != 0 ? -(int) value : (int) value;
+}
+
+float BinaryStateReader::readFloat()
+{
+    if (! checkAvailable (sizeof (float)))
+        return 0.0f;
+
+    const auto value = ByteOrder::littleEndianInt (getReadPointer());
+    position += sizeof (float);
+    return std::bit_cast<float> (value);
+}
+
+int BinaryStateReader::readCount (size_t minBytesPerItem)
+{
+    const auto count = readInt();
+    if (count < 0 || (size_t) count * minBytesPerItem > getNumBytesRemaining())
+    {
+        failed = true;
+        return 0;
+    }
+
+    return count;
+}
+
+MemoryBlock BinaryStateReader::readData()
+{
+    const auto numBytes = (size_t) readCount();
+    MemoryBlock block { getReadPointer(), numBytes };
+    position += numBytes;
+    return block;
+}
+
+String BinaryStateReader::readString()
+{
+    const auto numBytes = (size_t) readCount();
+    const auto value = String::fromUTF8 (reinterpret_cast<const char*> (getReadPointer()), (int) numBytes);
+    position += numBytes;
+    return value;
+}
+
+ValueTree BinaryStateReader::readParameterState()
+{
+    const auto tableIndex = readInt();
+    if (! isPositiveAndBelow (tableIndex, shared->idTables.size()))
+    {
+        failed = true;
+        return {};
+    }
+
+    const auto& paramIDs = shared->idTables[(size_t) tableIndex];
+    if (! checkAvailable ((size_t) paramIDs.size() * sizeof (float)))
+        return {};
+
+    Array<float> paramValues;
+    paramValues.ensureStorageAllocated (paramIDs.size());
+    for (int i = 0; i < paramIDs.size(); ++i)
+        paramValues.add (readFloat());
+
+    const auto otherStateData = readData();
+    auto state = ValueTree::readFromData (otherStateData.getData(), otherStateData.getSize());
+    if (failed || ! state.isValid())
+    {
+        failed = true;
+        return {};
+    }
+
+    for (int i = 0; i < paramIDs.size(); ++i)
+        state.addChild (ValueTree { paramType, { { paramIDTag, paramIDs[i] }, { paramValueTag, paramValues[i] } } }, i, nullptr);
+
+    return state;
+}
+
+StringArray BinaryStateReader::readIDTable()
+{
+    const auto tableIndex = readInt();
+    if (failed || ! isPositiveAndBelow (tableIndex, shared->idTables.size()))
+    {
+        failed = true;
+        return {};
+    }
+
+    return shared->idTables[(size_t) tableIndex];
+}
+
+BinaryStateReader BinaryStateReader::readRecord()
+{
+    const auto numBytes = (size_t) readCount();
+    BinaryStateReader recordReader { shared, position, position + numBytes };
+    recordReader.failed = failed;
+    position += numBytes;
+    return recordReader;
+}
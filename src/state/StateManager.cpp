@@ -39,6 +39,22 @@ std::unique_ptr<XmlElement> StateManager::saveState()
     return xml;
 }
 
+void StateManager::saveState (OutputStream& output)
+{
+    BinaryStateWriter writer;
+    writer.writeParameterState (vts.copyState());
+
+    // the preset state is small, so it's fine to keep it as XML
+    if (auto presetXml = presetManager.saveXmlState())
+        writer.writeString (presetXml->toString (XmlElement::TextFormat().singleLine().withoutHeader()));
+    else
+        writer.writeString ({});
+
+    procChain.getStateHelper().saveProcChain (writer);
+
+    writer.writeTo (output, JucePlugin_VersionString);
+}
+
 void StateManager::loadState (XmlElement* xmlState, ParamForwardManager& paramForwardManager)
 {
     if (xmlState == nullptr) // invalid XML
@@ -52,24 +68,59 @@ void StateManager::loadState (XmlElement* xmlState, ParamForwardManager& paramFo
     if (procChainXml == nullptr) // invalid procChain XML
         return;
 
-    const auto [presetWasDirty, pluginVersion] = [&]
+    loadStateInternal (ValueTree::fromXml (*vtsXml),
+                       xmlState->getChildByName (chowdsp::PresetManager::presetStateTag),
+                       getPluginVersionFromXML (xmlState),
+                       procChainXml,
+                       paramForwardManager);
+}
+
+void StateManager::loadState (const void* data, size_t dataSize, ParamForwardManager& paramForwardManager)
+{
+    auto reader = BinaryStateReader::fromData (data, dataSize);
+    if (! reader.has_value()) // states from older versions of the plugin are stored as XML
+    {
+        const auto xmlState = AudioProcessor::getXmlFromBinary (data, (int) dataSize);
+        loadState (xmlState.get(), paramForwardManager);
+        return;
+    }
+
+    const auto vtsState = reader->readParameterState();
+    const auto presetXml = parseXML (reader->readString());
+    if (reader->hasFailed() || ! vtsState.hasType (vts.state.getType())) // invalid ValueTreeState
+        return;
+
+    loadStateInternal (vtsState,
+                       presetXml.get(),
+                       reader->getPluginVersion(),
+                       *reader,
+                       paramForwardManager);
+}
+
+template <typename ProcChainState>
+void StateManager::loadStateInternal (const ValueTree& vtsState,
+                                      XmlElement* presetXml,
+                                      const chowdsp::Version& pluginVersion,
+                                      const ProcChainState& procChainState,
+                                      ParamForwardManager& paramForwardManager)
+{
+    const auto presetWasDirty = [&]
     {
         std::optional<MessageManagerLock> mml {};
         if (pluginWrapperType != AudioProcessor::WrapperType::wrapperType_AAX)
             mml.emplace();
-        presetManager.loadXmlState (xmlState->getChildByName (chowdsp::PresetManager::presetStateTag));
+        presetManager.loadXmlState (presetXml);
         const auto wasDirty = presetManager.getIsDirty();
 
-        const auto savedPluginVersion = getPluginVersionFromXML (xmlState);
-        vts.replaceState (ValueTree::fromXml (*vtsXml));
+        vts.replaceState (vtsState);
 
-        return std::make_tuple (wasDirty, savedPluginVersion);
+        return wasDirty;
     }();
 
     std::unique_ptr<WaitableEvent> waiter;
     if (pluginWrapperType != AudioProcessor::WrapperType::wrapperType_AAX)
         waiter = std::make_unique<WaitableEvent>();
-    procChain.getStateHelper().loadProcChain (procChainXml,
+    procChain.getStateHelper().loadProcChain (procChainState,
                                               pluginVersion,
                                               false,
                                               nullptr,
@@ -13,12 +13,26 @@ public:
     std::unique_ptr<XmlElement> saveState();
     void loadState (XmlElement* xml, ParamForwardManager& paramForwardManager);
 
+    /**
+     * Saves/loads the plugin state in the binary state format (see BinaryState.h).
+     * When loading, older XML states are detected and loaded as XML.
+     */
+    void saveState (OutputStream& output);
+    void loadState (const void* data, size_t dataSize, ParamForwardManager& paramForwardManager);
+
     auto& getUIState() { return uiState; }
 
     static void setCurrentPluginVersionInXML (XmlElement* xml);
     static chowdsp::Version getPluginVersionFromXML (const XmlElement* xml);
 
 private:
+    template <typename ProcChainState>
+    void loadStateInternal (const ValueTree& vtsState,
+                            XmlElement* presetXml,
+                            const chowdsp::Version& pluginVersion,
+                            const ProcChainState& procChainState,
+                            ParamForwardManager& paramForwardManager);
+
     AudioProcessorValueTreeState& vts;
     ProcessorChain& procChain;
     chowdsp::PresetManager& presetManager;
@@ -0,0 +1,64 @@
+#include "FactoryPresets.h"
+#include "processors/chain/ProcessorChainStateHelper.h"
+
+#include <FactoryPresetsTable.h>
+
+namespace FactoryPresets
+{
+static const Identifier factoryPresetFileTag { "factory_preset_file" };
+
+std::span<const FactoryPresetInfo> getFactoryPresetInfo()
+{
+    return factory_presets_table::presets;
+}
+
+const FactoryPresetInfo* getFactoryPresetInfo (const XmlElement* presetState)
+{
+    if (presetState == nullptr || ! presetState->hasAttribute (factoryPresetFileTag))
+        return nullptr;
+
+    const auto fileName = presetState->getStringAttribute (factoryPresetFileTag);
+    const auto& presets = factory_presets_table::presets;
+    const auto infoIter = std::find_if (presets.begin(), presets.end(), [&fileName] (const FactoryPresetInfo& info)
+                                        { return fileName == info.fileName; });
+    return infoIter != presets.end() ? &(*infoIter) : nullptr;
+}
+
+chowdsp::Preset createPlaceholderPreset (const FactoryPresetInfo& info)
+{
+    XmlElement placeholderState { ProcessorChainStateHelper::procChainStateTag };
+    placeholderState.setAttribute (factoryPresetFileTag, info.fileName);
+    for (const auto* moduleName : info.requiredModules)
+        placeholderState.createNewChildElement (String { moduleName }.replaceCharacter (' ', '_'));
+
+    return chowdsp::Preset { info.name, info.vendor, placeholderState, info.category };
+}
+
+std::optional<chowdsp::Preset> loadFullPreset (const XmlElement* presetState)
+{
+    if (presetState == nullptr || ! presetState->hasAttribute (factoryPresetFileTag))
+        return std::nullopt;
+
+    const auto fileName = presetState->getStringAttribute (factoryPresetFileTag);
+    for (int i = 0; i < BinaryData::namedResourceListSize; ++i)
+    {
+        if (fileName != BinaryData::originalFilenames[i])
+            continue;
+
+        int dataSize = 0;
+        const auto* data = BinaryData::getNamedResource (BinaryData::namedResourceList[i], dataSize);
+        if (data == nullptr)
+            break;
+
+        auto preset = chowdsp::Preset { data, dataSize };
+        if (! preset.isValid())
+            break;
+
+        return preset;
+    }
+
+    Logger::writeToLog ("Unable to load factory preset: " + fileName);
+    jassertfalse;
+    return std::nullopt;
+}
+} // namespace FactoryPresets
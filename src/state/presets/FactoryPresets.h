@@ -0,0 +1,38 @@
+#pragma once
+
+#include <pch.h>
+#include <span>
+
+/** Metadata for a factory preset, which is generated at build time (see res/CMakeLists.txt). */
+struct FactoryPresetInfo
+{
+    const char* name;
+    const char* vendor;
+    const char* category;
+    const char* fileName; // the original file name of the preset in BinaryData
+    std::span<const char* const> requiredModules;
+    std::span<const char* const> parameterIDs; // the parameters of the enabled modules, for the preset search
+};
+
+/**
+ * The factory presets are listed using their metadata, so that the preset
+ * state only needs to be parsed when the preset is actually loaded.
+ *
+ * In the preset manager, each factory preset is a placeholder preset, whose state
+ * contains the modules used in the preset (but not their parameters or connections),
+ * along with a reference to the full preset in BinaryData.
+ */
+namespace FactoryPresets
+{
+/** Returns the metadata for all the factory presets. */
+std::span<const FactoryPresetInfo> getFactoryPresetInfo();
+
+/** If the state is from a placeholder preset, this returns the metadata for the factory preset, otherwise nullptr. */
+const FactoryPresetInfo* getFactoryPresetInfo (const XmlElement* presetState);
+
+/** Creates a placeholder preset for a factory preset. */
+chowdsp::Preset createPlaceholderPreset (const FactoryPresetInfo& info);
+
+/** If the state is from a placeholder preset, this returns the full factory preset, otherwise nullopt. */
+std::optional<chowdsp::Preset> loadFullPreset (const XmlElement* presetState);
+} // namespace FactoryPresets
@@ -1,6 +1,7 @@
 #if HAS_CLAP_JUCE_EXTENSIONS
 
 #include "PresetDiscovery.h"
+#include "FactoryPresets.h"
 #include "PresetManager.h"
 #include "processors/ProcessorStore.h"
 #include "processors/chain/ProcessorChain.h"
@@ -51,6 +52,23 @@ struct FactoryPresetsProvider
         return true;
     }
 
+    static bool declarePreset (const clap_preset_discovery_metadata_receiver_t* metadata_receiver,
+                               const char* name,
+                               const char* vendor,
+                               const char* category) noexcept
+    {
+        if (! metadata_receiver->begin_preset (metadata_receiver, name, name))
+            return false;
+
+        metadata_receiver->add_plugin_id (metadata_receiver, &plugin_id);
+        metadata_receiver->add_creator (metadata_receiver, vendor);
+
+        if (*category != '\0')
+            metadata_receiver->add_feature (metadata_receiver, category);
+
+        return true;
+    }
+
     bool getMetadata (uint32_t location_kind,
                       [[maybe_unused]] const char* location,
                       const clap_preset_discovery_metadata_receiver_t* metadata_receiver) noexcept override
@@ -58,24 +76,26 @@ struct FactoryPresetsProvider
         if (location_kind != CLAP_PRESET_DISCOVERY_LOCATION_PLUGIN)
             return false;
 
+#if BYOD_ENABLE_ADD_ON_MODULES
+        // the add-on presets need to be checked against the modules that have been unlocked
         ScopedJuceInitialiser_GUI scopedJuce {};
         const ProcessorStore procStore { nullptr };
         for (const auto& factoryPreset : PresetManager::getFactoryPresets (procStore))
         {
-            DBG ("Indexing factory preset: " + factoryPreset.getName());
-            if (metadata_receiver->begin_preset (metadata_receiver, factoryPreset.getName().toRawUTF8(), factoryPreset.getName().toRawUTF8()))
-            {
-                metadata_receiver->add_plugin_id (metadata_receiver, &plugin_id);
-                metadata_receiver->add_creator (metadata_receiver, factoryPreset.getVendor().toRawUTF8());
-
-                if (factoryPreset.getCategory().isNotEmpty())
-                    metadata_receiver->add_feature (metadata_receiver, factoryPreset.getCategory().toRawUTF8());
-            }
-            else
-            {
+            if (! declarePreset (metadata_receiver,
+                                 factoryPreset.getName().toRawUTF8(),
+                                 factoryPreset.getVendor().toRawUTF8(),
+                                 factoryPreset.getCategory().toRawUTF8()))
                 break;
-            }
         }
+#else
+        // the factory preset metadata is generated at build time, so there's no need to parse the presets
+        for (const auto& presetInfo : FactoryPresets::getFactoryPresetInfo())
+        {
+            if (! declarePreset (metadata_receiver, presetInfo.name, presetInfo.vendor, presetInfo.category))
+                break;
+        }
+#endif
 
         return true;
     }
@@ -1,5 +1,6 @@
 #include "PresetManager.h"
 #include "../StateManager.h"
+#include "FactoryPresets.h"
 #include "PresetInfoHelpers.h"
 #include "gui/utils/ErrorMessageView.h"
 #include "processors/chain/ProcessorChainStateHelper.h"
@@ -211,55 +212,8 @@ std::vector<chowdsp::Preset> PresetManager::getFactoryPresets (const ProcessorSt
 {
     std::vector<chowdsp::Preset> factoryPresets;
 
-    // default
-    factoryPresets.emplace_back (BinaryData::Default_chowpreset, BinaryData::Default_chowpresetSize);
-
-    // amps
-    factoryPresets.emplace_back (BinaryData::Instant_Metal_chowpreset, BinaryData::Instant_Metal_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::Bass_Face_chowpreset, BinaryData::Bass_Face_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::Modern_HiGain_chowpreset, BinaryData::Modern_HiGain_chowpresetSize);
-
-    // modulation
-    factoryPresets.emplace_back (BinaryData::Chopped_Flange_chowpreset, BinaryData::Chopped_Flange_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::Mixed_In_Modulation_chowpreset, BinaryData::Mixed_In_Modulation_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::Seasick_Phase_chowpreset, BinaryData::Seasick_Phase_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::Laser_Cave_chowpreset, BinaryData::Laser_Cave_chowpresetSize);
-
-    // pedals
-    factoryPresets.emplace_back (BinaryData::American_Sound_chowpreset, BinaryData::American_Sound_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::Big_Muff_chowpreset, BinaryData::Big_Muff_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::Big_Muff_Triangle_chowpreset, BinaryData::Big_Muff_Triangle_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::Big_Muff_Rams_Head_56_chowpreset, BinaryData::Big_Muff_Rams_Head_56_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::Big_Muff_Russian_chowpreset, BinaryData::Big_Muff_Russian_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::Centaur_chowpreset, BinaryData::Centaur_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::Gainful_Clipper_chowpreset, BinaryData::Gainful_Clipper_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::Hot_Cakes_chowpreset, BinaryData::Hot_Cakes_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::Hot_Fuzz_chowpreset, BinaryData::Hot_Fuzz_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::King_Of_Tone_chowpreset, BinaryData::King_Of_Tone_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::MXR_Distortion_chowpreset, BinaryData::MXR_Distortion_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::OctaVerb_chowpreset, BinaryData::OctaVerb_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::RAT_chowpreset, BinaryData::RAT_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::Tube_Screamer_chowpreset, BinaryData::Tube_Screamer_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::Violet_Mist_chowpreset, BinaryData::Violet_Mist_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::Wah_Pedal_chowpreset, BinaryData::Wah_Pedal_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::ZenDrive_chowpreset, BinaryData::ZenDrive_chowpresetSize);
-
-    // players
-    factoryPresets.emplace_back (BinaryData::Black_Sabbath_chowpreset, BinaryData::Black_Sabbath_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::Boston_chowpreset, BinaryData::Boston_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::Clapton_chowpreset, BinaryData::Clapton_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::George_Harrison_chowpreset, BinaryData::George_Harrison_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::Green_Day_chowpreset, BinaryData::Green_Day_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::J_Mascis_chowpreset, BinaryData::J_Mascis_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::Jimi_Hendrix_chowpreset, BinaryData::Jimi_Hendrix_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::John_Mayer_chowpreset, BinaryData::John_Mayer_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::Johnny_Greenwood_chowpreset, BinaryData::Johnny_Greenwood_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::Neil_Young_chowpreset, BinaryData::Neil_Young_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::Nirvana_chowpreset, BinaryData::Nirvana_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::Pete_Townshend_chowpreset, BinaryData::Pete_Townshend_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::Superdrag_chowpreset, BinaryData::Superdrag_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::The_Strokes_chowpreset, BinaryData::The_Strokes_chowpresetSize);
-    factoryPresets.emplace_back (BinaryData::White_Stripes_chowpreset, BinaryData::White_Stripes_chowpresetSize);
+    for (const auto& presetInfo : FactoryPresets::getFactoryPresetInfo())
+        factoryPresets.push_back (FactoryPresets::createPlaceholderPreset (presetInfo));
 
 #if BYOD_ENABLE_ADD_ON_MODULES
     AddOnPresets::addFactoryPresets (factoryPresets);
@@ -300,6 +254,11 @@ void PresetManager::loadPresetState (const XmlElement* xml)
         um->perform (new ChangePresetAction (*this));
     }
 
+    // factory presets are only parsed when they're loaded
+    const auto fullFactoryPreset = FactoryPresets::loadFullPreset (xml);
+    if (fullFactoryPreset.has_value())
+        xml = fullFactoryPreset->getState();
+
     const auto statePluginVersion = StateManager::getPluginVersionFromXML (xml);
     procChain->getStateHelper().loadProcChain (xml, statePluginVersion, true, processor.getActiveEditor());
 }
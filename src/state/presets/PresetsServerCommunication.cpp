@@ -15,24 +15,39 @@ String makeMessageString (const String& message)
     return "Message: " + message + "\n";
 }
 
-String pingServer (const URL& requestURL, const String& httpRequest = "GET")
+ServerResponse sendRequest (const URL& requestURL, const String& httpRequest, const String& extraHeaders = {})
 {
-    String responseMessage = "URL: " + requestURL.toString (true) + "\n";
+    ServerResponse response;
 
     juce::StringPairArray responseHeaders;
-    int statusCode = 0;
     if (auto inputStream = requestURL.createInputStream (
             juce::URL::InputStreamOptions (juce::URL::ParameterHandling::inAddress)
                 .withConnectionTimeoutMs (5000) // 5 seconds
                 .withNumRedirectsToFollow (5)
-                .withStatusCode (&statusCode)
+                .withStatusCode (&response.statusCode)
                 .withResponseHeaders (&responseHeaders)
+                .withExtraHeaders (extraHeaders)
                 .withHttpRequestCmd (httpRequest)))
     {
-        auto streamString = inputStream->readEntireStreamAsString();
+        response.body = inputStream->readEntireStreamAsString();
+    }
+    else
+    {
+        response.statusCode = 0;
+    }
+
+    return response;
+}
 
-        responseMessage += "STATUS: " + juce::String (statusCode) + "\n";
-        responseMessage += makeMessageString (streamString);
+String pingServer (const URL& requestURL, const String& httpRequest = "GET")
+{
+    String responseMessage = "URL: " + requestURL.toString (true) + "\n";
+
+    const auto response = sendRequest (requestURL, httpRequest);
+    if (response.isConnected())
+    {
+        responseMessage += "STATUS: " + juce::String (response.statusCode) + "\n";
+        responseMessage += makeMessageString (response.body);
     }
     else
     {
@@ -100,6 +115,37 @@ juce::String sendUpdatePresetRequest (const PresetRequestInfo& info)
     return responseMessage;
 }
 
+ServerResponse sendGetPresetHashesRequest (const juce::String& user, const juce::String& pass)
+{
+    juce::StringPairArray requestHeaders;
+    requestHeaders.set ("user", user);
+    requestHeaders.set ("pass", pass);
+
+    auto requestURL = presetServerURL.getChildURL (magic_enum::enum_name (CommType::get_preset_hashes).data())
+                          .withParameters (requestHeaders);
+    auto response = sendRequest (requestURL, "GET");
+
+    Logger::writeToLog ("Requesting preset hashes from server, status: " + String (response.statusCode));
+
+    return response;
+}
+
+ServerResponse sendSyncPresetsRequest (const juce::String& user, const juce::String& pass, const juce::MemoryBlock& batchData)
+{
+    juce::StringPairArray requestHeaders;
+    requestHeaders.set ("user", user);
+    requestHeaders.set ("pass", pass);
+
+    auto requestURL = presetServerURL.getChildURL (magic_enum::enum_name (CommType::sync_presets).data())
+                          .withParameters (requestHeaders)
+                          .withPOSTData (batchData);
+    auto response = sendRequest (requestURL, "POST", "Content-Type: application/json\r\nContent-Encoding: deflate");
+
+    Logger::writeToLog ("Syncing preset batch to server (" + String ((int) batchData.getSize()) + " bytes), status: " + String (response.statusCode));
+
+    return response;
+}
+
 juce::String parseMessageResponse (const String& messageResponse)
 {
     return messageResponse.fromLastOccurrenceOf ("Message: ", false, false).upToLastOccurrenceOf ("\n", false, false);
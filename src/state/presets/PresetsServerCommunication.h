@@ -13,6 +13,8 @@ enum class CommType
     add_preset,
     update_preset,
     get_presets,
+    get_preset_hashes,
+    sync_presets,
 };
 
 juce::String sendServerRequest (CommType type, const juce::String& user, const juce::String& pass);
@@ -30,6 +32,25 @@ struct PresetRequestInfo
 juce::String sendAddPresetRequest (const PresetRequestInfo& info);
 juce::String sendUpdatePresetRequest (const PresetRequestInfo& info);
 
+/** The raw response to a server request. The status code is zero if the server could not be reached. */
+struct ServerResponse
+{
+    int statusCode = 0;
+    juce::String body {};
+
+    bool isConnected() const noexcept { return statusCode != 0; }
+    bool isOK() const noexcept { return statusCode >= 200 && statusCode < 300; }
+
+    /** True if the server doesn't have the requested endpoint (i.e. an older server). */
+    bool isUnsupported() const noexcept { return statusCode == 404 || statusCode == 405; }
+};
+
+/** Requests the content hashes of all the user's presets on the server. */
+ServerResponse sendGetPresetHashesRequest (const juce::String& user, const juce::String& pass);
+
+/** Uploads a compressed batch of presets (see PresetsServerSyncProtocol). */
+ServerResponse sendSyncPresetsRequest (const juce::String& user, const juce::String& pass, const juce::MemoryBlock& batchData);
+
 juce::String parseMessageResponse (const String& messageResponse);
 
 void showFailureMessage (const String& title, const String& message);
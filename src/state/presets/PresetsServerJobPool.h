@@ -9,6 +9,7 @@ struct PresetsServerJobPool
     ~PresetsServerJobPool()
     {
         pool.removeAllJobs (true, 250);
+        requestsPool.removeAllJobs (true, 250);
     }
 
     template <typename JobType>
@@ -17,6 +18,32 @@ struct PresetsServerJobPool
         pool.addJob (job);
     }
 
+    /**
+     * Runs a set of server requests, with at most maxConcurrentRequests running at
+     * once, and waits for them all to finish. The requests run on a separate pool,
+     * so this can be called from a job that's running on the main pool.
+     */
+    void runRequestsAndWait (std::vector<std::function<void()>>&& requests)
+    {
+        std::atomic_int numRequestsRemaining { (int) requests.size() };
+        WaitableEvent allRequestsFinished;
+        if (requests.empty())
+            return;
+
+        for (auto& request : requests)
+        {
+            requestsPool.addJob (
+                [&numRequestsRemaining, &allRequestsFinished, request = std::move (request)]
+                {
+                    request();
+                    if (--numRequestsRemaining == 0)
+                        allRequestsFinished.signal();
+                });
+        }
+
+        allRequestsFinished.wait();
+    }
+
     /** Safely run an action with a Component::SafePointer object (no return value) */
     template <typename SafeCompType, typename ActionType>
     static void callSafeOnMessageThread (SafeCompType& safeComp, ActionType&& action)
@@ -31,6 +58,9 @@ struct PresetsServerJobPool
 
 private:
     ThreadPool pool { 2 };
+
+    static constexpr int maxConcurrentRequests = 4;
+    ThreadPool requestsPool { maxConcurrentRequests };
 };
 
 using SharedPresetsServerJobPool = SharedResourcePointer<PresetsServerJobPool>;
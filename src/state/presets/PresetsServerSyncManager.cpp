@@ -3,6 +3,7 @@
 #include "PresetsServerSyncManager.h"
 #include "PresetInfoHelpers.h"
 #include "PresetsServerCommunication.h"
+#include "PresetsServerSyncProtocol.h"
 
 namespace
 {
@@ -18,6 +19,81 @@ void PresetsServerSyncManager::syncLocalPresetsToServer (const std::vector<const
 
     using namespace PresetsServerCommunication;
 
+    const auto hashesResponse = sendGetPresetHashesRequest (userManager->getUsername(), userManager->getPassword());
+    if (! hashesResponse.isConnected())
+    {
+        PresetsServerCommunication::showFailureMessage ("Presets sync failed", notConnectedStr);
+        return;
+    }
+
+    if (hashesResponse.isUnsupported())
+    {
+        // this server doesn't know about the delta sync protocol
+        syncPresetsIndividually (presets, addedPresetInfo, updateProgressCallback);
+        return;
+    }
+
+    // any other failure (e.g. bad credentials, or a server error) would most likely fail the one-by-one uploads as well
+    const auto serverHashes = hashesResponse.isOK() ? PresetsServerSyncProtocol::parseHashesResponse (hashesResponse.body) : std::nullopt;
+    if (! serverHashes.has_value())
+    {
+        Logger::writeToLog ("Unable to get preset hashes from server, status code: " + String (hashesResponse.statusCode));
+        PresetsServerCommunication::showFailureMessage ("Presets sync failed", hashesResponse.isOK() ? "Unable to read preset hashes from server!" : hashesResponse.body);
+        return;
+    }
+
+    auto changedPresets = PresetsServerSyncProtocol::getChangedPresets (presets, *serverHashes);
+    Logger::writeToLog ("Uploading " + String ((int) changedPresets.size()) + " of " + String ((int) presets.size()) + " presets");
+
+    const auto numPresets = (int) changedPresets.size();
+    auto batches = PresetsServerSyncProtocol::splitIntoBatches (std::move (changedPresets));
+
+    std::mutex resultsMutex;
+    int numPresetsSynced = 0;
+    std::atomic_bool syncFailed { false };
+
+    std::vector<std::function<void()>> batchRequests;
+    batchRequests.reserve (batches.size());
+    for (const auto& batch : batches)
+    {
+        batchRequests.emplace_back (
+            [&]
+            {
+                if (syncFailed)
+                    return;
+
+                const auto response = sendSyncPresetsRequest (userManager->getUsername(),
+                                                              userManager->getPassword(),
+                                                              PresetsServerSyncProtocol::createBatchRequestData (batch));
+                const auto presetIDs = response.isOK() ? PresetsServerSyncProtocol::parseBatchResponse (response.body, batch.size()) : std::nullopt;
+                if (! presetIDs.has_value())
+                {
+                    if (! syncFailed.exchange (true))
+                        PresetsServerCommunication::showFailureMessage ("Presets sync failed", response.isConnected() ? response.body : notConnectedStr);
+                    return;
+                }
+
+                std::lock_guard lock { resultsMutex };
+                for (auto [index, upload] : sst::cpputils::enumerate (batch))
+                {
+                    if (PresetInfoHelpers::getPresetID (*upload.preset).isEmpty())
+                        addedPresetInfo.emplace_back (upload.preset, (*presetIDs)[(int) index]);
+                }
+
+                numPresetsSynced += (int) batch.size();
+                updateProgressCallback (numPresetsSynced - 1, numPresets);
+            });
+    }
+
+    jobPool->runRequestsAndWait (std::move (batchRequests));
+}
+
+void PresetsServerSyncManager::syncPresetsIndividually (const std::vector<const chowdsp::Preset*>& presets,
+                                                        std::vector<AddedPresetInfo>& addedPresetInfo,
+                                                        const std::function<void (int, int)>& updateProgressCallback)
+{
+    using namespace PresetsServerCommunication;
+
     const auto numPresets = (int) presets.size();
     for (auto [index, preset] : sst::cpputils::enumerate (presets))
     {
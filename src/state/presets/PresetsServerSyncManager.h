@@ -11,13 +11,24 @@ public:
 
     using AddedPresetInfo = std::pair<const chowdsp::Preset*, String>;
 
+    /**
+     * Uploads any presets that are new or have changed since they were last synced,
+     * in batches (see PresetsServerSyncProtocol). If the server doesn't support batched
+     * syncing (i.e. the hashes request returns 404 or 405), then the presets are uploaded
+     * one-by-one instead. Any other failure is reported, and nothing is uploaded.
+     */
     void syncLocalPresetsToServer (const std::vector<const chowdsp::Preset*>& presets,
                                    std::vector<AddedPresetInfo>& addedPresetInfo,
                                    const std::function<void (int, int)>& updateProgressCallback);
     bool syncServerPresetsToLocal (std::vector<chowdsp::Preset>& serverPresets);
 
 private:
+    void syncPresetsIndividually (const std::vector<const chowdsp::Preset*>& presets,
+                                  std::vector<AddedPresetInfo>& addedPresetInfo,
+                                  const std::function<void (int, int)>& updateProgressCallback);
+
     SharedPresetsServerUserManager userManager;
+    SharedPresetsServerJobPool jobPool;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PresetsServerSyncManager)
 };
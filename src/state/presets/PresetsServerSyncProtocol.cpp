@@ -0,0 +1,141 @@
+#if BYOD_BUILD_PRESET_SERVER
+
+#include "PresetsServerSyncProtocol.h"
+#include "PresetInfoHelpers.h"
+
+namespace PresetsServerSyncProtocol
+{
+String getContentHash (const String& presetData)
+{
+    // 64-bit FNV-1a
+    uint64 hash = 0xcbf29ce484222325ULL;
+    for (auto* c = presetData.toRawUTF8(); *c != 0; ++c)
+    {
+        hash ^= (uint64) (uint8) *c;
+        hash *= 0x100000001b3ULL;
+    }
+
+    return String::toHexString ((int64) hash).paddedLeft ('0', 16);
+}
+
+std::optional<std::map<String, String>> parseHashesResponse (const String& response)
+{
+    try
+    {
+        const auto hashesJson = chowdsp::json::parse (response.toStdString());
+        if (! hashesJson.is_object())
+            return std::nullopt;
+
+        std::map<String, String> serverHashes;
+        for (const auto& [presetID, hash] : hashesJson.items())
+        {
+            if (hash.is_string())
+                serverHashes.emplace (String { presetID }, hash.get<String>());
+        }
+
+        return serverHashes;
+    }
+    catch (...)
+    {
+        return std::nullopt;
+    }
+}
+
+std::vector<PresetUpload> getChangedPresets (const std::vector<const chowdsp::Preset*>& presets,
+                                             const std::map<String, String>& serverHashes)
+{
+    std::vector<PresetUpload> changedPresets;
+    for (const auto* preset : presets)
+    {
+        if (preset == nullptr)
+        {
+            jassertfalse;
+            continue;
+        }
+
+        auto presetData = preset->toXml()->toString();
+        auto hash = getContentHash (presetData);
+
+        const auto presetID = PresetInfoHelpers::getPresetID (*preset);
+        if (presetID.isNotEmpty())
+        {
+            // preset already exists on the server, and hasn't changed
+            if (const auto serverHashIter = serverHashes.find (presetID); serverHashIter != serverHashes.end() && serverHashIter->second == hash)
+                continue;
+        }
+
+        changedPresets.push_back ({ preset, std::move (presetData), std::move (hash) });
+    }
+
+    return changedPresets;
+}
+
+std::vector<std::vector<PresetUpload>> splitIntoBatches (std::vector<PresetUpload>&& uploads)
+{
+    std::vector<std::vector<PresetUpload>> batches;
+    size_t currentBatchSizeBytes = 0;
+    for (auto& upload : uploads)
+    {
+        const auto uploadSizeBytes = upload.data.getNumBytesAsUTF8();
+        if (batches.empty()
+            || batches.back().size() >= maxPresetsPerBatch
+            || (! batches.back().empty() && currentBatchSizeBytes + uploadSizeBytes > maxBatchSizeBytes))
+        {
+            batches.emplace_back();
+            currentBatchSizeBytes = 0;
+        }
+
+        batches.back().push_back (std::move (upload));
+        currentBatchSizeBytes += uploadSizeBytes;
+    }
+
+    return batches;
+}
+
+MemoryBlock createBatchRequestData (const std::vector<PresetUpload>& batch)
+{
+    auto batchJson = chowdsp::json::array();
+    for (const auto& upload : batch)
+    {
+        batchJson.push_back ({
+            { "name", upload.preset->getName().toStdString() },
+            { "preset_id", PresetInfoHelpers::getPresetID (*upload.preset).toStdString() },
+            { "is_public", PresetInfoHelpers::getIsPublic (*upload.preset) },
+            { "data", upload.data.toStdString() },
+        });
+    }
+
+    const auto batchString = batchJson.dump();
+
+    MemoryBlock batchData;
+    {
+        MemoryOutputStream dataStream { batchData, false };
+        GZIPCompressorOutputStream compressedStream { dataStream };
+        compressedStream.write (batchString.data(), batchString.size());
+    }
+
+    return batchData;
+}
+
+std::optional<StringArray> parseBatchResponse (const String& response, size_t batchSize)
+{
+    try
+    {
+        const auto idsJson = chowdsp::json::parse (response.toStdString());
+        if (! idsJson.is_array() || idsJson.size() != batchSize)
+            return std::nullopt;
+
+        StringArray presetIDs;
+        for (const auto& presetID : idsJson)
+            presetIDs.add (presetID.get<String>());
+
+        return presetIDs;
+    }
+    catch (...)
+    {
+        return std::nullopt;
+    }
+}
+} // namespace PresetsServerSyncProtocol
+
+#endif // BYOD_BUILD_PRESET_SERVER
@@ -0,0 +1,60 @@
+#if BYOD_BUILD_PRESET_SERVER
+
+#pragma once
+
+#include <pch.h>
+
+/**
+ * The delta-based protocol used to sync local presets to the presets server.
+ *
+ * Rather than uploading every preset with its own request, the client first
+ * asks the server for the content hash of each of the user's presets (get_preset_hashes),
+ * and only uploads the presets that are new, or whose hash has changed. The changed
+ * presets are then uploaded in batches (sync_presets), where each batch is a JSON
+ * array of presets, compressed with zlib:
+ *
+ * [ { "name": ..., "preset_id": ..., "is_public": ..., "data": ... }, ... ]
+ *
+ * The server responds with a JSON array containing the ID of each preset in the batch
+ * (in the same order), so that newly added presets can be given their IDs.
+ *
+ * The content hash is the 64-bit FNV-1a hash of the preset XML string (UTF-8), written
+ * as 16 lower-case hex digits. The server must compute the hash in the same way!
+ */
+namespace PresetsServerSyncProtocol
+{
+/** Presets are uploaded in batches of (at most) this many presets... */
+static constexpr size_t maxPresetsPerBatch = 32;
+
+/** ... or this many bytes of (uncompressed) preset data, whichever comes first. */
+static constexpr size_t maxBatchSizeBytes = 512 * 1024;
+
+/** A preset that needs to be uploaded to the server. */
+struct PresetUpload
+{
+    const chowdsp::Preset* preset = nullptr;
+    String data {};
+    String hash {};
+};
+
+/** Returns the content hash of some preset data. */
+String getContentHash (const String& presetData);
+
+/** Parses the server's response to a get_preset_hashes request, as a map of preset ID to content hash. */
+std::optional<std::map<String, String>> parseHashesResponse (const String& response);
+
+/** Returns the presets that don't exist on the server yet, or have changed since they were last uploaded. */
+std::vector<PresetUpload> getChangedPresets (const std::vector<const chowdsp::Preset*>& presets,
+                                             const std::map<String, String>& serverHashes);
+
+/** Splits the presets to upload into batches. */
+std::vector<std::vector<PresetUpload>> splitIntoBatches (std::vector<PresetUpload>&& uploads);
+
+/** Creates the (compressed) request data for a batch of presets. */
+MemoryBlock createBatchRequestData (const std::vector<PresetUpload>& batch);
+
+/** Parses the server's response to a sync_presets request, as the preset IDs for each preset in the batch. */
+std::optional<StringArray> parseBatchResponse (const String& response, size_t batchSize);
+} // namespace PresetsServerSyncProtocol
+
+#endif // BYOD_BUILD_PRESET_SERVER